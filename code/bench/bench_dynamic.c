@@ -0,0 +1,141 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/sys/framework.h"
+#include "../tests/cases/fixture_libm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Library startup benchmark. Each comparison changes one variable:
+ *
+ *   flags:       sequential NOW loads against sequential LAZY loads
+ *   parallelism: LAZY preload on one worker against several workers
+ *
+ * Every round loads fresh private copies of libm, so each load maps a new
+ * object, and the variants alternate within a round so page-cache state
+ * and frequency drift hit them alike. The median and minimum are reported.
+ */
+
+enum
+{
+    BENCH_LIBS = 8,
+    BENCH_ROUNDS = 25,
+    BENCH_WORKERS = 4
+};
+
+typedef enum
+{
+    BENCH_SEQ_NOW,
+    BENCH_SEQ_LAZY,
+    BENCH_PRELOAD_ONE,
+    BENCH_PRELOAD_MANY,
+    BENCH_VARIANTS
+} bench_variant_t;
+
+static const char *bench_names[BENCH_VARIANTS] = {
+    "sequential NOW",
+    "sequential LAZY",
+    "preload LAZY, 1 worker",
+    "preload LAZY, 4 workers",
+};
+
+static char bench_files[BENCH_LIBS][64];
+static const char *bench_paths[BENCH_LIBS];
+
+static void bench_cleanup(void)
+{
+    for (int i = 0; i < BENCH_LIBS; ++i)
+        if (bench_paths[i])
+            remove(bench_paths[i]);
+}
+
+/* Loads every copy with one variant and returns the elapsed time, 0 on failure */
+static uint64_t bench_run(bench_variant_t variant)
+{
+    fossil_sys_dynamic_lib_t libs[BENCH_LIBS] = {{0}};
+    size_t loaded = 0;
+    uint64_t start = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+    switch (variant)
+    {
+    case BENCH_SEQ_NOW:
+    case BENCH_SEQ_LAZY:
+    {
+        unsigned flags = variant == BENCH_SEQ_NOW ? FOSSIL_SYS_DYNAMIC_NOW : FOSSIL_SYS_DYNAMIC_LAZY;
+        for (int i = 0; i < BENCH_LIBS; ++i)
+            loaded += fossil_sys_dynamic_load_ex(bench_paths[i], flags, FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT, &libs[i]);
+        break;
+    }
+    default:
+        loaded = fossil_sys_dynamic_preload(bench_paths, BENCH_LIBS, FOSSIL_SYS_DYNAMIC_LAZY,
+                                            variant == BENCH_PRELOAD_ONE ? 1 : BENCH_WORKERS, libs);
+        break;
+    }
+    uint64_t elapsed = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC) - start;
+
+    for (int i = 0; i < BENCH_LIBS; ++i)
+        fossil_sys_dynamic_unload(&libs[i]);
+    return loaded == BENCH_LIBS ? elapsed : 0;
+}
+
+static int bench_compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+int main(void)
+{
+#if defined(__linux__)
+    for (int i = 0; i < BENCH_LIBS; ++i)
+    {
+        snprintf(bench_files[i], sizeof(bench_files[i]), "./fossil_sys_bench_dynamic_%d.so", i);
+        bench_paths[i] = bench_files[i];
+        if (!fossil_test_fixture_install_libm(bench_paths[i]))
+        {
+            fprintf(stderr, "bench_dynamic: cannot copy libm to %s\n", bench_paths[i]);
+            bench_cleanup();
+            return 1;
+        }
+    }
+
+    static uint64_t samples[BENCH_VARIANTS][BENCH_ROUNDS];
+    for (int round = 0; round < BENCH_ROUNDS; ++round)
+    {
+        for (int v = 0; v < BENCH_VARIANTS; ++v)
+        {
+            bench_variant_t variant = (bench_variant_t)((v + round) % BENCH_VARIANTS);
+            samples[variant][round] = bench_run(variant);
+            if (!samples[variant][round])
+            {
+                fprintf(stderr, "bench_dynamic: %s failed: %s\n", bench_names[variant], fossil_sys_dynamic_error());
+                bench_cleanup();
+                return 1;
+            }
+        }
+    }
+    bench_cleanup();
+
+    printf("dynamic startup, %d libraries, %d rounds (median / min, ms)\n", BENCH_LIBS, BENCH_ROUNDS);
+    for (int v = 0; v < BENCH_VARIANTS; ++v)
+    {
+        qsort(samples[v], BENCH_ROUNDS, sizeof(samples[v][0]), bench_compare);
+        printf("  %-26s %8.3f %8.3f\n", bench_names[v], samples[v][BENCH_ROUNDS / 2] / 1e6, samples[v][0] / 1e6);
+    }
+#else
+    printf("dynamic startup benchmark needs a Linux loader\n");
+#endif
+    return 0;
+}
@@ -0,0 +1,1017 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// Must be defined before any header for O_CLOEXEC
+#define _GNU_SOURCE
+#endif
+
+#include "fossil/sys/config.h"
+#include "fossil/sys/env.h"
+#include "fossil/sys/event.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if !defined(O_CLOEXEC)
+#define O_CLOEXEC 0 // set with fcntl right after open
+#define FOSSIL_SYS_CONFIG_SET_CLOEXEC 1
+#endif
+#endif
+
+/* ============================================================================
+ * Synchronization
+ *
+ * Writers (defaults, file loads, reloads, handle creation) serialize on one
+ * lock. Readers never lock: they register in the current epoch, load the
+ * value pointer of a handle, copy what they need and leave. Value records
+ * are immutable; a record a writer replaces is retired and freed once every
+ * reader that could still see it has left (two-counter epoch scheme, as in
+ * the env snapshot), so memory stays bounded however often values change.
+ * ============================================================================
+ */
+
+#if defined(_WIN32)
+typedef volatile LONG fossil_sys_config_atomic_t;
+#define fossil_sys_config_atomic_inc(p) InterlockedIncrement(p)
+#define fossil_sys_config_atomic_dec(p) InterlockedDecrement(p)
+#define fossil_sys_config_atomic_dec_release(p) InterlockedDecrement(p)
+#define fossil_sys_config_atomic_load(p) InterlockedCompareExchange((p), 0, 0)
+#define fossil_sys_config_atomic_store(p, v) InterlockedExchange((p), (v))
+typedef SRWLOCK fossil_sys_config_lock_t;
+#define FOSSIL_SYS_CONFIG_LOCK_INIT SRWLOCK_INIT
+#define fossil_sys_config_lock(l) AcquireSRWLockExclusive(l)
+#define fossil_sys_config_unlock(l) ReleaseSRWLockExclusive(l)
+#define fossil_sys_config_load_ptr(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define fossil_sys_config_store_ptr(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (PVOID)(v))
+#define fossil_sys_config_load_u64(p) ((uint64_t)InterlockedCompareExchange64((LONG64 volatile *)(p), 0, 0))
+#define fossil_sys_config_store_u64(p, v) InterlockedExchange64((LONG64 volatile *)(p), (LONG64)(v))
+#else
+typedef long fossil_sys_config_atomic_t;
+#define fossil_sys_config_atomic_inc(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_config_atomic_dec(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_config_atomic_dec_release(p) __atomic_sub_fetch((p), 1, __ATOMIC_RELEASE)
+#define fossil_sys_config_atomic_load(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define fossil_sys_config_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+typedef pthread_mutex_t fossil_sys_config_lock_t;
+#define FOSSIL_SYS_CONFIG_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define fossil_sys_config_lock(l) pthread_mutex_lock(l)
+#define fossil_sys_config_unlock(l) pthread_mutex_unlock(l)
+#define fossil_sys_config_load_ptr(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define fossil_sys_config_store_ptr(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define fossil_sys_config_load_u64(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define fossil_sys_config_store_u64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+#define FOSSIL_SYS_CONFIG_CACHE_LINE 64
+
+/* Readers of the two epoch parities bump different cache lines */
+typedef struct
+{
+    fossil_sys_config_atomic_t count;
+    char pad[FOSSIL_SYS_CONFIG_CACHE_LINE - sizeof(fossil_sys_config_atomic_t)];
+} fossil_sys_config_counter_t;
+
+/* ============================================================================
+ * Storage
+ * ============================================================================
+ */
+
+enum
+{
+    FOSSIL_SYS_CONFIG_HAS_INT = 1 << 0,
+    FOSSIL_SYS_CONFIG_HAS_BOOL = 1 << 1,
+    FOSSIL_SYS_CONFIG_HAS_DOUBLE = 1 << 2,
+    FOSSIL_SYS_CONFIG_HAS_DURATION = 1 << 3,
+    FOSSIL_SYS_CONFIG_HAS_SIZE = 1 << 4
+};
+
+/* One resolved value in every form it parses as. Immutable once published. */
+typedef struct fossil_sys_config_value
+{
+    struct fossil_sys_config_value *retired_next;
+    unsigned long retired_epoch;
+    fossil_sys_config_source_t source;
+    unsigned valid; // FOSSIL_SYS_CONFIG_HAS_* bits
+    int64_t as_int;
+    int as_bool;
+    double as_double;
+    uint64_t as_duration_ns;
+    uint64_t as_size;
+    char text[];
+} fossil_sys_config_value_t;
+
+struct fossil_sys_config_entry
+{
+    char *key;
+    uint64_t hash;
+    char *default_value; // layers, guarded by the store lock
+    char *file_value;
+    const fossil_sys_config_value_t *value; // published, NULL when unset
+};
+
+typedef struct
+{
+    char *key;
+    char *value;
+} fossil_sys_config_pair_t;
+
+static struct
+{
+    fossil_sys_config_atomic_t epoch;
+    char pad0[FOSSIL_SYS_CONFIG_CACHE_LINE];
+    fossil_sys_config_counter_t active[2]; // readers per epoch parity
+
+    // Writer side, guarded by lock
+    fossil_sys_config_lock_t lock;
+    fossil_sys_config_handle_t **slots; // open addressing, power-of-two capacity
+    size_t capacity;
+    size_t count;
+    fossil_sys_config_value_t *retired; // replaced records readers may still hold
+    char *path;                         // file layer source
+    uint64_t generation;
+} fossil_sys_config = {
+    .lock = FOSSIL_SYS_CONFIG_LOCK_INIT,
+};
+
+/* Returns the epoch token to pass to fossil_sys_config_read_end. */
+static unsigned long fossil_sys_config_read_begin(void)
+{
+    for (;;)
+    {
+        unsigned long e = (unsigned long)fossil_sys_config_atomic_load(&fossil_sys_config.epoch);
+        fossil_sys_config_atomic_inc(&fossil_sys_config.active[e & 1].count);
+        if ((unsigned long)fossil_sys_config_atomic_load(&fossil_sys_config.epoch) == e)
+            return e;
+        fossil_sys_config_atomic_dec(&fossil_sys_config.active[e & 1].count);
+    }
+}
+
+/* Leaving only has to publish the reader's loads before the count drops */
+static void fossil_sys_config_read_end(unsigned long token)
+{
+    fossil_sys_config_atomic_dec_release(&fossil_sys_config.active[token & 1].count);
+}
+
+/*
+ * Frees retired records no reader can still hold and advances the epoch.
+ * Never waits: a record held by a slow reader is freed by a later call.
+ * Caller holds the lock.
+ */
+static void fossil_sys_config_reclaim(void)
+{
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        unsigned long e = (unsigned long)fossil_sys_config_atomic_load(&fossil_sys_config.epoch);
+        if (fossil_sys_config_atomic_load(&fossil_sys_config.active[(e + 1) & 1].count) != 0)
+            return; // readers from epoch e - 1 are still inside
+
+        fossil_sys_config_value_t **link = &fossil_sys_config.retired;
+        while (*link)
+        {
+            fossil_sys_config_value_t *value = *link;
+            if ((long)(e - 1 - value->retired_epoch) >= 0)
+            {
+                *link = value->retired_next;
+                free(value);
+            }
+            else
+                link = &value->retired_next;
+        }
+        fossil_sys_config_atomic_store(&fossil_sys_config.epoch, (long)(e + 1));
+    }
+}
+
+/* Publishes value as the entry's record and retires the one it replaces. Caller holds the lock. */
+static void fossil_sys_config_publish(fossil_sys_config_handle_t *entry, fossil_sys_config_value_t *value)
+{
+    fossil_sys_config_value_t *old = (fossil_sys_config_value_t *)entry->value;
+    fossil_sys_config_store_ptr(&entry->value, (const fossil_sys_config_value_t *)value);
+    if (old)
+    {
+        old->retired_epoch = (unsigned long)fossil_sys_config_atomic_load(&fossil_sys_config.epoch);
+        old->retired_next = fossil_sys_config.retired;
+        fossil_sys_config.retired = old;
+    }
+    fossil_sys_config_reclaim();
+}
+
+static uint64_t fossil_sys_config_hash(const char *key)
+{
+    uint64_t h = 1469598103934665603ull; // FNV-1a
+    for (; *key; ++key)
+    {
+        h ^= (unsigned char)*key;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static char *fossil_sys_config_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = malloc(len);
+    if (copy)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+/* Slot of key, or the empty slot where it belongs. Caller holds the lock. */
+static fossil_sys_config_handle_t **fossil_sys_config_slot(const char *key, uint64_t hash)
+{
+    size_t mask = fossil_sys_config.capacity - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        fossil_sys_config_handle_t *entry = fossil_sys_config.slots[i];
+        if (!entry || (entry->hash == hash && strcmp(entry->key, key) == 0))
+            return &fossil_sys_config.slots[i];
+    }
+}
+
+static int fossil_sys_config_grow(void)
+{
+    size_t capacity = fossil_sys_config.capacity ? fossil_sys_config.capacity * 2 : 64;
+    fossil_sys_config_handle_t **slots = calloc(capacity, sizeof(*slots));
+    if (!slots)
+        return -1;
+    fossil_sys_config_handle_t **old = fossil_sys_config.slots;
+    size_t old_capacity = fossil_sys_config.capacity;
+    fossil_sys_config.slots = slots;
+    fossil_sys_config.capacity = capacity;
+    for (size_t i = 0; i < old_capacity; ++i)
+    {
+        if (old[i])
+            *fossil_sys_config_slot(old[i]->key, old[i]->hash) = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+/* ============================================================================
+ * Value parsing
+ * ============================================================================
+ */
+
+static int fossil_sys_config_parse_int(const char *s, int64_t *out)
+{
+    const char *p = s;
+    if (*p == '+' || *p == '-')
+        ++p;
+    int hex = p[0] == '0' && (p[1] == 'x' || p[1] == 'X');
+    if (!isdigit((unsigned char)p[hex ? 2 : 0]))
+        return 0;
+    char *end;
+    errno = 0;
+    long long v = strtoll(s, &end, hex ? 16 : 10);
+    if (errno == ERANGE || *end != '\0')
+        return 0;
+    *out = (int64_t)v;
+    return 1;
+}
+
+static int fossil_sys_config_parse_bool(const char *s, int *out)
+{
+    static const char *const truthy[] = {"1", "true", "yes", "on"};
+    static const char *const falsy[] = {"0", "false", "no", "off"};
+    char lower[8];
+    size_t len = strlen(s);
+    if (len >= sizeof(lower))
+        return 0;
+    for (size_t i = 0; i <= len; ++i)
+        lower[i] = (char)tolower((unsigned char)s[i]);
+    for (size_t i = 0; i < sizeof(truthy) / sizeof(truthy[0]); ++i)
+    {
+        if (strcmp(lower, truthy[i]) == 0)
+            return *out = 1, 1;
+        if (strcmp(lower, falsy[i]) == 0)
+            return *out = 0, 1;
+    }
+    return 0;
+}
+
+static int fossil_sys_config_parse_double(const char *s, double *out)
+{
+    char *end;
+    if (*s == '\0' || isspace((unsigned char)*s))
+        return 0;
+    double v = strtod(s, &end);
+    if (*end != '\0')
+        return 0;
+    *out = v;
+    return 1;
+}
+
+/* Non-negative decimal number at *p, advancing past it. */
+static int fossil_sys_config_parse_amount(const char **p, double *out)
+{
+    if (!isdigit((unsigned char)**p) && **p != '.')
+        return 0;
+    char *end;
+    *out = strtod(*p, &end);
+    if (end == *p)
+        return 0;
+    *p = end;
+    return 1;
+}
+
+static int fossil_sys_config_parse_duration(const char *s, uint64_t *out)
+{
+    static const struct
+    {
+        const char *unit;
+        double ns;
+    } units[] = {
+        {"ns", 1.0}, {"us", 1e3}, {"ms", 1e6}, {"s", 1e9}, {"m", 60e9}, {"h", 3600e9}, {"d", 86400e9},
+    };
+
+    const char *p = s;
+    double total = 0.0, amount;
+    if (!fossil_sys_config_parse_amount(&p, &amount))
+        return 0;
+    if (*p == '\0')
+        total = amount * 1e6; // bare number: milliseconds
+    while (*p)
+    {
+        // Every amount after the first needs a unit: "1m30" is rejected
+        size_t len = 0;
+        while (isalpha((unsigned char)p[len]))
+            ++len;
+        size_t u = 0;
+        while (u < sizeof(units) / sizeof(units[0]) &&
+               (strlen(units[u].unit) != len || strncmp(units[u].unit, p, len) != 0))
+            ++u;
+        if (len == 0 || u == sizeof(units) / sizeof(units[0]))
+            return 0;
+        total += amount * units[u].ns;
+        p += len;
+        if (*p && (!fossil_sys_config_parse_amount(&p, &amount) || *p == '\0'))
+            return 0;
+    }
+    if (total >= 18446744073709551615.0)
+        return 0;
+    *out = (uint64_t)(total + 0.5);
+    return 1;
+}
+
+static int fossil_sys_config_parse_size(const char *s, uint64_t *out)
+{
+    const char *p = s;
+    double amount, scale = 1.0;
+    if (!fossil_sys_config_parse_amount(&p, &amount))
+        return 0;
+    while (*p == ' ')
+        ++p;
+    const char *units = "BKMGT";
+    const char *unit = *p ? strchr(units, toupper((unsigned char)*p)) : NULL;
+    if (*p && !unit)
+        return 0;
+    if (unit)
+    {
+        for (const char *u = units; u < unit; ++u)
+            scale = u == units ? 1.0 : scale * 1024.0;
+        if (unit != units)
+            scale *= 1024.0;
+        ++p;
+        if (unit != units && (*p == 'i' || *p == 'I'))
+            ++p;
+        if (unit != units && (*p == 'b' || *p == 'B'))
+            ++p;
+        if (*p)
+            return 0;
+    }
+    double total = amount * scale;
+    if (total >= 18446744073709551615.0)
+        return 0;
+    *out = (uint64_t)(total + 0.5);
+    return 1;
+}
+
+static fossil_sys_config_value_t *fossil_sys_config_value_new(const char *text, fossil_sys_config_source_t source)
+{
+    size_t len = strlen(text);
+    fossil_sys_config_value_t *value = calloc(1, sizeof(*value) + len + 1);
+    if (!value)
+        return NULL;
+    memcpy(value->text, text, len + 1);
+    value->source = source;
+    if (fossil_sys_config_parse_int(text, &value->as_int))
+        value->valid |= FOSSIL_SYS_CONFIG_HAS_INT;
+    if (fossil_sys_config_parse_bool(text, &value->as_bool))
+        value->valid |= FOSSIL_SYS_CONFIG_HAS_BOOL;
+    if (fossil_sys_config_parse_double(text, &value->as_double))
+        value->valid |= FOSSIL_SYS_CONFIG_HAS_DOUBLE;
+    if (fossil_sys_config_parse_duration(text, &value->as_duration_ns))
+        value->valid |= FOSSIL_SYS_CONFIG_HAS_DURATION;
+    if (fossil_sys_config_parse_size(text, &value->as_size))
+        value->valid |= FOSSIL_SYS_CONFIG_HAS_SIZE;
+    return value;
+}
+
+/* ============================================================================
+ * Layer resolution
+ * ============================================================================
+ */
+
+/*
+ * "fossil.runtime.log.level" -> "FOSSIL_RUNTIME_LOG_LEVEL". Returns a copy
+ * (the caller frees it) so a concurrent env set cannot free the text.
+ */
+static char *fossil_sys_config_env_value(const char *key)
+{
+    char name[256];
+    size_t len = strlen(key);
+    if (len >= sizeof(name))
+        return NULL;
+    for (size_t i = 0; i <= len; ++i)
+    {
+        char c = key[i];
+        name[i] = c == '.' || c == '-' ? '_' : (char)toupper((unsigned char)c);
+    }
+    char *value = NULL;
+    int n = fossil_sys_env_get_copy(name, NULL, 0);
+    while (n >= 0)
+    {
+        char *grown = realloc(value, (size_t)n + 1);
+        if (!grown)
+            break;
+        value = grown;
+        int again = fossil_sys_env_get_copy(name, value, (size_t)n + 1);
+        if (again >= 0 && again <= n)
+            return value;
+        n = again; /* changed meanwhile */
+    }
+    free(value);
+    return NULL;
+}
+
+/*
+ * Re-resolves an entry from its layers and publishes a new value record
+ * if the result differs. Caller holds the lock. Returns 1 if it changed,
+ * 0 if not, -1 on allocation failure.
+ */
+static int fossil_sys_config_resolve(fossil_sys_config_handle_t *entry)
+{
+    fossil_sys_config_source_t source = FOSSIL_SYS_CONFIG_SOURCE_NONE;
+    char *env_text = fossil_sys_config_env_value(entry->key);
+    const char *text = env_text;
+    if (text)
+        source = FOSSIL_SYS_CONFIG_SOURCE_ENV;
+    else if ((text = entry->file_value) != NULL)
+        source = FOSSIL_SYS_CONFIG_SOURCE_FILE;
+    else if ((text = entry->default_value) != NULL)
+        source = FOSSIL_SYS_CONFIG_SOURCE_DEFAULT;
+
+    const fossil_sys_config_value_t *current = entry->value;
+    if (!text)
+    {
+        if (!current)
+            return 0;
+        fossil_sys_config_publish(entry, NULL);
+        return 1;
+    }
+    if (current && current->source == source && strcmp(current->text, text) == 0)
+    {
+        free(env_text);
+        return 0;
+    }
+
+    fossil_sys_config_value_t *value = fossil_sys_config_value_new(text, source);
+    free(env_text);
+    if (!value)
+        return -1;
+    fossil_sys_config_publish(entry, value);
+    return 1;
+}
+
+/* Finds or creates the entry for key. Caller holds the lock. */
+static fossil_sys_config_handle_t *fossil_sys_config_entry(const char *key)
+{
+    uint64_t hash = fossil_sys_config_hash(key);
+    if (fossil_sys_config.capacity)
+    {
+        fossil_sys_config_handle_t *found = *fossil_sys_config_slot(key, hash);
+        if (found)
+            return found;
+    }
+    if ((fossil_sys_config.count + 1) * 4 > fossil_sys_config.capacity * 3 && fossil_sys_config_grow() != 0)
+        return NULL;
+
+    fossil_sys_config_handle_t *entry = calloc(1, sizeof(*entry));
+    if (!entry || !(entry->key = fossil_sys_config_strdup(key)))
+    {
+        free(entry);
+        return NULL;
+    }
+    entry->hash = hash;
+    *fossil_sys_config_slot(key, hash) = entry;
+    fossil_sys_config.count++;
+    fossil_sys_config_resolve(entry);
+    return entry;
+}
+
+/* ============================================================================
+ * File layer
+ * ============================================================================
+ */
+
+static char *fossil_sys_config_trim(char *begin, char *end)
+{
+    while (begin < end && isspace((unsigned char)*begin))
+        ++begin;
+    while (end > begin && isspace((unsigned char)end[-1]))
+        --end;
+    *end = '\0';
+    return begin;
+}
+
+/* Parses key=value / INI text into pairs. Returns the pair count, or -1. */
+static long fossil_sys_config_parse_text(const char *text, size_t size, fossil_sys_config_pair_t **pairs)
+{
+    size_t count = 0, capacity = 0;
+    char section[128] = "";
+    char small[1024];
+    char *line = small;
+    size_t line_size = sizeof(small);
+    *pairs = NULL;
+
+    for (size_t pos = 0; pos < size;)
+    {
+        const char *nl = memchr(text + pos, '\n', size - pos);
+        size_t len = (nl ? (size_t)(nl - text) : size) - pos;
+        if (len >= line_size)
+        {
+            // Long values are kept whole rather than cut into other values
+            char *grown = malloc(len + 1);
+            if (!grown)
+                goto fail;
+            if (line != small)
+                free(line);
+            line = grown;
+            line_size = len + 1;
+        }
+        memcpy(line, text + pos, len);
+        line[len] = '\0';
+        pos = nl ? (size_t)(nl - text) + 1 : size;
+
+        char *s = fossil_sys_config_trim(line, line + len);
+        if (*s == '\0' || *s == '#' || *s == ';')
+            continue;
+        if (*s == '[')
+        {
+            char *close = strchr(s, ']');
+            if (close)
+            {
+                char *name = fossil_sys_config_trim(s + 1, close);
+                snprintf(section, sizeof(section), "%s", name);
+            }
+            continue;
+        }
+
+        char *eq = strchr(s, '=');
+        if (!eq)
+            continue;
+        char *key = fossil_sys_config_trim(s, eq);
+        char *value = fossil_sys_config_trim(eq + 1, eq + 1 + strlen(eq + 1));
+        size_t value_len = strlen(value);
+        if (value_len >= 2 && value[0] == '"' && value[value_len - 1] == '"')
+        {
+            value[value_len - 1] = '\0';
+            ++value;
+        }
+        if (*key == '\0')
+            continue;
+
+        if (count == capacity)
+        {
+            size_t grown = capacity ? capacity * 2 : 32;
+            fossil_sys_config_pair_t *next = realloc(*pairs, grown * sizeof(**pairs));
+            if (!next)
+                goto fail;
+            *pairs = next;
+            capacity = grown;
+        }
+        size_t key_size = strlen(section) + 1 + strlen(key) + 1;
+        fossil_sys_config_pair_t *pair = &(*pairs)[count];
+        pair->key = malloc(key_size);
+        pair->value = fossil_sys_config_strdup(value);
+        if (!pair->key || !pair->value)
+        {
+            free(pair->key);
+            free(pair->value);
+            goto fail;
+        }
+        if (section[0])
+            snprintf(pair->key, key_size, "%s.%s", section, key);
+        else
+            snprintf(pair->key, key_size, "%s", key);
+        count++;
+    }
+    if (line != small)
+        free(line);
+    return (long)count;
+
+fail:
+    if (line != small)
+        free(line);
+    for (size_t i = 0; i < count; ++i)
+    {
+        free((*pairs)[i].key);
+        free((*pairs)[i].value);
+    }
+    free(*pairs);
+    *pairs = NULL;
+    return -1;
+}
+
+/* Maps the file read-only and parses it. Returns the pair count, or -1. */
+static long fossil_sys_config_read_file(const char *path, fossil_sys_config_pair_t **pairs)
+{
+    long count = -1;
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return -1;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size))
+        size.QuadPart = -1;
+    if (size.QuadPart == 0)
+        count = fossil_sys_config_parse_text("", 0, pairs);
+    else if (size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping)
+        {
+            const char *text = (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (text)
+            {
+                count = fossil_sys_config_parse_text(text, (size_t)size.QuadPart, pairs);
+                UnmapViewOfFile(text);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+#if defined(FOSSIL_SYS_CONFIG_SET_CLOEXEC)
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+    struct stat st;
+    if (fstat(fd, &st) == 0)
+    {
+        if (st.st_size == 0)
+            count = fossil_sys_config_parse_text("", 0, pairs);
+        else
+        {
+            void *text = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (text != MAP_FAILED)
+            {
+                count = fossil_sys_config_parse_text(text, (size_t)st.st_size, pairs);
+                munmap(text, (size_t)st.st_size);
+            }
+        }
+    }
+    close(fd);
+#endif
+    return count;
+}
+
+static void fossil_sys_config_free_pairs(fossil_sys_config_pair_t *pairs, long count)
+{
+    for (long i = 0; i < count; ++i)
+    {
+        free(pairs[i].key);
+        free(pairs[i].value);
+    }
+    free(pairs);
+}
+
+/*
+ * Replaces the file layer with pairs (taking ownership of the strings) when
+ * replace is set and re-resolves every entry. The reload event is posted
+ * only if a value changed, so an idle reload loop cannot fill the shared
+ * event queue; a failed post is reported as -3.
+ */
+static int fossil_sys_config_apply(fossil_sys_config_pair_t *pairs, long count, int replace)
+{
+    size_t changed = 0;
+    int rc = 0;
+
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    if (replace)
+    {
+        for (size_t i = 0; i < fossil_sys_config.capacity; ++i)
+        {
+            fossil_sys_config_handle_t *entry = fossil_sys_config.slots[i];
+            if (entry)
+            {
+                free(entry->file_value);
+                entry->file_value = NULL;
+            }
+        }
+        for (long i = 0; i < count; ++i)
+        {
+            fossil_sys_config_handle_t *entry = fossil_sys_config_entry(pairs[i].key);
+            if (!entry)
+            {
+                rc = -3;
+                continue;
+            }
+            free(entry->file_value);
+            entry->file_value = pairs[i].value; // later duplicates win
+            pairs[i].value = NULL;
+        }
+    }
+    for (size_t i = 0; i < fossil_sys_config.capacity; ++i)
+    {
+        fossil_sys_config_handle_t *entry = fossil_sys_config.slots[i];
+        if (!entry)
+            continue;
+        int result = fossil_sys_config_resolve(entry);
+        if (result > 0)
+            changed++;
+        else if (result < 0)
+            rc = -3;
+    }
+    uint64_t generation = fossil_sys_config.generation + 1;
+    fossil_sys_config_store_u64(&fossil_sys_config.generation, generation);
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+
+    if (changed)
+    {
+        fossil_sys_config_reload_event_t event;
+        event.generation = generation;
+        event.changed = changed;
+        if (fossil_sys_event_post(FOSSIL_SYS_CONFIG_EVENT_RELOAD, &event, sizeof(event)) != 0)
+            rc = -3;
+    }
+    return rc;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+int fossil_sys_config_set_default(const char *key, const char *value)
+{
+    if (!key || !*key)
+        return -1;
+    char *copy = NULL;
+    if (value && !(copy = fossil_sys_config_strdup(value)))
+        return -3;
+
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    fossil_sys_config_handle_t *entry = fossil_sys_config_entry(key);
+    int rc = -3;
+    if (entry)
+    {
+        free(entry->default_value);
+        entry->default_value = copy;
+        copy = NULL;
+        rc = fossil_sys_config_resolve(entry) < 0 ? -3 : 0;
+    }
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+    free(copy);
+    return rc;
+}
+
+int fossil_sys_config_load_file(const char *path)
+{
+    if (!path || !*path)
+        return -1;
+    char *copy = fossil_sys_config_strdup(path);
+    if (!copy)
+        return -3;
+
+    fossil_sys_config_pair_t *pairs;
+    long count = fossil_sys_config_read_file(path, &pairs);
+    if (count < 0)
+    {
+        free(copy);
+        return -3;
+    }
+
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    free(fossil_sys_config.path);
+    fossil_sys_config.path = copy;
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+
+    int rc = fossil_sys_config_apply(pairs, count, 1);
+    fossil_sys_config_free_pairs(pairs, count);
+    return rc;
+}
+
+int fossil_sys_config_reload(void)
+{
+    char path[4096] = "";
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    if (fossil_sys_config.path)
+        snprintf(path, sizeof(path), "%s", fossil_sys_config.path);
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+
+    fossil_sys_config_pair_t *pairs = NULL;
+    long count = 0;
+    int file_rc = 0;
+    if (path[0] && (count = fossil_sys_config_read_file(path, &pairs)) < 0)
+    {
+        count = 0;
+        file_rc = -3; // keep the previous file layer, still refresh the environment
+    }
+
+    int rc = fossil_sys_config_apply(pairs, count, path[0] && file_rc == 0);
+    fossil_sys_config_free_pairs(pairs, count);
+    return file_rc ? file_rc : rc;
+}
+
+uint64_t fossil_sys_config_generation(void)
+{
+    return fossil_sys_config_load_u64(&fossil_sys_config.generation);
+}
+
+fossil_sys_config_handle_t *fossil_sys_config_handle(const char *key)
+{
+    if (!key || !*key)
+        return NULL;
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    fossil_sys_config_handle_t *entry = fossil_sys_config_entry(key);
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+    return entry;
+}
+
+void fossil_sys_config_shutdown(void)
+{
+    fossil_sys_config_lock(&fossil_sys_config.lock);
+    for (size_t i = 0; i < fossil_sys_config.capacity; ++i)
+    {
+        fossil_sys_config_handle_t *entry = fossil_sys_config.slots[i];
+        if (!entry)
+            continue;
+        free(entry->key);
+        free(entry->default_value);
+        free(entry->file_value);
+        free((void *)entry->value);
+        free(entry);
+    }
+    free(fossil_sys_config.slots);
+    while (fossil_sys_config.retired)
+    {
+        fossil_sys_config_value_t *value = fossil_sys_config.retired;
+        fossil_sys_config.retired = value->retired_next;
+        free(value);
+    }
+    free(fossil_sys_config.path);
+    fossil_sys_config.slots = NULL;
+    fossil_sys_config.capacity = 0;
+    fossil_sys_config.count = 0;
+    fossil_sys_config.path = NULL;
+    fossil_sys_config_unlock(&fossil_sys_config.lock);
+}
+
+/*
+ * Loads the handle's record with the reader registered. The record stays
+ * valid until fossil_sys_config_read_end(*token); NULL if unset.
+ */
+static const fossil_sys_config_value_t *fossil_sys_config_value(const fossil_sys_config_handle_t *handle,
+                                                                unsigned long *token)
+{
+    *token = fossil_sys_config_read_begin();
+    return fossil_sys_config_load_ptr(&handle->value);
+}
+
+fossil_sys_config_source_t fossil_sys_config_source(const fossil_sys_config_handle_t *handle)
+{
+    if (!handle)
+        return FOSSIL_SYS_CONFIG_SOURCE_NONE;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    fossil_sys_config_source_t source = value ? value->source : FOSSIL_SYS_CONFIG_SOURCE_NONE;
+    fossil_sys_config_read_end(token);
+    return source;
+}
+
+const char *fossil_sys_config_string(const fossil_sys_config_handle_t *handle, const char *fallback)
+{
+    if (!handle)
+        return fallback;
+    const fossil_sys_config_value_t *value = fossil_sys_config_load_ptr(&handle->value);
+    return value ? value->text : fallback;
+}
+
+int fossil_sys_config_string_copy(const fossil_sys_config_handle_t *handle, char *buf, size_t size)
+{
+    if (!handle || (!buf && size))
+        return -1;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    int rc = -1;
+    if (value)
+    {
+        size_t len = strlen(value->text);
+        if (size)
+        {
+            size_t n = len < size - 1 ? len : size - 1;
+            memcpy(buf, value->text, n);
+            buf[n] = '\0';
+        }
+        rc = len > INT_MAX ? INT_MAX : (int)len;
+    }
+    fossil_sys_config_read_end(token);
+    return rc;
+}
+
+int64_t fossil_sys_config_int(const fossil_sys_config_handle_t *handle, int64_t fallback)
+{
+    if (!handle)
+        return fallback;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    int64_t result = value && (value->valid & FOSSIL_SYS_CONFIG_HAS_INT) ? value->as_int : fallback;
+    fossil_sys_config_read_end(token);
+    return result;
+}
+
+int fossil_sys_config_bool(const fossil_sys_config_handle_t *handle, int fallback)
+{
+    if (!handle)
+        return fallback;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    int result = value && (value->valid & FOSSIL_SYS_CONFIG_HAS_BOOL) ? value->as_bool : fallback;
+    fossil_sys_config_read_end(token);
+    return result;
+}
+
+double fossil_sys_config_double(const fossil_sys_config_handle_t *handle, double fallback)
+{
+    if (!handle)
+        return fallback;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    double result = value && (value->valid & FOSSIL_SYS_CONFIG_HAS_DOUBLE) ? value->as_double : fallback;
+    fossil_sys_config_read_end(token);
+    return result;
+}
+
+uint64_t fossil_sys_config_duration_ns(const fossil_sys_config_handle_t *handle, uint64_t fallback)
+{
+    if (!handle)
+        return fallback;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    uint64_t result = value && (value->valid & FOSSIL_SYS_CONFIG_HAS_DURATION) ? value->as_duration_ns : fallback;
+    fossil_sys_config_read_end(token);
+    return result;
+}
+
+uint64_t fossil_sys_config_size(const fossil_sys_config_handle_t *handle, uint64_t fallback)
+{
+    if (!handle)
+        return fallback;
+    unsigned long token;
+    const fossil_sys_config_value_t *value = fossil_sys_config_value(handle, &token);
+    uint64_t result = value && (value->valid & FOSSIL_SYS_CONFIG_HAS_SIZE) ? value->as_size : fallback;
+    fossil_sys_config_read_end(token);
+    return result;
+}
+
+const char *fossil_sys_config_get(const char *key, const char *fallback)
+{
+    return fossil_sys_config_string(fossil_sys_config_handle(key), fallback);
+}
@@ -22,12 +22,39 @@
  * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// Must be defined before any header for dl_iterate_phdr and dlinfo
+#define _GNU_SOURCE
+#endif
+
 #include "fossil/sys/dynamic.h"
+#include "fossil/sys/hostinfo.h"
 
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static char fossil_dyn_error_buf[256];
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#define fossil_dyn_atomic_inc(p) InterlockedIncrement(p)
+typedef volatile LONG fossil_dyn_atomic_t;
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#define fossil_dyn_atomic_inc(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+typedef long fossil_dyn_atomic_t;
+#endif
+
+#if defined(_MSC_VER)
+#define FOSSIL_DYN_THREAD_LOCAL __declspec(thread)
+#else
+#define FOSSIL_DYN_THREAD_LOCAL _Thread_local
+#endif
+
+/* Per thread, like dlerror, so parallel preloads keep their own messages */
+static FOSSIL_DYN_THREAD_LOCAL char fossil_dyn_error_buf[256];
 
 static void fossil_dyn_set_error(const char *msg)
 {
@@ -72,17 +99,330 @@ static void fossil_dyn_resolve_path(
     }
 }
 
+/* ------------------------------------------------------
+ * Symbol cache
+ *
+ * Open-addressed FNV-1a table of resolved symbols, one per
+ * library, guarded by its own lock. Misses are not cached so
+ * the loader error stays accurate.
+ * ----------------------------------------------------- */
+
 #if defined(_WIN32) || defined(_WIN64)
+typedef SRWLOCK fossil_dyn_lock_t;
+#define fossil_dyn_lock_init(l) InitializeSRWLock(l)
+#define fossil_dyn_lock_destroy(l) ((void)(l))
+#define fossil_dyn_lock(l) AcquireSRWLockExclusive(l)
+#define fossil_dyn_unlock(l) ReleaseSRWLockExclusive(l)
+#else
+typedef pthread_mutex_t fossil_dyn_lock_t;
+#define fossil_dyn_lock_init(l) pthread_mutex_init((l), NULL)
+#define fossil_dyn_lock_destroy(l) pthread_mutex_destroy(l)
+#define fossil_dyn_lock(l) pthread_mutex_lock(l)
+#define fossil_dyn_unlock(l) pthread_mutex_unlock(l)
+#endif
 
-/* ======================================================
- * Microslop implementation
- * ====================================================== */
+typedef struct
+{
+    uint64_t hash;
+    char *name; /* NULL marks an empty slot */
+    void *address;
+} fossil_dyn_symbol_t;
 
-#include <windows.h>
+struct fossil_sys_dynamic_cache
+{
+    fossil_dyn_lock_t lock;
+    fossil_dyn_symbol_t *slots;
+    size_t capacity; /* power of two */
+    size_t count;
+};
+
+static uint64_t fossil_dyn_hash(const char *name)
+{
+    uint64_t h = 1469598103934665603ull;
+    for (; *name; ++name)
+    {
+        h ^= (unsigned char)*name;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static fossil_dyn_symbol_t *fossil_dyn_cache_slot(
+    fossil_sys_dynamic_cache_t *cache,
+    const char *name,
+    uint64_t hash)
+{
+    size_t mask = cache->capacity - 1;
+    for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
+    {
+        fossil_dyn_symbol_t *slot = &cache->slots[i];
+        if (!slot->name || (slot->hash == hash && strcmp(slot->name, name) == 0))
+            return slot;
+    }
+}
+
+static fossil_sys_dynamic_cache_t *fossil_dyn_cache_create(void)
+{
+    fossil_sys_dynamic_cache_t *cache = calloc(1, sizeof(*cache));
+    if (!cache)
+        return NULL;
+    cache->capacity = 32;
+    cache->slots = calloc(cache->capacity, sizeof(*cache->slots));
+    if (!cache->slots)
+    {
+        free(cache);
+        return NULL;
+    }
+    fossil_dyn_lock_init(&cache->lock);
+    return cache;
+}
+
+static void fossil_dyn_cache_free(fossil_sys_dynamic_cache_t *cache)
+{
+    if (!cache)
+        return;
+    for (size_t i = 0; i < cache->capacity; ++i)
+        free(cache->slots[i].name);
+    free(cache->slots);
+    fossil_dyn_lock_destroy(&cache->lock);
+    free(cache);
+}
+
+/* Returns 1 and the address if name is cached. */
+static int fossil_dyn_cache_get(
+    fossil_sys_dynamic_cache_t *cache,
+    const char *name,
+    uint64_t hash,
+    void **address)
+{
+    fossil_dyn_lock(&cache->lock);
+    fossil_dyn_symbol_t *slot = fossil_dyn_cache_slot(cache, name, hash);
+    int found = slot->name != NULL;
+    if (found)
+        *address = slot->address;
+    fossil_dyn_unlock(&cache->lock);
+    return found;
+}
+
+/* Best effort: a failed insert only costs a future lookup. */
+static void fossil_dyn_cache_put(
+    fossil_sys_dynamic_cache_t *cache,
+    const char *name,
+    uint64_t hash,
+    void *address)
+{
+    size_t len = strlen(name) + 1;
+    char *copy = malloc(len);
+    if (!copy)
+        return;
+    memcpy(copy, name, len);
+
+    fossil_dyn_lock(&cache->lock);
+    if ((cache->count + 1) * 4 > cache->capacity * 3)
+    {
+        fossil_dyn_symbol_t *old = cache->slots;
+        size_t old_capacity = cache->capacity;
+        fossil_dyn_symbol_t *slots = calloc(old_capacity * 2, sizeof(*slots));
+        if (!slots)
+        {
+            fossil_dyn_unlock(&cache->lock);
+            free(copy);
+            return;
+        }
+        cache->slots = slots;
+        cache->capacity = old_capacity * 2;
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+            if (old[i].name)
+                *fossil_dyn_cache_slot(cache, old[i].name, old[i].hash) = old[i];
+        }
+        free(old);
+    }
+    fossil_dyn_symbol_t *slot = fossil_dyn_cache_slot(cache, name, hash);
+    if (slot->name)
+    {
+        free(copy); /* another thread cached it first */
+    }
+    else
+    {
+        slot->hash = hash;
+        slot->name = copy;
+        slot->address = address;
+        cache->count++;
+    }
+    fossil_dyn_unlock(&cache->lock);
+}
+
+/* Platform lookup without the cache; returns 0 if not found. */
+static int fossil_dyn_raw_symbol(
+    fossil_sys_dynamic_handle_t handle,
+    const char *name,
+    void **address);
+
+/* ------------------------------------------------------
+ * Library registry
+ *
+ * Process-wide list of libraries opened through this module.
+ * It owns the resolved path strings handed out in descriptors,
+ * shares one handle and symbol cache between repeated loads of
+ * the same library, and closes it when the last reference is
+ * unloaded. The loader itself is never called with the lock
+ * held, since library constructors may load libraries too.
+ * ----------------------------------------------------- */
+
+typedef struct fossil_dyn_record
+{
+    struct fossil_dyn_record *next;
+    char *path; /* resolved path as requested */
+    fossil_sys_dynamic_handle_t handle;
+    unsigned flags; /* FOSSIL_SYS_DYNAMIC_* flags in effect */
+    long ns;        /* link-map namespace */
+    uintptr_t base; /* load address, 0 if unknown */
+    unsigned refs;
+    fossil_sys_dynamic_cache_t *cache;
+} fossil_dyn_record_t;
+
+#if defined(_WIN32) || defined(_WIN64)
+static fossil_dyn_lock_t fossil_dyn_registry_lock = SRWLOCK_INIT;
+#else
+static fossil_dyn_lock_t fossil_dyn_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+static fossil_dyn_record_t *fossil_dyn_registry;
+
+static fossil_sys_dynamic_handle_t fossil_dyn_open(const char *path, unsigned flags, long ns);
+static bool fossil_dyn_close(fossil_sys_dynamic_handle_t handle);
+static uintptr_t fossil_dyn_base(fossil_sys_dynamic_handle_t handle);
+static long fossil_dyn_namespace(fossil_sys_dynamic_handle_t handle);
+
+/* Whether a library loaded with have satisfies a request for want. */
+static bool fossil_dyn_flags_cover(unsigned have, unsigned want)
+{
+    unsigned sticky = FOSSIL_SYS_DYNAMIC_GLOBAL | FOSSIL_SYS_DYNAMIC_NODELETE | FOSSIL_SYS_DYNAMIC_DEEPBIND;
+    if ((want & sticky) & ~have)
+        return false;
+    return !(have & FOSSIL_SYS_DYNAMIC_LAZY) || (want & FOSSIL_SYS_DYNAMIC_LAZY);
+}
+
+/* Takes a reference on the record for path loaded compatibly, or returns NULL. */
+static fossil_dyn_record_t *fossil_dyn_registry_find(const char *path, unsigned flags, long ns)
+{
+    if (ns == FOSSIL_SYS_DYNAMIC_NAMESPACE_NEW)
+        return NULL;
+    fossil_dyn_lock(&fossil_dyn_registry_lock);
+    fossil_dyn_record_t *record = fossil_dyn_registry;
+    while (record && (record->ns != ns || !fossil_dyn_flags_cover(record->flags, flags) ||
+                      strcmp(record->path, path) != 0))
+        record = record->next;
+    if (record)
+        record->refs++;
+    fossil_dyn_unlock(&fossil_dyn_registry_lock);
+    return record;
+}
+
+/*
+ * Registers a freshly opened handle. If another load won the race, or the
+ * path names a library already registered under another spelling, the
+ * existing record gains the reference and the extra handle is closed.
+ */
+static fossil_dyn_record_t *fossil_dyn_registry_add(
+    const char *path,
+    fossil_sys_dynamic_handle_t handle,
+    unsigned flags)
+{
+    fossil_dyn_record_t *fresh = calloc(1, sizeof(*fresh));
+    size_t len = strlen(path) + 1;
+    if (fresh && (fresh->path = malloc(len)) != NULL)
+    {
+        memcpy(fresh->path, path, len);
+        fresh->cache = fossil_dyn_cache_create(); /* NULL just disables caching */
+        fresh->handle = handle;
+        fresh->flags = flags;
+        fresh->ns = fossil_dyn_namespace(handle);
+        fresh->base = fossil_dyn_base(handle);
+        fresh->refs = 1;
+    }
+
+    fossil_dyn_record_t *inserted = NULL;
+    fossil_dyn_lock(&fossil_dyn_registry_lock);
+    fossil_dyn_record_t *record = fossil_dyn_registry;
+    while (record && record->handle != handle &&
+           (strcmp(record->path, path) != 0 || !fresh || record->ns != fresh->ns ||
+            !fossil_dyn_flags_cover(record->flags, flags)))
+        record = record->next;
+    if (record)
+    {
+        record->refs++;
+        if (record->handle == handle)
+        {
+            /* Reopening promotes GLOBAL/NODELETE and binds a lazy library now */
+            record->flags |= flags & ~FOSSIL_SYS_DYNAMIC_LAZY;
+            if (!(flags & FOSSIL_SYS_DYNAMIC_LAZY))
+                record->flags &= ~FOSSIL_SYS_DYNAMIC_LAZY;
+        }
+    }
+    else if (fresh && fresh->path)
+    {
+        fresh->next = fossil_dyn_registry;
+        fossil_dyn_registry = fresh;
+        record = inserted = fresh;
+        fresh = NULL;
+    }
+    fossil_dyn_unlock(&fossil_dyn_registry_lock);
+
+    if (fresh)
+    {
+        fossil_dyn_cache_free(fresh->cache);
+        free(fresh->path);
+        free(fresh);
+    }
+    if (!record)
+        fossil_dyn_set_error("out of memory");
+    /*
+     * Any record but the one just inserted already holds a loader reference,
+     * even when dlopen handed back the same handle (a promoting or racing
+     * load), so ours must be dropped or the library is never unmapped.
+     */
+    if (!record || record != inserted)
+        fossil_dyn_close(handle);
+    return record;
+}
+
+/*
+ * Drops a reference on the record owning handle. Returns 1 and unlinks the
+ * record when it was the last one, 0 if still referenced, -1 if the handle
+ * was not opened through the registry.
+ */
+static int fossil_dyn_registry_release(fossil_sys_dynamic_handle_t handle, fossil_dyn_record_t **out)
+{
+    int rc = -1;
+    fossil_dyn_lock(&fossil_dyn_registry_lock);
+    for (fossil_dyn_record_t **link = &fossil_dyn_registry; *link; link = &(*link)->next)
+    {
+        fossil_dyn_record_t *record = *link;
+        if (record->handle != handle)
+            continue;
+        rc = --record->refs == 0;
+        if (rc)
+            *link = record->next;
+        *out = record;
+        break;
+    }
+    fossil_dyn_unlock(&fossil_dyn_registry_lock);
+    return rc;
+}
 
 bool fossil_sys_dynamic_load(
     const char *path,
     fossil_sys_dynamic_lib_t *out_lib)
+{
+    return fossil_sys_dynamic_load_ex(path, FOSSIL_SYS_DYNAMIC_NOW, FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT, out_lib);
+}
+
+bool fossil_sys_dynamic_load_ex(
+    const char *path,
+    unsigned flags,
+    long ns,
+    fossil_sys_dynamic_lib_t *out_lib)
 {
     if (!path || !out_lib)
         return false;
@@ -90,62 +430,266 @@ bool fossil_sys_dynamic_load(
     char resolved[512];
     fossil_dyn_resolve_path(path, resolved, sizeof(resolved));
 
-    HMODULE h = LoadLibraryA(resolved);
-    if (!h)
+    fossil_dyn_record_t *record = fossil_dyn_registry_find(resolved, flags, ns);
+    if (!record)
     {
-        FormatMessageA(
-            FORMAT_MESSAGE_FROM_SYSTEM |
-                FORMAT_MESSAGE_IGNORE_INSERTS,
-            NULL,
-            GetLastError(),
-            0,
-            fossil_dyn_error_buf,
-            sizeof(fossil_dyn_error_buf),
-            NULL);
-        return false;
+        fossil_sys_dynamic_handle_t h = fossil_dyn_open(resolved, flags, ns);
+        if (!h)
+            return false;
+        record = fossil_dyn_registry_add(resolved, h, flags);
+        if (!record)
+            return false;
     }
 
-    out_lib->id = resolved;
-    out_lib->path = resolved;
-    out_lib->handle = h;
+    /* The registry owns the path for as long as the library is loaded */
+    out_lib->id = record->path;
+    out_lib->path = record->path;
+    out_lib->handle = record->handle;
     out_lib->status = 1;
+    out_lib->cache = record->cache;
     return true;
 }
 
+long fossil_sys_dynamic_namespace(
+    const fossil_sys_dynamic_lib_t *lib)
+{
+    if (!lib || !lib->handle)
+        return -1;
+    return fossil_dyn_namespace(lib->handle);
+}
+
 bool fossil_sys_dynamic_unload(fossil_sys_dynamic_lib_t *lib)
 {
     if (!lib || !lib->handle)
         return false;
 
-    if (!FreeLibrary(lib->handle))
+    fossil_dyn_record_t *record = NULL;
+    int last = fossil_dyn_registry_release(lib->handle, &record);
+    if (last != 0 && !fossil_dyn_close(lib->handle))
     {
-        fossil_dyn_set_error("FreeLibrary failed");
+        if (record)
+        {
+            /* keep the record so the descriptor stays usable */
+            fossil_dyn_lock(&fossil_dyn_registry_lock);
+            record->refs++;
+            record->next = fossil_dyn_registry;
+            fossil_dyn_registry = record;
+            fossil_dyn_unlock(&fossil_dyn_registry_lock);
+        }
         return false;
     }
+    if (last == 1)
+    {
+        fossil_dyn_cache_free(record->cache);
+        free(record->path);
+        free(record);
+    }
 
+    lib->id = NULL;
+    lib->path = NULL;
     lib->handle = NULL;
     lib->status = 0;
+    lib->cache = NULL;
     return true;
 }
 
-void *fossil_sys_dynamic_symbol(
-    fossil_sys_dynamic_lib_t *lib,
-    const char *symbol_name)
+size_t fossil_sys_dynamic_registry_count(void)
 {
-    if (!lib || !lib->handle || !symbol_name)
-        return NULL;
+    size_t count = 0;
+    fossil_dyn_lock(&fossil_dyn_registry_lock);
+    for (fossil_dyn_record_t *record = fossil_dyn_registry; record; record = record->next)
+        count++;
+    fossil_dyn_unlock(&fossil_dyn_registry_lock);
+    return count;
+}
 
-    FARPROC proc = GetProcAddress(lib->handle, symbol_name);
-    if (!proc)
+/* ------------------------------------------------------
+ * Parallel preload
+ *
+ * Workers pull paths from a shared index. Each one first asks
+ * the kernel to read the file ahead, so page-cache misses
+ * overlap even where the loader serializes the mapping and
+ * relocation work under its own lock.
+ * ----------------------------------------------------- */
+
+typedef struct
+{
+    const char *const *paths;
+    size_t count;
+    unsigned flags;
+    fossil_sys_dynamic_lib_t *libs;
+    fossil_dyn_atomic_t next;
+    fossil_dyn_atomic_t loaded;
+} fossil_dyn_preload_t;
+
+static void fossil_dyn_prefetch(const char *path)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    char resolved[512];
+    fossil_dyn_resolve_path(path, resolved, sizeof(resolved));
+    int fd = open(resolved, O_RDONLY);
+    if (fd < 0)
+        return; /* bare sonames are found by the loader's search path */
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    (void)path;
+#endif
+}
+
+static void fossil_dyn_preload_run(fossil_dyn_preload_t *job)
+{
+    for (;;)
     {
-        fossil_dyn_set_error("symbol not found");
-        return NULL;
+        size_t i = (size_t)(fossil_dyn_atomic_inc(&job->next) - 1);
+        if (i >= job->count)
+            return;
+        memset(&job->libs[i], 0, sizeof(job->libs[i]));
+        if (!job->paths[i])
+            continue;
+        fossil_dyn_prefetch(job->paths[i]);
+        if (fossil_sys_dynamic_load_ex(job->paths[i], job->flags, FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT,
+                                       &job->libs[i]))
+            fossil_dyn_atomic_inc(&job->loaded);
     }
+}
 
-    /* legal conversion via memcpy avoids pedantic UB */
-    void *out = NULL;
-    memcpy(&out, &proc, sizeof(out));
-    return out;
+#if defined(_WIN32) || defined(_WIN64)
+static DWORD WINAPI fossil_dyn_preload_thread(LPVOID arg)
+{
+    fossil_dyn_preload_run(arg);
+    return 0;
+}
+#else
+static void *fossil_dyn_preload_thread(void *arg)
+{
+    fossil_dyn_preload_run(arg);
+    return NULL;
+}
+#endif
+
+size_t fossil_sys_dynamic_preload(
+    const char *const *paths,
+    size_t count,
+    unsigned flags,
+    size_t threads,
+    fossil_sys_dynamic_lib_t *out_libs)
+{
+    if (!paths || !out_libs || count == 0)
+        return 0;
+
+    if (threads == 0)
+    {
+        int cpus = fossil_sys_hostinfo_effective_cpus();
+        threads = cpus > 0 ? (size_t)cpus : 1;
+    }
+    if (threads > count)
+        threads = count;
+    if (threads > 16)
+        threads = 16;
+
+    fossil_dyn_preload_t job = {0};
+    job.paths = paths;
+    job.count = count;
+    job.flags = flags;
+    job.libs = out_libs;
+
+    /* The calling thread is one of the workers */
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE workers[16];
+    size_t started = 0;
+    while (started + 1 < threads)
+    {
+        workers[started] = CreateThread(NULL, 0, fossil_dyn_preload_thread, &job, 0, NULL);
+        if (!workers[started])
+            break;
+        started++;
+    }
+    fossil_dyn_preload_run(&job);
+    for (size_t i = 0; i < started; ++i)
+    {
+        WaitForSingleObject(workers[i], INFINITE);
+        CloseHandle(workers[i]);
+    }
+#else
+    pthread_t workers[16];
+    size_t started = 0;
+    while (started + 1 < threads && pthread_create(&workers[started], NULL, fossil_dyn_preload_thread, &job) == 0)
+        started++;
+    fossil_dyn_preload_run(&job);
+    for (size_t i = 0; i < started; ++i)
+        pthread_join(workers[i], NULL);
+#endif
+    return (size_t)job.loaded;
+}
+
+/* Registry references per load address, copied so callbacks run unlocked */
+typedef struct
+{
+    uintptr_t *bases;
+    unsigned *refs;
+    size_t count;
+    fossil_sys_dynamic_module_cb cb;
+    void *user_data;
+    int visited;
+    int stop;
+} fossil_dyn_enum_t;
+
+static int fossil_dyn_enum_snapshot(fossil_dyn_enum_t *e)
+{
+    fossil_dyn_lock(&fossil_dyn_registry_lock);
+    size_t count = 0;
+    for (fossil_dyn_record_t *record = fossil_dyn_registry; record; record = record->next)
+        count++;
+    e->bases = malloc((count ? count : 1) * sizeof(*e->bases));
+    e->refs = malloc((count ? count : 1) * sizeof(*e->refs));
+    if (e->bases && e->refs)
+    {
+        for (fossil_dyn_record_t *record = fossil_dyn_registry; record; record = record->next)
+        {
+            e->bases[e->count] = record->base;
+            e->refs[e->count++] = record->refs;
+        }
+    }
+    fossil_dyn_unlock(&fossil_dyn_registry_lock);
+    return e->bases && e->refs ? 0 : -1;
+}
+
+/* Reports one module; returns non-zero to stop. */
+static int fossil_dyn_enum_visit(fossil_dyn_enum_t *e, const char *path, uintptr_t base)
+{
+    fossil_sys_dynamic_module_t module;
+    module.path = path ? path : "";
+    module.base = base;
+    module.refs = 0;
+    for (size_t i = 0; i < e->count; ++i)
+    {
+        if (e->bases[i] && e->bases[i] == base)
+            module.refs += e->refs[i];
+    }
+    e->visited++;
+    e->stop = e->cb(&module, e->user_data);
+    return e->stop;
+}
+
+static int fossil_dyn_enum_platform(fossil_dyn_enum_t *e);
+
+int fossil_sys_dynamic_enumerate(
+    fossil_sys_dynamic_module_cb cb,
+    void *user_data)
+{
+    if (!cb)
+        return -1;
+
+    fossil_dyn_enum_t e = {0};
+    e.cb = cb;
+    e.user_data = user_data;
+    int rc = fossil_dyn_enum_snapshot(&e);
+    if (rc == 0)
+        rc = fossil_dyn_enum_platform(&e);
+    free(e.bases);
+    free(e.refs);
+    return rc < 0 ? rc : e.visited;
 }
 
 bool fossil_sys_dynamic_is_loaded(
@@ -159,6 +703,99 @@ const char *fossil_sys_dynamic_error(void)
     return fossil_dyn_error_buf;
 }
 
+#if defined(_WIN32) || defined(_WIN64)
+
+/* ======================================================
+ * Microslop implementation
+ * ====================================================== */
+
+#include <tlhelp32.h>
+
+static fossil_sys_dynamic_handle_t fossil_dyn_open(const char *path, unsigned flags, long ns)
+{
+    /* The Windows loader binds imports at load; LAZY and GLOBAL have no equivalent */
+    if ((flags & FOSSIL_SYS_DYNAMIC_DEEPBIND) || (ns != FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT))
+    {
+        fossil_dyn_set_error("load option not supported on this platform");
+        return NULL;
+    }
+
+    HMODULE h = LoadLibraryA(path);
+    if (h && (flags & FOSSIL_SYS_DYNAMIC_NODELETE))
+    {
+        HMODULE pinned;
+        GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_PIN | GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS,
+                           (LPCSTR)h, &pinned);
+    }
+    if (!h)
+    {
+        FormatMessageA(
+            FORMAT_MESSAGE_FROM_SYSTEM |
+                FORMAT_MESSAGE_IGNORE_INSERTS,
+            NULL,
+            GetLastError(),
+            0,
+            fossil_dyn_error_buf,
+            sizeof(fossil_dyn_error_buf),
+            NULL);
+    }
+    return h;
+}
+
+static bool fossil_dyn_close(fossil_sys_dynamic_handle_t handle)
+{
+    if (!FreeLibrary(handle))
+    {
+        fossil_dyn_set_error("FreeLibrary failed");
+        return false;
+    }
+    return true;
+}
+
+static uintptr_t fossil_dyn_base(fossil_sys_dynamic_handle_t handle)
+{
+    return (uintptr_t)handle; /* an HMODULE is its load address */
+}
+
+static long fossil_dyn_namespace(fossil_sys_dynamic_handle_t handle)
+{
+    (void)handle;
+    return FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT;
+}
+
+static int fossil_dyn_raw_symbol(
+    fossil_sys_dynamic_handle_t handle,
+    const char *name,
+    void **address)
+{
+    FARPROC proc = GetProcAddress(handle, name);
+    if (!proc)
+    {
+        fossil_dyn_set_error("symbol not found");
+        return 0;
+    }
+
+    /* legal conversion via memcpy avoids pedantic UB */
+    memcpy(address, &proc, sizeof(*address));
+    return 1;
+}
+
+static int fossil_dyn_enum_platform(fossil_dyn_enum_t *e)
+{
+    HANDLE snap = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE, GetCurrentProcessId());
+    if (snap == INVALID_HANDLE_VALUE)
+        return -3;
+    MODULEENTRY32 me;
+    me.dwSize = sizeof(me);
+    for (BOOL ok = Module32First(snap, &me); ok; ok = Module32Next(snap, &me))
+    {
+        if (fossil_dyn_enum_visit(e, me.szExePath, (uintptr_t)me.modBaseAddr))
+            break;
+    }
+    CloseHandle(snap);
+    return 0;
+}
+
 #else
 
 /* ======================================================
@@ -166,79 +803,195 @@ const char *fossil_sys_dynamic_error(void)
  * ====================================================== */
 
 #include <dlfcn.h>
+#if defined(__APPLE__)
+#include <mach-o/dyld.h>
+#elif defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <link.h>
+#define FOSSIL_DYN_HAVE_PHDR 1
+#endif
+#if defined(__GLIBC__) && defined(LM_ID_NEWLM)
+#define FOSSIL_DYN_HAVE_DLMOPEN 1
+#endif
 
-bool fossil_sys_dynamic_load(
-    const char *path,
-    fossil_sys_dynamic_lib_t *out_lib)
+static fossil_sys_dynamic_handle_t fossil_dyn_open(const char *path, unsigned flags, long ns)
 {
-    if (!path || !out_lib)
-        return false;
-
-    char resolved[512];
-    fossil_dyn_resolve_path(path, resolved, sizeof(resolved));
+    int mode = (flags & FOSSIL_SYS_DYNAMIC_LAZY) ? RTLD_LAZY : RTLD_NOW;
+    mode |= (flags & FOSSIL_SYS_DYNAMIC_GLOBAL) ? RTLD_GLOBAL : RTLD_LOCAL;
+#if defined(RTLD_NODELETE)
+    if (flags & FOSSIL_SYS_DYNAMIC_NODELETE)
+        mode |= RTLD_NODELETE;
+#else
+    if (flags & FOSSIL_SYS_DYNAMIC_NODELETE)
+    {
+        fossil_dyn_set_error("RTLD_NODELETE not supported on this platform");
+        return NULL;
+    }
+#endif
+#if defined(RTLD_DEEPBIND)
+    if (flags & FOSSIL_SYS_DYNAMIC_DEEPBIND)
+        mode |= RTLD_DEEPBIND;
+#else
+    if (flags & FOSSIL_SYS_DYNAMIC_DEEPBIND)
+    {
+        fossil_dyn_set_error("RTLD_DEEPBIND not supported on this platform");
+        return NULL;
+    }
+#endif
 
     dlerror();
 
-    void *h = dlopen(resolved, RTLD_NOW | RTLD_LOCAL);
-    if (!h)
+    void *h;
+    if (ns == FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT)
+        h = dlopen(path, mode);
+    else
     {
-        fossil_dyn_set_error(dlerror());
-        return false;
+#if defined(FOSSIL_DYN_HAVE_DLMOPEN)
+        h = dlmopen(ns == FOSSIL_SYS_DYNAMIC_NAMESPACE_NEW ? LM_ID_NEWLM : (Lmid_t)ns, path, mode);
+#else
+        fossil_dyn_set_error("dlmopen namespaces not supported on this platform");
+        return NULL;
+#endif
     }
-
-    out_lib->id = resolved;
-    out_lib->path = resolved;
-    out_lib->handle = h;
-    out_lib->status = 1;
-    return true;
+    if (!h)
+        fossil_dyn_set_error(dlerror());
+    return h;
 }
 
-bool fossil_sys_dynamic_unload(fossil_sys_dynamic_lib_t *lib)
+static long fossil_dyn_namespace(fossil_sys_dynamic_handle_t handle)
 {
-    if (!lib || !lib->handle)
-        return false;
+#if defined(FOSSIL_DYN_HAVE_DLMOPEN)
+    Lmid_t lmid = LM_ID_BASE;
+    if (dlinfo(handle, RTLD_DI_LMID, &lmid) == 0)
+        return (long)lmid;
+#else
+    (void)handle;
+#endif
+    return FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT;
+}
 
-    if (dlclose(lib->handle) != 0)
+static bool fossil_dyn_close(fossil_sys_dynamic_handle_t handle)
+{
+    if (dlclose(handle) != 0)
     {
         fossil_dyn_set_error(dlerror());
         return false;
     }
-
-    lib->handle = NULL;
-    lib->status = 0;
     return true;
 }
 
-void *fossil_sys_dynamic_symbol(
-    fossil_sys_dynamic_lib_t *lib,
-    const char *symbol_name)
+static uintptr_t fossil_dyn_base(fossil_sys_dynamic_handle_t handle)
 {
-    if (!lib || !lib->handle || !symbol_name)
-        return NULL;
+#if defined(__GLIBC__)
+    struct link_map *map = NULL;
+    if (dlinfo(handle, RTLD_DI_LINKMAP, &map) == 0 && map)
+        return (uintptr_t)map->l_addr;
+#else
+    (void)handle;
+#endif
+    return 0;
+}
 
+static int fossil_dyn_raw_symbol(
+    fossil_sys_dynamic_handle_t handle,
+    const char *name,
+    void **address)
+{
     dlerror();
 
-    void *sym = dlsym(lib->handle, symbol_name);
+    void *sym = dlsym(handle, name);
 
     const char *err = dlerror();
     if (err)
     {
         fossil_dyn_set_error(err);
-        return NULL;
+        return 0;
     }
 
-    return sym;
+    *address = sym;
+    return 1;
 }
 
-bool fossil_sys_dynamic_is_loaded(
-    const fossil_sys_dynamic_lib_t *lib)
+#if defined(FOSSIL_DYN_HAVE_PHDR)
+static int fossil_dyn_phdr_cb(struct dl_phdr_info *info, size_t size, void *data)
 {
-    return lib && lib->handle != NULL && lib->status == 1;
+    (void)size;
+    return fossil_dyn_enum_visit(data, info->dlpi_name, (uintptr_t)info->dlpi_addr);
 }
+#endif
 
-const char *fossil_sys_dynamic_error(void)
+static int fossil_dyn_enum_platform(fossil_dyn_enum_t *e)
 {
-    return fossil_dyn_error_buf;
+#if defined(FOSSIL_DYN_HAVE_PHDR)
+    dl_iterate_phdr(fossil_dyn_phdr_cb, e);
+    return 0;
+#elif defined(__APPLE__)
+    uint32_t count = _dyld_image_count();
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (fossil_dyn_enum_visit(e, _dyld_get_image_name(i), (uintptr_t)_dyld_get_image_header(i)))
+            break;
+    }
+    return 0;
+#else
+    (void)e;
+    return -2;
+#endif
 }
 
 #endif
+
+/* ======================================================
+ * Cached resolution (all platforms)
+ * ====================================================== */
+
+void *fossil_sys_dynamic_symbol(
+    fossil_sys_dynamic_lib_t *lib,
+    const char *symbol_name)
+{
+    if (!lib || !lib->handle || !symbol_name)
+        return NULL;
+
+    uint64_t hash = fossil_dyn_hash(symbol_name);
+    void *address = NULL;
+    if (lib->cache && fossil_dyn_cache_get(lib->cache, symbol_name, hash, &address))
+        return address;
+
+    if (!fossil_dyn_raw_symbol(lib->handle, symbol_name, &address))
+        return NULL;
+
+    if (lib->cache)
+        fossil_dyn_cache_put(lib->cache, symbol_name, hash, address);
+    return address;
+}
+
+bool fossil_sys_dynamic_bind(
+    fossil_sys_dynamic_lib_t *lib,
+    const fossil_sys_dynamic_binding_t *bindings,
+    size_t count)
+{
+    if (!lib || !lib->handle || (!bindings && count))
+        return false;
+
+    bool all = true;
+    char first_missing[128] = "";
+    for (size_t i = 0; i < count; ++i)
+    {
+        const fossil_sys_dynamic_binding_t *binding = &bindings[i];
+        void *address = binding->name ? fossil_sys_dynamic_symbol(lib, binding->name) : NULL;
+        if (binding->slot)
+            *binding->slot = address;
+        if (!address && all)
+        {
+            all = false;
+            snprintf(first_missing, sizeof(first_missing), "%s", binding->name ? binding->name : "(null)");
+        }
+    }
+
+    if (!all)
+    {
+        char msg[sizeof(fossil_dyn_error_buf)];
+        snprintf(msg, sizeof(msg), "unresolved symbol: %s", first_missing);
+        fossil_dyn_set_error(msg);
+    }
+    return all;
+}
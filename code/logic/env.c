@@ -23,14 +23,21 @@
  * -----------------------------------------------------------------------------
  */
 #include "fossil/sys/env.h"
+#include "fossil/sys/hostinfo.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 
 #if defined(_WIN32)
 #include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
 #endif
 
 /* ============================================================================
@@ -77,273 +84,810 @@ static int fossil_sys_env_parse_bool(const char *v, int default_value)
 }
 
 /* ============================================================================
-    CORE API
+    ENVIRONMENT SNAPSHOT
 ============================================================================ */
 
 /*
- * Canonical String ID Handler
+ * The snapshot is a chain of immutable versions. Readers never lock: they
+ * register in the current epoch, load the published table and leave. A
+ * writer copies the table, applies its change, publishes the copy and
+ * retires the old one; retired tables are freed once every reader that
+ * could still see them has left (two-counter epoch scheme).
  *
- * This function maps canonical Fossil Sys string IDs to their platform-specific
- * environment variable names or retrieves their values using platform APIs.
- * If the key is not recognized, it falls back to the OS environment.
+ * Entries ("key\0value") are shared between versions. The entry a set
+ * replaces or removes is owned by the retired table that last held it and
+ * freed with that table, so memory stays bounded however often keys change.
  */
-static const char *fossil_sys_env_resolve_id(const char *key)
-{
-     if (!key)
-          return NULL;
-
-     /* System properties */
-     if (strcmp(key, "fossil.sys.name") == 0)
-     {
 #if defined(_WIN32)
-          return "windows";
-#elif defined(__APPLE__)
-          return "darwin";
-#elif defined(__linux__)
-          return "linux";
-#elif defined(__unix__)
-          return "unix";
+typedef volatile LONG fossil_sys_env_atomic_t;
+#define fossil_sys_env_atomic_inc(p) InterlockedIncrement(p)
+#define fossil_sys_env_atomic_dec(p) InterlockedDecrement(p)
+#define fossil_sys_env_atomic_dec_release(p) InterlockedDecrement(p)
+#define fossil_sys_env_atomic_load(p) InterlockedCompareExchange((p), 0, 0)
+#define fossil_sys_env_atomic_store(p, v) InterlockedExchange((p), (v))
+#define fossil_sys_env_load_ptr(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define fossil_sys_env_store_ptr(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (v))
+typedef SRWLOCK fossil_sys_env_lock_t;
+#define FOSSIL_SYS_ENV_LOCK_INIT SRWLOCK_INIT
+#define fossil_sys_env_lock(l) AcquireSRWLockExclusive(l)
+#define fossil_sys_env_unlock(l) ReleaseSRWLockExclusive(l)
 #else
-          return "unknown";
+typedef long fossil_sys_env_atomic_t;
+#define fossil_sys_env_atomic_inc(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_env_atomic_dec(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_env_atomic_dec_release(p) __atomic_sub_fetch((p), 1, __ATOMIC_RELEASE)
+#define fossil_sys_env_atomic_load(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define fossil_sys_env_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define fossil_sys_env_load_ptr(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define fossil_sys_env_store_ptr(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+typedef pthread_mutex_t fossil_sys_env_lock_t;
+#define FOSSIL_SYS_ENV_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define fossil_sys_env_lock(l) pthread_mutex_lock(l)
+#define fossil_sys_env_unlock(l) pthread_mutex_unlock(l)
 #endif
-     }
-     if (strcmp(key, "fossil.sys.arch") == 0)
-     {
-#if defined(_WIN64)
-          return "x86_64";
-#elif defined(_WIN32)
-          return "x86";
-#elif defined(__x86_64__) || defined(__amd64__)
-          return "x86_64";
-#elif defined(__aarch64__)
-          return "arm64";
-#elif defined(__arm__)
-          return "arm";
-#elif defined(__i386__)
-          return "x86";
-#else
-          return "unknown";
-#endif
-     }
-     if (strcmp(key, "fossil.sys.page_size") == 0)
+
+#define FOSSIL_SYS_ENV_CACHE_LINE 64
+
+typedef struct fossil_sys_env_entry
+{
+     uint64_t hash;
+     size_t key_len;
+     char data[]; /* key '\0' value '\0' */
+} fossil_sys_env_entry_t;
+
+typedef struct fossil_sys_env_table
+{
+     struct fossil_sys_env_table *retired_next;
+     unsigned long retired_epoch;
+     fossil_sys_env_entry_t *dropped; /* entry the next version no longer holds */
+     int drop_all;                    /* no later version shares the entries */
+     uint64_t version;
+     size_t count;
+     size_t capacity; /* power of two */
+     const fossil_sys_env_entry_t *slots[];
+} fossil_sys_env_table_t;
+
+/* Readers of the two epoch parities bump different cache lines */
+typedef struct
+{
+     fossil_sys_env_atomic_t count;
+     char pad[FOSSIL_SYS_ENV_CACHE_LINE - sizeof(fossil_sys_env_atomic_t)];
+} fossil_sys_env_counter_t;
+
+static struct
+{
+     fossil_sys_env_table_t *current; /* published version, NULL when disabled */
+     fossil_sys_env_atomic_t epoch;
+     char pad0[FOSSIL_SYS_ENV_CACHE_LINE];
+     fossil_sys_env_counter_t active[2]; /* readers per epoch parity */
+
+     /* Writer side, guarded by lock */
+     fossil_sys_env_lock_t lock;
+     int mirror;
+     uint64_t version;
+     fossil_sys_env_table_t *retired;
+} fossil_sys_env_snapshot = {
+     .lock = FOSSIL_SYS_ENV_LOCK_INIT,
+};
+
+static uint64_t fossil_sys_env_hash(const char *key, size_t len)
+{
+     uint64_t h = 1469598103934665603ull; /* FNV-1a */
+     for (size_t i = 0; i < len; ++i)
      {
-          static char buf[32];
-#if defined(_WIN32)
-          SYSTEM_INFO si;
-          GetSystemInfo(&si);
-          snprintf(buf, sizeof(buf), "%lu", (unsigned long)si.dwPageSize);
-#elif defined(_SC_PAGESIZE)
-          snprintf(buf, sizeof(buf), "%ld", sysconf(_SC_PAGESIZE));
-#else
-          snprintf(buf, sizeof(buf), "4096");
-#endif
-          return buf;
+          h ^= (unsigned char)key[i];
+          h *= 1099511628211ull;
      }
-     if (strcmp(key, "fossil.sys.cpu_count") == 0)
+     return h;
+}
+
+/* Returns the epoch token to pass to fossil_sys_env_read_end. */
+static unsigned long fossil_sys_env_read_begin(void)
+{
+     for (;;)
      {
-          static char buf[32];
-#if defined(_WIN32)
-          SYSTEM_INFO si;
-          GetSystemInfo(&si);
-          snprintf(buf, sizeof(buf), "%lu", (unsigned long)si.dwNumberOfProcessors);
-#elif defined(_SC_NPROCESSORS_ONLN)
-          snprintf(buf, sizeof(buf), "%ld", sysconf(_SC_NPROCESSORS_ONLN));
-#else
-          snprintf(buf, sizeof(buf), "1");
-#endif
-          return buf;
+          unsigned long e = (unsigned long)fossil_sys_env_atomic_load(&fossil_sys_env_snapshot.epoch);
+          fossil_sys_env_atomic_inc(&fossil_sys_env_snapshot.active[e & 1].count);
+          if ((unsigned long)fossil_sys_env_atomic_load(&fossil_sys_env_snapshot.epoch) == e)
+               return e;
+          fossil_sys_env_atomic_dec(&fossil_sys_env_snapshot.active[e & 1].count);
      }
-     if (strcmp(key, "fossil.sys.path") == 0)
+}
+
+/* Leaving only has to publish the reader's loads before the count drops */
+static void fossil_sys_env_read_end(unsigned long token)
+{
+     fossil_sys_env_atomic_dec_release(&fossil_sys_env_snapshot.active[token & 1].count);
+}
+
+static int fossil_sys_env_entry_is(const fossil_sys_env_entry_t *entry, const char *key, size_t len, uint64_t hash)
+{
+     return entry->hash == hash && entry->key_len == len && memcmp(entry->data, key, len) == 0;
+}
+
+/* Index of the slot holding key, or of the empty slot where it would go. */
+static size_t fossil_sys_env_table_find(const fossil_sys_env_table_t *table, const char *key, size_t len,
+                                        uint64_t hash)
+{
+     size_t mask = table->capacity - 1;
+     for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask)
      {
-#if defined(_WIN32)
-          return fossil_sys_env_get("PATH");
-#else
-          return fossil_sys_env_get("PATH");
-#endif
+          const fossil_sys_env_entry_t *entry = table->slots[i];
+          if (!entry || fossil_sys_env_entry_is(entry, key, len, hash))
+               return i;
      }
-     if (strcmp(key, "fossil.sys.home") == 0)
+}
+
+static fossil_sys_env_table_t *fossil_sys_env_table_new(size_t capacity)
+{
+     fossil_sys_env_table_t *table = calloc(1, sizeof(*table) + capacity * sizeof(table->slots[0]));
+     if (table)
+          table->capacity = capacity;
+     return table;
+}
+
+static void fossil_sys_env_table_free(fossil_sys_env_table_t *table)
+{
+     if (table->drop_all)
      {
-#if defined(_WIN32)
-          const char *home = fossil_sys_env_get("USERPROFILE");
-          if (!home)
-               home = fossil_sys_env_get("HOMEPATH");
-          return home;
-#else
-          return fossil_sys_env_get("HOME");
-#endif
+          for (size_t i = 0; i < table->capacity; ++i)
+               free((void *)table->slots[i]);
      }
-     if (strcmp(key, "fossil.sys.tmp") == 0)
+     free(table->dropped);
+     free(table);
+}
+
+/* Inserts entry, replacing an entry with the same key. */
+static void fossil_sys_env_table_put(fossil_sys_env_table_t *table, const fossil_sys_env_entry_t *entry)
+{
+     size_t i = fossil_sys_env_table_find(table, entry->data, entry->key_len, entry->hash);
+     if (!table->slots[i])
+          table->count++;
+     table->slots[i] = entry;
+}
+
+/* Empties slot i, shifting later entries of the probe run back into place. */
+static void fossil_sys_env_table_remove(fossil_sys_env_table_t *table, size_t i)
+{
+     size_t mask = table->capacity - 1;
+     for (size_t j = (i + 1) & mask; table->slots[j]; j = (j + 1) & mask)
      {
-#if defined(_WIN32)
-          const char *tmp = fossil_sys_env_get("TEMP");
-          if (!tmp)
-               tmp = fossil_sys_env_get("TMP");
-          return tmp;
-#else
-          const char *tmp = fossil_sys_env_get("TMPDIR");
-          if (!tmp)
-               tmp = "/tmp";
-          return tmp;
-#endif
+          size_t home = (size_t)table->slots[j]->hash & mask;
+          /* The entry may move to i unless its home lies cyclically in (i, j] */
+          if (((j - home) & mask) >= ((j - i) & mask))
+          {
+               table->slots[i] = table->slots[j];
+               i = j;
+          }
      }
+     table->slots[i] = NULL;
+     table->count--;
+}
 
-     /* Runtime properties */
-     if (strcmp(key, "fossil.runtime.mode") == 0)
+/*
+ * Frees retired tables no reader can still hold and advances the epoch.
+ * Never waits: a table held by a slow reader is freed by a later call.
+ */
+static void fossil_sys_env_reclaim(void)
+{
+     for (int pass = 0; pass < 2; ++pass)
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_MODE");
+          unsigned long e = (unsigned long)fossil_sys_env_atomic_load(&fossil_sys_env_snapshot.epoch);
+          if (fossil_sys_env_atomic_load(&fossil_sys_env_snapshot.active[(e + 1) & 1].count) != 0)
+               return; /* readers from epoch e - 1 are still inside */
+
+          fossil_sys_env_table_t **link = &fossil_sys_env_snapshot.retired;
+          while (*link)
+          {
+               fossil_sys_env_table_t *table = *link;
+               if ((long)(e - 1 - table->retired_epoch) >= 0)
+               {
+                    *link = table->retired_next;
+                    fossil_sys_env_table_free(table);
+               }
+               else
+                    link = &table->retired_next;
+          }
+          fossil_sys_env_atomic_store(&fossil_sys_env_snapshot.epoch, (long)(e + 1));
      }
-     if (strcmp(key, "fossil.runtime.debug") == 0)
+}
+
+/* Publishes next in place of the current version. Caller holds the lock. */
+static void fossil_sys_env_publish(fossil_sys_env_table_t *next)
+{
+     fossil_sys_env_table_t *old = fossil_sys_env_snapshot.current;
+     if (next)
+          next->version = ++fossil_sys_env_snapshot.version;
+     fossil_sys_env_store_ptr(&fossil_sys_env_snapshot.current, next);
+     if (old)
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_DEBUG");
+          old->retired_epoch = (unsigned long)fossil_sys_env_atomic_load(&fossil_sys_env_snapshot.epoch);
+          old->retired_next = fossil_sys_env_snapshot.retired;
+          fossil_sys_env_snapshot.retired = old;
      }
-     if (strcmp(key, "fossil.runtime.log.level") == 0)
+     fossil_sys_env_reclaim();
+}
+
+static fossil_sys_env_entry_t *fossil_sys_env_entry_new(const char *key, size_t len, const char *value)
+{
+     size_t value_len = strlen(value);
+     fossil_sys_env_entry_t *entry = malloc(sizeof(*entry) + len + 1 + value_len + 1);
+     if (!entry)
+          return NULL;
+     entry->hash = fossil_sys_env_hash(key, len);
+     entry->key_len = len;
+     memcpy(entry->data, key, len);
+     entry->data[len] = '\0';
+     memcpy(entry->data + len + 1, value, value_len + 1);
+     return entry;
+}
+
+/* Publishes a copy of the current version with key set, or removed when value is NULL. */
+static int fossil_sys_env_snapshot_put(const char *key, size_t len, const char *value)
+{
+     fossil_sys_env_table_t *cur = fossil_sys_env_snapshot.current;
+     if (!cur)
+          return -1;
+
+     fossil_sys_env_entry_t *entry = NULL;
+     if (value && !(entry = fossil_sys_env_entry_new(key, len, value)))
+          return -1;
+
+     /* Same capacity: copy the slots as they are; growing rehashes */
+     size_t capacity = cur->capacity;
+     if (entry && (cur->count + 1) * 4 > capacity * 3)
+          capacity *= 2;
+     fossil_sys_env_table_t *next = fossil_sys_env_table_new(capacity);
+     if (!next)
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_LOG_LEVEL");
+          free(entry);
+          return -1;
      }
-     if (strcmp(key, "fossil.runtime.log.output") == 0)
+     if (capacity == cur->capacity)
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_LOG_OUTPUT");
+          memcpy(next->slots, cur->slots, capacity * sizeof(next->slots[0]));
+          next->count = cur->count;
      }
-     if (strcmp(key, "fossil.runtime.seed") == 0)
+     else
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_SEED");
+          for (size_t i = 0; i < cur->capacity; ++i)
+          {
+               if (cur->slots[i])
+                    fossil_sys_env_table_put(next, cur->slots[i]);
+          }
      }
-     if (strcmp(key, "fossil.runtime.threads") == 0)
+
+     size_t i = fossil_sys_env_table_find(next, key, len, fossil_sys_env_hash(key, len));
+     /* The replaced entry dies with the last version that holds it */
+     cur->dropped = (fossil_sys_env_entry_t *)next->slots[i];
+     if (entry)
+          fossil_sys_env_table_put(next, entry);
+     else if (next->slots[i])
+          fossil_sys_env_table_remove(next, i);
+     fossil_sys_env_publish(next);
+     return 0;
+}
+
+/* Adds one "KEY=value" entry; Windows per-drive entries ("=C:=C:\") start with '='. */
+static int fossil_sys_env_snapshot_load(fossil_sys_env_table_t *table, const char *entry)
+{
+     const char *eq = strchr(entry[0] == '=' ? entry + 1 : entry, '=');
+     if (!eq)
+          return 0;
+     fossil_sys_env_entry_t *e = fossil_sys_env_entry_new(entry, (size_t)(eq - entry), eq + 1);
+     if (!e)
+          return -1;
+     size_t i = fossil_sys_env_table_find(table, e->data, e->key_len, e->hash);
+     free((void *)table->slots[i]); /* duplicate names: the last one wins */
+     fossil_sys_env_table_put(table, e);
+     return 0;
+}
+
+/*
+ * Retires the current version together with all of its entries. Tables a
+ * reader still holds are freed by a later enable; nothing here waits.
+ */
+void fossil_sys_env_snapshot_disable(void)
+{
+     fossil_sys_env_lock(&fossil_sys_env_snapshot.lock);
+     if (fossil_sys_env_snapshot.current)
+          fossil_sys_env_snapshot.current->drop_all = 1;
+     fossil_sys_env_publish(NULL);
+     fossil_sys_env_unlock(&fossil_sys_env_snapshot.lock);
+}
+
+int fossil_sys_env_snapshot_enable(void)
+{
+     size_t count = 0;
+#if defined(_WIN32)
+     LPCH env = GetEnvironmentStringsA();
+     if (!env)
+          return -1;
+     for (LPCH cur = env; *cur; cur += strlen(cur) + 1)
+          count++;
+#else
+     extern char **environ;
+     for (char **e = environ; *e; ++e)
+          count++;
+#endif
+
+     size_t capacity = 64;
+     while (capacity * 3 < count * 4 + 4)
+          capacity *= 2;
+
+     fossil_sys_env_lock(&fossil_sys_env_snapshot.lock);
+     int rc = -1;
+     fossil_sys_env_table_t *table = fossil_sys_env_table_new(capacity);
+     if (table)
      {
-          return fossil_sys_env_get("FOSSIL_RUNTIME_THREADS");
+          rc = 0;
+          table->drop_all = 1; /* until published */
+#if defined(_WIN32)
+          for (LPCH cur = env; *cur && rc == 0; cur += strlen(cur) + 1)
+               rc = fossil_sys_env_snapshot_load(table, cur);
+#else
+          for (char **e = environ; *e && rc == 0; ++e)
+               rc = fossil_sys_env_snapshot_load(table, *e);
+#endif
+          if (rc == 0)
+          {
+               table->drop_all = 0;
+               if (fossil_sys_env_snapshot.current)
+                    fossil_sys_env_snapshot.current->drop_all = 1; /* rebuilt from scratch */
+               fossil_sys_env_publish(table);
+          }
+          else
+               fossil_sys_env_table_free(table);
      }
+     fossil_sys_env_unlock(&fossil_sys_env_snapshot.lock);
+#if defined(_WIN32)
+     FreeEnvironmentStringsA(env);
+#endif
+     return rc;
+}
+
+int fossil_sys_env_snapshot_enabled(void)
+{
+     return fossil_sys_env_load_ptr(&fossil_sys_env_snapshot.current) != NULL;
+}
+
+uint64_t fossil_sys_env_snapshot_version(void)
+{
+     unsigned long token = fossil_sys_env_read_begin();
+     const fossil_sys_env_table_t *table = fossil_sys_env_load_ptr(&fossil_sys_env_snapshot.current);
+     uint64_t version = table ? table->version : 0;
+     fossil_sys_env_read_end(token);
+     return version;
+}
 
-     /* Application properties */
-     if (strcmp(key, "fossil.app.name") == 0)
+void fossil_sys_env_snapshot_mirror(int enable)
+{
+     fossil_sys_env_lock(&fossil_sys_env_snapshot.lock);
+     fossil_sys_env_snapshot.mirror = enable != 0;
+     fossil_sys_env_unlock(&fossil_sys_env_snapshot.lock);
+}
+
+/* Plain OS variable lookup, served from the snapshot when enabled. */
+static const char *fossil_sys_env_raw(const char *key)
+{
+     unsigned long token = fossil_sys_env_read_begin();
+     const fossil_sys_env_table_t *table = fossil_sys_env_load_ptr(&fossil_sys_env_snapshot.current);
+     if (!table)
      {
-          return fossil_sys_env_get("FOSSIL_APP_NAME");
+          fossil_sys_env_read_end(token);
+          return getenv(key);
      }
-     if (strcmp(key, "fossil.app.version") == 0)
+     size_t len = strlen(key);
+     const fossil_sys_env_entry_t *entry = table->slots[fossil_sys_env_table_find(table, key, len, fossil_sys_env_hash(key, len))];
+     fossil_sys_env_read_end(token);
+     return entry ? entry->data + len + 1 : NULL;
+}
+
+/* Copies value into buf (truncating, NUL-terminated); returns its full length. */
+static int fossil_sys_env_copy_out(const char *value, char *buf, size_t size)
+{
+     size_t len = strlen(value);
+     if (size)
      {
-          return fossil_sys_env_get("FOSSIL_APP_VERSION");
+          size_t n = len < size - 1 ? len : size - 1;
+          memcpy(buf, value, n);
+          buf[n] = '\0';
      }
-     if (strcmp(key, "fossil.app.instance") == 0)
+     return len > INT_MAX ? INT_MAX : (int)len;
+}
+
+/* Like fossil_sys_env_raw, but copies the value while the reader is registered. */
+static int fossil_sys_env_raw_copy(const char *key, char *buf, size_t size)
+{
+     unsigned long token = fossil_sys_env_read_begin();
+     const fossil_sys_env_table_t *table = fossil_sys_env_load_ptr(&fossil_sys_env_snapshot.current);
+     const char *value;
+     if (table)
      {
-          return fossil_sys_env_get("FOSSIL_APP_INSTANCE");
+          size_t len = strlen(key);
+          const fossil_sys_env_entry_t *entry =
+              table->slots[fossil_sys_env_table_find(table, key, len, fossil_sys_env_hash(key, len))];
+          value = entry ? entry->data + len + 1 : NULL;
      }
+     else
+          value = getenv(key);
+     int rc = value ? fossil_sys_env_copy_out(value, buf, size) : -1;
+     fossil_sys_env_read_end(token);
+     return rc;
+}
 
-     /* User properties */
-     if (strcmp(key, "fossil.user.name") == 0)
-     {
+/* ============================================================================
+    CORE API
+============================================================================ */
+
+/*
+ * Canonical String IDs
+ *
+ * Each canonical ID either maps to a platform environment variable (var,
+ * then alt, then a constant fallback) or is computed from platform APIs.
+ * Keep the table in enum order; fossil_sys_env_canonical_id must list
+ * every key under its length.
+ */
+typedef enum
+{
+     FOSSIL_SYS_ENV_SYS_NAME,
+     FOSSIL_SYS_ENV_SYS_ARCH,
+     FOSSIL_SYS_ENV_SYS_PAGE_SIZE,
+     FOSSIL_SYS_ENV_SYS_CPU_COUNT,
+     FOSSIL_SYS_ENV_SYS_CPU_EFFECTIVE,
+     FOSSIL_SYS_ENV_SYS_MEMORY_EFFECTIVE,
+     FOSSIL_SYS_ENV_SYS_PATH,
+     FOSSIL_SYS_ENV_SYS_HOME,
+     FOSSIL_SYS_ENV_SYS_TMP,
+     FOSSIL_SYS_ENV_RUNTIME_MODE,
+     FOSSIL_SYS_ENV_RUNTIME_DEBUG,
+     FOSSIL_SYS_ENV_RUNTIME_LOG_LEVEL,
+     FOSSIL_SYS_ENV_RUNTIME_LOG_OUTPUT,
+     FOSSIL_SYS_ENV_RUNTIME_SEED,
+     FOSSIL_SYS_ENV_RUNTIME_THREADS,
+     FOSSIL_SYS_ENV_APP_NAME,
+     FOSSIL_SYS_ENV_APP_VERSION,
+     FOSSIL_SYS_ENV_APP_INSTANCE,
+     FOSSIL_SYS_ENV_USER_NAME,
+     FOSSIL_SYS_ENV_USER_ID,
+     FOSSIL_SYS_ENV_TEMP_DIR,
+     FOSSIL_SYS_ENV_TEMP_CACHE,
+     FOSSIL_SYS_ENV_ID_COUNT
+} fossil_sys_env_id_t;
+
+static const struct
+{
+     const char *key;
+     const char *var;      /* mapped OS variable, NULL if computed */
+     const char *alt;      /* second OS variable to try */
+     const char *fallback; /* constant used when neither is set */
+} fossil_sys_env_ids[FOSSIL_SYS_ENV_ID_COUNT] = {
+     {"fossil.sys.name", NULL, NULL, NULL},
+     {"fossil.sys.arch", NULL, NULL, NULL},
+     {"fossil.sys.page_size", NULL, NULL, NULL},
+     {"fossil.sys.cpu_count", NULL, NULL, NULL},
+     {"fossil.sys.cpu_effective", NULL, NULL, NULL},
+     {"fossil.sys.memory_effective", NULL, NULL, NULL},
+     {"fossil.sys.path", "PATH", NULL, NULL},
 #if defined(_WIN32)
-          return fossil_sys_env_get("USERNAME");
+     {"fossil.sys.home", "USERPROFILE", "HOMEPATH", NULL},
+     {"fossil.sys.tmp", "TEMP", "TMP", NULL},
 #else
-          return fossil_sys_env_get("USER");
+     {"fossil.sys.home", "HOME", NULL, NULL},
+     {"fossil.sys.tmp", "TMPDIR", NULL, "/tmp"},
 #endif
-     }
-     if (strcmp(key, "fossil.user.id") == 0)
-     {
+     {"fossil.runtime.mode", "FOSSIL_RUNTIME_MODE", NULL, NULL},
+     {"fossil.runtime.debug", "FOSSIL_RUNTIME_DEBUG", NULL, NULL},
+     {"fossil.runtime.log.level", "FOSSIL_RUNTIME_LOG_LEVEL", NULL, NULL},
+     {"fossil.runtime.log.output", "FOSSIL_RUNTIME_LOG_OUTPUT", NULL, NULL},
+     {"fossil.runtime.seed", "FOSSIL_RUNTIME_SEED", NULL, NULL},
+     {"fossil.runtime.threads", "FOSSIL_RUNTIME_THREADS", NULL, NULL},
+     {"fossil.app.name", "FOSSIL_APP_NAME", NULL, NULL},
+     {"fossil.app.version", "FOSSIL_APP_VERSION", NULL, NULL},
+     {"fossil.app.instance", "FOSSIL_APP_INSTANCE", NULL, NULL},
 #if defined(_WIN32)
-          return fossil_sys_env_get("USERDOMAIN");
+     {"fossil.user.name", "USERNAME", NULL, NULL},
+     {"fossil.user.id", "USERDOMAIN", NULL, NULL},
+     {"fossil.temp.dir", "TEMP", "TMP", NULL},
 #else
-          return fossil_sys_env_get("UID");
+     {"fossil.user.name", "USER", NULL, NULL},
+     {"fossil.user.id", "UID", NULL, NULL},
+     {"fossil.temp.dir", "TMPDIR", NULL, "/tmp"},
 #endif
-     }
+     {"fossil.temp.cache", "FOSSIL_TEMP_CACHE", NULL, NULL},
+};
 
-     /* Temp/Path properties */
-     if (strcmp(key, "fossil.temp.dir") == 0)
-     {
-#if defined(_WIN32)
-          const char *tmp = fossil_sys_env_get("TEMP");
-          if (!tmp)
-               tmp = fossil_sys_env_get("TMP");
-          return tmp;
-#else
-          const char *tmp = fossil_sys_env_get("TMPDIR");
-          if (!tmp)
-               tmp = "/tmp";
-          return tmp;
-#endif
-     }
-     if (strcmp(key, "fossil.temp.cache") == 0)
+/*
+ * Picks the only candidate ID from the key length and one or two
+ * distinguishing characters, then confirms it with a single memcmp.
+ * Returns -1 for keys that are not canonical.
+ */
+static int fossil_sys_env_canonical_id(const char *key, size_t len)
+{
+     if (len < 14 || memcmp(key, "fossil.", 7) != 0)
+          return -1;
+
+     int id = -1;
+     char domain = key[7];
+     switch (len)
      {
-          return fossil_sys_env_get("FOSSIL_TEMP_CACHE");
+     case 14:
+          id = domain == 's' ? FOSSIL_SYS_ENV_SYS_TMP : FOSSIL_SYS_ENV_USER_ID;
+          break;
+     case 15:
+          if (domain == 'a')
+               id = FOSSIL_SYS_ENV_APP_NAME;
+          else if (domain == 't')
+               id = FOSSIL_SYS_ENV_TEMP_DIR;
+          else if (key[11] == 'n')
+               id = FOSSIL_SYS_ENV_SYS_NAME;
+          else if (key[11] == 'a')
+               id = FOSSIL_SYS_ENV_SYS_ARCH;
+          else if (key[11] == 'p')
+               id = FOSSIL_SYS_ENV_SYS_PATH;
+          else
+               id = FOSSIL_SYS_ENV_SYS_HOME;
+          break;
+     case 16:
+          id = FOSSIL_SYS_ENV_USER_NAME;
+          break;
+     case 17:
+          id = FOSSIL_SYS_ENV_TEMP_CACHE;
+          break;
+     case 18:
+          id = FOSSIL_SYS_ENV_APP_VERSION;
+          break;
+     case 19:
+          if (domain == 'a')
+               id = FOSSIL_SYS_ENV_APP_INSTANCE;
+          else
+               id = key[15] == 'm' ? FOSSIL_SYS_ENV_RUNTIME_MODE : FOSSIL_SYS_ENV_RUNTIME_SEED;
+          break;
+     case 20:
+          if (domain == 'r')
+               id = FOSSIL_SYS_ENV_RUNTIME_DEBUG;
+          else
+               id = key[11] == 'p' ? FOSSIL_SYS_ENV_SYS_PAGE_SIZE : FOSSIL_SYS_ENV_SYS_CPU_COUNT;
+          break;
+     case 22:
+          id = FOSSIL_SYS_ENV_RUNTIME_THREADS;
+          break;
+     case 24:
+          id = domain == 's' ? FOSSIL_SYS_ENV_SYS_CPU_EFFECTIVE : FOSSIL_SYS_ENV_RUNTIME_LOG_LEVEL;
+          break;
+     case 25:
+          id = FOSSIL_SYS_ENV_RUNTIME_LOG_OUTPUT;
+          break;
+     case 27:
+          id = FOSSIL_SYS_ENV_SYS_MEMORY_EFFECTIVE;
+          break;
+     default:
+          return -1;
      }
+     return memcmp(key, fossil_sys_env_ids[id].key, len + 1) == 0 ? id : -1;
+}
 
-     /* Fallback: try as OS environment variable */
-#if defined(_WIN32)
-     return getenv(key);
+/* ============================================================================
+    NUMERIC CANONICAL VALUES
+============================================================================ */
+
+#if defined(_MSC_VER)
+#define FOSSIL_SYS_ENV_THREAD_LOCAL __declspec(thread)
 #else
-     return getenv(key);
+#define FOSSIL_SYS_ENV_THREAD_LOCAL _Thread_local
 #endif
+
+#if defined(_WIN32)
+typedef INIT_ONCE fossil_sys_env_once_t;
+#define FOSSIL_SYS_ENV_ONCE_INIT INIT_ONCE_STATIC_INIT
+
+static BOOL CALLBACK fossil_sys_env_once_thunk(PINIT_ONCE once, PVOID param, PVOID *ctx)
+{
+     void (*fn)(void);
+     (void)once;
+     (void)ctx;
+     memcpy(&fn, &param, sizeof(fn));
+     fn();
+     return TRUE;
 }
 
-const char *
-fossil_sys_env_get(const char *key)
+static void fossil_sys_env_once(fossil_sys_env_once_t *once, void (*fn)(void))
 {
-     if (!key)
-          return NULL;
-     return fossil_sys_env_resolve_id(key);
+     PVOID param;
+     memcpy(&param, &fn, sizeof(param));
+     InitOnceExecuteOnce(once, fossil_sys_env_once_thunk, param, NULL);
 }
+#else
+typedef pthread_once_t fossil_sys_env_once_t;
+#define FOSSIL_SYS_ENV_ONCE_INIT PTHREAD_ONCE_INIT
 
-int fossil_sys_env_set(const char *key, const char *value)
+static void fossil_sys_env_once(fossil_sys_env_once_t *once, void (*fn)(void))
 {
-     if (!key)
-          return -1;
+     pthread_once(once, fn);
+}
+#endif
 
-     /* Only allow setting for non-canonical keys or mapped env vars */
-     /* For canonical keys, set the mapped env var if possible */
-     if (strcmp(key, "fossil.sys.path") == 0)
-          key = "PATH";
-     else if (strcmp(key, "fossil.sys.home") == 0)
-     {
+/* Values fixed for the life of the process, computed and formatted once. */
+static struct
+{
+     uint64_t page_size;
+     uint64_t cpu_count;
+     char page_size_text[24];
+     char cpu_count_text[24];
+} fossil_sys_env_constants;
+
+static fossil_sys_env_once_t fossil_sys_env_constants_once = FOSSIL_SYS_ENV_ONCE_INIT;
+
+static void fossil_sys_env_constants_init(void)
+{
 #if defined(_WIN32)
-          key = "USERPROFILE";
+     SYSTEM_INFO si;
+     GetSystemInfo(&si);
+     fossil_sys_env_constants.page_size = si.dwPageSize;
+     fossil_sys_env_constants.cpu_count = si.dwNumberOfProcessors;
 #else
-          key = "HOME";
+     long page_size = sysconf(_SC_PAGESIZE);
+     long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+     fossil_sys_env_constants.page_size = page_size > 0 ? (uint64_t)page_size : 4096;
+     fossil_sys_env_constants.cpu_count = cpu_count > 0 ? (uint64_t)cpu_count : 1;
 #endif
+     snprintf(fossil_sys_env_constants.page_size_text, sizeof(fossil_sys_env_constants.page_size_text), "%llu",
+              (unsigned long long)fossil_sys_env_constants.page_size);
+     snprintf(fossil_sys_env_constants.cpu_count_text, sizeof(fossil_sys_env_constants.cpu_count_text), "%llu",
+              (unsigned long long)fossil_sys_env_constants.cpu_count);
+}
+
+/* Value of a numeric canonical ID; callers pass only the four numeric IDs. */
+static uint64_t fossil_sys_env_numeric_id(int id)
+{
+     switch (id)
+     {
+     case FOSSIL_SYS_ENV_SYS_PAGE_SIZE:
+          fossil_sys_env_once(&fossil_sys_env_constants_once, fossil_sys_env_constants_init);
+          return fossil_sys_env_constants.page_size;
+     case FOSSIL_SYS_ENV_SYS_CPU_COUNT:
+          fossil_sys_env_once(&fossil_sys_env_constants_once, fossil_sys_env_constants_init);
+          return fossil_sys_env_constants.cpu_count;
+     case FOSSIL_SYS_ENV_SYS_CPU_EFFECTIVE:
+          return (uint64_t)fossil_sys_hostinfo_effective_cpus();
+     default:
+     {
+          fossil_sys_hostinfo_resources_t res;
+          if (fossil_sys_hostinfo_get_resources(&res) != 0)
+               return 0;
+          return res.effective_memory;
+     }
      }
-     else if (strcmp(key, "fossil.sys.tmp") == 0)
+}
+
+/*
+ * Canonical String ID Handler
+ *
+ * This function maps canonical Fossil Sys string IDs to their platform-specific
+ * environment variable names or retrieves their values using platform APIs.
+ */
+static const char *fossil_sys_env_resolve_id(int id)
+{
+     switch (id)
      {
+     case FOSSIL_SYS_ENV_SYS_NAME:
 #if defined(_WIN32)
-          key = "TEMP";
+          return "windows";
+#elif defined(__APPLE__)
+          return "darwin";
+#elif defined(__linux__)
+          return "linux";
+#elif defined(__unix__)
+          return "unix";
 #else
-          key = "TMPDIR";
+          return "unknown";
 #endif
-     }
-     else if (strcmp(key, "fossil.user.name") == 0)
-     {
-#if defined(_WIN32)
-          key = "USERNAME";
+     case FOSSIL_SYS_ENV_SYS_ARCH:
+#if defined(_WIN64)
+          return "x86_64";
+#elif defined(_WIN32)
+          return "x86";
+#elif defined(__x86_64__) || defined(__amd64__)
+          return "x86_64";
+#elif defined(__aarch64__)
+          return "arm64";
+#elif defined(__arm__)
+          return "arm";
+#elif defined(__i386__)
+          return "x86";
 #else
-          key = "USER";
+          return "unknown";
 #endif
+     case FOSSIL_SYS_ENV_SYS_PAGE_SIZE:
+          fossil_sys_env_once(&fossil_sys_env_constants_once, fossil_sys_env_constants_init);
+          return fossil_sys_env_constants.page_size_text;
+     case FOSSIL_SYS_ENV_SYS_CPU_COUNT:
+          fossil_sys_env_once(&fossil_sys_env_constants_once, fossil_sys_env_constants_init);
+          return fossil_sys_env_constants.cpu_count_text;
+     case FOSSIL_SYS_ENV_SYS_CPU_EFFECTIVE:
+     case FOSSIL_SYS_ENV_SYS_MEMORY_EFFECTIVE:
+     {
+          /* Limits can change at runtime; format per thread so callers never share a buffer */
+          static FOSSIL_SYS_ENV_THREAD_LOCAL char buf[2][24];
+          char *out = buf[id == FOSSIL_SYS_ENV_SYS_MEMORY_EFFECTIVE];
+          snprintf(out, sizeof(buf[0]), "%llu", (unsigned long long)fossil_sys_env_numeric_id(id));
+          return out;
+     }
+     default:
+          break;
+     }
+
+     const char *value = fossil_sys_env_raw(fossil_sys_env_ids[id].var);
+     if (!value && fossil_sys_env_ids[id].alt)
+          value = fossil_sys_env_raw(fossil_sys_env_ids[id].alt);
+     return value ? value : fossil_sys_env_ids[id].fallback;
+}
+
+const char *
+fossil_sys_env_get(const char *key)
+{
+     if (!key)
+          return NULL;
+     int id = fossil_sys_env_canonical_id(key, strlen(key));
+     if (id >= 0)
+          return fossil_sys_env_resolve_id(id);
+
+     /* Fallback: try as OS environment variable */
+     return fossil_sys_env_raw(key);
+}
+
+int fossil_sys_env_get_copy(const char *key, char *buf, size_t size)
+{
+     if (!key || (!buf && size))
+          return -1;
+     int id = fossil_sys_env_canonical_id(key, strlen(key));
+     if (id < 0)
+          return fossil_sys_env_raw_copy(key, buf, size);
+     if (!fossil_sys_env_ids[id].var)
+     {
+          /* Computed values are constants or per-thread buffers */
+          const char *value = fossil_sys_env_resolve_id(id);
+          return value ? fossil_sys_env_copy_out(value, buf, size) : -1;
      }
-     else if (strcmp(key, "fossil.runtime.mode") == 0)
-          key = "FOSSIL_RUNTIME_MODE";
-     else if (strcmp(key, "fossil.runtime.debug") == 0)
-          key = "FOSSIL_RUNTIME_DEBUG";
-     else if (strcmp(key, "fossil.runtime.log.level") == 0)
-          key = "FOSSIL_RUNTIME_LOG_LEVEL";
-     else if (strcmp(key, "fossil.runtime.log.output") == 0)
-          key = "FOSSIL_RUNTIME_LOG_OUTPUT";
-     else if (strcmp(key, "fossil.runtime.seed") == 0)
-          key = "FOSSIL_RUNTIME_SEED";
-     else if (strcmp(key, "fossil.runtime.threads") == 0)
-          key = "FOSSIL_RUNTIME_THREADS";
-     else if (strcmp(key, "fossil.app.name") == 0)
-          key = "FOSSIL_APP_NAME";
-     else if (strcmp(key, "fossil.app.version") == 0)
-          key = "FOSSIL_APP_VERSION";
-     else if (strcmp(key, "fossil.app.instance") == 0)
-          key = "FOSSIL_APP_INSTANCE";
-     else if (strcmp(key, "fossil.temp.cache") == 0)
-          key = "FOSSIL_TEMP_CACHE";
 
+     int rc = fossil_sys_env_raw_copy(fossil_sys_env_ids[id].var, buf, size);
+     if (rc < 0 && fossil_sys_env_ids[id].alt)
+          rc = fossil_sys_env_raw_copy(fossil_sys_env_ids[id].alt, buf, size);
+     if (rc < 0 && fossil_sys_env_ids[id].fallback)
+          rc = fossil_sys_env_copy_out(fossil_sys_env_ids[id].fallback, buf, size);
+     return rc;
+}
+
+static int fossil_sys_env_os_set(const char *key, const char *value)
+{
 #if defined(_WIN32)
      return SetEnvironmentVariableA(key, value) ? 0 : -1;
 #else
-     if (!value)
+     return value ? setenv(key, value, 1) : unsetenv(key);
+#endif
+}
+
+int fossil_sys_env_set(const char *key, const char *value)
+{
+     if (!key)
+          return -1;
+
+     /* For canonical keys, set the mapped env var if there is one */
+     int id = fossil_sys_env_canonical_id(key, strlen(key));
+     if (id >= 0 && fossil_sys_env_ids[id].var)
+          key = fossil_sys_env_ids[id].var;
+
+     fossil_sys_env_lock(&fossil_sys_env_snapshot.lock);
+     if (fossil_sys_env_snapshot.current)
      {
-          return unsetenv(key);
+          int rc = fossil_sys_env_snapshot_put(key, strlen(key), value);
+          if (rc == 0 && fossil_sys_env_snapshot.mirror)
+               rc = fossil_sys_env_os_set(key, value);
+          fossil_sys_env_unlock(&fossil_sys_env_snapshot.lock);
+          return rc;
      }
-     return setenv(key, value, 1);
-#endif
+     fossil_sys_env_unlock(&fossil_sys_env_snapshot.lock);
+     return fossil_sys_env_os_set(key, value);
 }
 
 int fossil_sys_env_exists(const char *key)
@@ -364,8 +908,10 @@ fossil_sys_env_get_or(const char *key, const char *fallback)
 
 int fossil_sys_env_get_int(const char *key, int default_value)
 {
-     const char *v = fossil_sys_env_get(key);
-     if (!v)
+     /* Parsed from a copy so a concurrent set cannot free the text */
+     char v[64];
+     int n = fossil_sys_env_get_copy(key, v, sizeof(v));
+     if (n < 0 || (size_t)n >= sizeof(v))
           return default_value;
 
      char *end = NULL;
@@ -381,84 +927,512 @@ int fossil_sys_env_get_int(const char *key, int default_value)
 
 int fossil_sys_env_get_bool(const char *key, int default_value)
 {
-     const char *v = fossil_sys_env_get(key);
+     char v[16];
+     int n = fossil_sys_env_get_copy(key, v, sizeof(v));
+     if (n < 0 || (size_t)n >= sizeof(v))
+          return default_value;
      return fossil_sys_env_parse_bool(v, default_value);
 }
 
+uint64_t fossil_sys_env_get_u64(const char *key, uint64_t default_value)
+{
+     if (!key)
+          return default_value;
+
+     int id = fossil_sys_env_canonical_id(key, strlen(key));
+     switch (id)
+     {
+     case FOSSIL_SYS_ENV_SYS_PAGE_SIZE:
+     case FOSSIL_SYS_ENV_SYS_CPU_COUNT:
+     case FOSSIL_SYS_ENV_SYS_CPU_EFFECTIVE:
+     case FOSSIL_SYS_ENV_SYS_MEMORY_EFFECTIVE:
+          return fossil_sys_env_numeric_id(id);
+     default:
+          break;
+     }
+
+     char v[64];
+     int n = fossil_sys_env_get_copy(key, v, sizeof(v));
+     if (n < 0 || (size_t)n >= sizeof(v) || *v < '0' || *v > '9')
+          return default_value;
+
+     char *end = NULL;
+     errno = 0;
+     unsigned long long result = strtoull(v, &end, 10);
+     if (*end != '\0' || errno == ERANGE || result > UINT64_MAX)
+          return default_value;
+     return (uint64_t)result;
+}
+
 /* ============================================================================
     ITERATION
 ============================================================================ */
 
-void fossil_sys_env_foreach(fossil_sys_env_iter_cb cb, void *user_data)
+static int fossil_sys_env_key_equal(const char *a, const char *b, size_t len)
 {
-     if (!cb)
-          return;
-
 #if defined(_WIN32)
+     return _strnicmp(a, b, len) == 0;
+#else
+     return memcmp(a, b, len) == 0;
+#endif
+}
 
-     LPCH env = GetEnvironmentStringsA();
-     if (!env)
+int fossil_sys_env_foreach_view(fossil_sys_env_view_cb cb, void *user_data)
+{
+     return fossil_sys_env_foreach_prefix(NULL, cb, user_data);
+}
+
+typedef struct
+{
+     const char *literal;
+     char mapped[128]; /* "fossil.app." -> "FOSSIL_APP_", empty if same */
+     size_t len;
+} fossil_sys_env_prefix_t;
+
+static void fossil_sys_env_prefix_init(fossil_sys_env_prefix_t *prefix, const char *text)
+{
+     prefix->literal = text ? text : "";
+     prefix->len = strlen(prefix->literal);
+     prefix->mapped[0] = '\0';
+     if (!strchr(prefix->literal, '.') || prefix->len >= sizeof(prefix->mapped))
           return;
+     for (size_t i = 0; i <= prefix->len; ++i)
+     {
+          char c = prefix->literal[i];
+          prefix->mapped[i] = c == '.' ? '_' : (char)toupper((unsigned char)c);
+     }
+}
 
-     LPCH cur = env;
+/* Compares the first prefix->len characters of key, which must be at least that long. */
+static int fossil_sys_env_prefix_match(const fossil_sys_env_prefix_t *prefix, const char *key)
+{
+     return fossil_sys_env_key_equal(key, prefix->literal, prefix->len) ||
+            (prefix->mapped[0] && fossil_sys_env_key_equal(key, prefix->mapped, prefix->len));
+}
+
+int fossil_sys_env_foreach_prefix(const char *prefix, fossil_sys_env_view_cb cb, void *user_data)
+{
+     if (!cb)
+          return 0;
+     fossil_sys_env_prefix_t match;
+     fossil_sys_env_prefix_init(&match, prefix);
+     if (strchr(match.literal, '='))
+          return 0;
+     int stop = 0;
 
-     while (*cur)
+     unsigned long token = fossil_sys_env_read_begin();
+     const fossil_sys_env_table_t *table = fossil_sys_env_load_ptr(&fossil_sys_env_snapshot.current);
+     if (table)
      {
-          const char *entry = cur;
-          const char *eq = strchr(entry, '=');
+          for (size_t i = 0; i < table->capacity && !stop; ++i)
+          {
+               const fossil_sys_env_entry_t *entry = table->slots[i];
+               if (!entry || entry->key_len < match.len || !fossil_sys_env_prefix_match(&match, entry->data))
+                    continue;
+               const char *value = entry->data + entry->key_len + 1;
+               stop = cb(entry->data, entry->key_len, value, strlen(value), user_data);
+          }
+          fossil_sys_env_read_end(token);
+          return stop;
+     }
+     fossil_sys_env_read_end(token);
 
+#if defined(_WIN32)
+     /* The OS hands out a copy here; entries are still viewed in place */
+     LPCH env = GetEnvironmentStringsA();
+     if (!env)
+          return 0;
+     for (LPCH cur = env; *cur && !stop;)
+     {
+          size_t len = strlen(cur);
+          /* Skip the first character so hidden "=C:=C:\\dir" entries keep their key */
+          const char *eq = len > 1 ? memchr(cur + 1, '=', len - 1) : NULL;
           if (eq)
           {
-               size_t key_len = (size_t)(eq - entry);
+               size_t key_len = (size_t)(eq - cur);
+               if (key_len >= match.len && fossil_sys_env_prefix_match(&match, cur))
+                    stop = cb(cur, key_len, eq + 1, len - key_len - 1, user_data);
+          }
+          cur += len + 1;
+     }
+     FreeEnvironmentStringsA(env);
+#else
+     extern char **environ;
+     for (char **e = environ; *e && !stop; ++e)
+     {
+          const char *entry = *e;
+          /* strncmp stops at a short entry; a prefix without '=' only matches names */
+          if (match.len && strncmp(entry, match.literal, match.len) != 0 &&
+              (!match.mapped[0] || strncmp(entry, match.mapped, match.len) != 0))
+               continue;
+          const char *eq = strchr(entry + match.len, '=');
+          if (!eq)
+               continue;
+          size_t key_len = (size_t)(eq - entry);
+          stop = cb(entry, key_len, eq + 1, strlen(eq + 1), user_data);
+     }
+#endif
+     return stop;
+}
 
-               char key[256];
-               if (key_len < sizeof(key))
-               {
-                    memcpy(key, entry, key_len);
-                    key[key_len] = '\0';
+typedef struct
+{
+     fossil_sys_env_iter_cb cb;
+     void *user_data;
+} fossil_sys_env_foreach_ctx_t;
 
-                    const char *value = eq + 1;
+/* Adapts views to the NUL-terminated key callback of fossil_sys_env_foreach. */
+static int fossil_sys_env_foreach_copy(const char *key, size_t key_len, const char *value, size_t value_len,
+                                       void *user_data)
+{
+     (void)value_len;
+     fossil_sys_env_foreach_ctx_t *ctx = user_data;
+     char buffer[256];
+     if (key[key_len] != '\0')
+     {
+          if (key_len >= sizeof(buffer))
+               return 0;
+          memcpy(buffer, key, key_len);
+          buffer[key_len] = '\0';
+          key = buffer;
+     }
+     return ctx->cb(key, value, ctx->user_data);
+}
 
-                    if (cb(key, value, user_data) != 0)
-                    {
-                         break;
-                    }
-               }
+void fossil_sys_env_foreach(fossil_sys_env_iter_cb cb, void *user_data)
+{
+     if (!cb)
+          return;
+     fossil_sys_env_foreach_ctx_t ctx = {cb, user_data};
+     fossil_sys_env_foreach_view(fossil_sys_env_foreach_copy, &ctx);
+}
+
+/* ============================================================================
+    ENVIRONMENT BLOCKS
+
+    An image is one allocation holding the NULL-terminated pointer array
+    followed by the packed "KEY=VALUE\0" strings and a final '\0'. The
+    strings keep insertion order, so the string area is not the sorted
+    block CreateProcess expects on Windows. Images are immutable and
+    reference counted, so clones share them; edits are kept on the block
+    and only merged into a fresh image when envp is requested again.
+============================================================================ */
+
+typedef struct fossil_sys_env_image
+{
+     fossil_sys_env_atomic_t refs;
+     size_t count;
+     size_t bytes; /* size of the string area */
+     char *vars[];
+} fossil_sys_env_image_t;
+
+typedef struct
+{
+     size_t key_len;
+     int remove;
+     char *data; /* "key\0value", value empty when removing */
+} fossil_sys_env_edit_t;
+
+struct fossil_sys_env_block
+{
+     fossil_sys_env_image_t *image;
+     fossil_sys_env_edit_t *edits;
+     size_t edit_count;
+     size_t edit_capacity;
+};
+
+static void fossil_sys_env_image_release(fossil_sys_env_image_t *image)
+{
+     if (image && fossil_sys_env_atomic_dec(&image->refs) == 0)
+          free(image);
+}
+
+/* Allocates an image for count strings totalling bytes (terminators included). */
+static fossil_sys_env_image_t *fossil_sys_env_image_alloc(size_t count, size_t bytes)
+{
+     fossil_sys_env_image_t *image = malloc(sizeof(*image) + (count + 1) * sizeof(char *) + bytes + 1);
+     if (!image)
+          return NULL;
+     image->refs = 1;
+     image->count = count;
+     image->bytes = bytes;
+     image->vars[count] = NULL;
+     return image;
+}
+
+static char *fossil_sys_env_image_strings(fossil_sys_env_image_t *image)
+{
+     return (char *)&image->vars[image->count + 1];
+}
+
+typedef struct
+{
+     char *buffer;
+     size_t size;
+     size_t capacity;
+     size_t count;
+     int failed;
+} fossil_sys_env_collect_t;
+
+static int fossil_sys_env_collect(const char *key, size_t key_len, const char *value, size_t value_len,
+                                  void *user_data)
+{
+     fossil_sys_env_collect_t *collect = user_data;
+     size_t need = key_len + value_len + 2;
+     if (collect->size + need > collect->capacity)
+     {
+          size_t capacity = collect->capacity ? collect->capacity * 2 : 4096;
+          while (capacity < collect->size + need)
+               capacity *= 2;
+          char *buffer = realloc(collect->buffer, capacity);
+          if (!buffer)
+          {
+               collect->failed = 1;
+               return 1;
           }
+          collect->buffer = buffer;
+          collect->capacity = capacity;
+     }
+     char *dst = collect->buffer + collect->size;
+     memcpy(dst, key, key_len);
+     dst[key_len] = '=';
+     memcpy(dst + key_len + 1, value, value_len);
+     dst[key_len + 1 + value_len] = '\0';
+     collect->size += need;
+     collect->count++;
+     return 0;
+}
 
+/* Points vars at the packed strings and terminates the string area. */
+static void fossil_sys_env_image_link(fossil_sys_env_image_t *image)
+{
+     char *cur = fossil_sys_env_image_strings(image);
+     for (size_t i = 0; i < image->count; ++i)
+     {
+          image->vars[i] = cur;
           cur += strlen(cur) + 1;
      }
+     *cur = '\0';
+}
 
-     FreeEnvironmentStringsA(env);
+fossil_sys_env_block_t *fossil_sys_env_block_create(int inherit)
+{
+     fossil_sys_env_block_t *block = calloc(1, sizeof(*block));
+     if (!block)
+          return NULL;
 
-#else
+     fossil_sys_env_collect_t collect = {0};
+     if (inherit)
+          fossil_sys_env_foreach_view(fossil_sys_env_collect, &collect);
 
-     extern char **environ;
+     if (!collect.failed)
+          block->image = fossil_sys_env_image_alloc(collect.count, collect.size);
+     if (!block->image)
+     {
+          free(collect.buffer);
+          free(block);
+          return NULL;
+     }
+     if (collect.size)
+          memcpy(fossil_sys_env_image_strings(block->image), collect.buffer, collect.size);
+     fossil_sys_env_image_link(block->image);
+     free(collect.buffer);
+     return block;
+}
 
-     for (char **e = environ; *e; ++e)
+fossil_sys_env_block_t *fossil_sys_env_block_clone(const fossil_sys_env_block_t *block)
+{
+     if (!block)
+          return NULL;
+     fossil_sys_env_block_t *clone = calloc(1, sizeof(*clone));
+     if (!clone)
+          return NULL;
+     if (block->edit_count)
      {
-          const char *entry = *e;
-          const char *eq = strchr(entry, '=');
+          clone->edits = malloc(block->edit_count * sizeof(*clone->edits));
+          if (!clone->edits)
+          {
+               free(clone);
+               return NULL;
+          }
+          clone->edit_capacity = block->edit_count;
+          for (size_t i = 0; i < block->edit_count; ++i)
+          {
+               const fossil_sys_env_edit_t *edit = &block->edits[i];
+               size_t size = edit->key_len + strlen(edit->data + edit->key_len + 1) + 2;
+               char *data = malloc(size);
+               if (!data)
+               {
+                    fossil_sys_env_block_free(clone);
+                    return NULL;
+               }
+               memcpy(data, edit->data, size);
+               clone->edits[i] = *edit;
+               clone->edits[i].data = data;
+               clone->edit_count++;
+          }
+     }
+     fossil_sys_env_atomic_inc(&block->image->refs);
+     clone->image = block->image;
+     return clone;
+}
 
-          if (!eq)
-               continue;
+void fossil_sys_env_block_free(fossil_sys_env_block_t *block)
+{
+     if (!block)
+          return;
+     for (size_t i = 0; i < block->edit_count; ++i)
+          free(block->edits[i].data);
+     free(block->edits);
+     fossil_sys_env_image_release(block->image);
+     free(block);
+}
 
-          size_t key_len = (size_t)(eq - entry);
+static fossil_sys_env_edit_t *fossil_sys_env_block_edit(const fossil_sys_env_block_t *block, const char *key,
+                                                        size_t key_len)
+{
+     for (size_t i = 0; i < block->edit_count; ++i)
+     {
+          fossil_sys_env_edit_t *edit = &block->edits[i];
+          if (edit->key_len == key_len && fossil_sys_env_key_equal(edit->data, key, key_len))
+               return edit;
+     }
+     return NULL;
+}
 
-          char key[256];
-          if (key_len >= sizeof(key))
-               continue;
+int fossil_sys_env_block_set(fossil_sys_env_block_t *block, const char *key, const char *value)
+{
+     if (!block || !key || !*key || strchr(key, '='))
+          return -1;
+
+     size_t key_len = strlen(key);
+     size_t value_len = value ? strlen(value) : 0;
+     char *data = malloc(key_len + value_len + 2);
+     if (!data)
+          return -3;
+     memcpy(data, key, key_len + 1);
+     memcpy(data + key_len + 1, value ? value : "", value_len + 1);
+
+     fossil_sys_env_edit_t *edit = fossil_sys_env_block_edit(block, key, key_len);
+     if (!edit)
+     {
+          if (block->edit_count == block->edit_capacity)
+          {
+               size_t capacity = block->edit_capacity ? block->edit_capacity * 2 : 8;
+               fossil_sys_env_edit_t *edits = realloc(block->edits, capacity * sizeof(*edits));
+               if (!edits)
+               {
+                    free(data);
+                    return -3;
+               }
+               block->edits = edits;
+               block->edit_capacity = capacity;
+          }
+          edit = &block->edits[block->edit_count++];
+          edit->data = NULL;
+     }
+     free(edit->data);
+     edit->data = data;
+     edit->key_len = key_len;
+     edit->remove = value == NULL;
+     return 0;
+}
 
-          memcpy(key, entry, key_len);
-          key[key_len] = '\0';
+int fossil_sys_env_block_unset(fossil_sys_env_block_t *block, const char *key)
+{
+     return fossil_sys_env_block_set(block, key, NULL);
+}
 
-          const char *value = eq + 1;
+/* Image variable matching key, or NULL. */
+static const char *fossil_sys_env_image_find(const fossil_sys_env_image_t *image, const char *key, size_t key_len)
+{
+     for (size_t i = 0; i < image->count; ++i)
+     {
+          /* Length first: var may be shorter than key */
+          const char *var = image->vars[i];
+          const char *eq = strchr(var[0] == '=' ? var + 1 : var, '=');
+          if (eq && (size_t)(eq - var) == key_len && fossil_sys_env_key_equal(var, key, key_len))
+               return var;
+     }
+     return NULL;
+}
 
-          if (cb(key, value, user_data) != 0)
+const char *fossil_sys_env_block_get(const fossil_sys_env_block_t *block, const char *key)
+{
+     if (!block || !key)
+          return NULL;
+     size_t key_len = strlen(key);
+     const fossil_sys_env_edit_t *edit = fossil_sys_env_block_edit(block, key, key_len);
+     if (edit)
+          return edit->remove ? NULL : edit->data + key_len + 1;
+     const char *var = fossil_sys_env_image_find(block->image, key, key_len);
+     return var ? var + key_len + 1 : NULL;
+}
+
+char *const *fossil_sys_env_block_envp(fossil_sys_env_block_t *block)
+{
+     if (!block)
+          return NULL;
+     if (!block->edit_count)
+          return block->image->vars;
+
+     const fossil_sys_env_image_t *old = block->image;
+     size_t count = 0, bytes = 0;
+     for (size_t i = 0; i < old->count; ++i)
+     {
+          const char *var = old->vars[i];
+          size_t key_len = (size_t)(strchr(var, '=') - var);
+          if (fossil_sys_env_block_edit(block, var, key_len))
+               continue;
+          count++;
+          bytes += strlen(var) + 1;
+     }
+     for (size_t i = 0; i < block->edit_count; ++i)
+     {
+          const fossil_sys_env_edit_t *edit = &block->edits[i];
+          if (edit->remove)
+               continue;
+          count++;
+          bytes += edit->key_len + strlen(edit->data + edit->key_len + 1) + 2;
+     }
+
+     fossil_sys_env_image_t *image = fossil_sys_env_image_alloc(count, bytes);
+     if (!image)
+          return NULL;
+     char *cur = fossil_sys_env_image_strings(image);
+     for (size_t i = 0; i < old->count; ++i)
+     {
+          const char *var = old->vars[i];
+          size_t key_len = (size_t)(strchr(var, '=') - var);
+          if (fossil_sys_env_block_edit(block, var, key_len))
+               continue;
+          size_t len = strlen(var) + 1;
+          memcpy(cur, var, len);
+          cur += len;
+     }
+     for (size_t i = 0; i < block->edit_count; ++i)
+     {
+          fossil_sys_env_edit_t *edit = &block->edits[i];
+          if (!edit->remove)
           {
-               break;
+               size_t value_len = strlen(edit->data + edit->key_len + 1);
+               memcpy(cur, edit->data, edit->key_len);
+               cur[edit->key_len] = '=';
+               memcpy(cur + edit->key_len + 1, edit->data + edit->key_len + 1, value_len + 1);
+               cur += edit->key_len + value_len + 2;
           }
+          free(edit->data);
      }
+     block->edit_count = 0;
+     fossil_sys_env_image_link(image);
 
-#endif
+     fossil_sys_env_image_release(block->image);
+     block->image = image;
+     return image->vars;
+}
+
+size_t fossil_sys_env_block_count(fossil_sys_env_block_t *block)
+{
+     char *const *envp = fossil_sys_env_block_envp(block);
+     return envp ? block->image->count : 0;
 }
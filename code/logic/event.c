@@ -28,21 +28,56 @@
 #include <stdio.h>
 #include <time.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <errno.h>
+#endif
+
 #define MAX_EVENTS 256
 
 /* ------------------------------------------------------
  * Internal Event Queue
+ *
+ * Guarded by a lock so events can be posted from worker
+ * threads (e.g. hostinfo watchers) while another thread
+ * polls or waits.
  * ----------------------------------------------------- */
 static fossil_sys_event_t event_queue[MAX_EVENTS];
 static size_t event_count = 0;
 
+#ifdef _WIN32
+static SRWLOCK event_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE event_ready = CONDITION_VARIABLE_INIT;
+#define EVENT_LOCK() AcquireSRWLockExclusive(&event_lock)
+#define EVENT_UNLOCK() ReleaseSRWLockExclusive(&event_lock)
+#else
+static pthread_mutex_t event_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t event_ready = PTHREAD_COND_INITIALIZER;
+#define EVENT_LOCK() pthread_mutex_lock(&event_lock)
+#define EVENT_UNLOCK() pthread_mutex_unlock(&event_lock)
+#endif
+
+/* Removes the oldest event. Caller holds the lock and checked event_count. */
+static void event_pop_locked(fossil_sys_event_t *out_event)
+{
+    *out_event = event_queue[0];
+
+    // Shift remaining events
+    memmove(event_queue, event_queue + 1, (event_count - 1) * sizeof(fossil_sys_event_t));
+    event_count--;
+}
+
 /* ------------------------------------------------------
  * Initialization
  * ----------------------------------------------------- */
 int fossil_sys_event_init(void)
 {
+    EVENT_LOCK();
     event_count = 0;
     memset(event_queue, 0, sizeof(event_queue));
+    EVENT_UNLOCK();
     return 0;
 }
 
@@ -54,14 +89,14 @@ int fossil_sys_event_poll(fossil_sys_event_t *out_event)
     if (!out_event)
         return -1;
 
+    EVENT_LOCK();
     if (event_count == 0)
+    {
+        EVENT_UNLOCK();
         return 0; // no events
-
-    *out_event = event_queue[0];
-
-    // Shift remaining events
-    memmove(event_queue, event_queue + 1, (event_count - 1) * sizeof(fossil_sys_event_t));
-    event_count--;
+    }
+    event_pop_locked(out_event);
+    EVENT_UNLOCK();
 
     return 1; // event returned
 }
@@ -74,16 +109,41 @@ int fossil_sys_event_wait(fossil_sys_event_t *out_event, uint32_t timeout_ms)
     if (!out_event)
         return -1;
 
-    clock_t start = clock();
+    EVENT_LOCK();
+#ifdef _WIN32
+    ULONGLONG deadline = GetTickCount64() + timeout_ms;
     while (event_count == 0)
     {
-        clock_t now = clock();
-        uint32_t elapsed_ms = (uint32_t)((now - start) * 1000 / CLOCKS_PER_SEC);
-        if (elapsed_ms >= timeout_ms)
-            return 0; // timeout
+        ULONGLONG now = GetTickCount64();
+        if (now >= deadline)
+            break;
+        SleepConditionVariableSRW(&event_ready, &event_lock, (DWORD)(deadline - now), 0);
+    }
+#else
+    // Sleep on the condition instead of spinning; woken by post
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(timeout_ms / 1000);
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L)
+    {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
     }
 
-    return fossil_sys_event_poll(out_event);
+    int rc = 0;
+    while (event_count == 0 && timeout_ms > 0 && rc != ETIMEDOUT)
+        rc = pthread_cond_timedwait(&event_ready, &event_lock, &deadline);
+#endif
+
+    if (event_count == 0)
+    {
+        EVENT_UNLOCK();
+        return 0; // timeout
+    }
+    event_pop_locked(out_event);
+    EVENT_UNLOCK();
+    return 1;
 }
 
 /* ------------------------------------------------------
@@ -91,27 +151,37 @@ int fossil_sys_event_wait(fossil_sys_event_t *out_event, uint32_t timeout_ms)
  * ----------------------------------------------------- */
 int fossil_sys_event_post(const char *id, void *payload, size_t size)
 {
+    // Copy the payload before taking the lock
+    void *copy = NULL;
+    if (payload && size > 0)
+    {
+        copy = malloc(size);
+        if (!copy)
+            return -1;
+        memcpy(copy, payload, size);
+    }
+
+    EVENT_LOCK();
     if (event_count >= MAX_EVENTS)
+    {
+        EVENT_UNLOCK();
+        free(copy);
         return -1; // queue full
+    }
 
     fossil_sys_event_t *e = &event_queue[event_count];
     e->id = id;
     e->type = FOSSIL_EVENT_CUSTOM;
     e->size = size;
-
-    if (payload && size > 0)
-    {
-        e->payload = malloc(size);
-        if (!e->payload)
-            return -1;
-        memcpy(e->payload, payload, size);
-    }
-    else
-    {
-        e->payload = NULL;
-    }
+    e->payload = copy;
 
     event_count++;
+#ifdef _WIN32
+    WakeConditionVariable(&event_ready);
+#else
+    pthread_cond_signal(&event_ready);
+#endif
+    EVENT_UNLOCK();
     return 0;
 }
 
@@ -120,6 +190,7 @@ int fossil_sys_event_post(const char *id, void *payload, size_t size)
  * ----------------------------------------------------- */
 void fossil_sys_event_shutdown(void)
 {
+    EVENT_LOCK();
     // Free any allocated payloads
     for (size_t i = 0; i < event_count; i++)
     {
@@ -127,4 +198,5 @@ void fossil_sys_event_shutdown(void)
         event_queue[i].payload = NULL;
     }
     event_count = 0;
+    EVENT_UNLOCK();
 }
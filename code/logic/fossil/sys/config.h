@@ -0,0 +1,338 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_SYS_CONFIG_H
+#define FOSSIL_SYS_CONFIG_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===============================================================================
+Fossil Sys Configuration API
+
+A process-wide layered key/value store over the fossil.<domain>.<name>
+namespace described in env.h. Each key resolves from three layers, highest
+priority first:
+
+    environment   the key upper-cased with '.' replaced by '_'
+                  ("fossil.runtime.log.level" -> FOSSIL_RUNTIME_LOG_LEVEL),
+                  read through fossil_sys_env_get
+    file          key=value lines or INI sections ("[fossil.runtime]"
+                  followed by "seed=1" defines "fossil.runtime.seed"),
+                  loaded with fossil_sys_config_load_file
+    defaults      registered with fossil_sys_config_set_default
+
+Values are parsed once, when a layer changes, into every typed form they
+support (int, bool, double, duration, size). A handle obtained once with
+fossil_sys_config_handle is stable for the life of the store, so hot loops
+read typed values with a single atomic load and no hashing or parsing.
+Replaced values are freed once no reader can still see them, so memory
+stays bounded however often the store is reloaded.
+
+Formats:
+    bool      1/0, true/false, yes/no, on/off (case-insensitive)
+    int       decimal or 0x-prefixed hexadecimal, optional sign
+    duration  one or more number+unit pairs: ns, us, ms, s, m, h, d
+              ("1h30m", "1.5s"); a bare number is milliseconds
+    size      number with optional unit B, K, M, G, T (optionally followed
+              by "B" or "iB"); all multiples are powers of 1024
+
+===============================================================================
+*/
+
+/**
+ * Event ID posted through fossil_sys_event_post after a load or reload
+ * that changed at least one value; the payload is a
+ * fossil_sys_config_reload_event_t.
+ */
+#define FOSSIL_SYS_CONFIG_EVENT_RELOAD "fossil.sys.config.reload"
+
+/**
+ * Layer a value was resolved from.
+ */
+typedef enum
+{
+    FOSSIL_SYS_CONFIG_SOURCE_NONE,
+    FOSSIL_SYS_CONFIG_SOURCE_DEFAULT,
+    FOSSIL_SYS_CONFIG_SOURCE_FILE,
+    FOSSIL_SYS_CONFIG_SOURCE_ENV
+} fossil_sys_config_source_t;
+
+/**
+ * Payload of FOSSIL_SYS_CONFIG_EVENT_RELOAD.
+ */
+typedef struct
+{
+    uint64_t generation; // value of fossil_sys_config_generation after the reload
+    size_t changed;      // number of keys whose resolved value changed
+} fossil_sys_config_reload_event_t;
+
+/**
+ * Stable handle to one configuration key.
+ */
+typedef struct fossil_sys_config_entry fossil_sys_config_handle_t;
+
+/**
+ * @brief Registers the lowest-priority value of a key.
+ *
+ * @param key Configuration key.
+ * @param value Default value, or NULL to remove the default.
+ * @return 0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_sys_config_set_default(const char *key, const char *value);
+
+/**
+ * @brief Loads the file layer from a key=value or INI file.
+ *
+ * The file is memory-mapped and parsed once; its path is remembered for
+ * fossil_sys_config_reload. Lines starting with '#' or ';' are comments,
+ * values may be wrapped in double quotes. Loading replaces the previous
+ * file layer and posts a reload event if any value changed.
+ *
+ * @param path Path to the file.
+ * @return 0 on success, -1 on invalid arguments, -3 if the file could not
+ *         be read, memory could not be allocated or the reload event could
+ *         not be posted (the new values are still in effect).
+ */
+int fossil_sys_config_load_file(const char *path);
+
+/**
+ * @brief Re-reads the file layer and the environment overrides.
+ *
+ * Keys whose resolved value changed are updated in place, so existing
+ * handles observe the new values. Posts FOSSIL_SYS_CONFIG_EVENT_RELOAD
+ * when at least one value changed.
+ *
+ * @return 0 on success, -3 if the file could not be re-read (the previous
+ *         file layer is kept) or the reload event could not be posted (the
+ *         new values are still in effect).
+ */
+int fossil_sys_config_reload(void);
+
+/**
+ * @brief Number of completed reloads; cheap to poll for changes.
+ */
+uint64_t fossil_sys_config_generation(void);
+
+/**
+ * @brief Returns the handle of a key, creating it if necessary.
+ *
+ * Handles exist for keys that are not set in any layer yet; their reads
+ * return the fallback until a layer provides a value.
+ *
+ * @param key Configuration key.
+ * @return The handle, or NULL on invalid arguments or allocation failure.
+ */
+fossil_sys_config_handle_t *fossil_sys_config_handle(const char *key);
+
+/**
+ * @brief Releases every key, value and handle. Handles and strings
+ *        returned earlier become invalid.
+ */
+void fossil_sys_config_shutdown(void);
+
+/**
+ * @brief Layer the current value of a handle comes from.
+ */
+fossil_sys_config_source_t fossil_sys_config_source(const fossil_sys_config_handle_t *handle);
+
+/**
+ * @brief Reads a value as a string.
+ *
+ * Like getenv, the returned string stays valid until the value of the key
+ * next changes. Use fossil_sys_config_string_copy where another thread may
+ * reload the store.
+ *
+ * @param handle Handle from fossil_sys_config_handle.
+ * @param fallback Returned when the key is unset or handle is NULL.
+ * @return The value or fallback.
+ */
+const char *fossil_sys_config_string(const fossil_sys_config_handle_t *handle, const char *fallback);
+
+/**
+ * @brief Copies a value as a string into a caller buffer.
+ *
+ * The copy is taken while the value is pinned, so it is safe against
+ * concurrent reloads.
+ *
+ * @param handle Handle from fossil_sys_config_handle.
+ * @param buf Destination, always NUL-terminated when size > 0.
+ * @param size Size of buf; 0 to query the length only.
+ * @return Length of the value (truncated if >= size), or -1 if the key is
+ *         unset, handle is NULL or buf is NULL with size > 0.
+ */
+int fossil_sys_config_string_copy(const fossil_sys_config_handle_t *handle, char *buf, size_t size);
+
+/**
+ * @brief Reads a value as a signed integer.
+ *
+ * @return The value, or fallback if unset or not an integer.
+ */
+int64_t fossil_sys_config_int(const fossil_sys_config_handle_t *handle, int64_t fallback);
+
+/**
+ * @brief Reads a value as a boolean.
+ *
+ * @return 1 or 0, or fallback if unset or not a boolean.
+ */
+int fossil_sys_config_bool(const fossil_sys_config_handle_t *handle, int fallback);
+
+/**
+ * @brief Reads a value as a floating-point number.
+ *
+ * @return The value, or fallback if unset or not a number.
+ */
+double fossil_sys_config_double(const fossil_sys_config_handle_t *handle, double fallback);
+
+/**
+ * @brief Reads a value as a duration in nanoseconds.
+ *
+ * @return The duration, or fallback if unset or not a duration.
+ */
+uint64_t fossil_sys_config_duration_ns(const fossil_sys_config_handle_t *handle, uint64_t fallback);
+
+/**
+ * @brief Reads a value as a size in bytes.
+ *
+ * @return The size, or fallback if unset or not a size.
+ */
+uint64_t fossil_sys_config_size(const fossil_sys_config_handle_t *handle, uint64_t fallback);
+
+/**
+ * @brief Looks up a key and reads it as a string.
+ *
+ * Hashes the key on every call; keep a handle for repeated reads. The
+ * string follows the lifetime rules of fossil_sys_config_string.
+ */
+const char *fossil_sys_config_get(const char *key, const char *fallback);
+
+#ifdef __cplusplus
+}
+#include <string>
+
+namespace fossil::sys {
+
+    class Config {
+    public:
+        /**
+         * Register the lowest-priority value of a key.
+         *
+         * @param key Configuration key.
+         * @param value Default value.
+         * @return 0 on success, negative on failure.
+         */
+        static int set_default(const std::string& key, const std::string& value) {
+            return fossil_sys_config_set_default(key.c_str(), value.c_str());
+        }
+
+        /**
+         * Load the file layer from a key=value or INI file.
+         *
+         * @param path Path to the file.
+         * @return 0 on success, negative on failure.
+         */
+        static int load_file(const std::string& path) {
+            return fossil_sys_config_load_file(path.c_str());
+        }
+
+        /**
+         * Re-read the file layer and environment overrides.
+         *
+         * @return 0 on success, negative on failure.
+         */
+        static int reload() {
+            return fossil_sys_config_reload();
+        }
+
+        /**
+         * Return the stable handle of a key.
+         *
+         * @param key Configuration key.
+         * @return The handle, or nullptr on failure.
+         */
+        static fossil_sys_config_handle_t* handle(const std::string& key) {
+            return fossil_sys_config_handle(key.c_str());
+        }
+
+        /**
+         * Read a key as a string, or fallback if unset.
+         */
+        static std::string get(const std::string& key, const std::string& fallback = std::string()) {
+            fossil_sys_config_handle_t* h = handle(key);
+            char small[256];
+            int len = fossil_sys_config_string_copy(h, small, sizeof(small));
+            if (len >= 0 && static_cast<size_t>(len) < sizeof(small))
+                return std::string(small, static_cast<size_t>(len));
+            std::string value;
+            while (len >= 0) {
+                value.resize(static_cast<size_t>(len));
+                int again = fossil_sys_config_string_copy(h, value.data(), value.size() + 1);
+                if (again >= 0 && again <= len) {
+                    value.resize(static_cast<size_t>(again));
+                    return value;
+                }
+                len = again; // changed meanwhile
+            }
+            return fallback;
+        }
+
+        /**
+         * Read a key as a signed integer, or fallback if unset or invalid.
+         */
+        static int64_t get_int(const std::string& key, int64_t fallback) {
+            return fossil_sys_config_int(handle(key), fallback);
+        }
+
+        /**
+         * Read a key as a boolean, or fallback if unset or invalid.
+         */
+        static bool get_bool(const std::string& key, bool fallback) {
+            return fossil_sys_config_bool(handle(key), fallback ? 1 : 0) == 1;
+        }
+
+        /**
+         * Read a key as a duration in nanoseconds, or fallback if unset or invalid.
+         */
+        static uint64_t get_duration_ns(const std::string& key, uint64_t fallback) {
+            return fossil_sys_config_duration_ns(handle(key), fallback);
+        }
+
+        /**
+         * Read a key as a size in bytes, or fallback if unset or invalid.
+         */
+        static uint64_t get_size(const std::string& key, uint64_t fallback) {
+            return fossil_sys_config_size(handle(key), fallback);
+        }
+    };
+
+} // namespace fossil::sys
+
+#endif
+
+#endif /* FOSSIL_SYS_CONFIG_H */
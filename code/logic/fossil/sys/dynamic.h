@@ -32,6 +32,7 @@ extern "C"
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 /* ------------------------------------------------------
     * Platform abstraction
@@ -48,6 +49,23 @@ typedef void *fossil_sys_dynamic_handle_t;
     * Types
     * ----------------------------------------------------- */
 
+/* Load flags for fossil_sys_dynamic_load_ex (bitwise OR) */
+enum
+{
+    FOSSIL_SYS_DYNAMIC_NOW = 0,           /* bind every symbol at load (default) */
+    FOSSIL_SYS_DYNAMIC_LAZY = 1 << 0,     /* bind functions on first call */
+    FOSSIL_SYS_DYNAMIC_GLOBAL = 1 << 1,   /* export symbols to later loads */
+    FOSSIL_SYS_DYNAMIC_NODELETE = 1 << 2, /* never unmap, even after unload */
+    FOSSIL_SYS_DYNAMIC_DEEPBIND = 1 << 3  /* prefer the library's own symbols */
+};
+
+/* Link-map namespaces for fossil_sys_dynamic_load_ex */
+#define FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT 0L /* the main program's namespace */
+#define FOSSIL_SYS_DYNAMIC_NAMESPACE_NEW (-1L)  /* a fresh, isolated namespace */
+
+/* Per-library symbol cache (opaque) */
+typedef struct fossil_sys_dynamic_cache fossil_sys_dynamic_cache_t;
+
 /* Dynamic library descriptor */
 typedef struct
 {
@@ -55,8 +73,29 @@ typedef struct
     const char *path; /* file path to library */
     fossil_sys_dynamic_handle_t handle;
     int status; /* loaded / unloaded / error */
+    fossil_sys_dynamic_cache_t *cache; /* resolved symbols, freed on unload */
 } fossil_sys_dynamic_lib_t;
 
+/* Module mapped into the process, as reported by the loader */
+typedef struct
+{
+    const char *path; /* module path, "" for the main program */
+    uintptr_t base;   /* load address */
+    unsigned refs;    /* loads held through fossil_sys_dynamic_load */
+} fossil_sys_dynamic_module_t;
+
+/* Module visitor; return non-zero to stop the enumeration */
+typedef int (*fossil_sys_dynamic_module_cb)(
+    const fossil_sys_dynamic_module_t *module,
+    void *user_data);
+
+/* One entry of a bulk binding table */
+typedef struct
+{
+    const char *name; /* symbol to resolve */
+    void **slot;      /* void * receiving the address, NULL if unresolved */
+} fossil_sys_dynamic_binding_t;
+
 /* ------------------------------------------------------
     * Lifecycle
     * ----------------------------------------------------- */
@@ -68,6 +107,12 @@ typedef struct
  * the fossil_sys_dynamic_lib_t structure with the library handle.
  * Sets the status field to indicate success or failure.
  *
+ * Loads go through a process-wide, thread-safe registry: loading a path
+ * that is already loaded only takes another reference on the same handle
+ * and symbol cache, and the library is closed when the last reference is
+ * unloaded. The id and path fields point at the registry's copy of the
+ * resolved path and stay valid until the descriptor is unloaded.
+ *
  * @param path      Path to the dynamic library file.
  * @param out_lib   Pointer to library descriptor (will be populated).
  * @return          true if library loaded successfully, false otherwise.
@@ -76,6 +121,66 @@ bool fossil_sys_dynamic_load(
     const char *path,
     fossil_sys_dynamic_lib_t *out_lib);
 
+/**
+ * @brief Load a dynamic library with explicit loader options.
+ *
+ * Like fossil_sys_dynamic_load, which is this call with
+ * FOSSIL_SYS_DYNAMIC_NOW in the default namespace. LAZY defers binding
+ * to first use, which shortens startup for large libraries. GLOBAL,
+ * NODELETE and DEEPBIND map to the RTLD_ flags of the same names.
+ * A namespace other than the default loads with dlmopen; NEW creates
+ * one, and fossil_sys_dynamic_namespace reports it so later loads can
+ * join it. Reloading an already loaded library with stronger flags
+ * (GLOBAL, NODELETE, or NOW after LAZY) promotes it in place.
+ *
+ * Options the platform lacks fail the load with an error message:
+ * namespaces and DEEPBIND need glibc; on Windows LAZY and GLOBAL are
+ * accepted and have no effect, and NODELETE pins the module.
+ *
+ * @param path      Path to the dynamic library file.
+ * @param flags     FOSSIL_SYS_DYNAMIC_* flags.
+ * @param ns        FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT, _NEW, or an id
+ *                  returned by fossil_sys_dynamic_namespace.
+ * @param out_lib   Pointer to library descriptor (will be populated).
+ * @return          true if library loaded successfully, false otherwise.
+ */
+bool fossil_sys_dynamic_load_ex(
+    const char *path,
+    unsigned flags,
+    long ns,
+    fossil_sys_dynamic_lib_t *out_lib);
+
+/**
+ * @brief Load several libraries concurrently.
+ *
+ * Spreads the paths over worker threads (the caller included). Each
+ * worker reads its file ahead before loading it, so disk and page-cache
+ * work overlaps even where the loader serializes mapping internally.
+ * Every descriptor is written: status 1 if loaded, zeroed otherwise.
+ *
+ * @param paths     Library paths.
+ * @param count     Number of paths and descriptors.
+ * @param flags     FOSSIL_SYS_DYNAMIC_* flags applied to every load.
+ * @param threads   Worker count, 0 for the effective CPU count.
+ * @param out_libs  Array of count descriptors.
+ * @return          Number of libraries loaded.
+ */
+size_t fossil_sys_dynamic_preload(
+    const char *const *paths,
+    size_t count,
+    unsigned flags,
+    size_t threads,
+    fossil_sys_dynamic_lib_t *out_libs);
+
+/**
+ * @brief Link-map namespace a library was loaded into.
+ *
+ * @param lib   Pointer to loaded library descriptor.
+ * @return      Namespace id (0 is the default), or -1 if not loaded.
+ */
+long fossil_sys_dynamic_namespace(
+    const fossil_sys_dynamic_lib_t *lib);
+
 /**
  * @brief Unload a previously loaded dynamic library.
  *
@@ -98,6 +203,8 @@ bool fossil_sys_dynamic_unload(
  * Looks up a symbol by name and returns its address. The caller must
  * cast the returned pointer to the appropriate function signature.
  * Returns NULL if the symbol is not found or library is not loaded.
+ * Resolved symbols are cached per library, so repeated lookups of the
+ * same name skip the platform loader. The cache is thread-safe.
  *
  * @param lib           Pointer to loaded library descriptor.
  * @param symbol_name   Name of the symbol to resolve.
@@ -107,10 +214,62 @@ void *fossil_sys_dynamic_symbol(
     fossil_sys_dynamic_lib_t *lib,
     const char *symbol_name);
 
+/**
+ * @brief Resolve a table of symbols in one pass.
+ *
+ * Stores each symbol address in its slot. Unresolved slots are set to
+ * NULL and the error message names the first missing symbol. Resolved
+ * symbols enter the cache.
+ *
+ * Slots are void * objects. Do not point a slot at a function pointer
+ * through (void **)&fn: that writes a function pointer object through a
+ * data pointer type, which is undefined behavior. Bind into a void *
+ * and convert afterwards:
+ *
+ *     void *sym = NULL;
+ *     fossil_sys_dynamic_binding_t table[] = {{"cos", &sym}};
+ *     double (*fn)(double) = NULL;
+ *     if (fossil_sys_dynamic_bind(&lib, table, 1))
+ *         memcpy(&fn, &sym, sizeof(fn)); // or fn = (double (*)(double))sym on POSIX
+ *
+ * @param lib       Pointer to loaded library descriptor.
+ * @param bindings  Table of {name, slot} pairs.
+ * @param count     Number of entries in the table.
+ * @return          true if every symbol resolved, false otherwise.
+ */
+bool fossil_sys_dynamic_bind(
+    fossil_sys_dynamic_lib_t *lib,
+    const fossil_sys_dynamic_binding_t *bindings,
+    size_t count);
+
 /* ------------------------------------------------------
     * Introspection / diagnostics
     * ----------------------------------------------------- */
 
+/**
+ * @brief Enumerate the modules mapped into the process.
+ *
+ * Walks the loader's module list (dl_iterate_phdr on Linux and the BSDs,
+ * dyld on macOS, Toolhelp on Windows) and reports each module with the
+ * number of references held on it through this registry. The callback
+ * must not load or unload libraries.
+ *
+ * @param cb        Visitor invoked for each module.
+ * @param user_data User pointer passed to the visitor.
+ * @return          Number of modules visited, -1 on invalid arguments,
+ *                  -2 if unsupported, -3 on failure.
+ */
+int fossil_sys_dynamic_enumerate(
+    fossil_sys_dynamic_module_cb cb,
+    void *user_data);
+
+/**
+ * @brief Number of distinct libraries held by the registry.
+ *
+ * @return  Library count.
+ */
+size_t fossil_sys_dynamic_registry_count(void);
+
 /**
  * @brief Check whether a library is currently loaded.
  *
@@ -128,7 +287,7 @@ bool fossil_sys_dynamic_is_loaded(
  *
  * Returns a platform-specific error string describing the most recent
  * load, unload, or symbol resolution failure. Message is valid until
- * the next dynamic library operation.
+ * the next dynamic library operation on the same thread.
  *
  * @return  Error message string, or empty string if no error occurred.
  */
@@ -137,6 +296,11 @@ const char *fossil_sys_dynamic_error(void);
 #ifdef __cplusplus
 }
 
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace fossil::sys
 {
 
@@ -247,6 +411,7 @@ namespace fossil::sys
             loaded_ = other.loaded_;
 
             other.lib_.handle = nullptr;
+            other.lib_.cache = nullptr;
             other.loaded_ = false;
         }
 
@@ -271,6 +436,7 @@ namespace fossil::sys
                 loaded_ = other.loaded_;
 
                 other.lib_.handle = nullptr;
+                other.lib_.cache = nullptr;
                 other.loaded_ = false;
             }
             return *this;
@@ -301,6 +467,56 @@ namespace fossil::sys
             return true;
         }
 
+        /**
+         * @brief Load a dynamic library with explicit loader options.
+         *
+         * @param path Path to the dynamic library file.
+         * @param flags FOSSIL_SYS_DYNAMIC_* flags.
+         * @param ns Link-map namespace (see fossil_sys_dynamic_load_ex).
+         * @return true if the library was loaded successfully, false otherwise.
+         */
+        bool load(const char *path, unsigned flags, long ns = FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT)
+        {
+            if (loaded_)
+                return false; /* already loaded */
+            if (!validate_path(path))
+                return false;
+
+            lib_.path = path;
+
+            if (!fossil_sys_dynamic_load_ex(path, flags, ns, &lib_))
+                return false;
+
+            loaded_ = true;
+            return true;
+        }
+
+        /**
+         * @brief Load several libraries concurrently.
+         *
+         * @param paths Library paths.
+         * @param flags FOSSIL_SYS_DYNAMIC_* flags applied to every load.
+         * @param threads Worker count, 0 for the effective CPU count.
+         * @return One object per path, unloaded where loading failed.
+         */
+        static std::vector<Dynamic> preload(const std::vector<std::string> &paths, unsigned flags = 0,
+                                            size_t threads = 0)
+        {
+            std::vector<const char *> names;
+            for (const auto &path : paths)
+                names.push_back(validate_path(path.c_str()) ? path.c_str() : nullptr);
+            std::vector<fossil_sys_dynamic_lib_t> libs(paths.size());
+            fossil_sys_dynamic_preload(names.data(), names.size(), flags, threads, libs.data());
+
+            std::vector<Dynamic> out(paths.size());
+            for (size_t i = 0; i < libs.size(); ++i)
+            {
+                out[i].lib_ = libs[i];
+                out[i].loaded_ = libs[i].status == 1;
+            }
+            return out;
+        }
+
         /**
          * @brief Unload the currently loaded dynamic library.
          *
@@ -337,6 +553,54 @@ namespace fossil::sys
             return fossil_sys_dynamic_symbol(&lib_, name);
         }
 
+        /**
+         * @brief Resolve a symbol as a typed function pointer.
+         *
+         * Resolve once (typically right after load) and keep the pointer;
+         * calls through it are then plain indirect calls.
+         *
+         * @tparam Sig Function type, e.g. int(int, int).
+         * @param name Name of the symbol to look up.
+         * @return Function pointer, or nullptr if not found or not loaded.
+         */
+        template <typename Sig>
+        Sig *bind(const char *name)
+        {
+            void *sym = symbol(name);
+            Sig *fn = nullptr;
+            static_assert(sizeof(fn) == sizeof(sym), "function and data pointers differ in size");
+            memcpy(&fn, &sym, sizeof(fn));
+            return fn;
+        }
+
+        /**
+         * @brief Resolve a symbol into a typed function pointer slot.
+         *
+         * @param name Name of the symbol to look up.
+         * @param slot Receives the function pointer, nullptr if not found.
+         * @return true if the symbol was resolved, false otherwise.
+         */
+        template <typename Sig>
+        bool bind(const char *name, Sig *&slot)
+        {
+            slot = bind<Sig>(name);
+            return slot != nullptr;
+        }
+
+        /**
+         * @brief Resolve a table of symbols in one pass.
+         *
+         * @param bindings Table of {name, slot} pairs.
+         * @param count Number of entries in the table.
+         * @return true if every symbol resolved, false otherwise.
+         */
+        bool bind_all(const fossil_sys_dynamic_binding_t *bindings, size_t count)
+        {
+            if (!loaded_)
+                return false;
+            return fossil_sys_dynamic_bind(&lib_, bindings, count);
+        }
+
         /**
          * @brief Check if a library is currently loaded.
          *
@@ -357,6 +621,30 @@ namespace fossil::sys
             return fossil_sys_dynamic_error();
         }
 
+        /**
+         * @brief Enumerate the modules mapped into the process.
+         *
+         * @param cb Visitor; return false to stop.
+         * @return Number of modules visited, or a negative error code.
+         */
+        static int enumerate(const std::function<bool(const fossil_sys_dynamic_module_t &)> &cb)
+        {
+            struct Wrapper
+            {
+                static int trampoline(const fossil_sys_dynamic_module_t *module, void *user_data)
+                {
+                    auto *func = static_cast<const std::function<bool(const fossil_sys_dynamic_module_t &)> *>(user_data);
+                    return (*func)(*module) ? 0 : 1;
+                }
+            };
+            return fossil_sys_dynamic_enumerate(&Wrapper::trampoline, (void *)&cb);
+        }
+
+        /**
+         * @brief Number of distinct libraries held by the registry.
+         */
+        static size_t registry_count() { return fossil_sys_dynamic_registry_count(); }
+
         /**
          * @brief Get a const pointer to the underlying library descriptor.
          *
@@ -25,6 +25,9 @@
 #ifndef FOSSIL_SYS_ENV_H
 #define FOSSIL_SYS_ENV_H
 
+#include <stdint.h>
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -65,10 +68,18 @@ CANONICAL STRING IDS
     Example: "x86_64", "arm64"
 
 "fossil.sys.page_size"
-    Memory page size (bytes, integer string)
+    Memory page size (bytes, integer string; computed once)
 
 "fossil.sys.cpu_count"
-    Number of logical CPUs (integer string)
+    Number of logical CPUs (integer string; computed once)
+
+"fossil.sys.cpu_effective"
+    CPUs this process can use after affinity and container (cgroup / job
+    object) quotas; size thread pools from this (integer string)
+
+"fossil.sys.memory_effective"
+    Memory available to this process in bytes: physical memory or the
+    container memory limit, whichever is lower (integer string)
 
 "fossil.sys.path"
     System PATH equivalent (normalized)
@@ -146,6 +157,10 @@ NOTES
     - embedded/static configuration
 - Keys are case-sensitive.
 - This is NOT a registry or config system—only a flat key/value interface.
+- Canonical keys resolve in constant time; other keys go to the OS
+  environment, or to the snapshot when one is enabled.
+- Without the snapshot, get/set have getenv/setenv thread-safety: do not
+  call fossil_sys_env_set while other threads read the environment.
 
 ===============================================================================
 */
@@ -153,11 +168,27 @@ NOTES
 /**
  * Retrieve the value of an environment variable by key.
  *
+ * As with getenv, the pointer is only valid until the key is next set or
+ * unset. Use fossil_sys_env_get_copy where another thread may set it.
+ *
  * @param key The name of the environment variable to retrieve.
  * @return Pointer to the value string if found, or NULL if not set.
  */
 const char *fossil_sys_env_get(const char *key);
 
+/**
+ * Copy the value of an environment variable into a caller buffer.
+ *
+ * With the snapshot enabled the copy is taken while the version is pinned,
+ * so it is safe against concurrent fossil_sys_env_set calls.
+ *
+ * @param key The name of the environment variable to retrieve.
+ * @param buf Destination, always NUL-terminated when size > 0.
+ * @param size Size of buf; 0 to query the length only.
+ * @return Length of the value (truncated if >= size), or -1 if not set.
+ */
+int fossil_sys_env_get_copy(const char *key, char *buf, size_t size);
+
 /**
  * Set the value of an environment variable.
  *
@@ -205,6 +236,21 @@ int fossil_sys_env_get_int(const char *key,
 int fossil_sys_env_get_bool(const char *key,
                          int default_value);
 
+/**
+ * Retrieve the value of an environment variable as an unsigned 64-bit integer.
+ *
+ * The numeric canonical keys (fossil.sys.page_size, fossil.sys.cpu_count,
+ * fossil.sys.cpu_effective, fossil.sys.memory_effective) are returned
+ * directly without formatting; page size and CPU count are computed once.
+ *
+ * @param key The name of the environment variable to retrieve.
+ * @param default_value The value to return if the variable is not set or not
+ *                      a non-negative decimal integer.
+ * @return The integer value of the variable, or default_value.
+ */
+uint64_t fossil_sys_env_get_u64(const char *key,
+                             uint64_t default_value);
+
 /**
  * Callback type for iterating over environment variables.
  *
@@ -226,9 +272,186 @@ typedef int (*fossil_sys_env_iter_cb)(
  */
 void fossil_sys_env_foreach(fossil_sys_env_iter_cb cb, void* user_data);
 
+/**
+ * Callback type for zero-copy iteration. key and value point directly into
+ * the environment (or the snapshot) and are not NUL-terminated at the
+ * given lengths; they are only valid during the callback.
+ *
+ * @param key Start of the variable name.
+ * @param key_len Length of the name.
+ * @param value Start of the value.
+ * @param value_len Length of the value.
+ * @param user_data User-defined data pointer passed to the callback.
+ * @return 0 to continue, non-zero to stop.
+ */
+typedef int (*fossil_sys_env_view_cb)(
+    const char* key,
+    size_t key_len,
+    const char* value,
+    size_t value_len,
+    void* user_data);
+
+/**
+ * Iterate over all environment variables without copying them.
+ *
+ * @param cb The callback function to invoke for each environment variable.
+ * @param user_data User-defined data pointer passed to the callback.
+ * @return The non-zero value that stopped the iteration, or 0.
+ */
+int fossil_sys_env_foreach_view(fossil_sys_env_view_cb cb, void* user_data);
+
+/**
+ * Iterate without copying over the variables whose name starts with prefix
+ * (for example "fossil.app."). A dotted prefix also matches its
+ * environment form ("FOSSIL_APP_"), so canonical keys stored under their
+ * mapped variable are found too. Names are compared case-insensitively on
+ * Windows, like the environment itself.
+ *
+ * @param prefix Name prefix, or NULL/"" for all variables.
+ * @param cb The callback function to invoke for each matching variable.
+ * @param user_data User-defined data pointer passed to the callback.
+ * @return The non-zero value that stopped the iteration, or 0.
+ */
+int fossil_sys_env_foreach_prefix(const char* prefix, fossil_sys_env_view_cb cb, void* user_data);
+
+/**
+ * Switch lookups to a thread-safe snapshot of the process environment.
+ *
+ * The snapshot is a versioned hash table copied from environ. Readers
+ * (get, exists, foreach) take no lock and never see a partial update;
+ * fossil_sys_env_set publishes a new version instead of modifying the
+ * process environment, so concurrent set and get are safe. A value
+ * replaced by a set is freed once no reader can still see it, so threads
+ * that read keys others set should use fossil_sys_env_get_copy.
+ *
+ * Calling this again rebuilds the snapshot from environ, dropping
+ * values that were set without mirroring.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int fossil_sys_env_snapshot_enable(void);
+
+/**
+ * Release the snapshot and return to live environment lookups. Never
+ * waits for readers: versions still in use are freed by a later enable.
+ * Pointers previously returned from the snapshot become invalid.
+ */
+void fossil_sys_env_snapshot_disable(void);
+
+/**
+ * Check whether lookups are served from the snapshot.
+ *
+ * @return 1 if enabled, 0 otherwise.
+ */
+int fossil_sys_env_snapshot_enabled(void);
+
+/**
+ * Version of the published snapshot, incremented by every change.
+ *
+ * @return The version, or 0 if the snapshot is disabled.
+ */
+uint64_t fossil_sys_env_snapshot_version(void);
+
+/**
+ * Also apply snapshot changes to the real process environment so child
+ * processes inherit them. Off by default: writing environ is exactly the
+ * setenv/getenv race the snapshot avoids, so enable it only when no other
+ * code reads environ concurrently.
+ *
+ * @param enable Non-zero to mirror, zero to keep changes in the snapshot.
+ */
+void fossil_sys_env_snapshot_mirror(int enable);
+
+/**
+ * Environment block for spawning child processes.
+ *
+ * A block starts from a copy of the current environment (or empty), takes
+ * sets and unsets, and materializes as a NULL-terminated envp array whose
+ * pointers and strings live in a single allocation. Materialized images are
+ * immutable and shared: cloning a block or spawning repeatedly from one
+ * block costs no copying, and an edit only builds a new image the next
+ * time envp is requested (copy-on-write).
+ *
+ * A block is not thread-safe; give each thread its own clone.
+ */
+typedef struct fossil_sys_env_block fossil_sys_env_block_t;
+
+/**
+ * Create an environment block.
+ *
+ * @param inherit Non-zero to start from the current environment (the
+ *                snapshot when enabled), zero to start empty.
+ * @return The block, or NULL on allocation failure.
+ */
+fossil_sys_env_block_t *fossil_sys_env_block_create(int inherit);
+
+/**
+ * Clone a block. The clone shares the materialized image with the
+ * original until either one is modified.
+ *
+ * @param block The block to clone.
+ * @return The clone, or NULL on failure.
+ */
+fossil_sys_env_block_t *fossil_sys_env_block_clone(const fossil_sys_env_block_t *block);
+
+/**
+ * Free a block. Arrays returned by fossil_sys_env_block_envp become invalid.
+ *
+ * @param block The block to free (may be NULL).
+ */
+void fossil_sys_env_block_free(fossil_sys_env_block_t *block);
+
+/**
+ * Add or override a variable in the block.
+ *
+ * @param block The block.
+ * @param key Variable name (must not contain '=').
+ * @param value Value, or NULL to remove the variable.
+ * @return 0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_sys_env_block_set(fossil_sys_env_block_t *block, const char *key, const char *value);
+
+/**
+ * Remove a variable from the block.
+ *
+ * @param block The block.
+ * @param key Variable name.
+ * @return 0 on success, -1 on invalid arguments, -3 on allocation failure.
+ */
+int fossil_sys_env_block_unset(fossil_sys_env_block_t *block, const char *key);
+
+/**
+ * Look up a variable in the block, pending edits included.
+ *
+ * @param block The block.
+ * @param key Variable name.
+ * @return The value, or NULL if not present. Valid until the block is
+ *         modified or freed.
+ */
+const char *fossil_sys_env_block_get(const fossil_sys_env_block_t *block, const char *key);
+
+/**
+ * Materialize the block as an envp array for fossil_sys_process_spawn.
+ * Without pending edits this returns the current image unchanged.
+ *
+ * @param block The block.
+ * @return NULL-terminated array valid until the block is next modified and
+ *         materialized, or freed; NULL on allocation failure.
+ */
+char *const *fossil_sys_env_block_envp(fossil_sys_env_block_t *block);
+
+/**
+ * Number of variables in the block (materializes pending edits).
+ *
+ * @param block The block.
+ * @return The variable count, or 0 on failure.
+ */
+size_t fossil_sys_env_block_count(fossil_sys_env_block_t *block);
+
 #ifdef __cplusplus
 }
 #include <string>
+#include <string_view>
 #include <functional>
 
 namespace fossil::sys {
@@ -244,8 +467,9 @@ namespace fossil::sys {
          * @return The value as a std::string, or empty if not found.
          */
         static std::string get(const std::string& key) {
-            const char* val = fossil_sys_env_get(key.c_str());
-            return val ? std::string(val) : std::string();
+            std::string value;
+            copy(key, value);
+            return value;
         }
 
         /**
@@ -277,8 +501,8 @@ namespace fossil::sys {
          * @return The value as a std::string, or the fallback if not found.
          */
         static std::string get_or(const std::string& key, const std::string& fallback) {
-            const char* val = fossil_sys_env_get_or(key.c_str(), fallback.c_str());
-            return val ? std::string(val) : fallback;
+            std::string value;
+            return copy(key, value) ? value : fallback;
         }
 
         /**
@@ -303,6 +527,17 @@ namespace fossil::sys {
             return fossil_sys_env_get_bool(key.c_str(), default_value ? 1 : 0) == 1;
         }
 
+        /**
+         * Retrieve the value of an environment variable as an unsigned 64-bit integer.
+         *
+         * @param key The environment variable key.
+         * @param default_value The value to return if not set or invalid.
+         * @return The integer value, or default_value if not set or invalid.
+         */
+        static uint64_t get_u64(const std::string& key, uint64_t default_value) {
+            return fossil_sys_env_get_u64(key.c_str(), default_value);
+        }
+
         /**
          * Type alias for the iteration callback function.
          * The callback receives the key and value as std::string.
@@ -323,6 +558,128 @@ namespace fossil::sys {
             };
             fossil_sys_env_foreach(&Wrapper::trampoline, (void*)&cb);
         }
+
+        using view_callback = std::function<bool(std::string_view, std::string_view)>;
+
+        /**
+         * Iterate without copying over variables whose name starts with
+         * prefix. The views are only valid during the callback.
+         *
+         * @param prefix Name prefix, empty for all variables.
+         * @param cb Callback; return false to stop.
+         * @return true if the iteration was stopped by the callback.
+         */
+        static bool foreach_prefix(const std::string& prefix, const view_callback& cb) {
+            struct Wrapper {
+            static int trampoline(const char* key, size_t key_len, const char* value, size_t value_len, void* user_data) {
+                auto* func = static_cast<const view_callback*>(user_data);
+                return (*func)(std::string_view(key, key_len), std::string_view(value, value_len)) ? 0 : 1;
+            }
+            };
+            return fossil_sys_env_foreach_prefix(prefix.c_str(), &Wrapper::trampoline, (void*)&cb) != 0;
+        }
+
+        /**
+         * Build (or rebuild) the thread-safe environment snapshot.
+         *
+         * @param mirror Also apply changes to the real process environment.
+         * @return true on success, false on allocation failure.
+         */
+        static bool snapshot_enable(bool mirror = false) {
+            fossil_sys_env_snapshot_mirror(mirror ? 1 : 0);
+            return fossil_sys_env_snapshot_enable() == 0;
+        }
+
+        /**
+         * Release the snapshot and return to live environment lookups.
+         */
+        static void snapshot_disable() {
+            fossil_sys_env_snapshot_disable();
+        }
+
+    private:
+        // Copies the value, retrying if a concurrent set made it longer
+        static bool copy(const std::string& key, std::string& out) {
+            char small[256];
+            int len = fossil_sys_env_get_copy(key.c_str(), small, sizeof(small));
+            if (len >= 0 && static_cast<size_t>(len) < sizeof(small)) {
+                out.assign(small, static_cast<size_t>(len));
+                return true;
+            }
+            while (len >= 0) {
+                out.resize(static_cast<size_t>(len));
+                int again = fossil_sys_env_get_copy(key.c_str(), out.data(), out.size() + 1);
+                if (again >= 0 && again <= len) {
+                    out.resize(static_cast<size_t>(again));
+                    return true;
+                }
+                len = again;
+            }
+            out.clear();
+            return false;
+        }
+    };
+
+    /**
+     * RAII wrapper over fossil_sys_env_block_t. Copies share the
+     * materialized image until one of them is modified.
+     */
+    class EnvBlock
+    {
+    public:
+        explicit EnvBlock(bool inherit = true) : block_(fossil_sys_env_block_create(inherit ? 1 : 0)) {}
+        EnvBlock(const EnvBlock& other) : block_(fossil_sys_env_block_clone(other.block_)) {}
+        EnvBlock(EnvBlock&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+        EnvBlock& operator=(EnvBlock other) noexcept {
+            fossil_sys_env_block_t* tmp = block_;
+            block_ = other.block_;
+            other.block_ = tmp;
+            return *this;
+        }
+        ~EnvBlock() { fossil_sys_env_block_free(block_); }
+
+        /**
+         * Add or override a variable.
+         *
+         * @return true on success, false otherwise.
+         */
+        bool set(const std::string& key, const std::string& value) {
+            return fossil_sys_env_block_set(block_, key.c_str(), value.c_str()) == 0;
+        }
+
+        /**
+         * Remove a variable.
+         *
+         * @return true on success, false otherwise.
+         */
+        bool unset(const std::string& key) {
+            return fossil_sys_env_block_unset(block_, key.c_str()) == 0;
+        }
+
+        /**
+         * Look up a variable, or an empty string if not present.
+         */
+        std::string get(const std::string& key) const {
+            const char* value = fossil_sys_env_block_get(block_, key.c_str());
+            return value ? std::string(value) : std::string();
+        }
+
+        /**
+         * Materialize the block as an envp array.
+         */
+        char* const* envp() {
+            return fossil_sys_env_block_envp(block_);
+        }
+
+        /**
+         * Number of variables in the block.
+         */
+        size_t size() {
+            return fossil_sys_env_block_count(block_);
+        }
+
+    private:
+        fossil_sys_env_block_t* block_;
     };
 
 } // namespace fossil::sys
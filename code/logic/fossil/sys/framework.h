@@ -34,5 +34,7 @@
 #include "memory.h"
 #include "event.h"
 #include "env.h"
+#include "config.h"
+#include "plugin.h"
 
 #endif /* FOSSIL_SYS_FRAMEWORK_H */
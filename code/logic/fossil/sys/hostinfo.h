@@ -29,6 +29,10 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -113,8 +117,57 @@ typedef struct
     char driver_version[64];
     uint64_t memory_total;
     uint64_t memory_free;
+    uint32_t vendor_id;  // PCI vendor id, 0 if unknown
+    uint32_t device_id;  // PCI device id, 0 if unknown
+    char bus_id[32];     // e.g. "0000:01:00.0", or "drm:<device>" for non-PCI GPUs
+    char driver[64];     // kernel driver name, empty if unbound
+    int drm_card;        // /dev/dri/cardN index, -1 if none
+    int is_primary;      // 1 if this is the boot/primary display adapter
 } fossil_sys_hostinfo_gpu_t;
 
+/**
+ * GPU list container
+ */
+#define FOSSIL_SYS_HOSTINFO_GPU_MAX 16
+typedef struct
+{
+    size_t count;
+    fossil_sys_hostinfo_gpu_t list[FOSSIL_SYS_HOSTINFO_GPU_MAX];
+} fossil_sys_hostinfo_gpu_list_t;
+
+/**
+ * One mounted filesystem with its capacity.
+ */
+typedef struct
+{
+    char device[128];          // mount source, e.g. "/dev/nvme0n1p2"
+    char mount_point[256];
+    char filesystem_type[64];
+    char options[128];         // per-mount options, e.g. "rw,relatime"
+    uint32_t major;            // device number of the mounted filesystem
+    uint32_t minor;
+    char block_device[32];     // backing whole disk in /sys/block, empty if none
+    int read_only;             // 1 if mounted read-only
+    int is_network;            // 1 for NFS, SMB etc.; capacity left at 0, see get_mount_space
+    uint32_t block_size;       // filesystem fragment size in bytes
+    uint64_t total_space;      // in bytes
+    uint64_t free_space;       // in bytes, including reserved blocks
+    uint64_t available_space;  // in bytes, available to unprivileged users
+    uint64_t used_space;       // in bytes
+    uint64_t total_inodes;
+    uint64_t free_inodes;
+} fossil_sys_hostinfo_mount_t;
+
+/**
+ * Mount list container
+ */
+#define FOSSIL_SYS_HOSTINFO_MOUNT_MAX 128
+typedef struct
+{
+    size_t count;
+    fossil_sys_hostinfo_mount_t list[FOSSIL_SYS_HOSTINFO_MOUNT_MAX];
+} fossil_sys_hostinfo_mount_list_t;
+
 /**
  * Storage information structure
  */
@@ -205,6 +258,682 @@ typedef struct
     int primary_refresh_rate;
 } fossil_sys_hostinfo_display_t;
 
+/**
+ * CPU topology limits
+ */
+#define FOSSIL_SYS_HOSTINFO_CPU_MAX 512
+#define FOSSIL_SYS_HOSTINFO_CACHE_MAX 1024
+#define FOSSIL_SYS_HOSTINFO_CPU_CACHE_MAX 8
+#define FOSSIL_SYS_HOSTINFO_NUMA_MAX 64
+
+/**
+ * Set of logical CPUs, one bit per CPU id.
+ */
+typedef struct
+{
+    uint64_t bits[FOSSIL_SYS_HOSTINFO_CPU_MAX / 64];
+} fossil_sys_hostinfo_cpuset_t;
+
+/**
+ * Cache type as reported by the platform.
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_CACHE_UNIFIED,
+    FOSSIL_SYS_HOSTINFO_CACHE_DATA,
+    FOSSIL_SYS_HOSTINFO_CACHE_INSTRUCTION
+} fossil_sys_hostinfo_cache_type_t;
+
+/**
+ * One physical cache instance and the CPUs sharing it.
+ */
+typedef struct
+{
+    int level;                             // 1, 2, 3, ...
+    fossil_sys_hostinfo_cache_type_t type; // data / instruction / unified
+    uint64_t size_bytes;                   // total size in bytes
+    int line_size;                         // coherency line size in bytes
+    int ways;                              // associativity, 0 if unknown
+    int sets;                              // number of sets, 0 if unknown
+    fossil_sys_hostinfo_cpuset_t shared_cpus;
+} fossil_sys_hostinfo_cache_t;
+
+/**
+ * Placement of a single hardware thread (logical CPU).
+ */
+typedef struct
+{
+    int cpu;         // logical CPU id
+    int online;      // 1 if online
+    int package_id;  // physical socket
+    int die_id;      // die within package, 0 if not reported
+    int core_id;     // core within die
+    int thread_id;   // SMT index within core
+    int numa_node;   // NUMA node, -1 if unknown
+    fossil_sys_hostinfo_cpuset_t smt_siblings;
+    int cache_count; // entries used in cache_index
+    int cache_index[FOSSIL_SYS_HOSTINFO_CPU_CACHE_MAX]; // indexes into topology caches
+} fossil_sys_hostinfo_cpu_thread_t;
+
+/**
+ * NUMA node with its CPUs and distance vector.
+ */
+typedef struct
+{
+    int node_id;
+    uint64_t memory_total; // in bytes, 0 if unknown
+    fossil_sys_hostinfo_cpuset_t cpus;
+    int distance_count;
+    int distance[FOSSIL_SYS_HOSTINFO_NUMA_MAX]; // distance to node index i
+} fossil_sys_hostinfo_numa_node_t;
+
+/**
+ * Full CPU topology: package -> die -> core -> hardware thread,
+ * caches and NUMA nodes.
+ */
+typedef struct
+{
+    int cpu_count;     // entries used in cpus
+    int package_count; // distinct packages
+    int die_count;     // distinct (package, die) pairs
+    int core_count;    // distinct (package, die, core) triples
+    int cache_count;   // entries used in caches
+    int numa_count;    // entries used in numa
+    fossil_sys_hostinfo_cpu_thread_t cpus[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    fossil_sys_hostinfo_cache_t caches[FOSSIL_SYS_HOSTINFO_CACHE_MAX];
+    fossil_sys_hostinfo_numa_node_t numa[FOSSIL_SYS_HOSTINFO_NUMA_MAX];
+} fossil_sys_hostinfo_topology_t;
+
+/**
+ * Hostinfo sections, usable as a bit mask.
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM = 1u << 0,
+    FOSSIL_SYS_HOSTINFO_SECTION_ARCHITECTURE = 1u << 1,
+    FOSSIL_SYS_HOSTINFO_SECTION_MEMORY = 1u << 2,
+    FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS = 1u << 3,
+    FOSSIL_SYS_HOSTINFO_SECTION_POWER = 1u << 4,
+    FOSSIL_SYS_HOSTINFO_SECTION_CPU = 1u << 5,
+    FOSSIL_SYS_HOSTINFO_SECTION_GPU = 1u << 6,
+    FOSSIL_SYS_HOSTINFO_SECTION_STORAGE = 1u << 7,
+    FOSSIL_SYS_HOSTINFO_SECTION_ENVIRONMENT = 1u << 8,
+    FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION = 1u << 9,
+    FOSSIL_SYS_HOSTINFO_SECTION_UPTIME = 1u << 10,
+    FOSSIL_SYS_HOSTINFO_SECTION_NETWORK = 1u << 11,
+    FOSSIL_SYS_HOSTINFO_SECTION_PROCESS = 1u << 12,
+    FOSSIL_SYS_HOSTINFO_SECTION_LIMITS = 1u << 13,
+    FOSSIL_SYS_HOSTINFO_SECTION_TIME = 1u << 14,
+    FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE = 1u << 15,
+    FOSSIL_SYS_HOSTINFO_SECTION_DISPLAY = 1u << 16,
+    FOSSIL_SYS_HOSTINFO_SECTION_ALL = (1u << 17) - 1
+} fossil_sys_hostinfo_section_t;
+
+/**
+ * Facts that never change while the process runs. Each section is
+ * collected at most once and is read-only afterwards.
+ */
+typedef struct
+{
+    fossil_sys_hostinfo_system_t system;
+    fossil_sys_hostinfo_architecture_t architecture;
+    fossil_sys_hostinfo_cpu_t cpu;
+    fossil_sys_hostinfo_gpu_t gpu;
+    fossil_sys_hostinfo_endianness_t endianness;
+    fossil_sys_hostinfo_hardware_t hardware;
+    fossil_sys_hostinfo_virtualization_t virtualization;
+} fossil_sys_hostinfo_static_t;
+
+/**
+ * Facts that change over time, refreshed when older than the snapshot TTL.
+ */
+typedef struct
+{
+    uint64_t generation; // incremented on every refresh
+    fossil_sys_hostinfo_memory_t memory;
+    fossil_sys_hostinfo_uptime_t uptime;
+    fossil_sys_hostinfo_power_t power;
+    fossil_sys_hostinfo_storage_t storage;
+    fossil_sys_hostinfo_network_t network;
+} fossil_sys_hostinfo_volatile_t;
+
+#define FOSSIL_SYS_HOSTINFO_STATIC_SECTIONS                                        \
+    (FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM | FOSSIL_SYS_HOSTINFO_SECTION_ARCHITECTURE | \
+     FOSSIL_SYS_HOSTINFO_SECTION_CPU | FOSSIL_SYS_HOSTINFO_SECTION_GPU |             \
+     FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS | FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE | \
+     FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION)
+
+#define FOSSIL_SYS_HOSTINFO_VOLATILE_SECTIONS                                   \
+    (FOSSIL_SYS_HOSTINFO_SECTION_MEMORY | FOSSIL_SYS_HOSTINFO_SECTION_UPTIME |  \
+     FOSSIL_SYS_HOSTINFO_SECTION_POWER | FOSSIL_SYS_HOSTINFO_SECTION_STORAGE | \
+     FOSSIL_SYS_HOSTINFO_SECTION_NETWORK)
+
+#define FOSSIL_SYS_HOSTINFO_SNAPSHOT_TTL_MS 1000
+
+/**
+ * Every hostinfo section gathered by fossil_sys_hostinfo_collect_all.
+ * Only members whose bit is set in `valid` hold collected data.
+ */
+typedef struct
+{
+    uint32_t requested;      // fossil_sys_hostinfo_section_t mask passed in
+    uint32_t valid;          // sections collected successfully
+    uint64_t collected_at;   // seconds since Unix epoch
+    fossil_sys_hostinfo_system_t system;
+    fossil_sys_hostinfo_architecture_t architecture;
+    fossil_sys_hostinfo_memory_t memory;
+    fossil_sys_hostinfo_endianness_t endianness;
+    fossil_sys_hostinfo_power_t power;
+    fossil_sys_hostinfo_cpu_t cpu;
+    fossil_sys_hostinfo_gpu_t gpu;
+    fossil_sys_hostinfo_storage_t storage;
+    fossil_sys_hostinfo_environment_t environment;
+    fossil_sys_hostinfo_virtualization_t virtualization;
+    fossil_sys_hostinfo_uptime_t uptime;
+    fossil_sys_hostinfo_network_t network;
+    fossil_sys_hostinfo_process_t process;
+    fossil_sys_hostinfo_limits_t limits;
+    fossil_sys_hostinfo_time_t time;
+    fossil_sys_hostinfo_hardware_t hardware;
+    fossil_sys_hostinfo_display_t display;
+} fossil_sys_hostinfo_all_t;
+
+/**
+ * Sections that touch many files, spawn tools or query drivers; collected
+ * on worker threads by fossil_sys_hostinfo_collect_all.
+ */
+#define FOSSIL_SYS_HOSTINFO_SLOW_SECTIONS                                      \
+    (FOSSIL_SYS_HOSTINFO_SECTION_GPU | FOSSIL_SYS_HOSTINFO_SECTION_DISPLAY |     \
+     FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE | FOSSIL_SYS_HOSTINFO_SECTION_STORAGE | \
+     FOSSIL_SYS_HOSTINFO_SECTION_NETWORK | FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION)
+
+/* First bytes of the binary export, followed by a format version byte. */
+#define FOSSIL_SYS_HOSTINFO_BINARY_MAGIC "FSHI"
+#define FOSSIL_SYS_HOSTINFO_BINARY_VERSION 1
+
+/**
+ * Instruction set features detected from CPUID (x86) or the auxiliary
+ * vector / sysctl (ARM). FOSSIL_SYS_HOSTINFO_FEATURE_NONE is never set and
+ * terminates requirement lists.
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_FEATURE_NONE = 0,
+
+    // x86 / x86-64
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSE,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSE2,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSE3,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSSE3,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSE41,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SSE42,
+    FOSSIL_SYS_HOSTINFO_FEATURE_POPCNT,
+    FOSSIL_SYS_HOSTINFO_FEATURE_LZCNT,
+    FOSSIL_SYS_HOSTINFO_FEATURE_MOVBE,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AES,
+    FOSSIL_SYS_HOSTINFO_FEATURE_PCLMUL,
+    FOSSIL_SYS_HOSTINFO_FEATURE_RDRAND,
+    FOSSIL_SYS_HOSTINFO_FEATURE_RDSEED,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ADX,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SHA,
+    FOSSIL_SYS_HOSTINFO_FEATURE_BMI1,
+    FOSSIL_SYS_HOSTINFO_FEATURE_BMI2,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX,
+    FOSSIL_SYS_HOSTINFO_FEATURE_F16C,
+    FOSSIL_SYS_HOSTINFO_FEATURE_FMA,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX2,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX_VNNI,
+    FOSSIL_SYS_HOSTINFO_FEATURE_VAES,
+    FOSSIL_SYS_HOSTINFO_FEATURE_VPCLMULQDQ,
+    FOSSIL_SYS_HOSTINFO_FEATURE_GFNI,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512F,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512DQ,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512CD,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BW,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VL,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512IFMA,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI2,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VNNI,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BITALG,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VPOPCNTDQ,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BF16,
+    FOSSIL_SYS_HOSTINFO_FEATURE_AVX512FP16,
+    FOSSIL_SYS_HOSTINFO_FEATURE_INVARIANT_TSC,
+    FOSSIL_SYS_HOSTINFO_FEATURE_HYPERVISOR,
+
+    // ARM / AArch64
+    FOSSIL_SYS_HOSTINFO_FEATURE_NEON,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_PMULL,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA1,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA2,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_ATOMICS,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_FP16,
+    FOSSIL_SYS_HOSTINFO_FEATURE_ARM_DOTPROD,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SVE,
+    FOSSIL_SYS_HOSTINFO_FEATURE_SVE2,
+
+    FOSSIL_SYS_HOSTINFO_FEATURE_COUNT
+} fossil_sys_hostinfo_feature_t;
+
+/**
+ * Bit set of fossil_sys_hostinfo_feature_t values.
+ */
+typedef struct
+{
+    uint64_t bits[(FOSSIL_SYS_HOSTINFO_FEATURE_COUNT + 63) / 64];
+} fossil_sys_hostinfo_features_t;
+
+#define FOSSIL_SYS_HOSTINFO_DISPATCH_REQUIRES_MAX 4
+
+/**
+ * Generic function pointer used by the dispatch helper; cast to the real
+ * signature after selection.
+ */
+typedef void (*fossil_sys_hostinfo_fn_t)(void);
+
+/**
+ * One candidate implementation and the features it needs. Unused
+ * requirement slots are FOSSIL_SYS_HOSTINFO_FEATURE_NONE.
+ */
+typedef struct
+{
+    fossil_sys_hostinfo_fn_t fn;
+    fossil_sys_hostinfo_feature_t required[FOSSIL_SYS_HOSTINFO_DISPATCH_REQUIRES_MAX];
+} fossil_sys_hostinfo_dispatch_entry_t;
+
+/**
+ * Sampler limits
+ */
+#define FOSSIL_SYS_HOSTINFO_DISK_MAX 32
+#define FOSSIL_SYS_HOSTINFO_IFACE_MAX 32
+#define FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY 64
+#define FOSSIL_SYS_HOSTINFO_SAMPLER_INTERVAL_MS 1000
+
+/**
+ * Per-disk IO rates over one sampling interval.
+ */
+typedef struct
+{
+    char name[32];               // block device, e.g. "nvme0n1"
+    double read_bytes_per_sec;
+    double write_bytes_per_sec;
+    double reads_per_sec;        // completed read requests
+    double writes_per_sec;       // completed write requests
+    float busy_percent;          // time with IO in flight, 0-100
+} fossil_sys_hostinfo_disk_rate_t;
+
+/**
+ * Per-interface network rates over one sampling interval.
+ */
+typedef struct
+{
+    char name[32];               // interface, e.g. "eth0"
+    double rx_bytes_per_sec;
+    double tx_bytes_per_sec;
+    double rx_packets_per_sec;
+    double tx_packets_per_sec;
+} fossil_sys_hostinfo_net_rate_t;
+
+/**
+ * One sample produced by the background sampler. Rates are deltas against
+ * the previous sample; the first sample after start has interval_ms 0 and
+ * zero rates.
+ */
+typedef struct
+{
+    uint64_t sequence;       // 1 for the first sample, then increasing
+    uint64_t timestamp_ns;   // CLOCK_MONOTONIC time of the sample
+    uint32_t interval_ms;    // time since the previous sample
+    int cpu_count;           // entries used in cpu
+    float cpu_busy;          // all CPUs, percent busy 0-100
+    float cpu_iowait;        // all CPUs, percent in iowait 0-100
+    float cpu[FOSSIL_SYS_HOSTINFO_CPU_MAX]; // per CPU id, percent busy 0-100
+    uint64_t memory_total;     // in bytes
+    uint64_t memory_available; // in bytes
+    uint64_t swap_used;        // in bytes
+    int disk_count;
+    fossil_sys_hostinfo_disk_rate_t disks[FOSSIL_SYS_HOSTINFO_DISK_MAX];
+    int iface_count;
+    fossil_sys_hostinfo_net_rate_t ifaces[FOSSIL_SYS_HOSTINFO_IFACE_MAX];
+} fossil_sys_hostinfo_sample_t;
+
+/**
+ * Whole block device with queue properties and cumulative IO counters.
+ */
+typedef struct
+{
+    char name[32];               // e.g. "sda", "nvme0n1"
+    char model[64];              // empty if not reported
+    uint32_t major;
+    uint32_t minor;
+    uint64_t size_bytes;
+    int rotational;              // 1 for spinning media, 0 for SSD/NVMe
+    int removable;               // 1 for removable media
+    uint32_t queue_depth;        // request queue size (nr_requests)
+    uint32_t logical_block_size; // in bytes
+    uint32_t physical_block_size;// in bytes
+    char scheduler[32];          // active IO scheduler, e.g. "mq-deadline"
+    uint64_t reads_completed;
+    uint64_t bytes_read;
+    uint64_t read_time_ms;
+    uint64_t writes_completed;
+    uint64_t bytes_written;
+    uint64_t write_time_ms;
+    uint64_t io_in_progress;
+    uint64_t io_time_ms;
+} fossil_sys_hostinfo_block_device_t;
+
+/**
+ * Block device list container
+ */
+typedef struct
+{
+    size_t count;
+    fossil_sys_hostinfo_block_device_t list[FOSSIL_SYS_HOSTINFO_DISK_MAX];
+} fossil_sys_hostinfo_block_device_list_t;
+
+/**
+ * One IPv4 or IPv6 address assigned to an interface.
+ */
+typedef struct
+{
+    int family;        // 4 for IPv4, 6 for IPv6
+    char address[64];  // textual form, e.g. "192.168.1.10" or "fe80::1"
+    int prefix_len;    // network prefix length in bits
+} fossil_sys_hostinfo_ip_address_t;
+
+#define FOSSIL_SYS_HOSTINFO_IFACE_ADDR_MAX 8
+
+/**
+ * Network interface with link properties, addresses and traffic counters.
+ */
+typedef struct
+{
+    char name[32];
+    int index;                  // kernel interface index, 0 if unknown
+    char mac_address[32];       // empty if the interface has no link address
+    int is_up;                  // administratively up
+    int is_running;             // carrier present / operationally up
+    int is_loopback;
+    uint32_t mtu;
+    int64_t speed_mbps;         // link speed, -1 if unknown or not applicable
+    char driver[64];            // empty for virtual interfaces without a driver
+    uint32_t rx_queues;
+    uint32_t tx_queues;
+    int address_count;
+    fossil_sys_hostinfo_ip_address_t addresses[FOSSIL_SYS_HOSTINFO_IFACE_ADDR_MAX];
+    uint64_t rx_bytes;
+    uint64_t tx_bytes;
+    uint64_t rx_packets;
+    uint64_t tx_packets;
+    uint64_t rx_errors;
+    uint64_t tx_errors;
+    uint64_t rx_dropped;
+    uint64_t tx_dropped;
+} fossil_sys_hostinfo_interface_t;
+
+/**
+ * Interface list container
+ */
+typedef struct
+{
+    size_t count;
+    fossil_sys_hostinfo_interface_t list[FOSSIL_SYS_HOSTINFO_IFACE_MAX];
+} fossil_sys_hostinfo_interface_list_t;
+
+/**
+ * Pool of huge pages of one size, from /sys/kernel/mm/hugepages.
+ */
+typedef struct
+{
+    uint64_t page_size; // in bytes
+    uint64_t total;     // pages, HugePages_Total for this size
+    uint64_t free;      // pages
+    uint64_t reserved;  // pages promised to mappings but not yet faulted in
+    uint64_t surplus;   // pages above the persistent pool
+} fossil_sys_hostinfo_hugepages_t;
+
+#define FOSSIL_SYS_HOSTINFO_HUGEPAGE_SIZES_MAX 8
+
+/**
+ * Detailed memory breakdown parsed in one pass from /proc/meminfo.
+ * All sizes are in bytes.
+ */
+typedef struct
+{
+    uint64_t total;
+    uint64_t free;
+    uint64_t available;        // MemAvailable: free plus reclaimable cache
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t swap_cached;
+    uint64_t active;
+    uint64_t inactive;
+    uint64_t shmem;
+    uint64_t slab_reclaimable;
+    uint64_t slab_unreclaimable;
+    uint64_t dirty;
+    uint64_t writeback;
+    uint64_t anon_pages;
+    uint64_t mapped;
+    uint64_t anon_huge_pages;  // transparent huge pages backing anonymous memory
+    uint64_t commit_limit;
+    uint64_t committed_as;
+    uint64_t swap_total;
+    uint64_t swap_free;
+    int has_available;         // 0 on kernels older than 3.14 (available is estimated)
+    size_t hugepage_size_count;
+    fossil_sys_hostinfo_hugepages_t hugepages[FOSSIL_SYS_HOSTINFO_HUGEPAGE_SIZES_MAX];
+    char thp_mode[16];         // "always", "madvise" or "never"; empty if unavailable
+    char thp_defrag[16];
+} fossil_sys_hostinfo_meminfo_t;
+
+/**
+ * Frequency scaling state of one logical CPU.
+ */
+typedef struct
+{
+    int cpu;                          // logical CPU id
+    uint32_t cur_khz;                 // current frequency, 0 if unknown
+    uint32_t min_khz;                 // scaling policy floor
+    uint32_t max_khz;                 // scaling policy ceiling
+    char governor[16];                // e.g. "performance", "schedutil"
+    uint64_t core_throttle_count;     // thermal throttle events for this core
+    uint64_t package_throttle_count;  // thermal throttle events for its package
+} fossil_sys_hostinfo_cpufreq_t;
+
+/**
+ * One thermal zone reading.
+ */
+typedef struct
+{
+    int zone;          // N in /sys/class/thermal/thermal_zoneN
+    char type[32];     // e.g. "x86_pkg_temp", "acpitz"
+    int32_t temp_mc;   // millidegrees Celsius
+} fossil_sys_hostinfo_thermal_zone_t;
+
+#define FOSSIL_SYS_HOSTINFO_THERMAL_MAX 32
+
+/**
+ * Frequency and thermal telemetry captured in one read.
+ */
+typedef struct
+{
+    uint64_t timestamp_ns; // monotonic
+    size_t cpu_count;
+    fossil_sys_hostinfo_cpufreq_t cpus[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    size_t zone_count;
+    fossil_sys_hostinfo_thermal_zone_t zones[FOSSIL_SYS_HOSTINFO_THERMAL_MAX];
+} fossil_sys_hostinfo_cpufreq_state_t;
+
+/**
+ * CPU and memory actually available to this process once affinity masks
+ * and container limits (cgroup v1/v2, Windows job objects) are applied.
+ */
+typedef struct
+{
+    int online_cpus;           // logical CPUs online on the host
+    int affinity_cpus;         // CPUs in the process affinity mask
+    double cpu_quota;          // CPUs worth of quota (cpu.max quota/period), 0 if unlimited
+    int effective_cpus;        // min(affinity_cpus, ceil(cpu_quota)), at least 1
+    uint64_t memory_total;     // physical memory in bytes
+    uint64_t memory_limit;     // container memory limit in bytes, 0 if unlimited
+    uint64_t effective_memory; // min(memory_total, memory_limit)
+    int cgroup_version;        // 1 or 2, 0 if no cgroup hierarchy was found
+    int is_container;          // as reported by fossil_sys_hostinfo_get_virtualization
+} fossil_sys_hostinfo_resources_t;
+
+/**
+ * Clock sources for fossil_sys_hostinfo_clock_ns.
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC,     // NTP-slewed, stops during suspend
+    FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC_RAW, // hardware rate, not slewed
+    FOSSIL_SYS_HOSTINFO_CLOCK_BOOTTIME       // like MONOTONIC but counts suspend
+} fossil_sys_hostinfo_clock_t;
+
+/**
+ * Where the cycle counter frequency came from.
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_TSC_SOURCE_NONE,       // no usable cycle counter
+    FOSSIL_SYS_HOSTINFO_TSC_SOURCE_CPUID_15,   // crystal clock ratio (exact)
+    FOSSIL_SYS_HOSTINFO_TSC_SOURCE_HYPERVISOR, // timing leaf 0x40000010
+    FOSSIL_SYS_HOSTINFO_TSC_SOURCE_CALIBRATED, // measured against MONOTONIC
+    FOSSIL_SYS_HOSTINFO_TSC_SOURCE_ARCH_TIMER  // ARM generic timer CNTFRQ
+} fossil_sys_hostinfo_tsc_source_t;
+
+/**
+ * Cycle counter description. Convert with
+ * ns = (cycles * mult) >> shift, see fossil_sys_hostinfo_cycles_to_ns.
+ */
+typedef struct
+{
+    uint64_t frequency_hz; // counter rate, 0 if there is no counter
+    int invariant;         // constant rate across P/C-states; required to use it as a clock
+    fossil_sys_hostinfo_tsc_source_t source;
+    uint32_t mult;
+    uint32_t shift;
+} fossil_sys_hostinfo_tsc_t;
+
+/**
+ * One row of /proc/interrupts or /proc/softirqs.
+ */
+typedef struct
+{
+    char name[16];         // IRQ number or symbol, e.g. "24", "LOC", "NET_RX"
+    char description[64];  // controller and handler text, empty for softirqs
+    uint64_t total;        // sum over all CPU columns
+} fossil_sys_hostinfo_irq_t;
+
+/**
+ * Per-CPU interrupt and softirq counters.
+ *
+ * Heap allocated by fossil_sys_hostinfo_get_interrupts and released with
+ * fossil_sys_hostinfo_free_interrupts. Counts are row-major:
+ * irq_counts[row * cpu_count + column] is the count of irqs[row] on
+ * cpus[column]; softirq_counts uses the same layout.
+ */
+typedef struct
+{
+    uint64_t timestamp_ns;     // monotonic
+    size_t cpu_count;
+    int *cpus;                 // CPU number of each column
+    size_t irq_count;
+    fossil_sys_hostinfo_irq_t *irqs;
+    uint64_t *irq_counts;
+    size_t softirq_count;
+    fossil_sys_hostinfo_irq_t *softirqs;
+    uint64_t *softirq_counts;
+} fossil_sys_hostinfo_interrupts_t;
+
+/**
+ * Open file descriptors of a process, classified by target, with a
+ * summary of the sockets among them. Socket counts are per distinct
+ * socket, so descriptors duplicated with dup() are counted once there.
+ */
+typedef struct
+{
+    uint64_t total;            // open descriptors
+    uint64_t limit;            // soft RLIMIT_NOFILE, 0 if unlimited or unknown
+    uint64_t files;            // paths outside /dev, including deleted files
+    uint64_t devices;          // /dev nodes such as ttys and /dev/null
+    uint64_t sockets;
+    uint64_t pipes;            // pipes and FIFOs opened through pipe()
+    uint64_t anon_inodes;      // eventfd, epoll, timerfd, signalfd, inotify, ...
+    uint64_t other;
+
+    uint64_t tcp_established;
+    uint64_t tcp_listen;
+    uint64_t tcp_syn;          // SYN_SENT and SYN_RECV
+    uint64_t tcp_closing;      // FIN_WAIT1/2, LAST_ACK and CLOSING
+    uint64_t tcp_close_wait;   // peer closed, local side has not: a common leak
+    uint64_t tcp_other;
+    uint64_t udp;
+    uint64_t unix_sockets;
+    uint64_t other_sockets;    // netlink, packet, raw, ... not found in the tables above
+} fossil_sys_hostinfo_fd_inventory_t;
+
+/**
+ * Resources covered by Pressure Stall Information (PSI).
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_PSI_CPU,
+    FOSSIL_SYS_HOSTINFO_PSI_MEMORY,
+    FOSSIL_SYS_HOSTINFO_PSI_IO,
+    FOSSIL_SYS_HOSTINFO_PSI_COUNT
+} fossil_sys_hostinfo_psi_resource_t;
+
+/**
+ * PSI line kind: "some" tasks stalled, or "full" (all non-idle tasks stalled).
+ */
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_PSI_SOME,
+    FOSSIL_SYS_HOSTINFO_PSI_FULL
+} fossil_sys_hostinfo_psi_kind_t;
+
+typedef struct
+{
+    float avg10;       // percent of time stalled over 10 s
+    float avg60;       // percent of time stalled over 60 s
+    float avg300;      // percent of time stalled over 300 s
+    uint64_t total_us; // cumulative stall time in microseconds
+} fossil_sys_hostinfo_psi_line_t;
+
+typedef struct
+{
+    fossil_sys_hostinfo_psi_line_t some;
+    fossil_sys_hostinfo_psi_line_t full;
+    int has_full; // 0 when the kernel does not report "full" (e.g. system-wide cpu on old kernels)
+} fossil_sys_hostinfo_psi_t;
+
+#define FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX 16
+
+/**
+ * Event ids posted when a PSI trigger fires. The payload of each event is a
+ * fossil_sys_hostinfo_psi_event_t.
+ */
+#define FOSSIL_SYS_HOSTINFO_PSI_EVENT_CPU "fossil.sys.hostinfo.psi.cpu"
+#define FOSSIL_SYS_HOSTINFO_PSI_EVENT_MEMORY "fossil.sys.hostinfo.psi.memory"
+#define FOSSIL_SYS_HOSTINFO_PSI_EVENT_IO "fossil.sys.hostinfo.psi.io"
+
+typedef struct
+{
+    int trigger_id;
+    fossil_sys_hostinfo_psi_resource_t resource;
+    fossil_sys_hostinfo_psi_kind_t kind;
+    uint32_t stall_us;
+    uint32_t window_us;
+    fossil_sys_hostinfo_psi_t pressure; // reading taken when the trigger fired
+} fossil_sys_hostinfo_psi_event_t;
+
 /**
  * @brief Retrieves the system uptime information.
  *
@@ -288,57 +1017,153 @@ int fossil_sys_hostinfo_get_cpu(fossil_sys_hostinfo_cpu_t *info);
 int fossil_sys_hostinfo_get_gpu(fossil_sys_hostinfo_gpu_t *info);
 
 /**
- * @brief Retrieves power information about the host system.
+ * @brief Enumerates every GPU in the host system.
  *
- * This function fills the fossil_sys_hostinfo_power_t structure with details
- * about the system's power state, including AC power status, battery presence,
- * charging state, battery percentage, and estimated time remaining.
+ * On Linux display-class PCI devices are read from /sys/bus/pci/devices and
+ * matched with their DRM card; non-PCI DRM devices (SoC GPUs) are listed as
+ * well. No external tools are executed. The primary adapter is flagged with
+ * is_primary and is what fossil_sys_hostinfo_get_gpu reports.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_power_t structure that
- *                  will be populated with power information.
- * @return 0 on success, or a negative error code on failure.
+ * @param[out] list Pointer to a list receiving up to FOSSIL_SYS_HOSTINFO_GPU_MAX GPUs.
+ * @return 0 on success (count may be 0), or a negative error code on failure.
  */
-int fossil_sys_hostinfo_get_power(fossil_sys_hostinfo_power_t *info);
+int fossil_sys_hostinfo_get_gpus(fossil_sys_hostinfo_gpu_list_t *list);
 
 /**
- * @brief Retrieves general system information.
- *
- * This function fills the fossil_sys_hostinfo_system_t structure with
- * information about the operating system, kernel version, hostname,
- * username, domain name, machine type, and platform.
+ * @brief Maps a PCI vendor id to a vendor name.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_system_t structure that
- *                  will be populated with system information.
- * @return 0 on success, or a negative error code on failure.
+ * @param vendor_id PCI vendor id (e.g. 0x10de).
+ * @return Static vendor name, or "Unknown" if not in the built-in table.
  */
-int fossil_sys_hostinfo_get_system(fossil_sys_hostinfo_system_t *info);
+const char *fossil_sys_hostinfo_gpu_vendor_name(uint32_t vendor_id);
 
 /**
- * @brief Retrieves architecture information about the host system.
+ * @brief Enumerates every real mounted filesystem.
  *
- * This function fills the fossil_sys_hostinfo_architecture_t structure with
- * details about the system's architecture, such as architecture name, CPU,
- * number of cores and threads, frequency, and CPU architecture.
+ * /proc/self/mountinfo is parsed in one pass; pseudo filesystems such as
+ * proc, sysfs or cgroup are skipped and every remaining mount is reported
+ * with its statvfs figures and backing block device. Network filesystems
+ * are listed with is_network set but without capacity, since statvfs on
+ * an unreachable server blocks; query them with
+ * fossil_sys_hostinfo_get_mount_space.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_architecture_t structure
- *                  that will be populated with architecture information.
- * @return 0 on success, or a negative error code on failure.
+ * @param[out] list Pointer to a list receiving up to FOSSIL_SYS_HOSTINFO_MOUNT_MAX mounts.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported, -3 if
+ *         the mount table could not be read.
  */
-int fossil_sys_hostinfo_get_architecture(fossil_sys_hostinfo_architecture_t *info);
+int fossil_sys_hostinfo_get_mounts(fossil_sys_hostinfo_mount_list_t *list);
 
 /**
- * @brief Retrieves memory information about the host system.
+ * @brief Fills in the capacity and inode figures of one mount.
  *
- * This function fills the fossil_sys_hostinfo_memory_t structure with
- * details about the system's memory, including total, free, used, and
- * available memory, as well as swap statistics.
+ * May block for as long as the filesystem takes to answer, which for a
+ * network mount with an unreachable server can be minutes.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_memory_t structure that
- *                  will be populated with memory information.
- * @return 0 on success, or a negative error code on failure.
+ * @param[in,out] mount Mount whose mount_point is queried.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported, -3 if
+ *         the filesystem could not be queried.
+ */
+int fossil_sys_hostinfo_get_mount_space(fossil_sys_hostinfo_mount_t *mount);
+
+/**
+ * @brief Enumerates whole block devices with queue details and IO counters.
+ *
+ * Queue properties come from /sys/block/<dev>/queue, counters from
+ * /proc/diskstats (read once for all devices). Loop and RAM disks are skipped.
+ *
+ * @param[out] list Pointer to a list receiving up to FOSSIL_SYS_HOSTINFO_DISK_MAX devices.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported.
+ */
+int fossil_sys_hostinfo_get_block_devices(fossil_sys_hostinfo_block_device_list_t *list);
+
+/**
+ * @brief Enumerates every network interface.
+ *
+ * Addresses and flags come from a single getifaddrs call; link details
+ * (MTU, speed, driver, queue counts) from /sys/class/net and counters from
+ * one read of /proc/net/dev.
+ *
+ * @param[out] list Pointer to a list receiving up to FOSSIL_SYS_HOSTINFO_IFACE_MAX interfaces.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported.
+ */
+int fossil_sys_hostinfo_get_interfaces(fossil_sys_hostinfo_interface_list_t *list);
+
+/**
+ * @brief Refreshes only the traffic counters of a previously filled list.
+ *
+ * Addresses and link properties are left untouched, which keeps the cost
+ * to a single counters read for throughput dashboards.
+ *
+ * @param[in,out] list List filled by fossil_sys_hostinfo_get_interfaces.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported.
+ */
+int fossil_sys_hostinfo_refresh_interface_counters(fossil_sys_hostinfo_interface_list_t *list);
+
+/**
+ * @brief Retrieves power information about the host system.
+ *
+ * This function fills the fossil_sys_hostinfo_power_t structure with details
+ * about the system's power state, including AC power status, battery presence,
+ * charging state, battery percentage, and estimated time remaining.
+ *
+ * @param[out] info Pointer to a fossil_sys_hostinfo_power_t structure that
+ *                  will be populated with power information.
+ * @return 0 on success, or a negative error code on failure.
+ */
+int fossil_sys_hostinfo_get_power(fossil_sys_hostinfo_power_t *info);
+
+/**
+ * @brief Retrieves general system information.
+ *
+ * This function fills the fossil_sys_hostinfo_system_t structure with
+ * information about the operating system, kernel version, hostname,
+ * username, domain name, machine type, and platform.
+ *
+ * @param[out] info Pointer to a fossil_sys_hostinfo_system_t structure that
+ *                  will be populated with system information.
+ * @return 0 on success, or a negative error code on failure.
+ */
+int fossil_sys_hostinfo_get_system(fossil_sys_hostinfo_system_t *info);
+
+/**
+ * @brief Retrieves architecture information about the host system.
+ *
+ * This function fills the fossil_sys_hostinfo_architecture_t structure with
+ * details about the system's architecture, such as architecture name, CPU,
+ * number of cores and threads, frequency, and CPU architecture.
+ *
+ * @param[out] info Pointer to a fossil_sys_hostinfo_architecture_t structure
+ *                  that will be populated with architecture information.
+ * @return 0 on success, or a negative error code on failure.
+ */
+int fossil_sys_hostinfo_get_architecture(fossil_sys_hostinfo_architecture_t *info);
+
+/**
+ * @brief Retrieves memory information about the host system.
+ *
+ * This function fills the fossil_sys_hostinfo_memory_t structure with
+ * details about the system's memory, including total, free, used, and
+ * available memory, as well as swap statistics.
+ *
+ * @param[out] info Pointer to a fossil_sys_hostinfo_memory_t structure that
+ *                  will be populated with memory information.
+ * @return 0 on success, or a negative error code on failure.
  */
 int fossil_sys_hostinfo_get_memory(fossil_sys_hostinfo_memory_t *info);
 
+/**
+ * @brief Retrieves a detailed memory breakdown.
+ *
+ * Parses /proc/meminfo in a single pass and adds the huge page pools of
+ * every size plus the transparent huge page mode. Use this instead of
+ * fossil_sys_hostinfo_get_memory when capacity decisions need to account
+ * for reclaimable page cache.
+ *
+ * @param[out] info Pointer to a structure receiving the breakdown.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported.
+ */
+int fossil_sys_hostinfo_get_meminfo(fossil_sys_hostinfo_meminfo_t *info);
+
 /**
  * @brief Retrieves endianness information about the host system.
  *
@@ -409,28 +1234,623 @@ int fossil_sys_hostinfo_get_time(fossil_sys_hostinfo_time_t *info);
  * details about the system manufacturer, product name, serial number,
  * and BIOS or firmware version.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_hardware_t structure
- *                  that will be populated with hardware information.
- * @return 0 on success, or a negative error code on failure.
+ * @param[out] info Pointer to a fossil_sys_hostinfo_hardware_t structure
+ *                  that will be populated with hardware information.
+ * @return 0 on success, or a negative error code on failure.
+ */
+int fossil_sys_hostinfo_get_hardware(fossil_sys_hostinfo_hardware_t *info);
+
+/**
+ * @brief Retrieves display information about the host system.
+ *
+ * This function fills the fossil_sys_hostinfo_display_t structure with
+ * details about connected displays, including display count, primary
+ * resolution, and refresh rate.
+ *
+ * @param[out] info Pointer to a fossil_sys_hostinfo_display_t structure
+ *                  that will be populated with display information.
+ * @return 0 on success, or a negative error code on failure.
+ */
+int fossil_sys_hostinfo_get_display(fossil_sys_hostinfo_display_t *info);
+
+/**
+ * @brief Retrieves the cached CPU topology of the host system.
+ *
+ * The topology is discovered once on first use (sysfs on Linux, a flat
+ * one-thread-per-core layout elsewhere) and cached for the lifetime of the
+ * process. Subsequent calls return the same immutable structure, so it is
+ * safe to share between threads.
+ *
+ * @return Pointer to the cached topology, or NULL if discovery failed.
+ */
+const fossil_sys_hostinfo_topology_t *fossil_sys_hostinfo_get_topology(void);
+
+/**
+ * @brief Retrieves the CPUs sharing a cache of the given level with a CPU.
+ *
+ * For example, level 3 answers "which CPUs share this CPU's L3". Data and
+ * unified caches are preferred over instruction caches at the same level.
+ *
+ * @param cpu   Logical CPU id.
+ * @param level Cache level (1, 2, 3, ...).
+ * @param[out] out Set of CPUs sharing the cache, including cpu itself.
+ * @return 0 on success, -1 on invalid arguments, -2 if no such cache is known.
+ */
+int fossil_sys_hostinfo_topology_cache_siblings(int cpu, int level,
+                                                fossil_sys_hostinfo_cpuset_t *out);
+
+/**
+ * @brief Retrieves the SMT siblings (hardware threads of the same core).
+ *
+ * @param cpu   Logical CPU id.
+ * @param[out] out Set of sibling CPUs, including cpu itself.
+ * @return 0 on success, -1 on invalid arguments or unknown CPU.
+ */
+int fossil_sys_hostinfo_topology_smt_siblings(int cpu,
+                                              fossil_sys_hostinfo_cpuset_t *out);
+
+/**
+ * @brief Retrieves the NUMA node that a CPU belongs to.
+ *
+ * @param cpu Logical CPU id.
+ * @return NUMA node id, or -1 if unknown.
+ */
+int fossil_sys_hostinfo_topology_numa_node(int cpu);
+
+/**
+ * @brief Retrieves the immutable part of the hostinfo snapshot.
+ *
+ * Every requested static section (see FOSSIL_SYS_HOSTINFO_STATIC_SECTIONS) is
+ * collected exactly once per process, thread-safely, on first request.
+ * Sections that were not requested yet are left zeroed. The returned
+ * structure is never modified again once a section is filled in, so
+ * pointers into it may be kept and shared freely.
+ *
+ * @param sections Bit mask of fossil_sys_hostinfo_section_t values.
+ * @return Pointer to the process-wide static snapshot (never NULL).
+ */
+const fossil_sys_hostinfo_static_t *fossil_sys_hostinfo_snapshot_static(uint32_t sections);
+
+/**
+ * @brief Copies the volatile part of the hostinfo snapshot.
+ *
+ * Requested volatile sections (see FOSSIL_SYS_HOSTINFO_VOLATILE_SECTIONS)
+ * that are older than the snapshot TTL are re-collected before the copy;
+ * fresh sections are served from the cache without touching /proc or /sys.
+ * Collection runs without holding the snapshot lock, so a slow storage or
+ * network refresh never stalls readers of other sections.
+ *
+ * @param sections Bit mask of fossil_sys_hostinfo_section_t values.
+ * @param[out] out Pointer to the structure receiving the snapshot.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_sys_hostinfo_snapshot_volatile(uint32_t sections, fossil_sys_hostinfo_volatile_t *out);
+
+/**
+ * @brief Copies one volatile section of the snapshot.
+ *
+ * Same refresh rules as fossil_sys_hostinfo_snapshot_volatile, but only
+ * the requested section is copied out.
+ *
+ * @param section A single volatile fossil_sys_hostinfo_section_t value.
+ * @param[out] out Structure of that section's type, e.g. fossil_sys_hostinfo_memory_t.
+ * @param size sizeof(*out); a mismatch with the section's type is rejected.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_sys_hostinfo_snapshot_section(uint32_t section, void *out, size_t size);
+
+/**
+ * @brief Sets the time-to-live of volatile snapshot sections.
+ *
+ * @param ttl_ms Maximum age in milliseconds; 0 re-collects on every request.
+ */
+void fossil_sys_hostinfo_snapshot_set_ttl(uint32_t ttl_ms);
+
+/**
+ * @brief Retrieves the current time-to-live of volatile snapshot sections.
+ *
+ * @return TTL in milliseconds.
+ */
+uint32_t fossil_sys_hostinfo_snapshot_get_ttl(void);
+
+/**
+ * @brief Marks every volatile section stale so the next request re-collects it.
+ */
+void fossil_sys_hostinfo_snapshot_invalidate(void);
+
+/**
+ * @brief Retrieves the instruction set features of the host CPU.
+ *
+ * Detection runs once per process. Unlike the features string in
+ * fossil_sys_hostinfo_cpu_t the set is never truncated, and AVX/AVX-512
+ * features are only reported when the operating system saves the
+ * corresponding register state.
+ *
+ * @return Pointer to the cached feature set (never NULL).
+ */
+const fossil_sys_hostinfo_features_t *fossil_sys_hostinfo_get_features(void);
+
+/**
+ * @brief Checks whether the host CPU supports a feature.
+ *
+ * @param feature Feature to query.
+ * @return 1 if supported, 0 otherwise.
+ */
+int fossil_sys_hostinfo_has_feature(fossil_sys_hostinfo_feature_t feature);
+
+/**
+ * @brief Returns the lowercase name of a feature (e.g. "avx512f").
+ *
+ * @param feature Feature to name.
+ * @return Static string, or "unknown" for out of range values.
+ */
+const char *fossil_sys_hostinfo_feature_name(fossil_sys_hostinfo_feature_t feature);
+
+/**
+ * @brief Selects the first implementation whose requirements are supported.
+ *
+ * Order the table from most to least specialised and end it with a
+ * portable entry that has no requirements. Call this once during
+ * initialisation and keep the result; the selection does not change for
+ * the lifetime of the process.
+ *
+ * @param table Candidate implementations.
+ * @param count Number of entries in table.
+ * @return Selected function, or NULL if no entry is usable.
+ */
+fossil_sys_hostinfo_fn_t fossil_sys_hostinfo_dispatch_select(
+    const fossil_sys_hostinfo_dispatch_entry_t *table, size_t count);
+
+/**
+ * @brief Checks whether a feature set contains a feature.
+ */
+static inline int fossil_sys_hostinfo_features_has(const fossil_sys_hostinfo_features_t *set,
+                                                   fossil_sys_hostinfo_feature_t feature)
+{
+    if (!set || feature <= FOSSIL_SYS_HOSTINFO_FEATURE_NONE || feature >= FOSSIL_SYS_HOSTINFO_FEATURE_COUNT)
+        return 0;
+    return (int)((set->bits[feature / 64] >> (feature % 64)) & 1u);
+}
+
+/**
+ * @brief Starts the background metrics sampler.
+ *
+ * A single process-wide thread reads /proc/stat, /proc/meminfo,
+ * /proc/diskstats and /proc/net/dev through file descriptors opened once
+ * and re-read with pread, and publishes one sample per interval into a
+ * ring of FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY entries. Ring slots are sized
+ * to the CPUs, disks and interfaces actually sampled; disks are rescanned
+ * when /proc/diskstats changes. Calling start while running only changes
+ * the interval.
+ *
+ * @param interval_ms Sampling interval; 0 selects FOSSIL_SYS_HOSTINFO_SAMPLER_INTERVAL_MS.
+ * @return 0 on success, -2 if unsupported on this platform, -3 if the
+ *         sources or the thread could not be set up.
+ */
+int fossil_sys_hostinfo_sampler_start(uint32_t interval_ms);
+
+/**
+ * @brief Stops the background sampler. Collected history stays readable.
+ *
+ * Closes the procfs descriptors; the next start or sample_now reopens them.
+ *
+ * @return 0 on success, -2 if unsupported on this platform.
+ */
+int fossil_sys_hostinfo_sampler_stop(void);
+
+/**
+ * @brief Takes one sample immediately on the calling thread.
+ *
+ * Works whether or not the background thread runs, which allows callers
+ * to drive sampling from their own loop.
+ *
+ * @return 0 on success, -2 if unsupported, -3 if the sources could not be read.
+ */
+int fossil_sys_hostinfo_sampler_sample_now(void);
+
+/**
+ * @brief Copies the most recent sample.
+ *
+ * Readers never block the sampler and never take a lock.
+ *
+ * @param[out] out Pointer to the structure receiving the sample.
+ * @return 0 on success, -1 on invalid arguments, -2 if no sample exists yet.
+ */
+int fossil_sys_hostinfo_sampler_latest(fossil_sys_hostinfo_sample_t *out);
+
+/**
+ * @brief Copies up to max recent samples, newest first.
+ *
+ * @param[out] out Array receiving the samples.
+ * @param max Capacity of out.
+ * @return Number of samples copied.
+ */
+size_t fossil_sys_hostinfo_sampler_history(fossil_sys_hostinfo_sample_t *out, size_t max);
+
+/**
+ * @brief Reads Pressure Stall Information for a resource.
+ *
+ * @param resource CPU, memory or IO.
+ * @param[out] info Pointer to the structure receiving the pressure figures.
+ * @return 0 on success, -1 on invalid arguments, -2 if PSI is unavailable.
+ */
+int fossil_sys_hostinfo_get_psi(fossil_sys_hostinfo_psi_resource_t resource, fossil_sys_hostinfo_psi_t *info);
+
+/**
+ * @brief Registers a kernel PSI trigger.
+ *
+ * The kernel signals the trigger when tasks were stalled for at least
+ * stall_us within any window_us period. Unprivileged processes may only use
+ * windows that are a multiple of two seconds.
+ *
+ * @param resource CPU, memory or IO.
+ * @param kind Stall kind to watch.
+ * @param stall_us Stall threshold in microseconds.
+ * @param window_us Tracking window in microseconds (500 ms to 10 s).
+ * @return Trigger id (>= 0) on success, -1 on invalid arguments, -2 if PSI is
+ *         unavailable, -3 if the kernel rejected the trigger, -4 if all
+ *         FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX slots are in use.
+ */
+int fossil_sys_hostinfo_psi_trigger_add(fossil_sys_hostinfo_psi_resource_t resource,
+                                        fossil_sys_hostinfo_psi_kind_t kind,
+                                        uint32_t stall_us, uint32_t window_us);
+
+/**
+ * @brief Removes a PSI trigger.
+ *
+ * @param trigger_id Id returned by fossil_sys_hostinfo_psi_trigger_add.
+ * @return 0 on success, -1 if the id is unknown.
+ */
+int fossil_sys_hostinfo_psi_trigger_remove(int trigger_id);
+
+/**
+ * @brief Waits for registered PSI triggers and posts their events.
+ *
+ * Blocks in poll() until a trigger fires or the timeout expires; every fired
+ * trigger posts one FOSSIL_SYS_HOSTINFO_PSI_EVENT_* event through
+ * fossil_sys_event_post. Only one thread may dispatch at a time.
+ *
+ * @param timeout_ms Maximum wait; 0 returns immediately, UINT32_MAX waits forever.
+ * @return Number of events posted (0 on timeout), -2 if unsupported, -4 if
+ *         another thread is dispatching.
+ */
+int fossil_sys_hostinfo_psi_dispatch(uint32_t timeout_ms);
+
+/**
+ * @brief Starts a background thread that dispatches PSI triggers.
+ *
+ * @return 0 on success, -2 if unsupported, -3 if the thread could not start.
+ */
+int fossil_sys_hostinfo_psi_watch_start(void);
+
+/**
+ * @brief Stops the PSI watcher thread. Registered triggers stay active.
+ *
+ * @return 0 on success, -2 if unsupported.
+ */
+int fossil_sys_hostinfo_psi_watch_stop(void);
+
+/**
+ * @brief Collects the requested hostinfo sections in one pass.
+ *
+ * Sections in FOSSIL_SYS_HOSTINFO_SLOW_SECTIONS run on worker threads
+ * while the remaining ones are collected on the calling thread. Leave
+ * expensive sections such as DISPLAY and GPU out of the mask to skip them.
+ *
+ * @param sections Mask of fossil_sys_hostinfo_section_t bits.
+ * @param[out] out Pointer to a structure receiving the sections.
+ * @return 0 if every requested section was collected, -1 on invalid
+ *         arguments, -3 if some sections failed (see out->valid).
+ */
+int fossil_sys_hostinfo_collect_all(uint32_t sections, fossil_sys_hostinfo_all_t *out);
+
+/**
+ * @brief Serializes collected sections as a JSON object.
+ *
+ * Writes straight into the caller's buffer. Only sections present in
+ * info->valid are emitted, one nested object per section.
+ *
+ * @param info Collected sections.
+ * @param[out] buf Destination buffer, always NUL-terminated when size > 0.
+ * @param size Size of buf in bytes.
+ * @param[out] written Optional; receives the full document length,
+ *                     excluding the NUL, even when buf was too small.
+ * @return 0 on success, -1 on invalid arguments, -4 if buf is too small.
+ */
+int fossil_sys_hostinfo_to_json(const fossil_sys_hostinfo_all_t *info, char *buf, size_t size, size_t *written);
+
+/**
+ * @brief Serializes collected sections in a compact binary form.
+ *
+ * Layout: FOSSIL_SYS_HOSTINFO_BINARY_MAGIC, a version byte, then varints
+ * for the valid mask and collection time, followed by the fields of every
+ * valid section in declaration order. Strings are a varint length plus
+ * bytes, integers are (zigzag) varints and floats are 4 little-endian bytes.
+ *
+ * @param info Collected sections.
+ * @param[out] buf Destination buffer.
+ * @param size Size of buf in bytes.
+ * @param[out] written Optional; receives the encoded length, even when
+ *                     buf was too small.
+ * @return 0 on success, -1 on invalid arguments, -4 if buf is too small.
+ */
+int fossil_sys_hostinfo_to_binary(const fossil_sys_hostinfo_all_t *info, void *buf, size_t size, size_t *written);
+
+/**
+ * @brief Decodes the output of fossil_sys_hostinfo_to_binary.
+ *
+ * @param buf Encoded data.
+ * @param size Length of buf in bytes.
+ * @param[out] out Pointer to a structure receiving the decoded sections.
+ * @return 0 on success, -1 on invalid arguments or malformed input,
+ *         -2 if the format version is not supported.
+ */
+int fossil_sys_hostinfo_from_binary(const void *buf, size_t size, fossil_sys_hostinfo_all_t *out);
+
+/**
+ * @brief Retrieves the CPU and memory budget of this process.
+ *
+ * Inside a container the host CPU count overstates what can be used:
+ * this combines sched_getaffinity with the cgroup cpu.max quota (or
+ * cpu.cfs_quota_us on cgroup v1) and memory.max (memory.limit_in_bytes),
+ * taking the tightest limit along the cgroup path. Size thread pools
+ * from effective_cpus rather than the online count.
+ *
+ * @param[out] info Pointer to a structure receiving the limits.
+ * @return 0 on success, -1 on invalid arguments.
+ */
+int fossil_sys_hostinfo_get_resources(fossil_sys_hostinfo_resources_t *info);
+
+/**
+ * @brief Returns the number of CPUs this process can effectively use.
+ *
+ * Shortcut for fossil_sys_hostinfo_get_resources(...).effective_cpus.
+ *
+ * @return Effective CPU count, at least 1.
+ */
+int fossil_sys_hostinfo_effective_cpus(void);
+
+/**
+ * @brief Reads a kernel clock in nanoseconds.
+ *
+ * Backed by clock_gettime (vDSO, no system call) on Linux,
+ * clock_gettime_nsec_np on macOS and QueryPerformanceCounter on Windows.
+ *
+ * @param clock Clock to read.
+ * @return Nanoseconds since the clock's epoch, or 0 if unsupported.
+ */
+uint64_t fossil_sys_hostinfo_clock_ns(fossil_sys_hostinfo_clock_t clock);
+
+/**
+ * @brief Describes the CPU cycle counter.
+ *
+ * The frequency comes from CPUID leaf 0x15, the hypervisor timing leaf,
+ * or a one-time 10 ms calibration against CLOCK_MONOTONIC on x86; from
+ * CNTFRQ_EL0 on ARM64. Computed once.
+ *
+ * @return Pointer to a process-wide, read-only description.
+ */
+const fossil_sys_hostinfo_tsc_t *fossil_sys_hostinfo_get_tsc(void);
+
+/**
+ * @brief Fast monotonic timestamp in nanoseconds.
+ *
+ * Converts the invariant cycle counter when available (on Linux x86 only
+ * while the kernel's clocksource is "tsc") and falls back to
+ * CLOCK_MONOTONIC otherwise. The epoch is arbitrary: compare timestamps
+ * only with each other.
+ *
+ * @return Nanoseconds since an arbitrary fixed point.
+ */
+uint64_t fossil_sys_hostinfo_timestamp_ns(void);
+
+/**
+ * @brief Reads the CPU cycle counter (RDTSC, CNTVCT_EL0).
+ *
+ * @return Current counter value, or 0 on architectures without one.
+ */
+static inline uint64_t fossil_sys_hostinfo_cycles(void)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return (uint64_t)__rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    return (uint64_t)__builtin_ia32_rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Converts a cycle count to nanoseconds.
+ *
+ * Split multiply so absolute counter values do not overflow.
+ */
+static inline uint64_t fossil_sys_hostinfo_cycles_to_ns(const fossil_sys_hostinfo_tsc_t *tsc, uint64_t cycles)
+{
+    if (!tsc || !tsc->mult)
+        return 0;
+    uint64_t hi = (cycles >> 32) * tsc->mult;
+    uint64_t lo = (cycles & 0xffffffffu) * tsc->mult;
+    return (hi << (32 - tsc->shift)) + (lo >> tsc->shift);
+}
+
+/**
+ * @brief Converts nanoseconds to a cycle count.
+ */
+static inline uint64_t fossil_sys_hostinfo_ns_to_cycles(const fossil_sys_hostinfo_tsc_t *tsc, uint64_t ns)
+{
+    if (!tsc || !tsc->frequency_hz)
+        return 0;
+    return (ns / 1000000000u) * tsc->frequency_hz + (ns % 1000000000u) * tsc->frequency_hz / 1000000000u;
+}
+
+/**
+ * @brief Reads per-CPU interrupt and softirq counters.
+ *
+ * Parses /proc/interrupts and /proc/softirqs into the tables described by
+ * fossil_sys_hostinfo_interrupts_t. Only online CPUs appear as columns.
+ *
+ * @param[out] stats Pointer to a structure receiving the tables. Release it
+ *                   with fossil_sys_hostinfo_free_interrupts on success.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported,
+ *         -3 if the files could not be read or memory could not be allocated.
+ */
+int fossil_sys_hostinfo_get_interrupts(fossil_sys_hostinfo_interrupts_t *stats);
+
+/**
+ * @brief Releases tables allocated by the interrupt functions.
+ *
+ * Safe to call on a zeroed structure or twice in a row.
+ */
+void fossil_sys_hostinfo_free_interrupts(fossil_sys_hostinfo_interrupts_t *stats);
+
+/**
+ * @brief Computes counter increases between two readings.
+ *
+ * Rows are matched by name and columns by CPU number, so the readings may
+ * differ in shape (an IRQ registered or a CPU brought online in between).
+ * The result has the shape of after; counters that went backwards or are
+ * missing from before count from zero.
+ *
+ * @param before Earlier reading.
+ * @param after Later reading.
+ * @param[out] delta Pointer to a structure receiving the increases. Release
+ *                   it with fossil_sys_hostinfo_free_interrupts on success.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported,
+ *         -3 on allocation failure.
+ */
+int fossil_sys_hostinfo_interrupts_delta(const fossil_sys_hostinfo_interrupts_t *before,
+                                         const fossil_sys_hostinfo_interrupts_t *after,
+                                         fossil_sys_hostinfo_interrupts_t *delta);
+
+/**
+ * @brief Ranks CPUs by interrupt load for pinning latency-sensitive work.
+ *
+ * Load is the sum of hardware interrupts and softirqs per column; pass a
+ * delta to rank by recent activity rather than counts since boot. Ties are
+ * broken by CPU number.
+ *
+ * @param stats Reading or delta to rank.
+ * @param[out] cpus Buffer receiving CPU numbers, quietest first.
+ * @param capacity Number of entries cpus can hold.
+ * @param[out] count Number of CPUs written.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported,
+ *         -3 on allocation failure.
+ */
+int fossil_sys_hostinfo_quiet_cpus(const fossil_sys_hostinfo_interrupts_t *stats,
+                                   int *cpus, size_t capacity, size_t *count);
+
+/**
+ * @brief Counts and classifies the open file descriptors of a process.
+ *
+ * Lists /proc/<pid>/fd once and resolves each entry with readlinkat on
+ * the directory descriptor, then matches socket inodes against the
+ * process's /proc/net/{tcp,tcp6,udp,udp6,unix} tables with a sorted
+ * lookup, so the cost stays linear in the descriptor count.
+ *
+ * @param pid Process to inspect, 0 for the calling process.
+ * @param[out] info Pointer to a structure receiving the counts.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported,
+ *         -3 if the descriptor directory could not be read or memory ran out.
+ */
+int fossil_sys_hostinfo_get_fd_inventory(int pid, fossil_sys_hostinfo_fd_inventory_t *info);
+
+/**
+ * @brief Opens the frequency and thermal telemetry sources.
+ *
+ * Discovers online CPUs, their cpufreq policies, thermal throttle counters
+ * and thermal zones, and keeps one file descriptor per attribute open so
+ * fossil_sys_hostinfo_cpufreq_read only issues pread calls. Calling it
+ * again re-discovers the sources.
+ *
+ * @return 0 on success, -2 if unsupported, -3 if no source could be opened.
+ */
+int fossil_sys_hostinfo_cpufreq_open(void);
+
+/**
+ * @brief Reads the current frequency and thermal telemetry.
+ *
+ * Cheap enough to call in a benchmark loop; opens the sources on first use.
+ *
+ * @param[out] state Pointer to a structure receiving per-CPU frequencies,
+ *                   governors, throttle counters and zone temperatures.
+ * @return 0 on success, -1 on invalid arguments, -2 if unsupported,
+ *         -3 if the sources could not be opened.
+ */
+int fossil_sys_hostinfo_cpufreq_read(fossil_sys_hostinfo_cpufreq_state_t *state);
+
+/**
+ * @brief Closes the descriptors opened by fossil_sys_hostinfo_cpufreq_open.
+ *
+ * @return 0 on success, -2 if unsupported.
  */
-int fossil_sys_hostinfo_get_hardware(fossil_sys_hostinfo_hardware_t *info);
+int fossil_sys_hostinfo_cpufreq_close(void);
 
 /**
- * @brief Retrieves display information about the host system.
+ * @brief Counts thermal throttle events between two readings.
  *
- * This function fills the fossil_sys_hostinfo_display_t structure with
- * details about connected displays, including display count, primary
- * resolution, and refresh rate.
+ * A non-zero result means frequency scaling noise affected the interval.
+ * Counters are reported by every CPU sharing a core or package, so one
+ * event may be counted several times; treat the value as an indicator.
  *
- * @param[out] info Pointer to a fossil_sys_hostinfo_display_t structure
- *                  that will be populated with display information.
- * @return 0 on success, or a negative error code on failure.
+ * @param before Earlier reading.
+ * @param after Later reading.
+ * @return Sum over CPUs of core and package throttle count increases,
+ *         0 if either reading is NULL.
  */
-int fossil_sys_hostinfo_get_display(fossil_sys_hostinfo_display_t *info);
+uint64_t fossil_sys_hostinfo_cpufreq_throttle_delta(const fossil_sys_hostinfo_cpufreq_state_t *before,
+                                                    const fossil_sys_hostinfo_cpufreq_state_t *after);
+
+/**
+ * @brief Checks whether a CPU is a member of a CPU set.
+ */
+static inline int fossil_sys_hostinfo_cpuset_has(const fossil_sys_hostinfo_cpuset_t *set, int cpu)
+{
+    if (!set || cpu < 0 || cpu >= FOSSIL_SYS_HOSTINFO_CPU_MAX)
+        return 0;
+    return (set->bits[cpu / 64] >> (cpu % 64)) & 1u;
+}
+
+/**
+ * @brief Adds a CPU to a CPU set.
+ */
+static inline void fossil_sys_hostinfo_cpuset_add(fossil_sys_hostinfo_cpuset_t *set, int cpu)
+{
+    if (!set || cpu < 0 || cpu >= FOSSIL_SYS_HOSTINFO_CPU_MAX)
+        return;
+    set->bits[cpu / 64] |= (uint64_t)1 << (cpu % 64);
+}
+
+/**
+ * @brief Counts the CPUs in a CPU set.
+ */
+static inline int fossil_sys_hostinfo_cpuset_count(const fossil_sys_hostinfo_cpuset_t *set)
+{
+    int count = 0;
+    if (!set)
+        return 0;
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_CPU_MAX / 64; ++i)
+    {
+        uint64_t word = set->bits[i];
+        while (word)
+        {
+            word &= word - 1;
+            count++;
+        }
+    }
+    return count;
+}
 
 #ifdef __cplusplus
 }
 
+#include <string>
+#include <vector>
+
 /**
  * Fossil namespace.
  */
@@ -450,13 +1870,14 @@ namespace fossil::sys
          * operating system, kernel version, hostname, username, domain name,
          * machine type, and platform of the host system.
          *
-         * @return A structure containing system information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached system information.
          */
-        static fossil_sys_hostinfo_system_t get_system()
+        static const fossil_sys_hostinfo_system_t &get_system()
         {
-            fossil_sys_hostinfo_system_t info;
-            fossil_sys_hostinfo_get_system(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM)->system;
         }
 
         /**
@@ -466,13 +1887,14 @@ namespace fossil::sys
          * architecture, such as architecture name, CPU, number of cores and
          * threads, frequency, and CPU architecture.
          *
-         * @return A structure containing architecture information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached architecture information.
          */
-        static fossil_sys_hostinfo_architecture_t get_architecture()
+        static const fossil_sys_hostinfo_architecture_t &get_architecture()
         {
-            fossil_sys_hostinfo_architecture_t info;
-            fossil_sys_hostinfo_get_architecture(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_ARCHITECTURE)->architecture;
         }
 
         /**
@@ -482,13 +1904,16 @@ namespace fossil::sys
          * memory, including total, free, used, and available memory, as well
          * as swap statistics.
          *
+         * Served from the volatile hostinfo snapshot; re-collected only when
+         * older than the snapshot TTL.
+         *
          * @return A structure containing memory information.
          */
         static fossil_sys_hostinfo_memory_t get_memory()
         {
-            fossil_sys_hostinfo_memory_t info;
-            fossil_sys_hostinfo_get_memory(&info);
-            return info;
+            fossil_sys_hostinfo_memory_t memory{};
+            fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &memory, sizeof(memory));
+            return memory;
         }
 
         /**
@@ -497,13 +1922,14 @@ namespace fossil::sys
          * This function returns a structure indicating whether the system is
          * little-endian or big-endian.
          *
-         * @return A structure containing endianness information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached endianness information.
          */
-        static fossil_sys_hostinfo_endianness_t get_endianness()
+        static const fossil_sys_hostinfo_endianness_t &get_endianness()
         {
-            fossil_sys_hostinfo_endianness_t info;
-            fossil_sys_hostinfo_get_endianness(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS)->endianness;
         }
 
         /**
@@ -513,13 +1939,14 @@ namespace fossil::sys
          * including model, vendor, number of cores, threads, frequency, and
          * supported features.
          *
-         * @return A structure containing CPU information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached CPU information.
          */
-        static fossil_sys_hostinfo_cpu_t get_cpu()
+        static const fossil_sys_hostinfo_cpu_t &get_cpu()
         {
-            fossil_sys_hostinfo_cpu_t info;
-            fossil_sys_hostinfo_get_cpu(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_CPU)->cpu;
         }
 
         /**
@@ -528,15 +1955,243 @@ namespace fossil::sys
          * This function returns a structure with details about the GPU,
          * such as name, vendor, driver version, and memory statistics.
          *
-         * @return A structure containing GPU information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached GPU information.
+         */
+        static const fossil_sys_hostinfo_gpu_t &get_gpu()
+        {
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_GPU)->gpu;
+        }
+
+        /**
+         * @brief Retrieves every GPU in the host system.
+         *
+         * @return A list containing one entry per GPU.
+         */
+        static fossil_sys_hostinfo_gpu_list_t get_gpus()
+        {
+            fossil_sys_hostinfo_gpu_list_t list{};
+            fossil_sys_hostinfo_get_gpus(&list);
+            return list;
+        }
+
+        /**
+         * @brief Retrieves every real mounted filesystem.
+         *
+         * @param list Reference to a list to be filled with the mounts.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_mounts(fossil_sys_hostinfo_mount_list_t &list)
+        {
+            return fossil_sys_hostinfo_get_mounts(&list);
+        }
+
+        /**
+         * @brief Fills in capacity for one mount; may block on network mounts.
+         *
+         * @param mount Mount whose mount_point is queried.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_mount_space(fossil_sys_hostinfo_mount_t &mount)
+        {
+            return fossil_sys_hostinfo_get_mount_space(&mount);
+        }
+
+        /**
+         * @brief Retrieves whole block devices with queue details and IO counters.
+         *
+         * @param list Reference to a list to be filled with the devices.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_block_devices(fossil_sys_hostinfo_block_device_list_t &list)
+        {
+            return fossil_sys_hostinfo_get_block_devices(&list);
+        }
+
+        /**
+         * @brief Retrieves every network interface.
+         *
+         * @param list Reference to a list to be filled with the interfaces.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_interfaces(fossil_sys_hostinfo_interface_list_t &list)
+        {
+            return fossil_sys_hostinfo_get_interfaces(&list);
+        }
+
+        /**
+         * @brief Refreshes only the traffic counters of an interface list.
+         *
+         * @param list Reference to a list filled by get_interfaces.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int refresh_interface_counters(fossil_sys_hostinfo_interface_list_t &list)
+        {
+            return fossil_sys_hostinfo_refresh_interface_counters(&list);
+        }
+
+        /**
+         * @brief Retrieves a detailed memory breakdown.
+         *
+         * @param info Reference to a structure receiving /proc/meminfo fields,
+         *             huge page pools and the THP mode.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_meminfo(fossil_sys_hostinfo_meminfo_t &info)
+        {
+            return fossil_sys_hostinfo_get_meminfo(&info);
+        }
+
+        /**
+         * @brief Reads per-CPU frequency and thermal telemetry.
+         *
+         * @param state Reference to a structure receiving the reading.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int read_cpufreq(fossil_sys_hostinfo_cpufreq_state_t &state)
+        {
+            return fossil_sys_hostinfo_cpufreq_read(&state);
+        }
+
+        /**
+         * @brief Collects the requested hostinfo sections in one pass.
+         *
+         * @param info Reference to a structure receiving the sections.
+         * @param sections Mask of fossil_sys_hostinfo_section_t bits.
+         * @return 0 on success, or a negative error code on failure.
          */
-        static fossil_sys_hostinfo_gpu_t get_gpu()
+        static int collect_all(fossil_sys_hostinfo_all_t &info,
+                               uint32_t sections = FOSSIL_SYS_HOSTINFO_SECTION_ALL)
         {
-            fossil_sys_hostinfo_gpu_t info;
-            fossil_sys_hostinfo_get_gpu(&info);
+            return fossil_sys_hostinfo_collect_all(sections, &info);
+        }
+
+        /**
+         * @brief Serializes collected sections as a JSON string.
+         *
+         * @param info Collected sections.
+         * @return The JSON document, or an empty string on failure.
+         */
+        static std::string to_json(const fossil_sys_hostinfo_all_t &info)
+        {
+            size_t length = 0;
+            if (fossil_sys_hostinfo_to_json(&info, nullptr, 0, &length) != -4)
+                return std::string();
+            std::string json(length, '\0');
+            if (fossil_sys_hostinfo_to_json(&info, json.data(), length + 1, nullptr) != 0)
+                return std::string();
+            return json;
+        }
+
+        /**
+         * @brief Retrieves the CPU and memory budget of this process.
+         *
+         * @return A structure with affinity, cgroup quota and effective limits.
+         */
+        static fossil_sys_hostinfo_resources_t get_resources()
+        {
+            fossil_sys_hostinfo_resources_t info;
+            fossil_sys_hostinfo_get_resources(&info);
             return info;
         }
 
+        /**
+         * @brief Returns the number of CPUs this process can effectively use.
+         */
+        static int effective_cpus()
+        {
+            return fossil_sys_hostinfo_effective_cpus();
+        }
+
+        /**
+         * @brief Reads a kernel clock in nanoseconds.
+         *
+         * @param clock Clock to read.
+         * @return Nanoseconds since the clock's epoch, or 0 if unsupported.
+         */
+        static uint64_t clock_ns(fossil_sys_hostinfo_clock_t clock = FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC)
+        {
+            return fossil_sys_hostinfo_clock_ns(clock);
+        }
+
+        /**
+         * @brief Fast monotonic timestamp in nanoseconds with an arbitrary epoch.
+         */
+        static uint64_t timestamp_ns()
+        {
+            return fossil_sys_hostinfo_timestamp_ns();
+        }
+
+        /**
+         * @brief Describes the CPU cycle counter.
+         */
+        static const fossil_sys_hostinfo_tsc_t &get_tsc()
+        {
+            return *fossil_sys_hostinfo_get_tsc();
+        }
+
+        /**
+         * @brief Reads per-CPU interrupt and softirq counters.
+         *
+         * @param stats Reference to a structure receiving the tables; release
+         *              it with free_interrupts.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_interrupts(fossil_sys_hostinfo_interrupts_t &stats)
+        {
+            return fossil_sys_hostinfo_get_interrupts(&stats);
+        }
+
+        /**
+         * @brief Releases tables allocated by get_interrupts or interrupts_delta.
+         */
+        static void free_interrupts(fossil_sys_hostinfo_interrupts_t &stats)
+        {
+            fossil_sys_hostinfo_free_interrupts(&stats);
+        }
+
+        /**
+         * @brief Computes counter increases between two readings.
+         *
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int interrupts_delta(const fossil_sys_hostinfo_interrupts_t &before,
+                                    const fossil_sys_hostinfo_interrupts_t &after,
+                                    fossil_sys_hostinfo_interrupts_t &delta)
+        {
+            return fossil_sys_hostinfo_interrupts_delta(&before, &after, &delta);
+        }
+
+        /**
+         * @brief Ranks CPUs by interrupt load, quietest first.
+         *
+         * @param stats Reading or delta to rank.
+         * @return CPU numbers, or an empty vector on failure.
+         */
+        static std::vector<int> quiet_cpus(const fossil_sys_hostinfo_interrupts_t &stats)
+        {
+            std::vector<int> cpus(stats.cpu_count);
+            size_t count = 0;
+            if (cpus.empty() || fossil_sys_hostinfo_quiet_cpus(&stats, cpus.data(), cpus.size(), &count) != 0)
+                return {};
+            cpus.resize(count);
+            return cpus;
+        }
+
+        /**
+         * @brief Counts and classifies the open file descriptors of a process.
+         *
+         * @param info Reference to a structure receiving the counts.
+         * @param pid Process to inspect, 0 for the calling process.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int get_fd_inventory(fossil_sys_hostinfo_fd_inventory_t &info, int pid = 0)
+        {
+            return fossil_sys_hostinfo_get_fd_inventory(pid, &info);
+        }
+
         /**
          * @brief Retrieves power information about the host system.
          *
@@ -544,13 +2199,16 @@ namespace fossil::sys
          * power state, including AC power status, battery presence, charging
          * state, battery percentage, and estimated time remaining.
          *
+         * Served from the volatile hostinfo snapshot; re-collected only when
+         * older than the snapshot TTL.
+         *
          * @return A structure containing power information.
          */
         static fossil_sys_hostinfo_power_t get_power()
         {
-            fossil_sys_hostinfo_power_t info;
-            fossil_sys_hostinfo_get_power(&info);
-            return info;
+            fossil_sys_hostinfo_power_t power{};
+            fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_POWER, &power, sizeof(power));
+            return power;
         }
 
         /**
@@ -560,13 +2218,16 @@ namespace fossil::sys
          * storage device, such as device name, mount point, total space,
          * free space, used space, and filesystem type.
          *
+         * Served from the volatile hostinfo snapshot; re-collected only when
+         * older than the snapshot TTL.
+         *
          * @return A structure containing storage information.
          */
         static fossil_sys_hostinfo_storage_t get_storage()
         {
-            fossil_sys_hostinfo_storage_t info;
-            fossil_sys_hostinfo_get_storage(&info);
-            return info;
+            fossil_sys_hostinfo_storage_t storage{};
+            fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_STORAGE, &storage, sizeof(storage));
+            return storage;
         }
 
         /**
@@ -592,13 +2253,16 @@ namespace fossil::sys
          * the system has been running since its last boot and the boot time
          * in epoch seconds.
          *
+         * Served from the volatile hostinfo snapshot; re-collected only when
+         * older than the snapshot TTL.
+         *
          * @return A structure containing uptime information.
          */
         static fossil_sys_hostinfo_uptime_t get_uptime()
         {
-            fossil_sys_hostinfo_uptime_t info;
-            fossil_sys_hostinfo_get_uptime(&info);
-            return info;
+            fossil_sys_hostinfo_uptime_t uptime{};
+            fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_UPTIME, &uptime, sizeof(uptime));
+            return uptime;
         }
 
         /**
@@ -610,13 +2274,14 @@ namespace fossil::sys
          * detected or whether the system is running on bare metal or in a
          * container.
          *
-         * @return A structure containing virtualization information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached virtualization information.
          */
-        static fossil_sys_hostinfo_virtualization_t get_virtualization()
+        static const fossil_sys_hostinfo_virtualization_t &get_virtualization()
         {
-            fossil_sys_hostinfo_virtualization_t info;
-            fossil_sys_hostinfo_get_virtualization(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION)->virtualization;
         }
 
         /**
@@ -626,13 +2291,16 @@ namespace fossil::sys
          * interface, including hostname, IP address, MAC address, interface name,
          * and link status.
          *
+         * Served from the volatile hostinfo snapshot; re-collected only when
+         * older than the snapshot TTL.
+         *
          * @return A structure containing network information.
          */
         static fossil_sys_hostinfo_network_t get_network()
         {
-            fossil_sys_hostinfo_network_t info;
-            fossil_sys_hostinfo_get_network(&info);
-            return info;
+            fossil_sys_hostinfo_network_t network{};
+            fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_NETWORK, &network, sizeof(network));
+            return network;
         }
 
         /**
@@ -687,13 +2355,14 @@ namespace fossil::sys
          * This function returns a structure with details about the system
          * manufacturer, product name, serial number, and BIOS or firmware version.
          *
-         * @return A structure containing hardware information.
+         * The value is collected once per process and served from the
+         * static hostinfo snapshot afterwards.
+         *
+         * @return Reference to the cached hardware information.
          */
-        static fossil_sys_hostinfo_hardware_t get_hardware()
+        static const fossil_sys_hostinfo_hardware_t &get_hardware()
         {
-            fossil_sys_hostinfo_hardware_t info;
-            fossil_sys_hostinfo_get_hardware(&info);
-            return info;
+            return fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE)->hardware;
         }
 
         /**
@@ -710,6 +2379,170 @@ namespace fossil::sys
             fossil_sys_hostinfo_get_display(&info);
             return info;
         }
+
+        /**
+         * @brief Sets the time-to-live of volatile snapshot sections.
+         *
+         * @param ttl_ms Maximum age in milliseconds; 0 disables caching.
+         */
+        static void set_snapshot_ttl(uint32_t ttl_ms)
+        {
+            fossil_sys_hostinfo_snapshot_set_ttl(ttl_ms);
+        }
+
+        /**
+         * @brief Forces volatile snapshot sections to be re-collected.
+         */
+        static void invalidate()
+        {
+            fossil_sys_hostinfo_snapshot_invalidate();
+        }
+
+        /**
+         * @brief Retrieves the cached CPU topology of the host system.
+         *
+         * The topology is discovered once and shared for the lifetime of the
+         * process.
+         *
+         * @return Pointer to the cached topology, or nullptr on failure.
+         */
+        static const fossil_sys_hostinfo_topology_t *get_topology()
+        {
+            return fossil_sys_hostinfo_get_topology();
+        }
+
+        /**
+         * @brief Retrieves the CPUs sharing a cache of the given level with a CPU.
+         *
+         * @param cpu   Logical CPU id.
+         * @param level Cache level (1, 2, 3, ...).
+         * @return Set of CPUs sharing the cache; empty if unknown.
+         */
+        static fossil_sys_hostinfo_cpuset_t cache_siblings(int cpu, int level)
+        {
+            fossil_sys_hostinfo_cpuset_t set{};
+            fossil_sys_hostinfo_topology_cache_siblings(cpu, level, &set);
+            return set;
+        }
+
+        /**
+         * @brief Retrieves the SMT siblings of a CPU.
+         *
+         * @param cpu Logical CPU id.
+         * @return Set of hardware threads on the same core; empty if unknown.
+         */
+        static fossil_sys_hostinfo_cpuset_t smt_siblings(int cpu)
+        {
+            fossil_sys_hostinfo_cpuset_t set{};
+            fossil_sys_hostinfo_topology_smt_siblings(cpu, &set);
+            return set;
+        }
+
+        /**
+         * @brief Retrieves the NUMA node that a CPU belongs to.
+         *
+         * @param cpu Logical CPU id.
+         * @return NUMA node id, or -1 if unknown.
+         */
+        static int numa_node(int cpu)
+        {
+            return fossil_sys_hostinfo_topology_numa_node(cpu);
+        }
+
+        /**
+         * @brief Checks whether the host CPU supports a feature.
+         *
+         * @param feature Feature to query.
+         * @return true if supported.
+         */
+        static bool has_feature(fossil_sys_hostinfo_feature_t feature)
+        {
+            return fossil_sys_hostinfo_has_feature(feature) != 0;
+        }
+
+        /**
+         * @brief Selects an implementation from a dispatch table.
+         *
+         * Typically used to initialise a function-local static so the
+         * selection happens once:
+         * `static const auto impl = Hostinfo::dispatch<sum_fn>(table, n);`
+         *
+         * @param table Candidate implementations, best first.
+         * @param count Number of entries in table.
+         * @return Selected function cast to Fn, or nullptr.
+         */
+        template <typename Fn>
+        static Fn dispatch(const fossil_sys_hostinfo_dispatch_entry_t *table, size_t count)
+        {
+            return reinterpret_cast<Fn>(fossil_sys_hostinfo_dispatch_select(table, count));
+        }
+
+        /**
+         * @brief Starts the background metrics sampler.
+         *
+         * @param interval_ms Sampling interval in milliseconds.
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int start_sampler(uint32_t interval_ms = FOSSIL_SYS_HOSTINFO_SAMPLER_INTERVAL_MS)
+        {
+            return fossil_sys_hostinfo_sampler_start(interval_ms);
+        }
+
+        /**
+         * @brief Stops the background metrics sampler.
+         *
+         * @return 0 on success, or a negative error code on failure.
+         */
+        static int stop_sampler()
+        {
+            return fossil_sys_hostinfo_sampler_stop();
+        }
+
+        /**
+         * @brief Retrieves the most recent metrics sample.
+         *
+         * @param[out] sample Receives the sample.
+         * @return true if a sample was available.
+         */
+        static bool latest_sample(fossil_sys_hostinfo_sample_t &sample)
+        {
+            return fossil_sys_hostinfo_sampler_latest(&sample) == 0;
+        }
+
+        /**
+         * @brief Reads Pressure Stall Information for a resource.
+         *
+         * @param resource CPU, memory or IO.
+         * @return Pressure figures; zeroed if PSI is unavailable.
+         */
+        static fossil_sys_hostinfo_psi_t get_psi(fossil_sys_hostinfo_psi_resource_t resource)
+        {
+            fossil_sys_hostinfo_psi_t info{};
+            fossil_sys_hostinfo_get_psi(resource, &info);
+            return info;
+        }
+
+        /**
+         * @brief Registers a kernel PSI trigger delivered through the event subsystem.
+         *
+         * @return Trigger id, or a negative error code.
+         */
+        static int add_psi_trigger(fossil_sys_hostinfo_psi_resource_t resource,
+                                   fossil_sys_hostinfo_psi_kind_t kind,
+                                   uint32_t stall_us, uint32_t window_us)
+        {
+            return fossil_sys_hostinfo_psi_trigger_add(resource, kind, stall_us, window_us);
+        }
+
+        /**
+         * @brief Removes a PSI trigger.
+         *
+         * @return 0 on success, -1 if the id is unknown.
+         */
+        static int remove_psi_trigger(int trigger_id)
+        {
+            return fossil_sys_hostinfo_psi_trigger_remove(trigger_id);
+        }
     };
 
 }
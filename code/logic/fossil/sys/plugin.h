@@ -0,0 +1,281 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_SYS_PLUGIN_H
+#define FOSSIL_SYS_PLUGIN_H
+
+#include "dynamic.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+===============================================================================
+Fossil Sys Plugin API
+
+Hot-reloadable plugins on top of fossil_sys_dynamic. A plugin is a shared
+library plus the list of symbols the host calls. Every version is loaded
+from a private copy of the file (so the loader never hands back the old
+mapping) and its symbols are resolved into an immutable function table.
+Copies go next to the plugin unless another directory is given, since
+temp directories are often mounted noexec; copies left by processes that
+died without closing the plugin are removed on the next open.
+
+Calls never take a lock:
+
+    unsigned long token;
+    const fossil_sys_plugin_table_t *t = fossil_sys_plugin_enter(p, &token);
+    ((int (*)(int))t->fns[0])(42);
+    fossil_sys_plugin_leave(p, token);
+
+A reload publishes the new table with one atomic store. The old version
+stays mapped until every reader that could have seen it has left (two
+epochs) and its grace period has passed; only then is it unloaded and its
+copy removed. Readers inside a call are never blocked or unmapped.
+
+Changes are detected with inotify on the plugin's directory (so both
+in-place writes and atomic renames are seen) and with mtime/size polling
+on other platforms. fossil_sys_plugin_poll is meant to be called from a
+housekeeping loop; writers (poll, reload, collect) are serialized.
+===============================================================================
+*/
+
+/* Immutable function table of one plugin version */
+typedef struct
+{
+    uint64_t version; /* 1 for the first load, +1 per reload */
+    size_t count;     /* number of symbols */
+    void *const *fns; /* addresses in the order given to open */
+} fossil_sys_plugin_table_t;
+
+typedef struct fossil_sys_plugin fossil_sys_plugin_t;
+
+/**
+ * Load a plugin and start watching its file.
+ *
+ * @param path Path to the shared library.
+ * @param symbols Names of the symbols to resolve, all required.
+ * @param count Number of symbols.
+ * @return The plugin, or NULL on failure (see fossil_sys_dynamic_error).
+ */
+fossil_sys_plugin_t *fossil_sys_plugin_open(const char *path, const char *const *symbols, size_t count);
+
+/**
+ * Load a plugin, placing version copies in a chosen directory.
+ *
+ * @param path Path to the shared library.
+ * @param symbols Names of the symbols to resolve, all required.
+ * @param count Number of symbols.
+ * @param copy_dir Directory for version copies, on a filesystem that
+ *        allows executable mappings; NULL for the plugin's own directory.
+ * @return The plugin, or NULL on failure (see fossil_sys_dynamic_error).
+ */
+fossil_sys_plugin_t *fossil_sys_plugin_open_ex(const char *path, const char *const *symbols, size_t count,
+                                               const char *copy_dir);
+
+/**
+ * Unload every version and free the plugin. No thread may be between
+ * enter and leave.
+ *
+ * @param plugin The plugin (may be NULL).
+ */
+void fossil_sys_plugin_close(fossil_sys_plugin_t *plugin);
+
+/**
+ * Begin a call: pin and return the current function table.
+ *
+ * @param plugin The plugin.
+ * @param token Receives the token to pass to fossil_sys_plugin_leave.
+ * @return The table, valid until fossil_sys_plugin_leave.
+ */
+const fossil_sys_plugin_table_t *fossil_sys_plugin_enter(fossil_sys_plugin_t *plugin, unsigned long *token);
+
+/**
+ * End a call started with fossil_sys_plugin_enter.
+ *
+ * @param plugin The plugin.
+ * @param token Token returned by enter.
+ */
+void fossil_sys_plugin_leave(fossil_sys_plugin_t *plugin, unsigned long token);
+
+/**
+ * Reload if the file changed since the last load, then collect retired
+ * versions. Never blocks.
+ *
+ * @param plugin The plugin.
+ * @return 1 if a new version was published, 0 if unchanged, -1 on invalid
+ *         arguments, -3 if the new version failed to load (the current
+ *         version stays active).
+ */
+int fossil_sys_plugin_poll(fossil_sys_plugin_t *plugin);
+
+/**
+ * Load and publish a new version unconditionally.
+ *
+ * @param plugin The plugin.
+ * @return 1 on success, -1 on invalid arguments, -3 if the new version
+ *         failed to load (the current version stays active).
+ */
+int fossil_sys_plugin_reload(fossil_sys_plugin_t *plugin);
+
+/**
+ * Unload retired versions that no reader can still hold and whose grace
+ * period has passed.
+ *
+ * @param plugin The plugin.
+ * @return Number of versions still retired.
+ */
+size_t fossil_sys_plugin_collect(fossil_sys_plugin_t *plugin);
+
+/**
+ * Keep retired versions mapped for at least grace_ns after they are
+ * replaced, for function pointers that escape enter/leave (default 0).
+ *
+ * @param plugin The plugin.
+ * @param grace_ns Minimum time in nanoseconds.
+ */
+void fossil_sys_plugin_set_grace(fossil_sys_plugin_t *plugin, uint64_t grace_ns);
+
+/**
+ * Version of the current table.
+ *
+ * @param plugin The plugin.
+ * @return The version, or 0 if plugin is NULL.
+ */
+uint64_t fossil_sys_plugin_version(fossil_sys_plugin_t *plugin);
+
+/**
+ * Descriptor to wait on for file changes (readable when poll may have
+ * work), for use with poll/epoll loops.
+ *
+ * @param plugin The plugin.
+ * @return The descriptor, or -1 where changes are detected by polling.
+ */
+int fossil_sys_plugin_watch_fd(const fossil_sys_plugin_t *plugin);
+
+#ifdef __cplusplus
+}
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace fossil::sys {
+
+    /**
+     * RAII wrapper over fossil_sys_plugin_t.
+     */
+    class Plugin {
+    public:
+        /**
+         * Pins the current version for the lifetime of the guard.
+         */
+        class Guard {
+        public:
+            explicit Guard(fossil_sys_plugin_t* plugin)
+                : plugin_(plugin), token_(0), table_(fossil_sys_plugin_enter(plugin, &token_)) {}
+            ~Guard() { fossil_sys_plugin_leave(plugin_, token_); }
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+
+            /**
+             * Typed function pointer of symbol index in this version.
+             */
+            template <typename Sig>
+            Sig* fn(size_t index) const {
+                Sig* out = nullptr;
+                void* sym = table_->fns[index];
+                static_assert(sizeof(out) == sizeof(sym), "function and data pointers differ in size");
+                memcpy(&out, &sym, sizeof(out));
+                return out;
+            }
+
+            /**
+             * Version pinned by this guard.
+             */
+            uint64_t version() const { return table_->version; }
+
+        private:
+            fossil_sys_plugin_t* plugin_;
+            unsigned long token_;
+            const fossil_sys_plugin_table_t* table_;
+        };
+
+        /**
+         * Load a plugin; copy_dir empty for copies next to the plugin.
+         */
+        Plugin(const std::string& path, const std::vector<std::string>& symbols, const std::string& copy_dir = "") {
+            std::vector<const char*> names;
+            for (const auto& name : symbols)
+                names.push_back(name.c_str());
+            plugin_ = fossil_sys_plugin_open_ex(path.c_str(), names.data(), names.size(),
+                                                copy_dir.empty() ? nullptr : copy_dir.c_str());
+        }
+        ~Plugin() { fossil_sys_plugin_close(plugin_); }
+        Plugin(const Plugin&) = delete;
+        Plugin& operator=(const Plugin&) = delete;
+
+        /**
+         * Whether the first version loaded.
+         */
+        bool is_open() const { return plugin_ != nullptr; }
+
+        /**
+         * Pin the current version for a call.
+         */
+        Guard enter() const { return Guard(plugin_); }
+
+        /**
+         * Reload if the file changed, then collect retired versions.
+         */
+        int poll() { return fossil_sys_plugin_poll(plugin_); }
+
+        /**
+         * Load and publish a new version unconditionally.
+         */
+        int reload() { return fossil_sys_plugin_reload(plugin_); }
+
+        /**
+         * Version of the current table.
+         */
+        uint64_t version() const { return fossil_sys_plugin_version(plugin_); }
+
+        /**
+         * Get the underlying plugin.
+         */
+        fossil_sys_plugin_t* raw() const { return plugin_; }
+
+    private:
+        fossil_sys_plugin_t* plugin_;
+    };
+
+} // namespace fossil::sys
+
+#endif
+
+#endif /* FOSSIL_SYS_PLUGIN_H */
@@ -22,6 +22,11 @@
  * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// Must be defined before any header for pread, sched_getaffinity and friends
+#define _GNU_SOURCE
+#endif
+
 #include "fossil/sys/hostinfo.h"
 
 #if defined(__APPLE__)
@@ -64,10 +69,15 @@
 #include <sys/time.h>
 #include <arpa/inet.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <net/if_dl.h>
 #include <mach/mach.h>
 #include <mach/mach_host.h>
 #include <mach/vm_statistics.h>
 #include <mach/vm_types.h>
+#include <pthread.h>
 
 // Graphics and power info (IOKit, CoreFoundation, CoreGraphics)
 #include <IOKit/IOKitLib.h>
@@ -88,12 +98,17 @@
 #include <arpa/inet.h>
 #include <locale.h>
 #include <netdb.h>
+#include <netinet/in.h>
+#include <ifaddrs.h>
 
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <errno.h>
 #include <linux/kd.h>
 #include <linux/fb.h>
+#include <linux/if.h>
+#include <linux/if_packet.h>
+#include <pthread.h>
 #endif
 
 #include <stdint.h>
@@ -436,151 +451,33 @@ int fossil_sys_hostinfo_get_gpu(fossil_sys_hostinfo_gpu_t *info)
     if (!info)
         return -1;
     memset(info, 0, sizeof(*info));
-#ifdef _WIN32
-    // Use DXGI to enumerate adapters
-    IDXGIFactory *factory = NULL;
-    if (SUCCEEDED(CreateDXGIFactory(&IID_IDXGIFactory, (void **)&factory)))
-    {
-        IDXGIAdapter *adapter = NULL;
-        if (factory->lpVtbl->EnumAdapters(factory, 0, &adapter) == S_OK)
-        { // first GPU
-            DXGI_ADAPTER_DESC desc;
-            if (adapter->lpVtbl->GetDesc(adapter, &desc) == S_OK)
-            {
-                // Copy strings
-                wcstombs(info->name, desc.Description, sizeof(info->name) - 1);
-                info->name[sizeof(info->name) - 1] = '\0';
-                strncpy(info->vendor, "Unknown", sizeof(info->vendor) - 1); // Vendor ID can be parsed if desired
-                info->vendor[sizeof(info->vendor) - 1] = '\0';
-                snprintf(info->driver_version, sizeof(info->driver_version), "DeviceID: %u", desc.DeviceId);
+    info->drm_card = -1;
 
-                info->memory_total = desc.DedicatedVideoMemory;
-                info->memory_free = 0; // DXGI doesn't provide free memory directly
-            }
-            adapter->lpVtbl->Release(adapter);
-        }
-        factory->lpVtbl->Release(factory);
-    }
-#elif defined(__APPLE__)
-    // macOS: Use IOKit to find GPU devices
-    CFMutableDictionaryRef matchDict = IOServiceMatching("IOPCIDevice");
-    if (matchDict)
-    {
-        io_iterator_t iter;
-        // Use kIOMainPortDefault for macOS 12+ compatibility
-        if (IOServiceGetMatchingServices(kIOMainPortDefault, matchDict, &iter) == KERN_SUCCESS)
-        {
-            io_object_t service;
-            while ((service = IOIteratorNext(iter)))
-            {
-                CFStringRef model = (CFStringRef)IORegistryEntryCreateCFProperty(
-                    service, CFSTR("model"), kCFAllocatorDefault, 0);
-                if (model)
-                {
-                    CFIndex length = CFStringGetLength(model);
-                    CFIndex maxSize = CFStringGetMaximumSizeForEncoding(length, kCFStringEncodingUTF8) + 1;
-                    char buffer[256];
-                    // Cast sizeof(buffer) to CFIndex for comparison
-                    if (maxSize < (CFIndex)sizeof(buffer))
-                    {
-                        if (CFStringGetCString(model, buffer, sizeof(buffer), kCFStringEncodingUTF8))
-                        {
-                            strncpy(info->name, buffer, sizeof(info->name) - 1);
-                            strncpy(info->vendor, "Apple/AMD/NVIDIA", sizeof(info->vendor) - 1);
-                            strncpy(info->driver_version, "Unknown", sizeof(info->driver_version) - 1);
-                            info->memory_total = 0; // macOS doesn't expose VRAM easily
-                            info->memory_free = 0;
-                            CFRelease(model);
-                            IOObjectRelease(service);
-                            break; // just pick the first GPU
-                        }
-                    }
-                    CFRelease(model);
-                }
-                IOObjectRelease(service);
-            }
-            IOObjectRelease(iter);
-        }
-    }
-#else
-    // Linux: Try to parse lspci and glxinfo output if available
-    FILE *fp = popen("lspci -mm | grep VGA", "r");
-    if (fp)
+    fossil_sys_hostinfo_gpu_list_t *list = malloc(sizeof(*list));
+    if (list)
     {
-        char line[512];
-        if (fgets(line, sizeof(line), fp))
+        if (fossil_sys_hostinfo_get_gpus(list) == 0 && list->count > 0)
         {
-            // Example: 00:02.0 "VGA compatible controller" "Intel Corporation" "HD Graphics 620" ...
-            char *vendor = strchr(line, '"');
-            if (vendor)
+            size_t pick = 0;
+            for (size_t i = 0; i < list->count; ++i)
             {
-                vendor++;
-                vendor = strchr(vendor, '"');
-                if (vendor)
+                if (list->list[i].is_primary)
                 {
-                    vendor++;
-                    vendor = strchr(vendor, '"');
-                    if (vendor)
-                    {
-                        vendor++;
-                        char *vendor_end = strchr(vendor, '"');
-                        if (vendor_end && vendor_end - vendor < (int)sizeof(info->vendor))
-                        {
-                            strncpy(info->vendor, vendor, vendor_end - vendor);
-                            info->vendor[vendor_end - vendor] = '\0';
-                        }
-                        char *name = strchr(vendor_end + 1, '"');
-                        if (name)
-                        {
-                            name++;
-                            char *name_end = strchr(name, '"');
-                            if (name_end && name_end - name < (int)sizeof(info->name))
-                            {
-                                strncpy(info->name, name, name_end - name);
-                                info->name[name_end - name] = '\0';
-                            }
-                        }
-                    }
+                    pick = i;
+                    break;
                 }
             }
+            *info = list->list[pick];
         }
-        pclose(fp);
+        free(list);
     }
+
     if (info->name[0] == '\0')
         strncpy(info->name, "Unknown", sizeof(info->name) - 1);
     if (info->vendor[0] == '\0')
         strncpy(info->vendor, "Unknown", sizeof(info->vendor) - 1);
-
-    // Try to get driver version from glxinfo
-    fp = popen("glxinfo -B 2>/dev/null | grep 'OpenGL version string'", "r");
-    if (fp)
-    {
-        char line[256];
-        if (fgets(line, sizeof(line), fp))
-        {
-            char *colon = strchr(line, ':');
-            if (colon)
-            {
-                colon++;
-                while (*colon == ' ')
-                    colon++;
-                strncpy(info->driver_version, colon, sizeof(info->driver_version) - 1);
-                info->driver_version[sizeof(info->driver_version) - 1] = '\0';
-                // Remove trailing newline
-                char *nl = strchr(info->driver_version, '\n');
-                if (nl)
-                    *nl = '\0';
-            }
-        }
-        pclose(fp);
-    }
     if (info->driver_version[0] == '\0')
         strncpy(info->driver_version, "Unknown", sizeof(info->driver_version) - 1);
-
-    // Memory info: not portable, set to 0
-    info->memory_total = 0;
-    info->memory_free = 0;
-#endif
     return 0;
 }
 
@@ -1130,6 +1027,23 @@ int fossil_sys_hostinfo_get_memory(fossil_sys_hostinfo_memory_t *info)
     info->used_memory = (sys_info.totalram - sys_info.freeram) * sys_info.mem_unit;
     info->available_memory = sys_info.freeram * sys_info.mem_unit;
 
+    // sysinfo has no notion of reclaimable page cache; prefer MemAvailable
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if (fp)
+    {
+        char line[128];
+        unsigned long long kb;
+        while (fgets(line, sizeof(line), fp))
+        {
+            if (sscanf(line, "MemAvailable: %llu kB", &kb) == 1)
+            {
+                info->available_memory = (uint64_t)kb * 1024u;
+                break;
+            }
+        }
+        fclose(fp);
+    }
+
     info->total_swap = sys_info.totalswap * sys_info.mem_unit;
     info->free_swap = sys_info.freeswap * sys_info.mem_unit;
     info->used_swap = (sys_info.totalswap - sys_info.freeswap) * sys_info.mem_unit;
@@ -1436,9 +1350,7 @@ int fossil_sys_hostinfo_get_network(fossil_sys_hostinfo_network_t *info)
                     if (ua->Address.lpSockaddr->sa_family == AF_INET)
                     {
                         struct sockaddr_in *sa_in = (struct sockaddr_in *)ua->Address.lpSockaddr;
-                        const char *ip = inet_ntoa(sa_in->sin_addr);
-                        if (ip)
-                            fossil_sys_strcpy(info->primary_ip, sizeof(info->primary_ip), ip);
+                        inet_ntop(AF_INET, &sa_in->sin_addr, info->primary_ip, sizeof(info->primary_ip));
                         break;
                     }
                     ua = ua->Next;
@@ -1456,13 +1368,6 @@ int fossil_sys_hostinfo_get_network(fossil_sys_hostinfo_network_t *info)
     info->is_up = 1;
 
 #elif defined(__APPLE__)
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <ifaddrs.h>
-#include <string.h>
-#include <net/if_dl.h>
-
     // Hostname
     if (gethostname(info->hostname, sizeof(info->hostname)) != 0)
         fossil_sys_strcpy(info->hostname, sizeof(info->hostname), "Unknown");
@@ -1476,9 +1381,8 @@ int fossil_sys_hostinfo_get_network(fossil_sys_hostinfo_network_t *info)
             if (ifa->ifa_addr && ifa->ifa_addr->sa_family == AF_INET)
             {
                 struct sockaddr_in *sa = (struct sockaddr_in *)ifa->ifa_addr;
-                const char *ip = inet_ntoa(sa->sin_addr);
-                if (ip)
-                    fossil_sys_strcpy(info->primary_ip, sizeof(info->primary_ip), ip);
+                // inet_ntop writes into our buffer; inet_ntoa's static one is not thread-safe
+                inet_ntop(AF_INET, &sa->sin_addr, info->primary_ip, sizeof(info->primary_ip));
 
                 if (ifa->ifa_name)
                     fossil_sys_strcpy(info->interface_name, sizeof(info->interface_name), ifa->ifa_name);
@@ -1522,15 +1426,6 @@ int fossil_sys_hostinfo_get_network(fossil_sys_hostinfo_network_t *info)
     info->is_up = 1;
 
 #elif defined(__linux__)
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <ifaddrs.h>
-#include <string.h>
-#include <sys/ioctl.h>
-#include <unistd.h>
-#include <linux/if.h>
-
     // Hostname
     if (gethostname(info->hostname, sizeof(info->hostname)) != 0)
         fossil_sys_strcpy(info->hostname, sizeof(info->hostname), "Unknown");
@@ -1545,9 +1440,8 @@ int fossil_sys_hostinfo_get_network(fossil_sys_hostinfo_network_t *info)
                 !(ifa->ifa_flags & IFF_LOOPBACK))
             {
                 struct sockaddr_in *sa = (struct sockaddr_in *)ifa->ifa_addr;
-                const char *ip = inet_ntoa(sa->sin_addr);
-                if (ip)
-                    fossil_sys_strcpy(info->primary_ip, sizeof(info->primary_ip), ip);
+                // inet_ntop writes into our buffer; inet_ntoa's static one is not thread-safe
+                inet_ntop(AF_INET, &sa->sin_addr, info->primary_ip, sizeof(info->primary_ip));
 
                 if (ifa->ifa_name)
                     fossil_sys_strcpy(info->interface_name, sizeof(info->interface_name), ifa->ifa_name);
@@ -1837,3 +1731,5245 @@ int fossil_sys_hostinfo_get_display(fossil_sys_hostinfo_display_t *info)
 
     return 0;
 }
+
+/* ============================================================================
+ * Internal helpers for cached and sysfs based queries
+ * ============================================================================
+ */
+
+#if defined(_WIN32)
+typedef INIT_ONCE fossil_sys_hostinfo_once_t;
+#define FOSSIL_SYS_HOSTINFO_ONCE_INIT INIT_ONCE_STATIC_INIT
+
+static BOOL CALLBACK fossil_sys_hostinfo_once_thunk(PINIT_ONCE once, PVOID param, PVOID *ctx)
+{
+    void (*fn)(void);
+    (void)once;
+    (void)ctx;
+    memcpy(&fn, &param, sizeof(fn));
+    fn();
+    return TRUE;
+}
+
+static void fossil_sys_hostinfo_once(fossil_sys_hostinfo_once_t *once, void (*fn)(void))
+{
+    PVOID param;
+    memcpy(&param, &fn, sizeof(param));
+    InitOnceExecuteOnce(once, fossil_sys_hostinfo_once_thunk, param, NULL);
+}
+#else
+typedef pthread_once_t fossil_sys_hostinfo_once_t;
+#define FOSSIL_SYS_HOSTINFO_ONCE_INIT PTHREAD_ONCE_INIT
+
+static void fossil_sys_hostinfo_once(fossil_sys_hostinfo_once_t *once, void (*fn)(void))
+{
+    pthread_once(once, fn);
+}
+#endif
+
+#if defined(_WIN32)
+typedef SRWLOCK fossil_sys_hostinfo_lock_t;
+#define FOSSIL_SYS_HOSTINFO_LOCK_INIT SRWLOCK_INIT
+#define fossil_sys_hostinfo_lock(l) AcquireSRWLockExclusive(l)
+#define fossil_sys_hostinfo_unlock(l) ReleaseSRWLockExclusive(l)
+#else
+typedef pthread_mutex_t fossil_sys_hostinfo_lock_t;
+#define FOSSIL_SYS_HOSTINFO_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define fossil_sys_hostinfo_lock(l) pthread_mutex_lock(l)
+#define fossil_sys_hostinfo_unlock(l) pthread_mutex_unlock(l)
+#endif
+
+/* Monotonic milliseconds, used for cache ageing only. */
+static uint64_t fossil_sys_hostinfo_now_ms(void)
+{
+#if defined(_WIN32)
+    return (uint64_t)GetTickCount64();
+#else
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+#endif
+}
+
+#if defined(__linux__)
+/*
+ * Read a small text file (sysfs attribute, procfs entry) into buf and strip
+ * trailing whitespace. Returns the string length, or -1 on failure.
+ */
+static int fossil_sys_hostinfo_read_text(const char *path, char *buf, size_t size)
+{
+    if (!path || !buf || size == 0)
+        return -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+
+    size_t len = 0;
+    while (len + 1 < size)
+    {
+        ssize_t n = read(fd, buf + len, size - 1 - len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            close(fd);
+            return -1;
+        }
+        if (n == 0)
+            break;
+        len += (size_t)n;
+    }
+    close(fd);
+
+    while (len > 0 && isspace((unsigned char)buf[len - 1]))
+        len--;
+    buf[len] = '\0';
+    return (int)len;
+}
+
+static long long fossil_sys_hostinfo_read_ll(const char *path, long long fallback)
+{
+    char buf[64];
+    if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) <= 0)
+        return fallback;
+
+    // PCI ids and classes are published as "0x10de"
+    int base = (buf[0] == '0' && (buf[1] == 'x' || buf[1] == 'X')) ? 16 : 10;
+    char *end = NULL;
+    long long value = strtoll(buf, &end, base);
+    if (end == buf)
+        return fallback;
+    return value;
+}
+
+/*
+ * Reads an open procfs file of unknown size into a NUL-terminated heap
+ * buffer and closes fd. Returns NULL if memory runs out or the read fails.
+ */
+static char *fossil_sys_hostinfo_read_all_fd(int fd)
+{
+    size_t size = 16384, len = 0;
+    char *buf = malloc(size);
+    while (buf)
+    {
+        if (len + 1 == size)
+        {
+            char *grown = realloc(buf, size * 2);
+            if (!grown)
+            {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = grown;
+            size *= 2;
+        }
+        ssize_t n = read(fd, buf + len, size - 1 - len);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            if (n < 0)
+            {
+                free(buf);
+                buf = NULL;
+            }
+            break;
+        }
+        len += (size_t)n;
+    }
+    close(fd);
+    if (buf)
+        buf[len] = '\0';
+    return buf;
+}
+
+static char *fossil_sys_hostinfo_read_all(const char *path)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return NULL;
+    return fossil_sys_hostinfo_read_all_fd(fd);
+}
+
+/*
+ * Parse a kernel CPU list such as "0-3,8,10-11" into a CPU set.
+ * Returns the number of CPUs added, or -1 on a malformed list.
+ */
+static int fossil_sys_hostinfo_parse_cpulist(const char *list, fossil_sys_hostinfo_cpuset_t *out)
+{
+    int added = 0;
+    const char *p = list;
+
+    if (!list || !out)
+        return -1;
+
+    while (*p)
+    {
+        while (*p == ',' || isspace((unsigned char)*p))
+            p++;
+        if (!*p)
+            break;
+
+        char *end = NULL;
+        long first = strtol(p, &end, 10);
+        if (end == p || first < 0)
+            return -1;
+        long last = first;
+        p = end;
+        if (*p == '-')
+        {
+            p++;
+            last = strtol(p, &end, 10);
+            if (end == p || last < first)
+                return -1;
+            p = end;
+        }
+        for (long cpu = first; cpu <= last && cpu < FOSSIL_SYS_HOSTINFO_CPU_MAX; ++cpu)
+        {
+            fossil_sys_hostinfo_cpuset_add(out, (int)cpu);
+            added++;
+        }
+    }
+    return added;
+}
+
+static int fossil_sys_hostinfo_read_cpulist(const char *path, fossil_sys_hostinfo_cpuset_t *out)
+{
+    char buf[4096];
+    memset(out, 0, sizeof(*out));
+    if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) < 0)
+        return -1;
+    return fossil_sys_hostinfo_parse_cpulist(buf, out);
+}
+
+/* Parse sizes such as "32K", "1024K" or "32M" into bytes. */
+static uint64_t fossil_sys_hostinfo_parse_size(const char *text)
+{
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text)
+        return 0;
+    switch (toupper((unsigned char)*end))
+    {
+    case 'K':
+        return (uint64_t)value << 10;
+    case 'M':
+        return (uint64_t)value << 20;
+    case 'G':
+        return (uint64_t)value << 30;
+    default:
+        return (uint64_t)value;
+    }
+}
+#endif
+
+/* ============================================================================
+ * CPU topology
+ * ============================================================================
+ */
+
+static fossil_sys_hostinfo_topology_t fossil_sys_hostinfo_topology;
+static int fossil_sys_hostinfo_topology_ready = 0;
+static fossil_sys_hostinfo_once_t fossil_sys_hostinfo_topology_once = FOSSIL_SYS_HOSTINFO_ONCE_INIT;
+
+static void fossil_sys_hostinfo_topology_count_units(fossil_sys_hostinfo_topology_t *t)
+{
+    t->package_count = 0;
+    t->die_count = 0;
+    t->core_count = 0;
+
+    for (int i = 0; i < t->cpu_count; ++i)
+    {
+        const fossil_sys_hostinfo_cpu_thread_t *a = &t->cpus[i];
+        int new_package = 1, new_die = 1, new_core = 1;
+
+        for (int j = 0; j < i; ++j)
+        {
+            const fossil_sys_hostinfo_cpu_thread_t *b = &t->cpus[j];
+            if (a->package_id != b->package_id)
+                continue;
+            new_package = 0;
+            if (a->die_id != b->die_id)
+                continue;
+            new_die = 0;
+            if (a->core_id == b->core_id)
+            {
+                new_core = 0;
+                break;
+            }
+        }
+        t->package_count += new_package;
+        t->die_count += new_die;
+        t->core_count += new_core;
+    }
+}
+
+/* Fallback: one package, every logical CPU its own core, no caches/NUMA. */
+static void fossil_sys_hostinfo_topology_build_flat(fossil_sys_hostinfo_topology_t *t)
+{
+    long count = 1;
+#if defined(_WIN32)
+    SYSTEM_INFO sysinfo;
+    GetSystemInfo(&sysinfo);
+    count = (long)sysinfo.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count < 1)
+        count = 1;
+    if (count > FOSSIL_SYS_HOSTINFO_CPU_MAX)
+        count = FOSSIL_SYS_HOSTINFO_CPU_MAX;
+
+    for (int i = 0; i < (int)count; ++i)
+    {
+        fossil_sys_hostinfo_cpu_thread_t *c = &t->cpus[i];
+        c->cpu = i;
+        c->online = 1;
+        c->core_id = i;
+        c->numa_node = -1;
+        fossil_sys_hostinfo_cpuset_add(&c->smt_siblings, i);
+    }
+    t->cpu_count = (int)count;
+    fossil_sys_hostinfo_topology_count_units(t);
+}
+
+#if defined(__linux__)
+static fossil_sys_hostinfo_cache_type_t fossil_sys_hostinfo_cache_type(const char *text)
+{
+    if (strcmp(text, "Data") == 0)
+        return FOSSIL_SYS_HOSTINFO_CACHE_DATA;
+    if (strcmp(text, "Instruction") == 0)
+        return FOSSIL_SYS_HOSTINFO_CACHE_INSTRUCTION;
+    return FOSSIL_SYS_HOSTINFO_CACHE_UNIFIED;
+}
+
+static void fossil_sys_hostinfo_topology_read_caches(fossil_sys_hostinfo_topology_t *t,
+                                                     fossil_sys_hostinfo_cpu_thread_t *c)
+{
+    char path[256];
+    char buf[64];
+
+    for (int idx = 0; idx < FOSSIL_SYS_HOSTINFO_CPU_CACHE_MAX; ++idx)
+    {
+        fossil_sys_hostinfo_cache_t cache;
+        memset(&cache, 0, sizeof(cache));
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/level", c->cpu, idx);
+        cache.level = (int)fossil_sys_hostinfo_read_ll(path, -1);
+        if (cache.level < 0)
+            break;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/type", c->cpu, idx);
+        if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) > 0)
+            cache.type = fossil_sys_hostinfo_cache_type(buf);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/size", c->cpu, idx);
+        if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) > 0)
+            cache.size_bytes = fossil_sys_hostinfo_parse_size(buf);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/coherency_line_size", c->cpu, idx);
+        cache.line_size = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/ways_of_associativity", c->cpu, idx);
+        cache.ways = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/number_of_sets", c->cpu, idx);
+        cache.sets = (int)fossil_sys_hostinfo_read_ll(path, 0);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", c->cpu, idx);
+        if (fossil_sys_hostinfo_read_cpulist(path, &cache.shared_cpus) <= 0)
+            fossil_sys_hostinfo_cpuset_add(&cache.shared_cpus, c->cpu);
+
+        /* The same physical cache is reported once per CPU sharing it. */
+        int found = -1;
+        for (int i = 0; i < t->cache_count; ++i)
+        {
+            const fossil_sys_hostinfo_cache_t *other = &t->caches[i];
+            if (other->level == cache.level && other->type == cache.type &&
+                memcmp(&other->shared_cpus, &cache.shared_cpus, sizeof(cache.shared_cpus)) == 0)
+            {
+                found = i;
+                break;
+            }
+        }
+        if (found < 0)
+        {
+            if (t->cache_count >= FOSSIL_SYS_HOSTINFO_CACHE_MAX)
+                continue;
+            found = t->cache_count++;
+            t->caches[found] = cache;
+        }
+        c->cache_index[c->cache_count++] = found;
+    }
+}
+
+static void fossil_sys_hostinfo_topology_read_numa(fossil_sys_hostinfo_topology_t *t)
+{
+    fossil_sys_hostinfo_cpuset_t nodes;
+    char path[256];
+    char buf[4096];
+
+    if (fossil_sys_hostinfo_read_cpulist("/sys/devices/system/node/online", &nodes) <= 0)
+        return;
+
+    for (int id = 0; id < FOSSIL_SYS_HOSTINFO_CPU_MAX && t->numa_count < FOSSIL_SYS_HOSTINFO_NUMA_MAX; ++id)
+    {
+        if (!fossil_sys_hostinfo_cpuset_has(&nodes, id))
+            continue;
+
+        fossil_sys_hostinfo_numa_node_t *node = &t->numa[t->numa_count++];
+        node->node_id = id;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+        fossil_sys_hostinfo_read_cpulist(path, &node->cpus);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/distance", id);
+        if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) > 0)
+        {
+            char *p = buf;
+            while (*p && node->distance_count < FOSSIL_SYS_HOSTINFO_NUMA_MAX)
+            {
+                char *end = NULL;
+                long d = strtol(p, &end, 10);
+                if (end == p)
+                    break;
+                node->distance[node->distance_count++] = (int)d;
+                p = end;
+            }
+        }
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/meminfo", id);
+        if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) > 0)
+        {
+            const char *total = strstr(buf, "MemTotal:");
+            if (total)
+                node->memory_total = strtoull(total + 9, NULL, 10) * 1024ULL;
+        }
+
+        for (int i = 0; i < t->cpu_count; ++i)
+        {
+            if (fossil_sys_hostinfo_cpuset_has(&node->cpus, t->cpus[i].cpu))
+                t->cpus[i].numa_node = id;
+        }
+    }
+}
+
+static int fossil_sys_hostinfo_topology_build_linux(fossil_sys_hostinfo_topology_t *t)
+{
+    fossil_sys_hostinfo_cpuset_t present, online;
+    char path[256];
+
+    if (fossil_sys_hostinfo_read_cpulist("/sys/devices/system/cpu/present", &present) <= 0 &&
+        fossil_sys_hostinfo_read_cpulist("/sys/devices/system/cpu/possible", &present) <= 0)
+        return -1;
+    if (fossil_sys_hostinfo_read_cpulist("/sys/devices/system/cpu/online", &online) <= 0)
+        online = present;
+
+    for (int cpu = 0; cpu < FOSSIL_SYS_HOSTINFO_CPU_MAX; ++cpu)
+    {
+        if (!fossil_sys_hostinfo_cpuset_has(&present, cpu))
+            continue;
+
+        fossil_sys_hostinfo_cpu_thread_t *c = &t->cpus[t->cpu_count++];
+        c->cpu = cpu;
+        c->online = fossil_sys_hostinfo_cpuset_has(&online, cpu);
+        c->numa_node = -1;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+        c->package_id = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/die_id", cpu);
+        c->die_id = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+        c->core_id = (int)fossil_sys_hostinfo_read_ll(path, cpu);
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/thread_siblings_list", cpu);
+        if (fossil_sys_hostinfo_read_cpulist(path, &c->smt_siblings) <= 0)
+            fossil_sys_hostinfo_cpuset_add(&c->smt_siblings, cpu);
+
+        for (int other = 0; other < cpu; ++other)
+        {
+            if (fossil_sys_hostinfo_cpuset_has(&c->smt_siblings, other))
+                c->thread_id++;
+        }
+
+        fossil_sys_hostinfo_topology_read_caches(t, c);
+    }
+
+    if (t->cpu_count == 0)
+        return -1;
+
+    fossil_sys_hostinfo_topology_count_units(t);
+    fossil_sys_hostinfo_topology_read_numa(t);
+    return 0;
+}
+#endif
+
+static void fossil_sys_hostinfo_topology_build(void)
+{
+    fossil_sys_hostinfo_topology_t *t = &fossil_sys_hostinfo_topology;
+    memset(t, 0, sizeof(*t));
+
+#if defined(__linux__)
+    if (fossil_sys_hostinfo_topology_build_linux(t) == 0)
+    {
+        fossil_sys_hostinfo_topology_ready = 1;
+        return;
+    }
+    memset(t, 0, sizeof(*t));
+#endif
+    fossil_sys_hostinfo_topology_build_flat(t);
+    fossil_sys_hostinfo_topology_ready = 1;
+}
+
+const fossil_sys_hostinfo_topology_t *fossil_sys_hostinfo_get_topology(void)
+{
+    fossil_sys_hostinfo_once(&fossil_sys_hostinfo_topology_once, fossil_sys_hostinfo_topology_build);
+    return fossil_sys_hostinfo_topology_ready ? &fossil_sys_hostinfo_topology : NULL;
+}
+
+static const fossil_sys_hostinfo_cpu_thread_t *fossil_sys_hostinfo_topology_find(int cpu)
+{
+    const fossil_sys_hostinfo_topology_t *t = fossil_sys_hostinfo_get_topology();
+    if (!t || cpu < 0)
+        return NULL;
+    for (int i = 0; i < t->cpu_count; ++i)
+    {
+        if (t->cpus[i].cpu == cpu)
+            return &t->cpus[i];
+    }
+    return NULL;
+}
+
+int fossil_sys_hostinfo_topology_cache_siblings(int cpu, int level,
+                                                fossil_sys_hostinfo_cpuset_t *out)
+{
+    if (!out || level <= 0)
+        return -1;
+    memset(out, 0, sizeof(*out));
+
+    const fossil_sys_hostinfo_cpu_thread_t *c = fossil_sys_hostinfo_topology_find(cpu);
+    if (!c)
+        return -1;
+
+    const fossil_sys_hostinfo_topology_t *t = fossil_sys_hostinfo_get_topology();
+    const fossil_sys_hostinfo_cache_t *match = NULL;
+    for (int i = 0; i < c->cache_count; ++i)
+    {
+        const fossil_sys_hostinfo_cache_t *cache = &t->caches[c->cache_index[i]];
+        if (cache->level != level)
+            continue;
+        if (!match || match->type == FOSSIL_SYS_HOSTINFO_CACHE_INSTRUCTION)
+            match = cache;
+    }
+    if (!match)
+        return -2;
+
+    *out = match->shared_cpus;
+    return 0;
+}
+
+int fossil_sys_hostinfo_topology_smt_siblings(int cpu, fossil_sys_hostinfo_cpuset_t *out)
+{
+    if (!out)
+        return -1;
+    memset(out, 0, sizeof(*out));
+
+    const fossil_sys_hostinfo_cpu_thread_t *c = fossil_sys_hostinfo_topology_find(cpu);
+    if (!c)
+        return -1;
+
+    *out = c->smt_siblings;
+    return 0;
+}
+
+int fossil_sys_hostinfo_topology_numa_node(int cpu)
+{
+    const fossil_sys_hostinfo_cpu_thread_t *c = fossil_sys_hostinfo_topology_find(cpu);
+    return c ? c->numa_node : -1;
+}
+
+/* ============================================================================
+ * Snapshots
+ * ============================================================================
+ */
+
+static fossil_sys_hostinfo_static_t fossil_sys_hostinfo_static_snap;
+
+#define FOSSIL_SYS_HOSTINFO_STATIC_ONCE(name)                                              \
+    static fossil_sys_hostinfo_once_t fossil_sys_hostinfo_##name##_once =                  \
+        FOSSIL_SYS_HOSTINFO_ONCE_INIT;                                                     \
+    static void fossil_sys_hostinfo_collect_##name(void)                                   \
+    {                                                                                      \
+        fossil_sys_hostinfo_get_##name(&fossil_sys_hostinfo_static_snap.name);             \
+    }
+
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(system)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(architecture)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(cpu)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(gpu)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(endianness)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(hardware)
+FOSSIL_SYS_HOSTINFO_STATIC_ONCE(virtualization)
+
+const fossil_sys_hostinfo_static_t *fossil_sys_hostinfo_snapshot_static(uint32_t sections)
+{
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_system_once, fossil_sys_hostinfo_collect_system);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_ARCHITECTURE)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_architecture_once, fossil_sys_hostinfo_collect_architecture);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_CPU)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_cpu_once, fossil_sys_hostinfo_collect_cpu);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_GPU)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_gpu_once, fossil_sys_hostinfo_collect_gpu);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_endianness_once, fossil_sys_hostinfo_collect_endianness);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_hardware_once, fossil_sys_hostinfo_collect_hardware);
+    if (sections & FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION)
+        fossil_sys_hostinfo_once(&fossil_sys_hostinfo_virtualization_once, fossil_sys_hostinfo_collect_virtualization);
+    return &fossil_sys_hostinfo_static_snap;
+}
+
+/*
+ * Volatile sections carry their own collection timestamp so that a caller
+ * asking only for memory never pays for a storage or network refresh.
+ */
+#define FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(name)                                         \
+    static void fossil_sys_hostinfo_refresh_##name(fossil_sys_hostinfo_volatile_t *snap)  \
+    {                                                                                      \
+        fossil_sys_hostinfo_get_##name(&snap->name);                                       \
+    }
+
+FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(memory)
+FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(uptime)
+FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(power)
+FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(storage)
+FOSSIL_SYS_HOSTINFO_VOLATILE_COLLECT(network)
+
+static const struct
+{
+    uint32_t section;
+    size_t offset;
+    size_t size;
+    void (*collect)(fossil_sys_hostinfo_volatile_t *snap);
+} fossil_sys_hostinfo_volatile_sections[] = {
+    {FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, offsetof(fossil_sys_hostinfo_volatile_t, memory),
+     sizeof(fossil_sys_hostinfo_memory_t), fossil_sys_hostinfo_refresh_memory},
+    {FOSSIL_SYS_HOSTINFO_SECTION_UPTIME, offsetof(fossil_sys_hostinfo_volatile_t, uptime),
+     sizeof(fossil_sys_hostinfo_uptime_t), fossil_sys_hostinfo_refresh_uptime},
+    {FOSSIL_SYS_HOSTINFO_SECTION_POWER, offsetof(fossil_sys_hostinfo_volatile_t, power),
+     sizeof(fossil_sys_hostinfo_power_t), fossil_sys_hostinfo_refresh_power},
+    {FOSSIL_SYS_HOSTINFO_SECTION_STORAGE, offsetof(fossil_sys_hostinfo_volatile_t, storage),
+     sizeof(fossil_sys_hostinfo_storage_t), fossil_sys_hostinfo_refresh_storage},
+    {FOSSIL_SYS_HOSTINFO_SECTION_NETWORK, offsetof(fossil_sys_hostinfo_volatile_t, network),
+     sizeof(fossil_sys_hostinfo_network_t), fossil_sys_hostinfo_refresh_network},
+};
+
+#define FOSSIL_SYS_HOSTINFO_VOL_COUNT \
+    (sizeof(fossil_sys_hostinfo_volatile_sections) / sizeof(fossil_sys_hostinfo_volatile_sections[0]))
+
+static fossil_sys_hostinfo_volatile_t fossil_sys_hostinfo_volatile_snap;
+static uint64_t fossil_sys_hostinfo_volatile_stamp[FOSSIL_SYS_HOSTINFO_VOL_COUNT];
+static int fossil_sys_hostinfo_volatile_valid[FOSSIL_SYS_HOSTINFO_VOL_COUNT];
+static uint32_t fossil_sys_hostinfo_snapshot_ttl = FOSSIL_SYS_HOSTINFO_SNAPSHOT_TTL_MS;
+static fossil_sys_hostinfo_lock_t fossil_sys_hostinfo_volatile_lock = FOSSIL_SYS_HOSTINFO_LOCK_INIT;
+
+static int fossil_sys_hostinfo_volatile_stale(size_t slot, uint64_t now)
+{
+    if (!fossil_sys_hostinfo_volatile_valid[slot])
+        return 1;
+    return now - fossil_sys_hostinfo_volatile_stamp[slot] >= fossil_sys_hostinfo_snapshot_ttl;
+}
+
+/*
+ * Re-collects the requested sections that are stale. Collection reads
+ * /proc, /sys and the network stack and can take a while, so it runs
+ * into a local copy without the lock; the lock only covers the swap.
+ */
+static void fossil_sys_hostinfo_volatile_refresh(uint32_t sections)
+{
+    uint32_t stale = 0;
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    uint64_t now = fossil_sys_hostinfo_now_ms();
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_VOL_COUNT; ++i)
+    {
+        if ((sections & fossil_sys_hostinfo_volatile_sections[i].section) &&
+            fossil_sys_hostinfo_volatile_stale(i, now))
+            stale |= fossil_sys_hostinfo_volatile_sections[i].section;
+    }
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+    if (!stale)
+        return;
+
+    fossil_sys_hostinfo_volatile_t fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_VOL_COUNT; ++i)
+    {
+        if (stale & fossil_sys_hostinfo_volatile_sections[i].section)
+            fossil_sys_hostinfo_volatile_sections[i].collect(&fresh);
+    }
+
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_VOL_COUNT; ++i)
+    {
+        if (!(stale & fossil_sys_hostinfo_volatile_sections[i].section))
+            continue;
+        size_t offset = fossil_sys_hostinfo_volatile_sections[i].offset;
+        memcpy((char *)&fossil_sys_hostinfo_volatile_snap + offset, (const char *)&fresh + offset,
+               fossil_sys_hostinfo_volatile_sections[i].size);
+        fossil_sys_hostinfo_volatile_stamp[i] = now;
+        fossil_sys_hostinfo_volatile_valid[i] = 1;
+        fossil_sys_hostinfo_volatile_snap.generation++;
+    }
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+}
+
+int fossil_sys_hostinfo_snapshot_volatile(uint32_t sections, fossil_sys_hostinfo_volatile_t *out)
+{
+    if (!out)
+        return -1;
+
+    fossil_sys_hostinfo_volatile_refresh(sections);
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    *out = fossil_sys_hostinfo_volatile_snap;
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+    return 0;
+}
+
+int fossil_sys_hostinfo_snapshot_section(uint32_t section, void *out, size_t size)
+{
+    if (!out)
+        return -1;
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_VOL_COUNT; ++i)
+    {
+        if (fossil_sys_hostinfo_volatile_sections[i].section != section)
+            continue;
+        if (fossil_sys_hostinfo_volatile_sections[i].size != size)
+            return -1;
+
+        fossil_sys_hostinfo_volatile_refresh(section);
+        fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+        memcpy(out, (const char *)&fossil_sys_hostinfo_volatile_snap + fossil_sys_hostinfo_volatile_sections[i].offset,
+               size);
+        fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+        return 0;
+    }
+    return -1;
+}
+
+void fossil_sys_hostinfo_snapshot_set_ttl(uint32_t ttl_ms)
+{
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    fossil_sys_hostinfo_snapshot_ttl = ttl_ms;
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+}
+
+uint32_t fossil_sys_hostinfo_snapshot_get_ttl(void)
+{
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    uint32_t ttl = fossil_sys_hostinfo_snapshot_ttl;
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+    return ttl;
+}
+
+void fossil_sys_hostinfo_snapshot_invalidate(void)
+{
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_volatile_lock);
+    memset(fossil_sys_hostinfo_volatile_valid, 0, sizeof(fossil_sys_hostinfo_volatile_valid));
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_volatile_lock);
+}
+
+/* ============================================================================
+ * CPU features
+ * ============================================================================
+ */
+
+#if defined(__linux__) && (defined(__aarch64__) || defined(__arm__))
+#include <sys/auxv.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+static const char *const fossil_sys_hostinfo_feature_names[FOSSIL_SYS_HOSTINFO_FEATURE_COUNT] = {
+    [FOSSIL_SYS_HOSTINFO_FEATURE_NONE] = "none",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSE] = "sse",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSE2] = "sse2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSE3] = "sse3",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSSE3] = "ssse3",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSE41] = "sse4.1",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SSE42] = "sse4.2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_POPCNT] = "popcnt",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_LZCNT] = "lzcnt",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_MOVBE] = "movbe",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AES] = "aes",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_PCLMUL] = "pclmul",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_RDRAND] = "rdrand",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_RDSEED] = "rdseed",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ADX] = "adx",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SHA] = "sha",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_BMI1] = "bmi1",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_BMI2] = "bmi2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX] = "avx",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_F16C] = "f16c",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_FMA] = "fma",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX2] = "avx2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX_VNNI] = "avx_vnni",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_VAES] = "vaes",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_VPCLMULQDQ] = "vpclmulqdq",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_GFNI] = "gfni",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512F] = "avx512f",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512DQ] = "avx512dq",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512CD] = "avx512cd",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BW] = "avx512bw",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VL] = "avx512vl",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512IFMA] = "avx512ifma",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI] = "avx512vbmi",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI2] = "avx512vbmi2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VNNI] = "avx512vnni",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BITALG] = "avx512bitalg",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VPOPCNTDQ] = "avx512vpopcntdq",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BF16] = "avx512bf16",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_AVX512FP16] = "avx512fp16",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_INVARIANT_TSC] = "invariant_tsc",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_HYPERVISOR] = "hypervisor",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_NEON] = "neon",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES] = "arm_aes",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_PMULL] = "arm_pmull",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA1] = "arm_sha1",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA2] = "arm_sha2",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32] = "arm_crc32",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_ATOMICS] = "arm_atomics",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_FP16] = "arm_fp16",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_ARM_DOTPROD] = "arm_dotprod",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SVE] = "sve",
+    [FOSSIL_SYS_HOSTINFO_FEATURE_SVE2] = "sve2",
+};
+
+static fossil_sys_hostinfo_features_t fossil_sys_hostinfo_features;
+static fossil_sys_hostinfo_once_t fossil_sys_hostinfo_features_once = FOSSIL_SYS_HOSTINFO_ONCE_INIT;
+
+static void fossil_sys_hostinfo_feature_set(fossil_sys_hostinfo_features_t *set,
+                                            fossil_sys_hostinfo_feature_t feature, int present)
+{
+    if (present)
+        set->bits[feature / 64] |= (uint64_t)1 << (feature % 64);
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+/* Executes CPUID for leaf/subleaf. Returns 0 if the leaf is not implemented. */
+static int fossil_sys_hostinfo_cpuid(unsigned int leaf, unsigned int sub, unsigned int regs[4])
+{
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, (int)(leaf & 0x80000000u));
+    if ((unsigned int)r[0] < leaf)
+        return 0;
+    __cpuidex(r, (int)leaf, (int)sub);
+    for (int i = 0; i < 4; ++i)
+        regs[i] = (unsigned int)r[i];
+#else
+    if (__get_cpuid_max(leaf & 0x80000000u, NULL) < leaf)
+        return 0;
+    __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    return 1;
+}
+
+static uint64_t fossil_sys_hostinfo_xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_xgetbv(0);
+#else
+    unsigned int lo, hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((uint64_t)hi << 32) | lo;
+#endif
+}
+
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    unsigned int r[4];
+    int os_avx = 0, os_avx512 = 0;
+
+    if (fossil_sys_hostinfo_cpuid(1, 0, r))
+    {
+        unsigned int ecx = r[2], edx = r[3];
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSE, edx & (1u << 25));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSE2, edx & (1u << 26));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSE3, ecx & (1u << 0));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_PCLMUL, ecx & (1u << 1));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSSE3, ecx & (1u << 9));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSE41, ecx & (1u << 19));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SSE42, ecx & (1u << 20));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_MOVBE, ecx & (1u << 22));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_POPCNT, ecx & (1u << 23));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AES, ecx & (1u << 25));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_RDRAND, ecx & (1u << 30));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_HYPERVISOR, ecx & (1u << 31));
+
+        // AVX state must be enabled by the OS (OSXSAVE + XCR0), not just the CPU
+        if (ecx & (1u << 27))
+        {
+            uint64_t xcr0 = fossil_sys_hostinfo_xgetbv();
+            os_avx = (xcr0 & 0x6) == 0x6;
+            os_avx512 = os_avx && (xcr0 & 0xE0) == 0xE0;
+        }
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX, os_avx && (ecx & (1u << 28)));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_F16C, os_avx && (ecx & (1u << 29)));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_FMA, os_avx && (ecx & (1u << 12)));
+    }
+
+    if (fossil_sys_hostinfo_cpuid(7, 0, r))
+    {
+        unsigned int ebx = r[1], ecx = r[2], edx = r[3];
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_BMI1, ebx & (1u << 3));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX2, os_avx && (ebx & (1u << 5)));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_BMI2, ebx & (1u << 8));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_RDSEED, ebx & (1u << 18));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ADX, ebx & (1u << 19));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SHA, ebx & (1u << 29));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_GFNI, ecx & (1u << 8));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_VAES, os_avx && (ecx & (1u << 9)));
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_VPCLMULQDQ, os_avx && (ecx & (1u << 10)));
+
+        if (os_avx512)
+        {
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512F, ebx & (1u << 16));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512DQ, ebx & (1u << 17));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512IFMA, ebx & (1u << 21));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512CD, ebx & (1u << 28));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BW, ebx & (1u << 30));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VL, ebx & (1u << 31));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI, ecx & (1u << 1));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VBMI2, ecx & (1u << 6));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VNNI, ecx & (1u << 11));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BITALG, ecx & (1u << 12));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512VPOPCNTDQ, ecx & (1u << 14));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512FP16, edx & (1u << 23));
+        }
+
+        if (fossil_sys_hostinfo_cpuid(7, 1, r))
+        {
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX_VNNI, os_avx && (r[0] & (1u << 4)));
+            fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_AVX512BF16, os_avx512 && (r[0] & (1u << 5)));
+        }
+    }
+
+    if (fossil_sys_hostinfo_cpuid(0x80000001u, 0, r))
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_LZCNT, r[2] & (1u << 5));
+
+    if (fossil_sys_hostinfo_cpuid(0x80000007u, 0, r))
+        fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_INVARIANT_TSC, r[3] & (1u << 8));
+}
+#elif defined(__linux__) && defined(__aarch64__)
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_NEON, hwcap & (1ul << 1));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES, hwcap & (1ul << 3));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_PMULL, hwcap & (1ul << 4));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA1, hwcap & (1ul << 5));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA2, hwcap & (1ul << 6));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32, hwcap & (1ul << 7));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_ATOMICS, hwcap & (1ul << 8));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_FP16, hwcap & (1ul << 9));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_DOTPROD, hwcap & (1ul << 20));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SVE, hwcap & (1ul << 22));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_SVE2, hwcap2 & (1ul << 1));
+}
+#elif defined(__linux__) && defined(__arm__)
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    unsigned long hwcap2 = getauxval(AT_HWCAP2);
+
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_NEON, hwcap & (1ul << 12));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES, hwcap2 & (1ul << 0));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_PMULL, hwcap2 & (1ul << 1));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA1, hwcap2 & (1ul << 2));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA2, hwcap2 & (1ul << 3));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32, hwcap2 & (1ul << 4));
+}
+#elif defined(__APPLE__) && defined(__aarch64__)
+static int fossil_sys_hostinfo_sysctl_flag(const char *name)
+{
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, NULL, 0) != 0)
+        return 0;
+    return value != 0;
+}
+
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    // Advanced SIMD, AES, PMULL, SHA1/2 are part of every Apple silicon core
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_NEON, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_PMULL, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA1, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_SHA2, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32,
+                                    fossil_sys_hostinfo_sysctl_flag("hw.optional.armv8_crc32"));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_ATOMICS,
+                                    fossil_sys_hostinfo_sysctl_flag("hw.optional.armv8_1_atomics"));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_FP16,
+                                    fossil_sys_hostinfo_sysctl_flag("hw.optional.neon_fp16"));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_DOTPROD,
+                                    fossil_sys_hostinfo_sysctl_flag("hw.optional.arm.FEAT_DotProd"));
+}
+#elif defined(_M_ARM64)
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_NEON, 1);
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_CRC32,
+                                    IsProcessorFeaturePresent(PF_ARM_V8_CRC32_INSTRUCTIONS_AVAILABLE));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_AES,
+                                    IsProcessorFeaturePresent(PF_ARM_V8_CRYPTO_INSTRUCTIONS_AVAILABLE));
+    fossil_sys_hostinfo_feature_set(f, FOSSIL_SYS_HOSTINFO_FEATURE_ARM_ATOMICS,
+                                    IsProcessorFeaturePresent(PF_ARM_V81_ATOMIC_INSTRUCTIONS_AVAILABLE));
+}
+#else
+static void fossil_sys_hostinfo_detect_features(fossil_sys_hostinfo_features_t *f)
+{
+    (void)f;
+}
+#endif
+
+static void fossil_sys_hostinfo_features_init(void)
+{
+    fossil_sys_hostinfo_detect_features(&fossil_sys_hostinfo_features);
+}
+
+const fossil_sys_hostinfo_features_t *fossil_sys_hostinfo_get_features(void)
+{
+    fossil_sys_hostinfo_once(&fossil_sys_hostinfo_features_once, fossil_sys_hostinfo_features_init);
+    return &fossil_sys_hostinfo_features;
+}
+
+int fossil_sys_hostinfo_has_feature(fossil_sys_hostinfo_feature_t feature)
+{
+    return fossil_sys_hostinfo_features_has(fossil_sys_hostinfo_get_features(), feature);
+}
+
+const char *fossil_sys_hostinfo_feature_name(fossil_sys_hostinfo_feature_t feature)
+{
+    if (feature < FOSSIL_SYS_HOSTINFO_FEATURE_NONE || feature >= FOSSIL_SYS_HOSTINFO_FEATURE_COUNT)
+        return "unknown";
+    return fossil_sys_hostinfo_feature_names[feature];
+}
+
+fossil_sys_hostinfo_fn_t fossil_sys_hostinfo_dispatch_select(
+    const fossil_sys_hostinfo_dispatch_entry_t *table, size_t count)
+{
+    if (!table)
+        return NULL;
+
+    const fossil_sys_hostinfo_features_t *features = fossil_sys_hostinfo_get_features();
+    for (size_t i = 0; i < count; ++i)
+    {
+        int usable = table[i].fn != NULL;
+        for (size_t j = 0; usable && j < FOSSIL_SYS_HOSTINFO_DISPATCH_REQUIRES_MAX; ++j)
+        {
+            fossil_sys_hostinfo_feature_t need = table[i].required[j];
+            if (need != FOSSIL_SYS_HOSTINFO_FEATURE_NONE && !fossil_sys_hostinfo_features_has(features, need))
+                usable = 0;
+        }
+        if (usable)
+            return table[i].fn;
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * GPUs
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <limits.h>
+#endif
+
+/* PCI vendor ids, sorted for binary search. */
+static const struct
+{
+    uint16_t id;
+    const char *name;
+} fossil_sys_hostinfo_gpu_vendors[] = {
+    {0x1002, "AMD"},
+    {0x1022, "AMD"},
+    {0x102b, "Matrox"},
+    {0x106b, "Apple"},
+    {0x10de, "NVIDIA"},
+    {0x1234, "QEMU"},
+    {0x13b5, "ARM"},
+    {0x1414, "Microsoft"},
+    {0x15ad, "VMware"},
+    {0x1a03, "ASPEED"},
+    {0x1af4, "Red Hat"},
+    {0x1b36, "Red Hat"},
+    {0x1d17, "Zhaoxin"},
+    {0x1ed5, "Moore Threads"},
+    {0x5143, "Qualcomm"},
+    {0x5333, "S3 Graphics"},
+    {0x8086, "Intel"},
+    {0x80ee, "VirtualBox"},
+};
+
+const char *fossil_sys_hostinfo_gpu_vendor_name(uint32_t vendor_id)
+{
+    size_t lo = 0, hi = sizeof(fossil_sys_hostinfo_gpu_vendors) / sizeof(fossil_sys_hostinfo_gpu_vendors[0]);
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        if (fossil_sys_hostinfo_gpu_vendors[mid].id == vendor_id)
+            return fossil_sys_hostinfo_gpu_vendors[mid].name;
+        if (fossil_sys_hostinfo_gpu_vendors[mid].id < vendor_id)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return "Unknown";
+}
+
+static fossil_sys_hostinfo_gpu_t *fossil_sys_hostinfo_gpu_add(fossil_sys_hostinfo_gpu_list_t *list)
+{
+    if (list->count >= FOSSIL_SYS_HOSTINFO_GPU_MAX)
+        return NULL;
+    fossil_sys_hostinfo_gpu_t *gpu = &list->list[list->count++];
+    memset(gpu, 0, sizeof(*gpu));
+    gpu->drm_card = -1;
+    return gpu;
+}
+
+#if defined(__linux__)
+/* Reads the last path component of a sysfs symlink such as device/driver. */
+static int fossil_sys_hostinfo_read_link_name(const char *path, char *out, size_t size)
+{
+    char target[PATH_MAX];
+    ssize_t len = readlink(path, target, sizeof(target) - 1);
+    if (len <= 0)
+    {
+        if (size)
+            out[0] = '\0';
+        return -1;
+    }
+    target[len] = '\0';
+    const char *base = strrchr(target, '/');
+    fossil_sys_strcpy(out, size, base ? base + 1 : target);
+    return 0;
+}
+
+static void fossil_sys_hostinfo_gpu_driver(fossil_sys_hostinfo_gpu_t *gpu, const char *dev_dir)
+{
+    char path[PATH_MAX];
+
+    snprintf(path, sizeof(path), "%s/driver", dev_dir);
+    if (fossil_sys_hostinfo_read_link_name(path, gpu->driver, sizeof(gpu->driver)) != 0)
+        return;
+
+    // Out-of-tree modules publish a version; in-tree drivers ship with the kernel
+    snprintf(path, sizeof(path), "/sys/module/%s/version", gpu->driver);
+    if (fossil_sys_hostinfo_read_text(path, gpu->driver_version, sizeof(gpu->driver_version)) > 0)
+        return;
+
+    struct utsname uts;
+    if (uname(&uts) == 0)
+        fossil_sys_strcpy(gpu->driver_version, sizeof(gpu->driver_version), uts.release);
+}
+
+/*
+ * Looks up a device name in the pci.ids database that lspci uses. Vendor
+ * lines are "vvvv  Name", device lines under them "\tdddd  Name".
+ */
+static int fossil_sys_hostinfo_pci_ids_name(uint32_t vendor_id, uint32_t device_id, char *out, size_t size)
+{
+    static const char *const paths[] = {
+        "/usr/share/hwdata/pci.ids",
+        "/usr/share/misc/pci.ids",
+        "/usr/share/pci.ids",
+    };
+
+    FILE *fp = NULL;
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]) && !fp; ++i)
+        fp = fopen(paths[i], "r");
+    if (!fp)
+        return -1;
+
+    char line[512];
+    int in_vendor = 0;
+    int found = -1;
+    while (fgets(line, sizeof(line), fp))
+    {
+        if (line[0] == '#' || line[0] == '\n')
+            continue;
+        if (line[0] != '\t')
+        {
+            if (in_vendor || strncmp(line, "C ", 2) == 0)
+                break; // past our vendor, or into the class list
+            in_vendor = strtoul(line, NULL, 16) == vendor_id && isxdigit((unsigned char)line[3]);
+            continue;
+        }
+        if (!in_vendor || line[1] == '\t')
+            continue; // subsystem lines
+
+        char *end = NULL;
+        if (strtoul(line + 1, &end, 16) != device_id || end != line + 5)
+            continue;
+        while (*end == ' ')
+            end++;
+        end[strcspn(end, "\r\n")] = '\0';
+        if (*end)
+        {
+            fossil_sys_strcpy(out, size, end);
+            found = 0;
+        }
+        break;
+    }
+    fclose(fp);
+    return found;
+}
+
+/*
+ * Resolves a marketing name: the pci.ids entry when the database is
+ * installed, else the name some drivers publish in sysfs (amdgpu's
+ * product_name, the firmware label), else the raw ids.
+ */
+static void fossil_sys_hostinfo_gpu_name(fossil_sys_hostinfo_gpu_t *gpu, const char *dev_dir)
+{
+    char path[PATH_MAX];
+
+    if (fossil_sys_hostinfo_pci_ids_name(gpu->vendor_id, gpu->device_id, gpu->name, sizeof(gpu->name)) == 0)
+        return;
+
+    snprintf(path, sizeof(path), "%s/product_name", dev_dir);
+    if (fossil_sys_hostinfo_read_text(path, gpu->name, sizeof(gpu->name)) > 0)
+        return;
+    snprintf(path, sizeof(path), "%s/label", dev_dir);
+    if (fossil_sys_hostinfo_read_text(path, gpu->name, sizeof(gpu->name)) > 0)
+        return;
+
+    snprintf(gpu->name, sizeof(gpu->name), "%s Device %04x", gpu->vendor, (unsigned)gpu->device_id);
+}
+
+static int fossil_sys_hostinfo_gpu_compare(const void *a, const void *b)
+{
+    return strcmp(((const fossil_sys_hostinfo_gpu_t *)a)->bus_id,
+                  ((const fossil_sys_hostinfo_gpu_t *)b)->bus_id);
+}
+
+static void fossil_sys_hostinfo_gpus_pci(fossil_sys_hostinfo_gpu_list_t *list)
+{
+    DIR *dir = opendir("/sys/bus/pci/devices");
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    char dev_dir[320];
+    char path[PATH_MAX];
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+
+        snprintf(dev_dir, sizeof(dev_dir), "/sys/bus/pci/devices/%s", entry->d_name);
+        snprintf(path, sizeof(path), "%s/class", dev_dir);
+        long long pci_class = fossil_sys_hostinfo_read_ll(path, -1);
+        if (pci_class < 0 || ((pci_class >> 16) & 0xff) != 0x03)
+            continue; // not a display controller
+
+        fossil_sys_hostinfo_gpu_t *gpu = fossil_sys_hostinfo_gpu_add(list);
+        if (!gpu)
+            break;
+
+        fossil_sys_strcpy(gpu->bus_id, sizeof(gpu->bus_id), entry->d_name);
+        snprintf(path, sizeof(path), "%s/vendor", dev_dir);
+        gpu->vendor_id = (uint32_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "%s/device", dev_dir);
+        gpu->device_id = (uint32_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "%s/boot_vga", dev_dir);
+        gpu->is_primary = fossil_sys_hostinfo_read_ll(path, 0) == 1;
+
+        fossil_sys_strcpy(gpu->vendor, sizeof(gpu->vendor), fossil_sys_hostinfo_gpu_vendor_name(gpu->vendor_id));
+        fossil_sys_hostinfo_gpu_name(gpu, dev_dir);
+        fossil_sys_hostinfo_gpu_driver(gpu, dev_dir);
+
+        // amdgpu exposes VRAM usage directly on the PCI device
+        snprintf(path, sizeof(path), "%s/mem_info_vram_total", dev_dir);
+        long long total = fossil_sys_hostinfo_read_ll(path, 0);
+        if (total > 0)
+        {
+            snprintf(path, sizeof(path), "%s/mem_info_vram_used", dev_dir);
+            long long used = fossil_sys_hostinfo_read_ll(path, 0);
+            gpu->memory_total = (uint64_t)total;
+            gpu->memory_free = used > 0 && used <= total ? (uint64_t)(total - used) : 0;
+        }
+    }
+    closedir(dir);
+}
+
+/* Attaches DRM card numbers and adds DRM-only (non-PCI, e.g. SoC) GPUs. */
+static void fossil_sys_hostinfo_gpus_drm(fossil_sys_hostinfo_gpu_list_t *list)
+{
+    DIR *dir = opendir("/sys/class/drm");
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    char dev_dir[320];
+    char path[PATH_MAX];
+    char device[64];
+
+    while ((entry = readdir(dir)) != NULL)
+    {
+        const char *name = entry->d_name;
+        if (strncmp(name, "card", 4) != 0 || !isdigit((unsigned char)name[4]) || strchr(name, '-'))
+            continue; // connectors are card0-HDMI-A-1 etc.
+
+        int card = atoi(name + 4);
+        snprintf(dev_dir, sizeof(dev_dir), "/sys/class/drm/%s/device", name);
+        if (fossil_sys_hostinfo_read_link_name(dev_dir, device, sizeof(device)) != 0)
+            continue;
+
+        char key[sizeof(list->list[0].bus_id)];
+        snprintf(key, sizeof(key), "drm:%.27s", device);
+
+        fossil_sys_hostinfo_gpu_t *gpu = NULL;
+        for (size_t i = 0; i < list->count; ++i)
+        {
+            if (strcmp(list->list[i].bus_id, device) == 0 || strcmp(list->list[i].bus_id, key) == 0)
+            {
+                gpu = &list->list[i];
+                break;
+            }
+        }
+
+        if (!gpu)
+        {
+            gpu = fossil_sys_hostinfo_gpu_add(list);
+            if (!gpu)
+                break;
+            fossil_sys_hostinfo_gpu_driver(gpu, dev_dir);
+            // Not on PCI, so key it by the platform device for dedupe and ordering
+            fossil_sys_strcpy(gpu->bus_id, sizeof(gpu->bus_id), key);
+            snprintf(path, sizeof(path), "%s/label", dev_dir);
+            if (fossil_sys_hostinfo_read_text(path, gpu->name, sizeof(gpu->name)) <= 0)
+                fossil_sys_strcpy(gpu->name, sizeof(gpu->name), gpu->driver[0] ? gpu->driver : device);
+            snprintf(path, sizeof(path), "%s/vendor", dev_dir);
+            gpu->vendor_id = (uint32_t)fossil_sys_hostinfo_read_ll(path, 0);
+            fossil_sys_strcpy(gpu->vendor, sizeof(gpu->vendor), fossil_sys_hostinfo_gpu_vendor_name(gpu->vendor_id));
+        }
+        if (gpu->drm_card < 0 || card < gpu->drm_card)
+            gpu->drm_card = card;
+    }
+    closedir(dir);
+
+    qsort(list->list, list->count, sizeof(list->list[0]), fossil_sys_hostinfo_gpu_compare);
+}
+#endif
+
+int fossil_sys_hostinfo_get_gpus(fossil_sys_hostinfo_gpu_list_t *list)
+{
+    if (!list)
+        return -1;
+    list->count = 0;
+
+#ifdef _WIN32
+    IDXGIFactory *factory = NULL;
+    if (FAILED(CreateDXGIFactory(&IID_IDXGIFactory, (void **)&factory)))
+        return -2;
+
+    IDXGIAdapter *adapter = NULL;
+    for (UINT i = 0; factory->lpVtbl->EnumAdapters(factory, i, &adapter) == S_OK; ++i)
+    {
+        DXGI_ADAPTER_DESC desc;
+        fossil_sys_hostinfo_gpu_t *gpu = NULL;
+        if (adapter->lpVtbl->GetDesc(adapter, &desc) == S_OK && (gpu = fossil_sys_hostinfo_gpu_add(list)) != NULL)
+        {
+            wcstombs(gpu->name, desc.Description, sizeof(gpu->name) - 1);
+            gpu->name[sizeof(gpu->name) - 1] = '\0';
+            gpu->vendor_id = desc.VendorId;
+            gpu->device_id = desc.DeviceId;
+            fossil_sys_strcpy(gpu->vendor, sizeof(gpu->vendor), fossil_sys_hostinfo_gpu_vendor_name(desc.VendorId));
+            gpu->memory_total = desc.DedicatedVideoMemory;
+            gpu->memory_free = 0; // DXGI doesn't provide free memory directly
+            gpu->is_primary = i == 0;
+
+            LARGE_INTEGER umd;
+            if (adapter->lpVtbl->CheckInterfaceSupport(adapter, &IID_IDXGIDevice, &umd) == S_OK)
+            {
+                snprintf(gpu->driver_version, sizeof(gpu->driver_version), "%u.%u.%u.%u",
+                         (unsigned)(umd.HighPart >> 16), (unsigned)(umd.HighPart & 0xffff),
+                         (unsigned)(umd.LowPart >> 16), (unsigned)(umd.LowPart & 0xffff));
+            }
+        }
+        adapter->lpVtbl->Release(adapter);
+        if (!gpu && list->count >= FOSSIL_SYS_HOSTINFO_GPU_MAX)
+            break;
+    }
+    factory->lpVtbl->Release(factory);
+#elif defined(__APPLE__)
+    CFMutableDictionaryRef matchDict = IOServiceMatching("IOPCIDevice");
+    if (!matchDict)
+        return -2;
+
+    io_iterator_t iter;
+    // Use kIOMainPortDefault for macOS 12+ compatibility
+    if (IOServiceGetMatchingServices(kIOMainPortDefault, matchDict, &iter) != KERN_SUCCESS)
+        return -2;
+
+    io_object_t service;
+    while ((service = IOIteratorNext(iter)))
+    {
+        // class-code is the little-endian PCI class; base class 0x03 is display
+        int is_display = 0;
+        CFDataRef class_code = (CFDataRef)IORegistryEntryCreateCFProperty(
+            service, CFSTR("class-code"), kCFAllocatorDefault, 0);
+        if (class_code)
+        {
+            if (CFGetTypeID(class_code) == CFDataGetTypeID() && CFDataGetLength(class_code) >= 3)
+                is_display = CFDataGetBytePtr(class_code)[2] == 0x03;
+            CFRelease(class_code);
+        }
+        if (!is_display)
+        {
+            IOObjectRelease(service);
+            continue;
+        }
+
+        CFStringRef model = (CFStringRef)IORegistryEntryCreateCFProperty(
+            service, CFSTR("model"), kCFAllocatorDefault, 0);
+        char buffer[256];
+        if (model && CFGetTypeID(model) == CFStringGetTypeID() &&
+            CFStringGetCString(model, buffer, sizeof(buffer), kCFStringEncodingUTF8))
+        {
+            fossil_sys_hostinfo_gpu_t *gpu = fossil_sys_hostinfo_gpu_add(list);
+            if (gpu)
+            {
+                fossil_sys_strcpy(gpu->name, sizeof(gpu->name), buffer);
+                CFDataRef vendor = (CFDataRef)IORegistryEntryCreateCFProperty(
+                    service, CFSTR("vendor-id"), kCFAllocatorDefault, 0);
+                if (vendor)
+                {
+                    if (CFGetTypeID(vendor) == CFDataGetTypeID() && CFDataGetLength(vendor) >= 2)
+                    {
+                        const UInt8 *bytes = CFDataGetBytePtr(vendor);
+                        gpu->vendor_id = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8);
+                    }
+                    CFRelease(vendor);
+                }
+                fossil_sys_strcpy(gpu->vendor, sizeof(gpu->vendor), fossil_sys_hostinfo_gpu_vendor_name(gpu->vendor_id));
+                gpu->is_primary = list->count == 1;
+            }
+        }
+        if (model)
+            CFRelease(model);
+        IOObjectRelease(service);
+        if (list->count >= FOSSIL_SYS_HOSTINFO_GPU_MAX)
+            break;
+    }
+    IOObjectRelease(iter);
+#elif defined(__linux__)
+    fossil_sys_hostinfo_gpus_pci(list);
+    fossil_sys_hostinfo_gpus_drm(list);
+
+    int has_primary = 0;
+    for (size_t i = 0; i < list->count; ++i)
+        has_primary |= list->list[i].is_primary;
+    if (!has_primary && list->count > 0)
+        list->list[0].is_primary = 1;
+#else
+    return -2;
+#endif
+    return 0;
+}
+
+/* ============================================================================
+ * Metrics sampler
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+#define FOSSIL_SYS_HOSTINFO_SAMPLER_BUF (256 * 1024)
+
+typedef struct
+{
+    char name[32];
+    uint64_t v[5];
+} fossil_sys_hostinfo_counters_t;
+
+static struct
+{
+    pthread_mutex_t lock; // serialises writers and start/stop; readers never take it
+    pthread_cond_t wake;
+    int cond_ready;
+    pthread_t thread;
+    int running;
+    uint32_t interval_ms;
+
+    int fd_stat;
+    int fd_meminfo;
+    int fd_diskstats;
+    int fd_netdev;
+    int opened;
+    char *buf;
+
+    int block_count;
+    char block_names[FOSSIL_SYS_HOSTINFO_DISK_MAX][32];
+    int diskstats_lines; // line count when block_names was scanned
+
+    int have_prev;
+    uint64_t prev_ns;
+    uint64_t prev_total;
+    uint64_t prev_idle;
+    uint64_t prev_iowait;
+    uint64_t prev_cpu_total[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    uint64_t prev_cpu_idle[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    int prev_disk_count;
+    fossil_sys_hostinfo_counters_t prev_disks[FOSSIL_SYS_HOSTINFO_DISK_MAX];
+    int prev_iface_count;
+    fossil_sys_hostinfo_counters_t prev_ifaces[FOSSIL_SYS_HOSTINFO_IFACE_MAX];
+
+    fossil_sys_hostinfo_sample_t scratch;
+    uint64_t published; // sequence of the newest complete slot
+} fossil_sys_hostinfo_sampler = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .fd_stat = -1,
+    .fd_meminfo = -1,
+    .fd_diskstats = -1,
+    .fd_netdev = -1,
+};
+
+/*
+ * History ring. Slots hold packed samples sized to what is being sampled:
+ * the scalar fields, then cpu_cap CPU loads, disk_cap disk rates and
+ * iface_cap interface rates. Each slot is guarded by a sequence counter
+ * (seqlock): odd while the writer fills it, even when stable. Readers copy
+ * the slot and retry if the counter moved, so they never block the sampler.
+ *
+ * When a sample outgrows the ring the writer moves the history into a
+ * larger one. The old ring is kept, since a reader may still be copying
+ * from it; caps only grow, up to the *_MAX limits, so this is bounded.
+ */
+typedef struct fossil_sys_hostinfo_sampler_ring
+{
+    struct fossil_sys_hostinfo_sampler_ring *retired;
+    int cpu_cap;
+    int disk_cap;
+    int iface_cap;
+    size_t stride;
+    uint64_t slot_seq[FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY];
+    unsigned char slots[];
+} fossil_sys_hostinfo_sampler_ring_t;
+
+static fossil_sys_hostinfo_sampler_ring_t *fossil_sys_hostinfo_sampler_ring;
+
+static uint64_t fossil_sys_hostinfo_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* Re-reads a pre-opened procfs file from offset 0 into buf. */
+static ssize_t fossil_sys_hostinfo_pread_all(int fd, char *buf, size_t size)
+{
+    size_t len = 0;
+    while (len < size - 1)
+    {
+        ssize_t n = pread(fd, buf + len, size - 1 - len, (off_t)len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -1;
+        }
+        if (n == 0)
+            break;
+        len += (size_t)n;
+    }
+    buf[len] = '\0';
+    return (ssize_t)len;
+}
+
+static const char *fossil_sys_hostinfo_next_line(const char *p)
+{
+    const char *nl = strchr(p, '\n');
+    return nl ? nl + 1 : p + strlen(p);
+}
+
+/* Releases the descriptors and buffer; the next sample reopens them. */
+static void fossil_sys_hostinfo_sampler_close(void)
+{
+    int *fds[] = {&fossil_sys_hostinfo_sampler.fd_stat, &fossil_sys_hostinfo_sampler.fd_meminfo,
+                  &fossil_sys_hostinfo_sampler.fd_diskstats, &fossil_sys_hostinfo_sampler.fd_netdev};
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); ++i)
+    {
+        if (*fds[i] >= 0)
+            close(*fds[i]);
+        *fds[i] = -1;
+    }
+    free(fossil_sys_hostinfo_sampler.buf);
+    fossil_sys_hostinfo_sampler.buf = NULL;
+    fossil_sys_hostinfo_sampler.opened = 0;
+}
+
+static int fossil_sys_hostinfo_sampler_open(void)
+{
+    if (fossil_sys_hostinfo_sampler.opened)
+        return 0;
+
+    fossil_sys_hostinfo_sampler.buf = malloc(FOSSIL_SYS_HOSTINFO_SAMPLER_BUF);
+    fossil_sys_hostinfo_sampler.fd_stat = open("/proc/stat", O_RDONLY | O_CLOEXEC);
+    fossil_sys_hostinfo_sampler.fd_meminfo = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+    fossil_sys_hostinfo_sampler.fd_diskstats = open("/proc/diskstats", O_RDONLY | O_CLOEXEC);
+    fossil_sys_hostinfo_sampler.fd_netdev = open("/proc/net/dev", O_RDONLY | O_CLOEXEC);
+
+    if (!fossil_sys_hostinfo_sampler.buf || fossil_sys_hostinfo_sampler.fd_stat < 0)
+    {
+        fossil_sys_hostinfo_sampler_close();
+        return -3;
+    }
+
+    fossil_sys_hostinfo_sampler.diskstats_lines = -1; // scan on the first read
+    fossil_sys_hostinfo_sampler.opened = 1;
+    return 0;
+}
+
+/* Whole disks only; partitions in /proc/diskstats would double count. */
+static void fossil_sys_hostinfo_sampler_scan_disks(void)
+{
+    fossil_sys_hostinfo_sampler.block_count = 0;
+    DIR *dir = opendir("/sys/block");
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL &&
+           fossil_sys_hostinfo_sampler.block_count < FOSSIL_SYS_HOSTINFO_DISK_MAX)
+    {
+        const char *name = entry->d_name;
+        if (name[0] == '.' || strncmp(name, "loop", 4) == 0 || strncmp(name, "ram", 3) == 0)
+            continue;
+        fossil_sys_strcpy(fossil_sys_hostinfo_sampler.block_names[fossil_sys_hostinfo_sampler.block_count++],
+                          32, name);
+    }
+    closedir(dir);
+}
+
+static int fossil_sys_hostinfo_sampler_is_disk(const char *name)
+{
+    for (int i = 0; i < fossil_sys_hostinfo_sampler.block_count; ++i)
+    {
+        if (strcmp(fossil_sys_hostinfo_sampler.block_names[i], name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+static const fossil_sys_hostinfo_counters_t *fossil_sys_hostinfo_counters_find(
+    const fossil_sys_hostinfo_counters_t *list, int count, const char *name)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (strcmp(list[i].name, name) == 0)
+            return &list[i];
+    }
+    return NULL;
+}
+
+static float fossil_sys_hostinfo_percent(uint64_t part, uint64_t whole)
+{
+    if (part > whole)
+        part = whole;
+    return whole ? (float)(100.0 * (double)part / (double)whole) : 0.0f;
+}
+
+/* Counter delta; 0 when the counter went backwards (iowait, re-added devices). */
+static uint64_t fossil_sys_hostinfo_delta(uint64_t now, uint64_t prev)
+{
+    return now > prev ? now - prev : 0;
+}
+
+static void fossil_sys_hostinfo_sampler_cpu(fossil_sys_hostinfo_sample_t *out, int have_prev)
+{
+    if (fossil_sys_hostinfo_pread_all(fossil_sys_hostinfo_sampler.fd_stat, fossil_sys_hostinfo_sampler.buf,
+                                      FOSSIL_SYS_HOSTINFO_SAMPLER_BUF) <= 0)
+        return;
+
+    for (const char *p = fossil_sys_hostinfo_sampler.buf; *p && strncmp(p, "cpu", 3) == 0;
+         p = fossil_sys_hostinfo_next_line(p))
+    {
+        // user nice system idle iowait irq softirq steal; guest time is already in user
+        unsigned long long f[8] = {0};
+        int id = -1;
+        const char *q = p + 3;
+        if (*q != ' ')
+            id = (int)strtol(q, (char **)&q, 10);
+        for (int i = 0; i < 8; ++i)
+            f[i] = strtoull(q, (char **)&q, 10);
+
+        uint64_t total = 0;
+        for (int i = 0; i < 8; ++i)
+            total += f[i];
+        uint64_t idle = f[3] + f[4];
+
+        if (id < 0)
+        {
+            if (have_prev && total > fossil_sys_hostinfo_sampler.prev_total)
+            {
+                uint64_t dt = total - fossil_sys_hostinfo_sampler.prev_total;
+                uint64_t di = fossil_sys_hostinfo_delta(idle, fossil_sys_hostinfo_sampler.prev_idle);
+                out->cpu_busy = fossil_sys_hostinfo_percent(di < dt ? dt - di : 0, dt);
+                out->cpu_iowait = fossil_sys_hostinfo_percent(
+                    fossil_sys_hostinfo_delta(f[4], fossil_sys_hostinfo_sampler.prev_iowait), dt);
+            }
+            fossil_sys_hostinfo_sampler.prev_total = total;
+            fossil_sys_hostinfo_sampler.prev_idle = idle;
+            fossil_sys_hostinfo_sampler.prev_iowait = f[4];
+        }
+        else if (id < FOSSIL_SYS_HOSTINFO_CPU_MAX)
+        {
+            if (have_prev && total > fossil_sys_hostinfo_sampler.prev_cpu_total[id])
+            {
+                uint64_t dt = total - fossil_sys_hostinfo_sampler.prev_cpu_total[id];
+                uint64_t di = fossil_sys_hostinfo_delta(idle, fossil_sys_hostinfo_sampler.prev_cpu_idle[id]);
+                out->cpu[id] = fossil_sys_hostinfo_percent(di < dt ? dt - di : 0, dt);
+            }
+            fossil_sys_hostinfo_sampler.prev_cpu_total[id] = total;
+            fossil_sys_hostinfo_sampler.prev_cpu_idle[id] = idle;
+            if (id + 1 > out->cpu_count)
+                out->cpu_count = id + 1;
+        }
+    }
+}
+
+static void fossil_sys_hostinfo_sampler_memory(fossil_sys_hostinfo_sample_t *out)
+{
+    if (fossil_sys_hostinfo_sampler.fd_meminfo < 0 ||
+        fossil_sys_hostinfo_pread_all(fossil_sys_hostinfo_sampler.fd_meminfo, fossil_sys_hostinfo_sampler.buf,
+                                      FOSSIL_SYS_HOSTINFO_SAMPLER_BUF) <= 0)
+        return;
+
+    uint64_t swap_total = 0, swap_free = 0;
+    for (const char *p = fossil_sys_hostinfo_sampler.buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        uint64_t *dst = NULL;
+        if (strncmp(p, "MemTotal:", 9) == 0)
+            dst = &out->memory_total;
+        else if (strncmp(p, "MemAvailable:", 13) == 0)
+            dst = &out->memory_available;
+        else if (strncmp(p, "SwapTotal:", 10) == 0)
+            dst = &swap_total;
+        else if (strncmp(p, "SwapFree:", 9) == 0)
+            dst = &swap_free;
+        if (dst)
+            *dst = (uint64_t)strtoull(strchr(p, ':') + 1, NULL, 10) * 1024u;
+    }
+    out->swap_used = swap_total > swap_free ? swap_total - swap_free : 0;
+}
+
+static void fossil_sys_hostinfo_sampler_disks(fossil_sys_hostinfo_sample_t *out, double seconds)
+{
+    fossil_sys_hostinfo_counters_t now[FOSSIL_SYS_HOSTINFO_DISK_MAX];
+    int count = 0;
+
+    if (fossil_sys_hostinfo_sampler.fd_diskstats < 0 ||
+        fossil_sys_hostinfo_pread_all(fossil_sys_hostinfo_sampler.fd_diskstats, fossil_sys_hostinfo_sampler.buf,
+                                      FOSSIL_SYS_HOSTINFO_SAMPLER_BUF) <= 0)
+        return;
+
+    // A hot-plugged or removed disk changes the line count; rescan then
+    int lines = 0;
+    for (const char *p = fossil_sys_hostinfo_sampler.buf; *p; p = fossil_sys_hostinfo_next_line(p))
+        lines++;
+    if (lines != fossil_sys_hostinfo_sampler.diskstats_lines)
+    {
+        fossil_sys_hostinfo_sampler_scan_disks();
+        fossil_sys_hostinfo_sampler.diskstats_lines = lines;
+    }
+
+    for (const char *p = fossil_sys_hostinfo_sampler.buf; *p && count < FOSSIL_SYS_HOSTINFO_DISK_MAX;
+         p = fossil_sys_hostinfo_next_line(p))
+    {
+        // major minor name reads merged sectors ms writes merged sectors ms inflight io_ticks ...
+        unsigned int major, minor;
+        char name[32];
+        unsigned long long f[10];
+        if (sscanf(p, "%u %u %31s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu", &major, &minor, name,
+                   &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6], &f[7], &f[8], &f[9]) != 13)
+            continue;
+        if (!fossil_sys_hostinfo_sampler_is_disk(name))
+            continue;
+
+        fossil_sys_hostinfo_counters_t *c = &now[count];
+        fossil_sys_strcpy(c->name, sizeof(c->name), name);
+        c->v[0] = f[0]; // reads completed
+        c->v[1] = f[2]; // sectors read
+        c->v[2] = f[4]; // writes completed
+        c->v[3] = f[6]; // sectors written
+        c->v[4] = f[9]; // ms spent doing IO
+
+        fossil_sys_hostinfo_disk_rate_t *rate = &out->disks[count];
+        fossil_sys_strcpy(rate->name, sizeof(rate->name), name);
+        const fossil_sys_hostinfo_counters_t *prev = fossil_sys_hostinfo_counters_find(
+            fossil_sys_hostinfo_sampler.prev_disks, fossil_sys_hostinfo_sampler.prev_disk_count, name);
+        if (prev && seconds > 0)
+        {
+            // diskstats sectors are always 512 bytes regardless of the device
+            rate->reads_per_sec = (double)fossil_sys_hostinfo_delta(c->v[0], prev->v[0]) / seconds;
+            rate->read_bytes_per_sec = (double)fossil_sys_hostinfo_delta(c->v[1], prev->v[1]) * 512.0 / seconds;
+            rate->writes_per_sec = (double)fossil_sys_hostinfo_delta(c->v[2], prev->v[2]) / seconds;
+            rate->write_bytes_per_sec = (double)fossil_sys_hostinfo_delta(c->v[3], prev->v[3]) * 512.0 / seconds;
+            double busy = (double)fossil_sys_hostinfo_delta(c->v[4], prev->v[4]) / (seconds * 10.0);
+            rate->busy_percent = (float)(busy > 100.0 ? 100.0 : busy);
+        }
+        count++;
+    }
+
+    out->disk_count = count;
+    memcpy(fossil_sys_hostinfo_sampler.prev_disks, now, sizeof(now[0]) * (size_t)count);
+    fossil_sys_hostinfo_sampler.prev_disk_count = count;
+}
+
+static void fossil_sys_hostinfo_sampler_net(fossil_sys_hostinfo_sample_t *out, double seconds)
+{
+    fossil_sys_hostinfo_counters_t now[FOSSIL_SYS_HOSTINFO_IFACE_MAX];
+    int count = 0;
+
+    if (fossil_sys_hostinfo_sampler.fd_netdev < 0 ||
+        fossil_sys_hostinfo_pread_all(fossil_sys_hostinfo_sampler.fd_netdev, fossil_sys_hostinfo_sampler.buf,
+                                      FOSSIL_SYS_HOSTINFO_SAMPLER_BUF) <= 0)
+        return;
+
+    for (const char *p = fossil_sys_hostinfo_sampler.buf; *p && count < FOSSIL_SYS_HOSTINFO_IFACE_MAX;
+         p = fossil_sys_hostinfo_next_line(p))
+    {
+        // "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast tx_bytes tx_packets ..."
+        const char *colon = strchr(p, ':');
+        const char *nl = strchr(p, '\n');
+        if (!colon || (nl && colon > nl))
+            continue; // header lines
+        while (*p == ' ')
+            p++;
+
+        fossil_sys_hostinfo_counters_t *c = &now[count];
+        size_t len = (size_t)(colon - p);
+        if (len >= sizeof(c->name))
+            len = sizeof(c->name) - 1;
+        memcpy(c->name, p, len);
+        c->name[len] = '\0';
+
+        unsigned long long f[10];
+        const char *q = colon + 1;
+        for (int i = 0; i < 10; ++i)
+            f[i] = strtoull(q, (char **)&q, 10);
+        c->v[0] = f[0]; // rx bytes
+        c->v[1] = f[1]; // rx packets
+        c->v[2] = f[8]; // tx bytes
+        c->v[3] = f[9]; // tx packets
+
+        fossil_sys_hostinfo_net_rate_t *rate = &out->ifaces[count];
+        fossil_sys_strcpy(rate->name, sizeof(rate->name), c->name);
+        const fossil_sys_hostinfo_counters_t *prev = fossil_sys_hostinfo_counters_find(
+            fossil_sys_hostinfo_sampler.prev_ifaces, fossil_sys_hostinfo_sampler.prev_iface_count, c->name);
+        if (prev && seconds > 0)
+        {
+            rate->rx_bytes_per_sec = (double)fossil_sys_hostinfo_delta(c->v[0], prev->v[0]) / seconds;
+            rate->rx_packets_per_sec = (double)fossil_sys_hostinfo_delta(c->v[1], prev->v[1]) / seconds;
+            rate->tx_bytes_per_sec = (double)fossil_sys_hostinfo_delta(c->v[2], prev->v[2]) / seconds;
+            rate->tx_packets_per_sec = (double)fossil_sys_hostinfo_delta(c->v[3], prev->v[3]) / seconds;
+        }
+        count++;
+    }
+
+    out->iface_count = count;
+    memcpy(fossil_sys_hostinfo_sampler.prev_ifaces, now, sizeof(now[0]) * (size_t)count);
+    fossil_sys_hostinfo_sampler.prev_iface_count = count;
+}
+
+/*
+ * Moves one sample between a slot and a full structure: the scalar runs
+ * whole, each array only up to the ring's cap. Counts beyond the caps are
+ * dropped when packing.
+ */
+static void fossil_sys_hostinfo_sampler_copy(const fossil_sys_hostinfo_sampler_ring_t *ring, size_t slot,
+                                             fossil_sys_hostinfo_sample_t *sample, int pack)
+{
+    const struct
+    {
+        size_t offset;
+        size_t size;
+    } runs[] = {
+        {0, offsetof(fossil_sys_hostinfo_sample_t, cpu)},
+        {offsetof(fossil_sys_hostinfo_sample_t, cpu), sizeof(sample->cpu[0]) * (size_t)ring->cpu_cap},
+        {offsetof(fossil_sys_hostinfo_sample_t, memory_total),
+         offsetof(fossil_sys_hostinfo_sample_t, disks) - offsetof(fossil_sys_hostinfo_sample_t, memory_total)},
+        {offsetof(fossil_sys_hostinfo_sample_t, disks), sizeof(sample->disks[0]) * (size_t)ring->disk_cap},
+        {offsetof(fossil_sys_hostinfo_sample_t, iface_count),
+         offsetof(fossil_sys_hostinfo_sample_t, ifaces) - offsetof(fossil_sys_hostinfo_sample_t, iface_count)},
+        {offsetof(fossil_sys_hostinfo_sample_t, ifaces), sizeof(sample->ifaces[0]) * (size_t)ring->iface_cap},
+    };
+
+    unsigned char *p = (unsigned char *)ring->slots + slot * ring->stride;
+    for (size_t i = 0; i < sizeof(runs) / sizeof(runs[0]); ++i)
+    {
+        if (pack)
+            memcpy(p, (const unsigned char *)sample + runs[i].offset, runs[i].size);
+        else
+            memcpy((unsigned char *)sample + runs[i].offset, p, runs[i].size);
+        p += runs[i].size;
+    }
+    if (pack)
+        return;
+
+    // Counts are read racily and only validated afterwards; keep them in bounds
+    if (sample->cpu_count < 0 || sample->cpu_count > ring->cpu_cap)
+        sample->cpu_count = ring->cpu_cap;
+    if (sample->disk_count < 0 || sample->disk_count > ring->disk_cap)
+        sample->disk_count = ring->disk_cap;
+    if (sample->iface_count < 0 || sample->iface_count > ring->iface_cap)
+        sample->iface_count = ring->iface_cap;
+}
+
+static int fossil_sys_hostinfo_sampler_cap(int needed, int current, int headroom, int max)
+{
+    int cap = needed > current ? needed + headroom : current;
+    return cap > max ? max : cap;
+}
+
+/*
+ * Returns a ring large enough for sample, moving the history into a new
+ * ring when the current one is too small. Caller holds the sampler lock.
+ */
+static fossil_sys_hostinfo_sampler_ring_t *fossil_sys_hostinfo_sampler_reserve(const fossil_sys_hostinfo_sample_t *sample)
+{
+    fossil_sys_hostinfo_sampler_ring_t *old = fossil_sys_hostinfo_sampler_ring;
+    if (old && sample->cpu_count <= old->cpu_cap && sample->disk_count <= old->disk_cap &&
+        sample->iface_count <= old->iface_cap)
+        return old;
+
+    // CPUs are fixed at boot; disks and interfaces get room to come and go
+    int cpu_cap = fossil_sys_hostinfo_sampler_cap(sample->cpu_count, old ? old->cpu_cap : 0, 0,
+                                                  FOSSIL_SYS_HOSTINFO_CPU_MAX);
+    int disk_cap = fossil_sys_hostinfo_sampler_cap(sample->disk_count, old ? old->disk_cap : 0, 4,
+                                                   FOSSIL_SYS_HOSTINFO_DISK_MAX);
+    int iface_cap = fossil_sys_hostinfo_sampler_cap(sample->iface_count, old ? old->iface_cap : 0, 4,
+                                                    FOSSIL_SYS_HOSTINFO_IFACE_MAX);
+    // The fixed part is everything but the three arrays
+    size_t stride = sizeof(*sample) - sizeof(sample->cpu) - sizeof(sample->disks) - sizeof(sample->ifaces) +
+                    sizeof(sample->cpu[0]) * (size_t)cpu_cap + sizeof(sample->disks[0]) * (size_t)disk_cap +
+                    sizeof(sample->ifaces[0]) * (size_t)iface_cap;
+
+    fossil_sys_hostinfo_sampler_ring_t *ring =
+        calloc(1, sizeof(*ring) + stride * FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY);
+    fossil_sys_hostinfo_sample_t *moved = old ? malloc(sizeof(*moved)) : NULL;
+    if (!ring || (old && !moved))
+    {
+        free(ring);
+        free(moved);
+        return old; // keep sampling, truncated to the current caps
+    }
+    ring->retired = old;
+    ring->cpu_cap = cpu_cap;
+    ring->disk_cap = disk_cap;
+    ring->iface_cap = iface_cap;
+    ring->stride = stride;
+
+    // Only this thread writes, so the old slots are stable
+    for (size_t slot = 0; old && slot < FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY; ++slot)
+    {
+        memset(moved, 0, sizeof(*moved));
+        fossil_sys_hostinfo_sampler_copy(old, slot, moved, 0);
+        fossil_sys_hostinfo_sampler_copy(ring, slot, moved, 1);
+        ring->slot_seq[slot] = old->slot_seq[slot];
+    }
+    free(moved);
+
+    __atomic_store_n(&fossil_sys_hostinfo_sampler_ring, ring, __ATOMIC_RELEASE);
+    return ring;
+}
+
+/* Takes one sample and publishes it. Caller holds the sampler lock. */
+static int fossil_sys_hostinfo_sampler_step(void)
+{
+    if (fossil_sys_hostinfo_sampler_open() != 0)
+        return -3;
+
+    fossil_sys_hostinfo_sample_t *out = &fossil_sys_hostinfo_sampler.scratch;
+    memset(out, 0, sizeof(*out));
+
+    uint64_t now = fossil_sys_hostinfo_now_ns();
+    int have_prev = fossil_sys_hostinfo_sampler.have_prev;
+    double seconds = 0;
+    if (have_prev && now > fossil_sys_hostinfo_sampler.prev_ns)
+    {
+        seconds = (double)(now - fossil_sys_hostinfo_sampler.prev_ns) / 1e9;
+        out->interval_ms = (uint32_t)((now - fossil_sys_hostinfo_sampler.prev_ns) / 1000000u);
+    }
+
+    fossil_sys_hostinfo_sampler_cpu(out, have_prev);
+    fossil_sys_hostinfo_sampler_memory(out);
+    fossil_sys_hostinfo_sampler_disks(out, have_prev ? seconds : 0);
+    fossil_sys_hostinfo_sampler_net(out, have_prev ? seconds : 0);
+    fossil_sys_hostinfo_sampler.prev_ns = now;
+    fossil_sys_hostinfo_sampler.have_prev = 1;
+
+    uint64_t seq = __atomic_load_n(&fossil_sys_hostinfo_sampler.published, __ATOMIC_RELAXED) + 1;
+    out->sequence = seq;
+    out->timestamp_ns = now;
+
+    fossil_sys_hostinfo_sampler_ring_t *ring = fossil_sys_hostinfo_sampler_reserve(out);
+    if (!ring)
+        return -3;
+
+    size_t slot = (size_t)((seq - 1) % FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY);
+    uint64_t version = __atomic_load_n(&ring->slot_seq[slot], __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->slot_seq[slot], version + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    fossil_sys_hostinfo_sampler_copy(ring, slot, out, 1);
+    __atomic_store_n(&ring->slot_seq[slot], version + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&fossil_sys_hostinfo_sampler.published, seq, __ATOMIC_RELEASE);
+    return 0;
+}
+
+/* Copies the slot holding sample seq; returns 0 if it was overwritten meanwhile. */
+static int fossil_sys_hostinfo_sampler_read(uint64_t seq, fossil_sys_hostinfo_sample_t *out)
+{
+    size_t slot = (size_t)((seq - 1) % FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY);
+    const fossil_sys_hostinfo_sampler_ring_t *ring =
+        __atomic_load_n(&fossil_sys_hostinfo_sampler_ring, __ATOMIC_ACQUIRE);
+    if (!ring)
+        return 0;
+    memset(out, 0, sizeof(*out));
+    for (;;)
+    {
+        uint64_t before = __atomic_load_n(&ring->slot_seq[slot], __ATOMIC_ACQUIRE);
+        if (before & 1)
+            continue; // writer in progress
+        fossil_sys_hostinfo_sampler_copy(ring, slot, out, 0);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&ring->slot_seq[slot], __ATOMIC_RELAXED) == before)
+            return out->sequence == seq;
+    }
+}
+
+static void *fossil_sys_hostinfo_sampler_main(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&fossil_sys_hostinfo_sampler.lock);
+    while (fossil_sys_hostinfo_sampler.running)
+    {
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        uint64_t ns = (uint64_t)deadline.tv_nsec + (uint64_t)fossil_sys_hostinfo_sampler.interval_ms * 1000000u;
+        deadline.tv_sec += (time_t)(ns / 1000000000u);
+        deadline.tv_nsec = (long)(ns % 1000000000u);
+
+        int rc = 0;
+        while (fossil_sys_hostinfo_sampler.running && rc != ETIMEDOUT)
+            rc = pthread_cond_timedwait(&fossil_sys_hostinfo_sampler.wake, &fossil_sys_hostinfo_sampler.lock, &deadline);
+        if (!fossil_sys_hostinfo_sampler.running)
+            break;
+        fossil_sys_hostinfo_sampler_step();
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+    return NULL;
+}
+#endif
+
+int fossil_sys_hostinfo_sampler_start(uint32_t interval_ms)
+{
+#if defined(__linux__)
+    if (interval_ms == 0)
+        interval_ms = FOSSIL_SYS_HOSTINFO_SAMPLER_INTERVAL_MS;
+
+    pthread_mutex_lock(&fossil_sys_hostinfo_sampler.lock);
+    fossil_sys_hostinfo_sampler.interval_ms = interval_ms;
+    if (fossil_sys_hostinfo_sampler.running)
+    {
+        pthread_cond_signal(&fossil_sys_hostinfo_sampler.wake);
+        pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+        return 0;
+    }
+
+    if (!fossil_sys_hostinfo_sampler.cond_ready)
+    {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&fossil_sys_hostinfo_sampler.wake, &attr);
+        pthread_condattr_destroy(&attr);
+        fossil_sys_hostinfo_sampler.cond_ready = 1;
+    }
+
+    // Baseline so the first timed sample already carries rates
+    int rc = fossil_sys_hostinfo_sampler_step();
+    if (rc == 0)
+    {
+        fossil_sys_hostinfo_sampler.running = 1;
+        if (pthread_create(&fossil_sys_hostinfo_sampler.thread, NULL, fossil_sys_hostinfo_sampler_main, NULL) != 0)
+        {
+            fossil_sys_hostinfo_sampler.running = 0;
+            rc = -3;
+        }
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+    return rc;
+#else
+    (void)interval_ms;
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_sampler_stop(void)
+{
+#if defined(__linux__)
+    pthread_mutex_lock(&fossil_sys_hostinfo_sampler.lock);
+    int was_running = fossil_sys_hostinfo_sampler.running;
+    fossil_sys_hostinfo_sampler.running = 0;
+    if (was_running)
+        pthread_cond_signal(&fossil_sys_hostinfo_sampler.wake);
+    pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+
+    if (was_running)
+        pthread_join(fossil_sys_hostinfo_sampler.thread, NULL);
+
+    // A start that raced in after the unlock owns the descriptors again
+    pthread_mutex_lock(&fossil_sys_hostinfo_sampler.lock);
+    if (!fossil_sys_hostinfo_sampler.running)
+        fossil_sys_hostinfo_sampler_close();
+    pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_sampler_sample_now(void)
+{
+#if defined(__linux__)
+    pthread_mutex_lock(&fossil_sys_hostinfo_sampler.lock);
+    int rc = fossil_sys_hostinfo_sampler_step();
+    pthread_mutex_unlock(&fossil_sys_hostinfo_sampler.lock);
+    return rc;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_sampler_latest(fossil_sys_hostinfo_sample_t *out)
+{
+    if (!out)
+        return -1;
+#if defined(__linux__)
+    for (;;)
+    {
+        uint64_t seq = __atomic_load_n(&fossil_sys_hostinfo_sampler.published, __ATOMIC_ACQUIRE);
+        if (seq == 0)
+            return -2;
+        if (fossil_sys_hostinfo_sampler_read(seq, out))
+            return 0;
+    }
+#else
+    return -2;
+#endif
+}
+
+size_t fossil_sys_hostinfo_sampler_history(fossil_sys_hostinfo_sample_t *out, size_t max)
+{
+    size_t copied = 0;
+    if (!out)
+        return 0;
+#if defined(__linux__)
+    uint64_t seq = __atomic_load_n(&fossil_sys_hostinfo_sampler.published, __ATOMIC_ACQUIRE);
+    if (max > FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY)
+        max = FOSSIL_SYS_HOSTINFO_SAMPLER_HISTORY;
+    while (copied < max && seq > 0)
+    {
+        // A slot that was overwritten while copying ends the history
+        if (!fossil_sys_hostinfo_sampler_read(seq, &out[copied]))
+            break;
+        copied++;
+        seq--;
+    }
+#else
+    (void)max;
+#endif
+    return copied;
+}
+
+/* ============================================================================
+ * Pressure Stall Information
+ * ============================================================================
+ */
+
+#include "fossil/sys/event.h"
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+
+static const char *const fossil_sys_hostinfo_psi_paths[FOSSIL_SYS_HOSTINFO_PSI_COUNT] = {
+    "/proc/pressure/cpu",
+    "/proc/pressure/memory",
+    "/proc/pressure/io",
+};
+
+static const char *const fossil_sys_hostinfo_psi_event_ids[FOSSIL_SYS_HOSTINFO_PSI_COUNT] = {
+    FOSSIL_SYS_HOSTINFO_PSI_EVENT_CPU,
+    FOSSIL_SYS_HOSTINFO_PSI_EVENT_MEMORY,
+    FOSSIL_SYS_HOSTINFO_PSI_EVENT_IO,
+};
+
+typedef struct
+{
+    int fd;
+    int active;  // registered and polled
+    int closing; // removed while a dispatch was polling; closed afterwards
+    fossil_sys_hostinfo_psi_resource_t resource;
+    fossil_sys_hostinfo_psi_kind_t kind;
+    uint32_t stall_us;
+    uint32_t window_us;
+} fossil_sys_hostinfo_psi_trigger_t;
+
+static struct
+{
+    pthread_mutex_t lock;
+    fossil_sys_hostinfo_psi_trigger_t triggers[FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX];
+    int wake_fd; // eventfd that interrupts a dispatch blocked in poll()
+    int dispatching;
+    int watching;
+    pthread_t thread;
+} fossil_sys_hostinfo_psi = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake_fd = -1,
+};
+
+/* Caller holds the PSI lock. */
+static int fossil_sys_hostinfo_psi_wake_fd(void)
+{
+    if (fossil_sys_hostinfo_psi.wake_fd < 0)
+        fossil_sys_hostinfo_psi.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return fossil_sys_hostinfo_psi.wake_fd;
+}
+
+/* Caller holds the PSI lock. */
+static void fossil_sys_hostinfo_psi_wake(void)
+{
+    uint64_t one = 1;
+    if (fossil_sys_hostinfo_psi.wake_fd >= 0)
+        (void)!write(fossil_sys_hostinfo_psi.wake_fd, &one, sizeof(one));
+}
+#endif
+
+int fossil_sys_hostinfo_get_psi(fossil_sys_hostinfo_psi_resource_t resource, fossil_sys_hostinfo_psi_t *info)
+{
+    if (!info || resource < 0 || resource >= FOSSIL_SYS_HOSTINFO_PSI_COUNT)
+        return -1;
+    memset(info, 0, sizeof(*info));
+#if defined(__linux__)
+    char buf[256];
+    if (fossil_sys_hostinfo_read_text(fossil_sys_hostinfo_psi_paths[resource], buf, sizeof(buf)) <= 0)
+        return -2;
+
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    // full avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        char kind[8];
+        unsigned long long total = 0;
+        fossil_sys_hostinfo_psi_line_t line;
+        if (sscanf(p, "%7s avg10=%f avg60=%f avg300=%f total=%llu", kind, &line.avg10, &line.avg60,
+                   &line.avg300, &total) != 5)
+            continue;
+        line.total_us = total;
+        if (strcmp(kind, "some") == 0)
+            info->some = line;
+        else if (strcmp(kind, "full") == 0)
+        {
+            info->full = line;
+            info->has_full = 1;
+        }
+    }
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_psi_trigger_add(fossil_sys_hostinfo_psi_resource_t resource,
+                                        fossil_sys_hostinfo_psi_kind_t kind,
+                                        uint32_t stall_us, uint32_t window_us)
+{
+    if (resource < 0 || resource >= FOSSIL_SYS_HOSTINFO_PSI_COUNT ||
+        (kind != FOSSIL_SYS_HOSTINFO_PSI_SOME && kind != FOSSIL_SYS_HOSTINFO_PSI_FULL) ||
+        stall_us == 0 || stall_us > window_us)
+        return -1;
+#if defined(__linux__)
+    int fd = open(fossil_sys_hostinfo_psi_paths[resource], O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+        return errno == ENOENT ? -2 : -3;
+
+    // The kernel expects the trigger string including its terminator
+    char spec[64];
+    int len = snprintf(spec, sizeof(spec), "%s %u %u", kind == FOSSIL_SYS_HOSTINFO_PSI_FULL ? "full" : "some",
+                       stall_us, window_us);
+    if (write(fd, spec, (size_t)len + 1) < 0)
+    {
+        close(fd);
+        return -3;
+    }
+
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    for (int i = 0; i < FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX; ++i)
+    {
+        fossil_sys_hostinfo_psi_trigger_t *t = &fossil_sys_hostinfo_psi.triggers[i];
+        if (t->active || t->closing)
+            continue;
+        t->fd = fd;
+        t->active = 1;
+        t->resource = resource;
+        t->kind = kind;
+        t->stall_us = stall_us;
+        t->window_us = window_us;
+        fossil_sys_hostinfo_psi_wake(); // let a running dispatch pick it up
+        pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+        return i;
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+    close(fd);
+    return -4;
+#else
+    (void)window_us;
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_psi_trigger_remove(int trigger_id)
+{
+#if defined(__linux__)
+    if (trigger_id < 0 || trigger_id >= FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX)
+        return -1;
+
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    fossil_sys_hostinfo_psi_trigger_t *t = &fossil_sys_hostinfo_psi.triggers[trigger_id];
+    if (!t->active)
+    {
+        pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+        return -1;
+    }
+    t->active = 0;
+    if (fossil_sys_hostinfo_psi.dispatching)
+    {
+        // The fd may be inside poll() right now; the dispatcher closes it
+        t->closing = 1;
+        fossil_sys_hostinfo_psi_wake();
+    }
+    else
+    {
+        close(t->fd);
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+    return 0;
+#else
+    (void)trigger_id;
+    return -1;
+#endif
+}
+
+int fossil_sys_hostinfo_psi_dispatch(uint32_t timeout_ms)
+{
+#if defined(__linux__)
+    struct pollfd fds[FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX + 1];
+    int owner[FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX + 1];
+    nfds_t count = 0;
+
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    if (fossil_sys_hostinfo_psi.dispatching)
+    {
+        pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+        return -4;
+    }
+    fossil_sys_hostinfo_psi.dispatching = 1;
+
+    int wake_fd = fossil_sys_hostinfo_psi_wake_fd();
+    if (wake_fd >= 0)
+    {
+        fds[count].fd = wake_fd;
+        fds[count].events = POLLIN;
+        owner[count++] = -1;
+    }
+    for (int i = 0; i < FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX; ++i)
+    {
+        if (!fossil_sys_hostinfo_psi.triggers[i].active)
+            continue;
+        fds[count].fd = fossil_sys_hostinfo_psi.triggers[i].fd;
+        fds[count].events = POLLPRI;
+        owner[count++] = i;
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+
+    int timeout = timeout_ms == UINT32_MAX ? -1 : (timeout_ms > INT_MAX ? INT_MAX : (int)timeout_ms);
+    int ready = poll(fds, count, timeout);
+    int posted = 0;
+
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    for (nfds_t i = 0; ready > 0 && i < count; ++i)
+    {
+        if (owner[i] < 0)
+        {
+            uint64_t drained;
+            if (fds[i].revents & POLLIN)
+                (void)!read(fds[i].fd, &drained, sizeof(drained));
+            continue;
+        }
+
+        fossil_sys_hostinfo_psi_trigger_t *t = &fossil_sys_hostinfo_psi.triggers[owner[i]];
+        if (!(fds[i].revents & POLLPRI) || !t->active)
+            continue;
+
+        fossil_sys_hostinfo_psi_event_t event;
+        memset(&event, 0, sizeof(event));
+        event.trigger_id = owner[i];
+        event.resource = t->resource;
+        event.kind = t->kind;
+        event.stall_us = t->stall_us;
+        event.window_us = t->window_us;
+        fossil_sys_hostinfo_get_psi(t->resource, &event.pressure);
+        if (fossil_sys_event_post(fossil_sys_hostinfo_psi_event_ids[t->resource], &event, sizeof(event)) == 0)
+            posted++;
+    }
+    for (int i = 0; i < FOSSIL_SYS_HOSTINFO_PSI_TRIGGER_MAX; ++i)
+    {
+        fossil_sys_hostinfo_psi_trigger_t *t = &fossil_sys_hostinfo_psi.triggers[i];
+        if (t->closing)
+        {
+            close(t->fd);
+            t->closing = 0;
+        }
+    }
+    fossil_sys_hostinfo_psi.dispatching = 0;
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+    return posted;
+#else
+    (void)timeout_ms;
+    return -2;
+#endif
+}
+
+#if defined(__linux__)
+static void *fossil_sys_hostinfo_psi_main(void *arg)
+{
+    (void)arg;
+    while (__atomic_load_n(&fossil_sys_hostinfo_psi.watching, __ATOMIC_ACQUIRE))
+    {
+        // Bounded wait so a missed wake-up can never stall shutdown
+        if (fossil_sys_hostinfo_psi_dispatch(1000) == -4)
+            poll(NULL, 0, 100);
+    }
+    return NULL;
+}
+#endif
+
+int fossil_sys_hostinfo_psi_watch_start(void)
+{
+#if defined(__linux__)
+    int rc = 0;
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    if (!fossil_sys_hostinfo_psi.watching)
+    {
+        fossil_sys_hostinfo_psi_wake_fd();
+        __atomic_store_n(&fossil_sys_hostinfo_psi.watching, 1, __ATOMIC_RELEASE);
+        if (pthread_create(&fossil_sys_hostinfo_psi.thread, NULL, fossil_sys_hostinfo_psi_main, NULL) != 0)
+        {
+            __atomic_store_n(&fossil_sys_hostinfo_psi.watching, 0, __ATOMIC_RELEASE);
+            rc = -3;
+        }
+    }
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+    return rc;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_psi_watch_stop(void)
+{
+#if defined(__linux__)
+    pthread_mutex_lock(&fossil_sys_hostinfo_psi.lock);
+    int was_watching = fossil_sys_hostinfo_psi.watching;
+    __atomic_store_n(&fossil_sys_hostinfo_psi.watching, 0, __ATOMIC_RELEASE);
+    if (was_watching)
+        fossil_sys_hostinfo_psi_wake();
+    pthread_mutex_unlock(&fossil_sys_hostinfo_psi.lock);
+
+    if (was_watching)
+        pthread_join(fossil_sys_hostinfo_psi.thread, NULL);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+/* ============================================================================
+ * Mounts and block devices
+ * ============================================================================
+ */
+
+#if defined(__APPLE__)
+#include <sys/mount.h>
+#include <sys/statvfs.h>
+#endif
+
+static fossil_sys_hostinfo_mount_t *fossil_sys_hostinfo_mount_add(fossil_sys_hostinfo_mount_list_t *list)
+{
+    if (list->count >= FOSSIL_SYS_HOSTINFO_MOUNT_MAX)
+        return NULL;
+    fossil_sys_hostinfo_mount_t *m = &list->list[list->count++];
+    memset(m, 0, sizeof(*m));
+    return m;
+}
+
+/*
+ * Filesystems served over the network. statvfs on one whose server is
+ * gone blocks until the client times out, so capacity is opt-in for them.
+ */
+static int fossil_sys_hostinfo_is_network_fs(const char *type)
+{
+    static const char *const network[] = {
+        "9p", "afs", "ceph", "cifs", "davfs", "fuse.glusterfs", "fuse.rclone", "fuse.s3fs",
+        "fuse.sshfs", "glusterfs", "gpfs", "lustre", "ncpfs", "nfs", "nfs4", "smb3", "smbfs",
+        "webdav",
+    };
+    for (size_t i = 0; i < sizeof(network) / sizeof(network[0]); ++i)
+    {
+        if (strcmp(type, network[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+#if defined(__linux__)
+/* Kernel-side filesystems that never hold user data. */
+static int fossil_sys_hostinfo_is_pseudo_fs(const char *type)
+{
+    static const char *const pseudo[] = {
+        "autofs", "binfmt_misc", "bpf", "cgroup", "cgroup2", "configfs", "debugfs",
+        "devpts", "devtmpfs", "efivarfs", "fusectl", "hugetlbfs", "mqueue", "nsfs",
+        "proc", "pstore", "rpc_pipefs", "securityfs", "selinuxfs", "sysfs", "tracefs",
+    };
+    for (size_t i = 0; i < sizeof(pseudo) / sizeof(pseudo[0]); ++i)
+    {
+        if (strcmp(type, pseudo[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+/* Copies one space-separated mountinfo field, decoding \\040-style escapes. */
+static const char *fossil_sys_hostinfo_mountinfo_field(const char *p, char *out, size_t size)
+{
+    size_t len = 0;
+    while (*p == ' ')
+        p++;
+    while (*p && *p != ' ' && *p != '\n')
+    {
+        char c = *p++;
+        if (c == '\\' && p[0] >= '0' && p[0] <= '7' && p[1] >= '0' && p[1] <= '7' && p[2] >= '0' && p[2] <= '7')
+        {
+            c = (char)(((p[0] - '0') << 6) | ((p[1] - '0') << 3) | (p[2] - '0'));
+            p += 3;
+        }
+        if (len + 1 < size)
+            out[len++] = c;
+    }
+    if (size)
+        out[len] = '\0';
+    return p;
+}
+
+/* Extracts the active choice from sysfs selectors like "mq-deadline [bfq] none". */
+static void fossil_sys_hostinfo_bracketed(const char *text, char *out, size_t size)
+{
+    const char *open_br = strchr(text, '[');
+    const char *close_br = open_br ? strchr(open_br, ']') : NULL;
+    if (open_br && close_br && (size_t)(close_br - open_br - 1) < size)
+    {
+        memcpy(out, open_br + 1, (size_t)(close_br - open_br - 1));
+        out[close_br - open_br - 1] = '\0';
+    }
+    else
+    {
+        fossil_sys_strcpy(out, size, text);
+    }
+}
+
+/* Resolves a device number to its whole disk in /sys/block ("sda" for sda1). */
+static void fossil_sys_hostinfo_block_parent(uint32_t major, uint32_t minor, char *out, size_t size)
+{
+    char path[64];
+    char target[PATH_MAX];
+
+    out[0] = '\0';
+    snprintf(path, sizeof(path), "/sys/dev/block/%u:%u", major, minor);
+    ssize_t len = readlink(path, target, sizeof(target) - 1);
+    if (len <= 0)
+        return;
+    target[len] = '\0';
+
+    // .../block/sda/sda1 or .../block/dm-0
+    const char *block = NULL;
+    for (const char *p = strstr(target, "/block/"); p; p = strstr(p + 1, "/block/"))
+        block = p + 7;
+    if (!block)
+        return;
+
+    size_t n = strcspn(block, "/");
+    if (n >= size)
+        n = size - 1;
+    memcpy(out, block, n);
+    out[n] = '\0';
+}
+#endif
+
+int fossil_sys_hostinfo_get_mount_space(fossil_sys_hostinfo_mount_t *mount)
+{
+    if (!mount || !mount->mount_point[0])
+        return -1;
+
+#if defined(_WIN32)
+    ULARGE_INTEGER avail, total, free_bytes;
+    if (!GetDiskFreeSpaceExA(mount->mount_point, &avail, &total, &free_bytes))
+        return -3;
+    mount->total_space = total.QuadPart;
+    mount->free_space = free_bytes.QuadPart;
+    mount->available_space = avail.QuadPart;
+    mount->used_space = total.QuadPart - free_bytes.QuadPart;
+    return 0;
+#elif defined(__linux__) || defined(__APPLE__)
+    struct statvfs vfs;
+    if (statvfs(mount->mount_point, &vfs) != 0)
+        return -3;
+    uint64_t frag = vfs.f_frsize ? vfs.f_frsize : vfs.f_bsize;
+    mount->block_size = (uint32_t)frag;
+    mount->total_space = (uint64_t)vfs.f_blocks * frag;
+    mount->free_space = (uint64_t)vfs.f_bfree * frag;
+    mount->available_space = (uint64_t)vfs.f_bavail * frag;
+    mount->used_space = mount->total_space - mount->free_space;
+    mount->total_inodes = vfs.f_files;
+    mount->free_inodes = vfs.f_ffree;
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_get_mounts(fossil_sys_hostinfo_mount_list_t *list)
+{
+    if (!list)
+        return -1;
+    list->count = 0;
+
+#if defined(__linux__)
+    int fd = open("/proc/self/mountinfo", O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -2;
+    char *buf = fossil_sys_hostinfo_read_all_fd(fd);
+    if (!buf)
+        return -3;
+
+    // id parent major:minor root mount_point options [optional...] - fstype source super_options
+    for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        unsigned int id, parent, major, minor;
+        char root[8];
+        char mount_point[256];
+        char options[128];
+        char type[64];
+        char source[128];
+        int consumed = 0;
+
+        if (sscanf(p, "%u %u %u:%u%n", &id, &parent, &major, &minor, &consumed) != 4)
+            continue;
+        const char *q = p + consumed;
+        q = fossil_sys_hostinfo_mountinfo_field(q, root, sizeof(root));
+        q = fossil_sys_hostinfo_mountinfo_field(q, mount_point, sizeof(mount_point));
+        q = fossil_sys_hostinfo_mountinfo_field(q, options, sizeof(options));
+
+        const char *sep = strstr(q, " - ");
+        const char *nl = strchr(q, '\n');
+        if (!sep || (nl && sep > nl))
+            continue;
+        q = fossil_sys_hostinfo_mountinfo_field(sep + 3, type, sizeof(type));
+        fossil_sys_hostinfo_mountinfo_field(q, source, sizeof(source));
+
+        if (fossil_sys_hostinfo_is_pseudo_fs(type))
+            continue;
+
+        fossil_sys_hostinfo_mount_t *m = fossil_sys_hostinfo_mount_add(list);
+        if (!m)
+            break;
+        fossil_sys_strcpy(m->device, sizeof(m->device), source);
+        fossil_sys_strcpy(m->mount_point, sizeof(m->mount_point), mount_point);
+        fossil_sys_strcpy(m->filesystem_type, sizeof(m->filesystem_type), type);
+        fossil_sys_strcpy(m->options, sizeof(m->options), options);
+        m->major = major;
+        m->minor = minor;
+        m->read_only = strncmp(options, "ro", 2) == 0 && (options[2] == '\0' || options[2] == ',');
+        if (major != 0)
+            fossil_sys_hostinfo_block_parent(major, minor, m->block_device, sizeof(m->block_device));
+
+        m->is_network = fossil_sys_hostinfo_is_network_fs(type);
+        if (!m->is_network)
+            fossil_sys_hostinfo_get_mount_space(m);
+    }
+    free(buf);
+    return 0;
+#elif defined(__APPLE__)
+    struct statfs *mounts = NULL;
+    int count = getmntinfo(&mounts, MNT_NOWAIT);
+    if (count <= 0)
+        return -2;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const struct statfs *fs = &mounts[i];
+        if (strcmp(fs->f_fstypename, "devfs") == 0 || strcmp(fs->f_fstypename, "autofs") == 0)
+            continue;
+
+        fossil_sys_hostinfo_mount_t *m = fossil_sys_hostinfo_mount_add(list);
+        if (!m)
+            break;
+        fossil_sys_strcpy(m->device, sizeof(m->device), fs->f_mntfromname);
+        fossil_sys_strcpy(m->mount_point, sizeof(m->mount_point), fs->f_mntonname);
+        fossil_sys_strcpy(m->filesystem_type, sizeof(m->filesystem_type), fs->f_fstypename);
+        m->is_network = (fs->f_flags & MNT_LOCAL) == 0;
+        m->read_only = (fs->f_flags & MNT_RDONLY) != 0;
+        fossil_sys_strcpy(m->options, sizeof(m->options), m->read_only ? "ro" : "rw");
+        m->block_size = (uint32_t)fs->f_bsize;
+        m->total_space = (uint64_t)fs->f_blocks * fs->f_bsize;
+        m->free_space = (uint64_t)fs->f_bfree * fs->f_bsize;
+        m->available_space = (uint64_t)fs->f_bavail * fs->f_bsize;
+        m->used_space = m->total_space - m->free_space;
+        m->total_inodes = fs->f_files;
+        m->free_inodes = fs->f_ffree;
+    }
+    return 0;
+#elif defined(_WIN32)
+    char drives[256];
+    DWORD len = GetLogicalDriveStringsA(sizeof(drives) - 1, drives);
+    if (len == 0 || len >= sizeof(drives))
+        return -2;
+
+    for (const char *d = drives; *d; d += strlen(d) + 1)
+    {
+        UINT type = GetDriveTypeA(d);
+        if (type == DRIVE_NO_ROOT_DIR || type == DRIVE_UNKNOWN)
+            continue;
+
+        fossil_sys_hostinfo_mount_t *m = fossil_sys_hostinfo_mount_add(list);
+        if (!m)
+            break;
+        fossil_sys_strcpy(m->device, sizeof(m->device), d);
+        fossil_sys_strcpy(m->mount_point, sizeof(m->mount_point), d);
+
+        DWORD flags = 0;
+        if (type != DRIVE_REMOTE &&
+            GetVolumeInformationA(d, NULL, 0, NULL, NULL, &flags, m->filesystem_type, sizeof(m->filesystem_type)))
+            m->read_only = (flags & FILE_READ_ONLY_VOLUME) != 0;
+        fossil_sys_strcpy(m->options, sizeof(m->options), m->read_only ? "ro" : "rw");
+
+        m->is_network = type == DRIVE_REMOTE;
+        if (!m->is_network)
+            fossil_sys_hostinfo_get_mount_space(m);
+    }
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+#if defined(__linux__)
+static int fossil_sys_hostinfo_block_compare(const void *a, const void *b)
+{
+    return strcmp(((const fossil_sys_hostinfo_block_device_t *)a)->name,
+                  ((const fossil_sys_hostinfo_block_device_t *)b)->name);
+}
+#endif
+
+int fossil_sys_hostinfo_get_block_devices(fossil_sys_hostinfo_block_device_list_t *list)
+{
+    if (!list)
+        return -1;
+    list->count = 0;
+
+#if defined(__linux__)
+    DIR *dir = opendir("/sys/block");
+    if (!dir)
+        return -2;
+
+    struct dirent *entry;
+    char path[PATH_MAX];
+    char text[256];
+
+    while ((entry = readdir(dir)) != NULL && list->count < FOSSIL_SYS_HOSTINFO_DISK_MAX)
+    {
+        const char *name = entry->d_name;
+        if (name[0] == '.' || strncmp(name, "loop", 4) == 0 || strncmp(name, "ram", 3) == 0 ||
+            strlen(name) >= sizeof(list->list[0].name))
+            continue;
+
+        fossil_sys_hostinfo_block_device_t *dev = &list->list[list->count++];
+        memset(dev, 0, sizeof(*dev));
+        fossil_sys_strcpy(dev->name, sizeof(dev->name), name);
+
+        snprintf(path, sizeof(path), "/sys/block/%s/dev", name);
+        if (fossil_sys_hostinfo_read_text(path, text, sizeof(text)) > 0)
+            sscanf(text, "%u:%u", &dev->major, &dev->minor);
+        snprintf(path, sizeof(path), "/sys/block/%s/size", name);
+        dev->size_bytes = (uint64_t)fossil_sys_hostinfo_read_ll(path, 0) * 512u;
+        snprintf(path, sizeof(path), "/sys/block/%s/removable", name);
+        dev->removable = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/block/%s/device/model", name);
+        fossil_sys_hostinfo_read_text(path, dev->model, sizeof(dev->model));
+
+        snprintf(path, sizeof(path), "/sys/block/%s/queue/rotational", name);
+        dev->rotational = (int)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/block/%s/queue/nr_requests", name);
+        dev->queue_depth = (uint32_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/block/%s/queue/logical_block_size", name);
+        dev->logical_block_size = (uint32_t)fossil_sys_hostinfo_read_ll(path, 512);
+        snprintf(path, sizeof(path), "/sys/block/%s/queue/physical_block_size", name);
+        dev->physical_block_size = (uint32_t)fossil_sys_hostinfo_read_ll(path, dev->logical_block_size);
+
+        // "mq-deadline kyber [bfq] none": the active one is bracketed
+        snprintf(path, sizeof(path), "/sys/block/%s/queue/scheduler", name);
+        if (fossil_sys_hostinfo_read_text(path, text, sizeof(text)) > 0)
+            fossil_sys_hostinfo_bracketed(text, dev->scheduler, sizeof(dev->scheduler));
+    }
+    closedir(dir);
+    qsort(list->list, list->count, sizeof(list->list[0]), fossil_sys_hostinfo_block_compare);
+
+    // One pass over /proc/diskstats for every device's counters
+    char *buf = fossil_sys_hostinfo_read_all("/proc/diskstats");
+    if (buf)
+    {
+        for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+        {
+            unsigned int major, minor;
+            char name[32];
+            unsigned long long f[10];
+            if (sscanf(p, "%u %u %31s %llu %llu %llu %llu %llu %llu %llu %llu %llu %llu", &major, &minor, name,
+                       &f[0], &f[1], &f[2], &f[3], &f[4], &f[5], &f[6], &f[7], &f[8], &f[9]) != 13)
+                continue;
+
+            fossil_sys_hostinfo_block_device_t key;
+            fossil_sys_strcpy(key.name, sizeof(key.name), name);
+            fossil_sys_hostinfo_block_device_t *dev = bsearch(&key, list->list, list->count, sizeof(list->list[0]),
+                                                              fossil_sys_hostinfo_block_compare);
+            if (!dev)
+                continue;
+            dev->reads_completed = f[0];
+            dev->bytes_read = f[2] * 512u;
+            dev->read_time_ms = f[3];
+            dev->writes_completed = f[4];
+            dev->bytes_written = f[6] * 512u;
+            dev->write_time_ms = f[7];
+            dev->io_in_progress = f[8];
+            dev->io_time_ms = f[9];
+        }
+    }
+    free(buf);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+/* ============================================================================
+ * Network interfaces
+ * ============================================================================
+ */
+
+#define FOSSIL_SYS_HOSTINFO_NETDEV_BUF (64 * 1024)
+
+static void fossil_sys_hostinfo_iface_mac(fossil_sys_hostinfo_interface_t *iface, const unsigned char *mac,
+                                          size_t len)
+{
+    if (len != 6)
+        return;
+    snprintf(iface->mac_address, sizeof(iface->mac_address), "%02X:%02X:%02X:%02X:%02X:%02X",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+#if defined(__linux__) || defined(__APPLE__)
+static fossil_sys_hostinfo_interface_t *fossil_sys_hostinfo_iface_find(fossil_sys_hostinfo_interface_list_t *list,
+                                                                       const char *name)
+{
+    for (size_t i = 0; i < list->count; ++i)
+    {
+        if (strcmp(list->list[i].name, name) == 0)
+            return &list->list[i];
+    }
+    return NULL;
+}
+
+static fossil_sys_hostinfo_interface_t *fossil_sys_hostinfo_iface_get(fossil_sys_hostinfo_interface_list_t *list,
+                                                                      const char *name)
+{
+    fossil_sys_hostinfo_interface_t *iface = fossil_sys_hostinfo_iface_find(list, name);
+    if (iface || list->count >= FOSSIL_SYS_HOSTINFO_IFACE_MAX)
+        return iface;
+    iface = &list->list[list->count++];
+    memset(iface, 0, sizeof(*iface));
+    fossil_sys_strcpy(iface->name, sizeof(iface->name), name);
+    iface->speed_mbps = -1;
+    return iface;
+}
+
+static int fossil_sys_hostinfo_prefix_len(const void *mask, size_t len)
+{
+    const unsigned char *bytes = (const unsigned char *)mask;
+    int bits = 0;
+    for (size_t i = 0; i < len; ++i)
+    {
+        for (unsigned char b = bytes[i]; b; b &= (unsigned char)(b - 1))
+            bits++;
+    }
+    return bits;
+}
+
+/* Adds an AF_INET/AF_INET6 entry from getifaddrs; other families are ignored. */
+static void fossil_sys_hostinfo_iface_addr(fossil_sys_hostinfo_interface_t *iface, const struct sockaddr *addr,
+                                           const struct sockaddr *mask)
+{
+    if (iface->address_count >= FOSSIL_SYS_HOSTINFO_IFACE_ADDR_MAX)
+        return;
+
+    fossil_sys_hostinfo_ip_address_t *ip = &iface->addresses[iface->address_count];
+    if (addr->sa_family == AF_INET)
+    {
+        const struct sockaddr_in *in = (const struct sockaddr_in *)addr;
+        if (!inet_ntop(AF_INET, &in->sin_addr, ip->address, sizeof(ip->address)))
+            return;
+        ip->family = 4;
+        ip->prefix_len = mask ? fossil_sys_hostinfo_prefix_len(&((const struct sockaddr_in *)mask)->sin_addr, 4) : 32;
+    }
+    else if (addr->sa_family == AF_INET6)
+    {
+        const struct sockaddr_in6 *in6 = (const struct sockaddr_in6 *)addr;
+        if (!inet_ntop(AF_INET6, &in6->sin6_addr, ip->address, sizeof(ip->address)))
+            return;
+        ip->family = 6;
+        ip->prefix_len =
+            mask ? fossil_sys_hostinfo_prefix_len(&((const struct sockaddr_in6 *)mask)->sin6_addr, 16) : 128;
+    }
+    else
+    {
+        return;
+    }
+    iface->address_count++;
+}
+#endif
+
+#if defined(__linux__)
+/* One read of /proc/net/dev fills the counters of every listed interface. */
+static int fossil_sys_hostinfo_iface_counters(fossil_sys_hostinfo_interface_list_t *list)
+{
+    char *buf = malloc(FOSSIL_SYS_HOSTINFO_NETDEV_BUF);
+    if (!buf)
+        return -2;
+    if (fossil_sys_hostinfo_read_text("/proc/net/dev", buf, FOSSIL_SYS_HOSTINFO_NETDEV_BUF) <= 0)
+    {
+        free(buf);
+        return -2;
+    }
+
+    for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        // "  eth0: rx_bytes rx_packets errs drop fifo frame compressed multicast tx_bytes tx_packets errs drop ..."
+        const char *colon = strchr(p, ':');
+        const char *nl = strchr(p, '\n');
+        if (!colon || (nl && colon > nl))
+            continue;
+        while (*p == ' ')
+            p++;
+
+        char name[32];
+        size_t len = (size_t)(colon - p);
+        if (len >= sizeof(name))
+            continue;
+        memcpy(name, p, len);
+        name[len] = '\0';
+
+        fossil_sys_hostinfo_interface_t *iface = fossil_sys_hostinfo_iface_find(list, name);
+        if (!iface)
+            continue;
+
+        unsigned long long f[12];
+        const char *q = colon + 1;
+        for (int i = 0; i < 12; ++i)
+            f[i] = strtoull(q, (char **)&q, 10);
+        iface->rx_bytes = f[0];
+        iface->rx_packets = f[1];
+        iface->rx_errors = f[2];
+        iface->rx_dropped = f[3];
+        iface->tx_bytes = f[8];
+        iface->tx_packets = f[9];
+        iface->tx_errors = f[10];
+        iface->tx_dropped = f[11];
+    }
+    free(buf);
+    return 0;
+}
+
+static void fossil_sys_hostinfo_iface_sysfs(fossil_sys_hostinfo_interface_t *iface)
+{
+    char path[PATH_MAX];
+
+    snprintf(path, sizeof(path), "/sys/class/net/%s/mtu", iface->name);
+    iface->mtu = (uint32_t)fossil_sys_hostinfo_read_ll(path, 0);
+    if (iface->index == 0)
+    {
+        snprintf(path, sizeof(path), "/sys/class/net/%s/ifindex", iface->name);
+        iface->index = (int)fossil_sys_hostinfo_read_ll(path, 0);
+    }
+
+    // Reading speed fails with EINVAL on links that are down or virtual
+    snprintf(path, sizeof(path), "/sys/class/net/%s/speed", iface->name);
+    long long speed = fossil_sys_hostinfo_read_ll(path, -1);
+    iface->speed_mbps = speed > 0 && speed < INT32_MAX ? (int64_t)speed : -1;
+
+    snprintf(path, sizeof(path), "/sys/class/net/%s/device/driver", iface->name);
+    fossil_sys_hostinfo_read_link_name(path, iface->driver, sizeof(iface->driver));
+
+    snprintf(path, sizeof(path), "/sys/class/net/%s/queues", iface->name);
+    DIR *dir = opendir(path);
+    if (dir)
+    {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (strncmp(entry->d_name, "rx-", 3) == 0)
+                iface->rx_queues++;
+            else if (strncmp(entry->d_name, "tx-", 3) == 0)
+                iface->tx_queues++;
+        }
+        closedir(dir);
+    }
+}
+#elif defined(__APPLE__)
+static void fossil_sys_hostinfo_iface_link(fossil_sys_hostinfo_interface_t *iface, const struct ifaddrs *ifa)
+{
+    const struct sockaddr_dl *sdl = (const struct sockaddr_dl *)ifa->ifa_addr;
+    iface->index = sdl->sdl_index;
+    fossil_sys_hostinfo_iface_mac(iface, (const unsigned char *)LLADDR(sdl), sdl->sdl_alen);
+
+    const struct if_data *data = (const struct if_data *)ifa->ifa_data;
+    if (!data)
+        return;
+    iface->mtu = data->ifi_mtu;
+    iface->speed_mbps = data->ifi_baudrate ? (int64_t)(data->ifi_baudrate / 1000000u) : -1;
+    iface->rx_bytes = data->ifi_ibytes;
+    iface->tx_bytes = data->ifi_obytes;
+    iface->rx_packets = data->ifi_ipackets;
+    iface->tx_packets = data->ifi_opackets;
+    iface->rx_errors = data->ifi_ierrors;
+    iface->tx_errors = data->ifi_oerrors;
+    iface->rx_dropped = data->ifi_iqdrops;
+}
+#elif defined(_WIN32)
+static void fossil_sys_hostinfo_iface_row(fossil_sys_hostinfo_interface_t *iface)
+{
+    MIB_IF_ROW2 row;
+    memset(&row, 0, sizeof(row));
+    row.InterfaceIndex = (NET_IFINDEX)iface->index;
+    if (GetIfEntry2(&row) != NO_ERROR)
+        return;
+    iface->rx_bytes = row.InOctets;
+    iface->tx_bytes = row.OutOctets;
+    iface->rx_packets = row.InUcastPkts + row.InNUcastPkts;
+    iface->tx_packets = row.OutUcastPkts + row.OutNUcastPkts;
+    iface->rx_errors = row.InErrors;
+    iface->tx_errors = row.OutErrors;
+    iface->rx_dropped = row.InDiscards;
+    iface->tx_dropped = row.OutDiscards;
+}
+#endif
+
+int fossil_sys_hostinfo_get_interfaces(fossil_sys_hostinfo_interface_list_t *list)
+{
+    if (!list)
+        return -1;
+    list->count = 0;
+
+#if defined(__linux__)
+    struct ifaddrs *ifaddr;
+    if (getifaddrs(&ifaddr) != 0)
+        return -2;
+
+    // getifaddrs reports every interface at least once as AF_PACKET, plus one entry per address
+    for (struct ifaddrs *ifa = ifaddr; ifa; ifa = ifa->ifa_next)
+    {
+        if (!ifa->ifa_name)
+            continue;
+        fossil_sys_hostinfo_interface_t *iface = fossil_sys_hostinfo_iface_get(list, ifa->ifa_name);
+        if (!iface)
+            continue;
+
+        iface->is_up = (ifa->ifa_flags & IFF_UP) != 0;
+        iface->is_running = (ifa->ifa_flags & IFF_RUNNING) != 0;
+        iface->is_loopback = (ifa->ifa_flags & IFF_LOOPBACK) != 0;
+        if (!ifa->ifa_addr)
+            continue;
+
+        if (ifa->ifa_addr->sa_family == AF_PACKET)
+        {
+            const struct sockaddr_ll *ll = (const struct sockaddr_ll *)ifa->ifa_addr;
+            iface->index = ll->sll_ifindex;
+            if (!iface->is_loopback)
+                fossil_sys_hostinfo_iface_mac(iface, ll->sll_addr, ll->sll_halen);
+        }
+        else
+        {
+            fossil_sys_hostinfo_iface_addr(iface, ifa->ifa_addr, ifa->ifa_netmask);
+        }
+    }
+    freeifaddrs(ifaddr);
+
+    for (size_t i = 0; i < list->count; ++i)
+        fossil_sys_hostinfo_iface_sysfs(&list->list[i]);
+    fossil_sys_hostinfo_iface_counters(list);
+    return 0;
+#elif defined(__APPLE__)
+    struct ifaddrs *ifaddr;
+    if (getifaddrs(&ifaddr) != 0)
+        return -2;
+
+    for (struct ifaddrs *ifa = ifaddr; ifa; ifa = ifa->ifa_next)
+    {
+        if (!ifa->ifa_name)
+            continue;
+        fossil_sys_hostinfo_interface_t *iface = fossil_sys_hostinfo_iface_get(list, ifa->ifa_name);
+        if (!iface)
+            continue;
+
+        iface->is_up = (ifa->ifa_flags & IFF_UP) != 0;
+        iface->is_running = (ifa->ifa_flags & IFF_RUNNING) != 0;
+        iface->is_loopback = (ifa->ifa_flags & IFF_LOOPBACK) != 0;
+        if (!ifa->ifa_addr)
+            continue;
+
+        if (ifa->ifa_addr->sa_family == AF_LINK)
+            fossil_sys_hostinfo_iface_link(iface, ifa);
+        else
+            fossil_sys_hostinfo_iface_addr(iface, ifa->ifa_addr, ifa->ifa_netmask);
+    }
+    freeifaddrs(ifaddr);
+    return 0;
+#elif defined(_WIN32)
+    ULONG size = 16 * 1024;
+    IP_ADAPTER_ADDRESSES *adapters = NULL;
+    ULONG rc = ERROR_BUFFER_OVERFLOW;
+    for (int attempt = 0; attempt < 3 && rc == ERROR_BUFFER_OVERFLOW; ++attempt)
+    {
+        free(adapters);
+        adapters = (IP_ADAPTER_ADDRESSES *)malloc(size);
+        if (!adapters)
+            return -2;
+        rc = GetAdaptersAddresses(AF_UNSPEC, GAA_FLAG_INCLUDE_PREFIX, NULL, adapters, &size);
+    }
+    if (rc != NO_ERROR)
+    {
+        free(adapters);
+        return -2;
+    }
+
+    for (IP_ADAPTER_ADDRESSES *a = adapters; a && list->count < FOSSIL_SYS_HOSTINFO_IFACE_MAX; a = a->Next)
+    {
+        fossil_sys_hostinfo_interface_t *iface = &list->list[list->count++];
+        memset(iface, 0, sizeof(*iface));
+        if (WideCharToMultiByte(CP_UTF8, 0, a->FriendlyName, -1, iface->name, (int)sizeof(iface->name), NULL,
+                                NULL) == 0)
+            fossil_sys_strcpy(iface->name, sizeof(iface->name), a->AdapterName);
+        WideCharToMultiByte(CP_UTF8, 0, a->Description, -1, iface->driver, (int)sizeof(iface->driver), NULL, NULL);
+
+        iface->index = (int)a->IfIndex;
+        iface->is_up = a->OperStatus != IfOperStatusDown;
+        iface->is_running = a->OperStatus == IfOperStatusUp;
+        iface->is_loopback = a->IfType == IF_TYPE_SOFTWARE_LOOPBACK;
+        iface->mtu = a->Mtu;
+        iface->speed_mbps = a->TransmitLinkSpeed && a->TransmitLinkSpeed != (ULONG64)-1
+                                ? (int64_t)(a->TransmitLinkSpeed / 1000000u)
+                                : -1;
+        fossil_sys_hostinfo_iface_mac(iface, a->PhysicalAddress, a->PhysicalAddressLength);
+
+        for (IP_ADAPTER_UNICAST_ADDRESS *ua = a->FirstUnicastAddress;
+             ua && iface->address_count < FOSSIL_SYS_HOSTINFO_IFACE_ADDR_MAX; ua = ua->Next)
+        {
+            fossil_sys_hostinfo_ip_address_t *ip = &iface->addresses[iface->address_count];
+            const struct sockaddr *sa = ua->Address.lpSockaddr;
+            const void *raw = sa->sa_family == AF_INET ? (const void *)&((const struct sockaddr_in *)sa)->sin_addr
+                              : sa->sa_family == AF_INET6
+                                  ? (const void *)&((const struct sockaddr_in6 *)sa)->sin6_addr
+                                  : NULL;
+            if (!raw || !inet_ntop(sa->sa_family, raw, ip->address, sizeof(ip->address)))
+                continue;
+            ip->family = sa->sa_family == AF_INET ? 4 : 6;
+            ip->prefix_len = ua->OnLinkPrefixLength;
+            iface->address_count++;
+        }
+        fossil_sys_hostinfo_iface_row(iface);
+    }
+    free(adapters);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_refresh_interface_counters(fossil_sys_hostinfo_interface_list_t *list)
+{
+    if (!list)
+        return -1;
+
+#if defined(__linux__)
+    return fossil_sys_hostinfo_iface_counters(list);
+#elif defined(__APPLE__)
+    struct ifaddrs *ifaddr;
+    if (getifaddrs(&ifaddr) != 0)
+        return -2;
+    for (struct ifaddrs *ifa = ifaddr; ifa; ifa = ifa->ifa_next)
+    {
+        if (!ifa->ifa_name || !ifa->ifa_addr || ifa->ifa_addr->sa_family != AF_LINK)
+            continue;
+        fossil_sys_hostinfo_interface_t *iface = fossil_sys_hostinfo_iface_find(list, ifa->ifa_name);
+        if (iface)
+            fossil_sys_hostinfo_iface_link(iface, ifa);
+    }
+    freeifaddrs(ifaddr);
+    return 0;
+#elif defined(_WIN32)
+    for (size_t i = 0; i < list->count; ++i)
+        fossil_sys_hostinfo_iface_row(&list->list[i]);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+/* ============================================================================
+ * Detailed memory breakdown
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+typedef struct
+{
+    const char *key;
+    size_t offset;
+} fossil_sys_hostinfo_meminfo_field_t;
+
+#define FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD(key, member) {key, offsetof(fossil_sys_hostinfo_meminfo_t, member)}
+
+/* Sorted by key for binary search. */
+static const fossil_sys_hostinfo_meminfo_field_t fossil_sys_hostinfo_meminfo_fields[] = {
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Active", active),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("AnonHugePages", anon_huge_pages),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("AnonPages", anon_pages),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Buffers", buffers),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Cached", cached),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("CommitLimit", commit_limit),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Committed_AS", committed_as),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Dirty", dirty),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Inactive", inactive),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Mapped", mapped),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("MemAvailable", available),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("MemFree", free),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("MemTotal", total),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("SReclaimable", slab_reclaimable),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("SUnreclaim", slab_unreclaimable),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Shmem", shmem),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("SwapCached", swap_cached),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("SwapFree", swap_free),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("SwapTotal", swap_total),
+    FOSSIL_SYS_HOSTINFO_MEMINFO_FIELD("Writeback", writeback),
+};
+
+static int fossil_sys_hostinfo_meminfo_compare(const void *key, const void *field)
+{
+    return strcmp((const char *)key, ((const fossil_sys_hostinfo_meminfo_field_t *)field)->key);
+}
+
+static int fossil_sys_hostinfo_hugepages_compare(const void *a, const void *b)
+{
+    uint64_t x = ((const fossil_sys_hostinfo_hugepages_t *)a)->page_size;
+    uint64_t y = ((const fossil_sys_hostinfo_hugepages_t *)b)->page_size;
+    return x < y ? -1 : x > y;
+}
+
+static void fossil_sys_hostinfo_meminfo_hugepages(fossil_sys_hostinfo_meminfo_t *info)
+{
+    DIR *dir = opendir("/sys/kernel/mm/hugepages");
+    if (!dir)
+        return;
+
+    struct dirent *entry;
+    char path[PATH_MAX];
+    while ((entry = readdir(dir)) != NULL && info->hugepage_size_count < FOSSIL_SYS_HOSTINFO_HUGEPAGE_SIZES_MAX)
+    {
+        // hugepages-2048kB
+        unsigned long long kb;
+        if (sscanf(entry->d_name, "hugepages-%llukB", &kb) != 1)
+            continue;
+
+        fossil_sys_hostinfo_hugepages_t *pool = &info->hugepages[info->hugepage_size_count++];
+        pool->page_size = (uint64_t)kb * 1024u;
+        snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/%s/nr_hugepages", entry->d_name);
+        pool->total = (uint64_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/%s/free_hugepages", entry->d_name);
+        pool->free = (uint64_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/%s/resv_hugepages", entry->d_name);
+        pool->reserved = (uint64_t)fossil_sys_hostinfo_read_ll(path, 0);
+        snprintf(path, sizeof(path), "/sys/kernel/mm/hugepages/%s/surplus_hugepages", entry->d_name);
+        pool->surplus = (uint64_t)fossil_sys_hostinfo_read_ll(path, 0);
+    }
+    closedir(dir);
+    qsort(info->hugepages, info->hugepage_size_count, sizeof(info->hugepages[0]),
+          fossil_sys_hostinfo_hugepages_compare);
+}
+#endif
+
+int fossil_sys_hostinfo_get_meminfo(fossil_sys_hostinfo_meminfo_t *info)
+{
+    if (!info)
+        return -1;
+    memset(info, 0, sizeof(*info));
+
+#if defined(__linux__)
+    char buf[8192];
+    if (fossil_sys_hostinfo_read_text("/proc/meminfo", buf, sizeof(buf)) <= 0)
+        return -2;
+
+    // "MemTotal:       16318976 kB"
+    for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        char key[32];
+        size_t len = strcspn(p, ":\n");
+        if (p[len] != ':' || len >= sizeof(key))
+            continue;
+        memcpy(key, p, len);
+        key[len] = '\0';
+
+        const fossil_sys_hostinfo_meminfo_field_t *field =
+            bsearch(key, fossil_sys_hostinfo_meminfo_fields,
+                    sizeof(fossil_sys_hostinfo_meminfo_fields) / sizeof(fossil_sys_hostinfo_meminfo_fields[0]),
+                    sizeof(fossil_sys_hostinfo_meminfo_fields[0]), fossil_sys_hostinfo_meminfo_compare);
+        if (!field)
+            continue;
+
+        uint64_t value = strtoull(p + len + 1, NULL, 10) * 1024u;
+        memcpy((char *)info + field->offset, &value, sizeof(value));
+        if (field->offset == offsetof(fossil_sys_hostinfo_meminfo_t, available))
+            info->has_available = 1;
+    }
+    if (!info->has_available)
+        info->available = info->free + info->buffers + info->cached + info->slab_reclaimable;
+
+    fossil_sys_hostinfo_meminfo_hugepages(info);
+
+    char text[128];
+    if (fossil_sys_hostinfo_read_text("/sys/kernel/mm/transparent_hugepage/enabled", text, sizeof(text)) > 0)
+        fossil_sys_hostinfo_bracketed(text, info->thp_mode, sizeof(info->thp_mode));
+    if (fossil_sys_hostinfo_read_text("/sys/kernel/mm/transparent_hugepage/defrag", text, sizeof(text)) > 0)
+        fossil_sys_hostinfo_bracketed(text, info->thp_defrag, sizeof(info->thp_defrag));
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+/* ============================================================================
+ * CPU frequency and thermal telemetry
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+#define FOSSIL_SYS_HOSTINFO_PACKAGE_MAX 64
+#define FOSSIL_SYS_HOSTINFO_CPUFREQ_NONE UINT16_MAX
+
+/*
+ * Descriptors stay open between reads. Policy attributes (min, max,
+ * governor) are shared by the CPUs of one cpufreq policy and package
+ * throttle counters by the CPUs of one package, so those are opened once
+ * per policy/package to keep the descriptor count near 2 per CPU.
+ */
+static struct
+{
+    fossil_sys_hostinfo_lock_t lock;
+    int opened;
+
+    size_t cpu_count;
+    int cpu_id[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    int fd_cur[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    int fd_core[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    uint16_t policy[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    uint16_t package[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+
+    size_t policy_count;
+    char policy_name[FOSSIL_SYS_HOSTINFO_CPU_MAX][16];
+    int fd_min[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    int fd_max[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    int fd_governor[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+
+    size_t package_count;
+    int package_id[FOSSIL_SYS_HOSTINFO_PACKAGE_MAX];
+    int fd_package[FOSSIL_SYS_HOSTINFO_PACKAGE_MAX];
+
+    size_t zone_count;
+    int zone_id[FOSSIL_SYS_HOSTINFO_THERMAL_MAX];
+    char zone_type[FOSSIL_SYS_HOSTINFO_THERMAL_MAX][32];
+    int fd_zone[FOSSIL_SYS_HOSTINFO_THERMAL_MAX];
+} fossil_sys_hostinfo_cpufreq = {
+    .lock = FOSSIL_SYS_HOSTINFO_LOCK_INIT,
+};
+
+static int fossil_sys_hostinfo_open_ro(const char *path)
+{
+    return open(path, O_RDONLY | O_CLOEXEC);
+}
+
+static long long fossil_sys_hostinfo_pread_ll(int fd, long long fallback)
+{
+    char buf[32];
+    if (fd < 0 || fossil_sys_hostinfo_pread_all(fd, buf, sizeof(buf)) <= 0)
+        return fallback;
+    return strtoll(buf, NULL, 10);
+}
+
+static void fossil_sys_hostinfo_close_fds(int *fds, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (fds[i] >= 0)
+            close(fds[i]);
+        fds[i] = -1;
+    }
+}
+
+static void fossil_sys_hostinfo_cpufreq_close_locked(void)
+{
+    size_t cpus = fossil_sys_hostinfo_cpufreq.cpu_count;
+    size_t policies = fossil_sys_hostinfo_cpufreq.policy_count;
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_cur, cpus);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_core, cpus);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_min, policies);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_max, policies);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_governor, policies);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_package, fossil_sys_hostinfo_cpufreq.package_count);
+    fossil_sys_hostinfo_close_fds(fossil_sys_hostinfo_cpufreq.fd_zone, fossil_sys_hostinfo_cpufreq.zone_count);
+    fossil_sys_hostinfo_cpufreq.cpu_count = 0;
+    fossil_sys_hostinfo_cpufreq.policy_count = 0;
+    fossil_sys_hostinfo_cpufreq.package_count = 0;
+    fossil_sys_hostinfo_cpufreq.zone_count = 0;
+    fossil_sys_hostinfo_cpufreq.opened = 0;
+}
+
+static uint16_t fossil_sys_hostinfo_cpufreq_policy(int cpu)
+{
+    char path[128];
+    char name[16];
+
+    // cpuN/cpufreq is a symlink to the shared ../cpufreq/policyM directory
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq", cpu);
+    if (fossil_sys_hostinfo_read_link_name(path, name, sizeof(name)) != 0)
+        snprintf(name, sizeof(name), "cpu%d", cpu);
+
+    for (size_t i = 0; i < fossil_sys_hostinfo_cpufreq.policy_count; ++i)
+    {
+        if (strcmp(fossil_sys_hostinfo_cpufreq.policy_name[i], name) == 0)
+            return (uint16_t)i;
+    }
+
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu);
+    int fd_governor = fossil_sys_hostinfo_open_ro(path);
+    if (fd_governor < 0)
+        return FOSSIL_SYS_HOSTINFO_CPUFREQ_NONE;
+
+    size_t i = fossil_sys_hostinfo_cpufreq.policy_count++;
+    fossil_sys_strcpy(fossil_sys_hostinfo_cpufreq.policy_name[i], sizeof(fossil_sys_hostinfo_cpufreq.policy_name[i]),
+                      name);
+    fossil_sys_hostinfo_cpufreq.fd_governor[i] = fd_governor;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_min_freq", cpu);
+    fossil_sys_hostinfo_cpufreq.fd_min[i] = fossil_sys_hostinfo_open_ro(path);
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_max_freq", cpu);
+    fossil_sys_hostinfo_cpufreq.fd_max[i] = fossil_sys_hostinfo_open_ro(path);
+    return (uint16_t)i;
+}
+
+static uint16_t fossil_sys_hostinfo_cpufreq_package(int cpu)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    int id = (int)fossil_sys_hostinfo_read_ll(path, -1);
+
+    for (size_t i = 0; i < fossil_sys_hostinfo_cpufreq.package_count; ++i)
+    {
+        if (fossil_sys_hostinfo_cpufreq.package_id[i] == id)
+            return (uint16_t)i;
+    }
+    if (fossil_sys_hostinfo_cpufreq.package_count >= FOSSIL_SYS_HOSTINFO_PACKAGE_MAX)
+        return FOSSIL_SYS_HOSTINFO_CPUFREQ_NONE;
+
+    // x86 only; -1 elsewhere and the counter reads as 0
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/thermal_throttle/package_throttle_count", cpu);
+    size_t i = fossil_sys_hostinfo_cpufreq.package_count++;
+    fossil_sys_hostinfo_cpufreq.package_id[i] = id;
+    fossil_sys_hostinfo_cpufreq.fd_package[i] = fossil_sys_hostinfo_open_ro(path);
+    return (uint16_t)i;
+}
+
+static int fossil_sys_hostinfo_cpufreq_open_locked(void)
+{
+    char path[128];
+    fossil_sys_hostinfo_cpuset_t online;
+
+    fossil_sys_hostinfo_cpufreq_close_locked();
+    if (fossil_sys_hostinfo_read_cpulist("/sys/devices/system/cpu/online", &online) <= 0)
+        return -3;
+
+    for (int cpu = 0; cpu < FOSSIL_SYS_HOSTINFO_CPU_MAX; ++cpu)
+    {
+        if (!fossil_sys_hostinfo_cpuset_has(&online, cpu))
+            continue;
+        size_t i = fossil_sys_hostinfo_cpufreq.cpu_count++;
+        fossil_sys_hostinfo_cpufreq.cpu_id[i] = cpu;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", cpu);
+        fossil_sys_hostinfo_cpufreq.fd_cur[i] = fossil_sys_hostinfo_open_ro(path);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/thermal_throttle/core_throttle_count", cpu);
+        fossil_sys_hostinfo_cpufreq.fd_core[i] = fossil_sys_hostinfo_open_ro(path);
+        fossil_sys_hostinfo_cpufreq.policy[i] = fossil_sys_hostinfo_cpufreq_policy(cpu);
+        fossil_sys_hostinfo_cpufreq.package[i] = fossil_sys_hostinfo_cpufreq_package(cpu);
+    }
+
+    DIR *dir = opendir("/sys/class/thermal");
+    if (dir)
+    {
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL && fossil_sys_hostinfo_cpufreq.zone_count < FOSSIL_SYS_HOSTINFO_THERMAL_MAX)
+        {
+            int zone;
+            if (sscanf(entry->d_name, "thermal_zone%d", &zone) != 1)
+                continue;
+            snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/temp", zone);
+            int fd = fossil_sys_hostinfo_open_ro(path);
+            if (fd < 0)
+                continue;
+            size_t i = fossil_sys_hostinfo_cpufreq.zone_count++;
+            fossil_sys_hostinfo_cpufreq.zone_id[i] = zone;
+            fossil_sys_hostinfo_cpufreq.fd_zone[i] = fd;
+            snprintf(path, sizeof(path), "/sys/class/thermal/thermal_zone%d/type", zone);
+            if (fossil_sys_hostinfo_read_text(path, fossil_sys_hostinfo_cpufreq.zone_type[i],
+                                           sizeof(fossil_sys_hostinfo_cpufreq.zone_type[i])) <= 0)
+                fossil_sys_hostinfo_cpufreq.zone_type[i][0] = '\0';
+        }
+        closedir(dir);
+    }
+
+    fossil_sys_hostinfo_cpufreq.opened = 1;
+    return 0;
+}
+#endif
+
+int fossil_sys_hostinfo_cpufreq_open(void)
+{
+#if defined(__linux__)
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_cpufreq.lock);
+    int rc = fossil_sys_hostinfo_cpufreq_open_locked();
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_cpufreq.lock);
+    return rc;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_cpufreq_read(fossil_sys_hostinfo_cpufreq_state_t *state)
+{
+    if (!state)
+        return -1;
+
+#if defined(__linux__)
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_cpufreq.lock);
+    if (!fossil_sys_hostinfo_cpufreq.opened && fossil_sys_hostinfo_cpufreq_open_locked() != 0)
+    {
+        fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_cpufreq.lock);
+        return -3;
+    }
+
+    state->timestamp_ns = fossil_sys_hostinfo_now_ns();
+    state->cpu_count = fossil_sys_hostinfo_cpufreq.cpu_count;
+    for (size_t i = 0; i < state->cpu_count; ++i)
+    {
+        fossil_sys_hostinfo_cpufreq_t *cpu = &state->cpus[i];
+        cpu->cpu = fossil_sys_hostinfo_cpufreq.cpu_id[i];
+        cpu->cur_khz = (uint32_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_cur[i], 0);
+        cpu->core_throttle_count = (uint64_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_core[i], 0);
+
+        uint16_t policy = fossil_sys_hostinfo_cpufreq.policy[i];
+        cpu->min_khz = 0;
+        cpu->max_khz = 0;
+        cpu->governor[0] = '\0';
+        if (policy != FOSSIL_SYS_HOSTINFO_CPUFREQ_NONE)
+        {
+            cpu->min_khz = (uint32_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_min[policy], 0);
+            cpu->max_khz = (uint32_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_max[policy], 0);
+            if (fossil_sys_hostinfo_pread_all(fossil_sys_hostinfo_cpufreq.fd_governor[policy], cpu->governor,
+                                              sizeof(cpu->governor)) > 0)
+                cpu->governor[strcspn(cpu->governor, "\n")] = '\0';
+        }
+
+        uint16_t package = fossil_sys_hostinfo_cpufreq.package[i];
+        cpu->package_throttle_count =
+            package != FOSSIL_SYS_HOSTINFO_CPUFREQ_NONE
+                ? (uint64_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_package[package], 0)
+                : 0;
+    }
+
+    state->zone_count = fossil_sys_hostinfo_cpufreq.zone_count;
+    for (size_t i = 0; i < state->zone_count; ++i)
+    {
+        fossil_sys_hostinfo_thermal_zone_t *zone = &state->zones[i];
+        zone->zone = fossil_sys_hostinfo_cpufreq.zone_id[i];
+        fossil_sys_strcpy(zone->type, sizeof(zone->type), fossil_sys_hostinfo_cpufreq.zone_type[i]);
+        zone->temp_mc = (int32_t)fossil_sys_hostinfo_pread_ll(fossil_sys_hostinfo_cpufreq.fd_zone[i], 0);
+    }
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_cpufreq.lock);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_cpufreq_close(void)
+{
+#if defined(__linux__)
+    fossil_sys_hostinfo_lock(&fossil_sys_hostinfo_cpufreq.lock);
+    fossil_sys_hostinfo_cpufreq_close_locked();
+    fossil_sys_hostinfo_unlock(&fossil_sys_hostinfo_cpufreq.lock);
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+uint64_t fossil_sys_hostinfo_cpufreq_throttle_delta(const fossil_sys_hostinfo_cpufreq_state_t *before,
+                                                    const fossil_sys_hostinfo_cpufreq_state_t *after)
+{
+    if (!before || !after)
+        return 0;
+
+    uint64_t delta = 0;
+    for (size_t i = 0; i < after->cpu_count; ++i)
+    {
+        const fossil_sys_hostinfo_cpufreq_t *now = &after->cpus[i];
+        const fossil_sys_hostinfo_cpufreq_t *then = NULL;
+
+        // Same CPU set on both sides is the common case; search only after hotplug
+        if (i < before->cpu_count && before->cpus[i].cpu == now->cpu)
+            then = &before->cpus[i];
+        for (size_t j = 0; !then && j < before->cpu_count; ++j)
+        {
+            if (before->cpus[j].cpu == now->cpu)
+                then = &before->cpus[j];
+        }
+        if (!then)
+            continue;
+
+        if (now->core_throttle_count > then->core_throttle_count)
+            delta += now->core_throttle_count - then->core_throttle_count;
+        if (now->package_throttle_count > then->package_throttle_count)
+            delta += now->package_throttle_count - then->package_throttle_count;
+    }
+    return delta;
+}
+
+/* ============================================================================
+ * One-pass collection and export
+ * ============================================================================
+ */
+
+typedef int (*fossil_sys_hostinfo_gather_fn)(fossil_sys_hostinfo_all_t *all);
+
+#define FOSSIL_SYS_HOSTINFO_GATHER(member)                                                \
+    static int fossil_sys_hostinfo_gather_##member(fossil_sys_hostinfo_all_t *all)          \
+    {                                                                                        \
+        return fossil_sys_hostinfo_get_##member(&all->member);                               \
+    }
+
+FOSSIL_SYS_HOSTINFO_GATHER(system)
+FOSSIL_SYS_HOSTINFO_GATHER(architecture)
+FOSSIL_SYS_HOSTINFO_GATHER(memory)
+FOSSIL_SYS_HOSTINFO_GATHER(endianness)
+FOSSIL_SYS_HOSTINFO_GATHER(power)
+FOSSIL_SYS_HOSTINFO_GATHER(cpu)
+FOSSIL_SYS_HOSTINFO_GATHER(gpu)
+FOSSIL_SYS_HOSTINFO_GATHER(storage)
+FOSSIL_SYS_HOSTINFO_GATHER(environment)
+FOSSIL_SYS_HOSTINFO_GATHER(virtualization)
+FOSSIL_SYS_HOSTINFO_GATHER(uptime)
+FOSSIL_SYS_HOSTINFO_GATHER(network)
+FOSSIL_SYS_HOSTINFO_GATHER(process)
+FOSSIL_SYS_HOSTINFO_GATHER(limits)
+FOSSIL_SYS_HOSTINFO_GATHER(time)
+FOSSIL_SYS_HOSTINFO_GATHER(hardware)
+FOSSIL_SYS_HOSTINFO_GATHER(display)
+
+typedef struct
+{
+    uint32_t bit;
+    const char *name;
+    fossil_sys_hostinfo_gather_fn gather;
+} fossil_sys_hostinfo_section_entry_t;
+
+/* In bit order; the binary format depends on it. */
+static const fossil_sys_hostinfo_section_entry_t fossil_sys_hostinfo_sections[] = {
+    {FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM, "system", fossil_sys_hostinfo_gather_system},
+    {FOSSIL_SYS_HOSTINFO_SECTION_ARCHITECTURE, "architecture", fossil_sys_hostinfo_gather_architecture},
+    {FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, "memory", fossil_sys_hostinfo_gather_memory},
+    {FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS, "endianness", fossil_sys_hostinfo_gather_endianness},
+    {FOSSIL_SYS_HOSTINFO_SECTION_POWER, "power", fossil_sys_hostinfo_gather_power},
+    {FOSSIL_SYS_HOSTINFO_SECTION_CPU, "cpu", fossil_sys_hostinfo_gather_cpu},
+    {FOSSIL_SYS_HOSTINFO_SECTION_GPU, "gpu", fossil_sys_hostinfo_gather_gpu},
+    {FOSSIL_SYS_HOSTINFO_SECTION_STORAGE, "storage", fossil_sys_hostinfo_gather_storage},
+    {FOSSIL_SYS_HOSTINFO_SECTION_ENVIRONMENT, "environment", fossil_sys_hostinfo_gather_environment},
+    {FOSSIL_SYS_HOSTINFO_SECTION_VIRTUALIZATION, "virtualization", fossil_sys_hostinfo_gather_virtualization},
+    {FOSSIL_SYS_HOSTINFO_SECTION_UPTIME, "uptime", fossil_sys_hostinfo_gather_uptime},
+    {FOSSIL_SYS_HOSTINFO_SECTION_NETWORK, "network", fossil_sys_hostinfo_gather_network},
+    {FOSSIL_SYS_HOSTINFO_SECTION_PROCESS, "process", fossil_sys_hostinfo_gather_process},
+    {FOSSIL_SYS_HOSTINFO_SECTION_LIMITS, "limits", fossil_sys_hostinfo_gather_limits},
+    {FOSSIL_SYS_HOSTINFO_SECTION_TIME, "time", fossil_sys_hostinfo_gather_time},
+    {FOSSIL_SYS_HOSTINFO_SECTION_HARDWARE, "hardware", fossil_sys_hostinfo_gather_hardware},
+    {FOSSIL_SYS_HOSTINFO_SECTION_DISPLAY, "display", fossil_sys_hostinfo_gather_display},
+};
+
+#define FOSSIL_SYS_HOSTINFO_SECTION_COUNT (sizeof(fossil_sys_hostinfo_sections) / sizeof(fossil_sys_hostinfo_sections[0]))
+
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_FIELD_STR,
+    FOSSIL_SYS_HOSTINFO_FIELD_U64,
+    FOSSIL_SYS_HOSTINFO_FIELD_U32,
+    FOSSIL_SYS_HOSTINFO_FIELD_INT,
+    FOSSIL_SYS_HOSTINFO_FIELD_FLOAT
+} fossil_sys_hostinfo_field_kind_t;
+
+typedef struct
+{
+    uint32_t section;
+    const char *name;
+    fossil_sys_hostinfo_field_kind_t kind;
+    size_t offset;
+    size_t size;
+} fossil_sys_hostinfo_field_t;
+
+#define FOSSIL_SYS_HOSTINFO_FIELD(section, kind, member, name)                                       \
+    {FOSSIL_SYS_HOSTINFO_SECTION_##section, name, FOSSIL_SYS_HOSTINFO_FIELD_##kind,                   \
+     offsetof(fossil_sys_hostinfo_all_t, member), sizeof(((fossil_sys_hostinfo_all_t *)0)->member)}
+
+/*
+ * Serialization schema shared by the JSON writer and the binary codec.
+ * Grouped by section in bit order; appending or reordering fields changes
+ * the binary layout and requires bumping FOSSIL_SYS_HOSTINFO_BINARY_VERSION.
+ */
+static const fossil_sys_hostinfo_field_t fossil_sys_hostinfo_fields[] = {
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.os_name, "os_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.os_version, "os_version"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.kernel_version, "kernel_version"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.hostname, "hostname"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.username, "username"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.domain_name, "domain_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.machine_type, "machine_type"),
+    FOSSIL_SYS_HOSTINFO_FIELD(SYSTEM, STR, system.platform, "platform"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.architecture, "architecture"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.cpu, "cpu"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.cpu_cores, "cpu_cores"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.cpu_threads, "cpu_threads"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.cpu_frequency, "cpu_frequency"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ARCHITECTURE, STR, architecture.cpu_architecture, "cpu_architecture"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.total_memory, "total_memory"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.free_memory, "free_memory"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.used_memory, "used_memory"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.available_memory, "available_memory"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.total_swap, "total_swap"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.free_swap, "free_swap"),
+    FOSSIL_SYS_HOSTINFO_FIELD(MEMORY, U64, memory.used_swap, "used_swap"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(ENDIANNESS, INT, endianness.is_little_endian, "is_little_endian"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(POWER, INT, power.on_ac_power, "on_ac_power"),
+    FOSSIL_SYS_HOSTINFO_FIELD(POWER, INT, power.battery_present, "battery_present"),
+    FOSSIL_SYS_HOSTINFO_FIELD(POWER, INT, power.battery_charging, "battery_charging"),
+    FOSSIL_SYS_HOSTINFO_FIELD(POWER, INT, power.battery_percentage, "battery_percentage"),
+    FOSSIL_SYS_HOSTINFO_FIELD(POWER, INT, power.battery_seconds_left, "battery_seconds_left"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, STR, cpu.model, "model"),
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, STR, cpu.vendor, "vendor"),
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, INT, cpu.cores, "cores"),
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, INT, cpu.threads, "threads"),
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, FLOAT, cpu.frequency_ghz, "frequency_ghz"),
+    FOSSIL_SYS_HOSTINFO_FIELD(CPU, STR, cpu.features, "features"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, STR, gpu.name, "name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, STR, gpu.vendor, "vendor"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, STR, gpu.driver_version, "driver_version"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, U64, gpu.memory_total, "memory_total"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, U64, gpu.memory_free, "memory_free"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, U32, gpu.vendor_id, "vendor_id"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, U32, gpu.device_id, "device_id"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, STR, gpu.bus_id, "bus_id"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, STR, gpu.driver, "driver"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, INT, gpu.drm_card, "drm_card"),
+    FOSSIL_SYS_HOSTINFO_FIELD(GPU, INT, gpu.is_primary, "is_primary"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, STR, storage.device_name, "device_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, STR, storage.mount_point, "mount_point"),
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, U64, storage.total_space, "total_space"),
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, U64, storage.free_space, "free_space"),
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, U64, storage.used_space, "used_space"),
+    FOSSIL_SYS_HOSTINFO_FIELD(STORAGE, STR, storage.filesystem_type, "filesystem_type"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment.shell, "shell"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment.home_dir, "home_dir"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment.lang, "lang"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment.path, "path"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment._term, "term"),
+    FOSSIL_SYS_HOSTINFO_FIELD(ENVIRONMENT, STR, environment.user, "user"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(VIRTUALIZATION, INT, virtualization.is_virtual_machine, "is_virtual_machine"),
+    FOSSIL_SYS_HOSTINFO_FIELD(VIRTUALIZATION, INT, virtualization.is_container, "is_container"),
+    FOSSIL_SYS_HOSTINFO_FIELD(VIRTUALIZATION, STR, virtualization.hypervisor, "hypervisor"),
+    FOSSIL_SYS_HOSTINFO_FIELD(VIRTUALIZATION, STR, virtualization.container_type, "container_type"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(UPTIME, U64, uptime.uptime_seconds, "uptime_seconds"),
+    FOSSIL_SYS_HOSTINFO_FIELD(UPTIME, U64, uptime.boot_time_epoch, "boot_time_epoch"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(NETWORK, STR, network.hostname, "hostname"),
+    FOSSIL_SYS_HOSTINFO_FIELD(NETWORK, STR, network.primary_ip, "primary_ip"),
+    FOSSIL_SYS_HOSTINFO_FIELD(NETWORK, STR, network.mac_address, "mac_address"),
+    FOSSIL_SYS_HOSTINFO_FIELD(NETWORK, STR, network.interface_name, "interface_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(NETWORK, INT, network.is_up, "is_up"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, INT, process.pid, "pid"),
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, INT, process.ppid, "ppid"),
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, STR, process.executable_path, "executable_path"),
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, STR, process.current_working_dir, "current_working_dir"),
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, STR, process.process_name, "process_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(PROCESS, INT, process.is_elevated, "is_elevated"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(LIMITS, U64, limits.max_open_files, "max_open_files"),
+    FOSSIL_SYS_HOSTINFO_FIELD(LIMITS, U64, limits.max_processes, "max_processes"),
+    FOSSIL_SYS_HOSTINFO_FIELD(LIMITS, U64, limits.page_size, "page_size"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(TIME, STR, time.timezone, "timezone"),
+    FOSSIL_SYS_HOSTINFO_FIELD(TIME, INT, time.utc_offset_seconds, "utc_offset_seconds"),
+    FOSSIL_SYS_HOSTINFO_FIELD(TIME, STR, time.locale, "locale"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(HARDWARE, STR, hardware.manufacturer, "manufacturer"),
+    FOSSIL_SYS_HOSTINFO_FIELD(HARDWARE, STR, hardware.product_name, "product_name"),
+    FOSSIL_SYS_HOSTINFO_FIELD(HARDWARE, STR, hardware.serial_number, "serial_number"),
+    FOSSIL_SYS_HOSTINFO_FIELD(HARDWARE, STR, hardware.bios_version, "bios_version"),
+
+    FOSSIL_SYS_HOSTINFO_FIELD(DISPLAY, INT, display.display_count, "display_count"),
+    FOSSIL_SYS_HOSTINFO_FIELD(DISPLAY, INT, display.primary_width, "primary_width"),
+    FOSSIL_SYS_HOSTINFO_FIELD(DISPLAY, INT, display.primary_height, "primary_height"),
+    FOSSIL_SYS_HOSTINFO_FIELD(DISPLAY, INT, display.primary_refresh_rate, "primary_refresh_rate"),
+};
+
+#define FOSSIL_SYS_HOSTINFO_FIELD_COUNT (sizeof(fossil_sys_hostinfo_fields) / sizeof(fossil_sys_hostinfo_fields[0]))
+
+typedef struct
+{
+    fossil_sys_hostinfo_all_t *all;
+    const fossil_sys_hostinfo_section_entry_t *entry;
+    int rc;
+} fossil_sys_hostinfo_collect_job_t;
+
+#if defined(_WIN32)
+static DWORD WINAPI fossil_sys_hostinfo_collect_thread(LPVOID arg)
+{
+    fossil_sys_hostinfo_collect_job_t *job = (fossil_sys_hostinfo_collect_job_t *)arg;
+    job->rc = job->entry->gather(job->all);
+    return 0;
+}
+#else
+static void *fossil_sys_hostinfo_collect_thread(void *arg)
+{
+    fossil_sys_hostinfo_collect_job_t *job = (fossil_sys_hostinfo_collect_job_t *)arg;
+    job->rc = job->entry->gather(job->all);
+    return NULL;
+}
+#endif
+
+int fossil_sys_hostinfo_collect_all(uint32_t sections, fossil_sys_hostinfo_all_t *out)
+{
+    if (!out)
+        return -1;
+    memset(out, 0, sizeof(*out));
+    out->requested = sections & FOSSIL_SYS_HOSTINFO_SECTION_ALL;
+    out->collected_at = (uint64_t)time(NULL);
+
+    fossil_sys_hostinfo_collect_job_t jobs[FOSSIL_SYS_HOSTINFO_SECTION_COUNT];
+#if defined(_WIN32)
+    HANDLE threads[FOSSIL_SYS_HOSTINFO_SECTION_COUNT];
+#else
+    pthread_t threads[FOSSIL_SYS_HOSTINFO_SECTION_COUNT];
+#endif
+    int started[FOSSIL_SYS_HOSTINFO_SECTION_COUNT] = {0};
+
+    // Slow sections first so they overlap with the inline ones
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_SECTION_COUNT; ++i)
+    {
+        const fossil_sys_hostinfo_section_entry_t *entry = &fossil_sys_hostinfo_sections[i];
+        jobs[i].all = out;
+        jobs[i].entry = entry;
+        jobs[i].rc = -1;
+        if (!(out->requested & entry->bit) || !(entry->bit & FOSSIL_SYS_HOSTINFO_SLOW_SECTIONS))
+            continue;
+#if defined(_WIN32)
+        threads[i] = CreateThread(NULL, 0, fossil_sys_hostinfo_collect_thread, &jobs[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, fossil_sys_hostinfo_collect_thread, &jobs[i]) == 0;
+#endif
+    }
+
+    // Fast sections, plus any slow one whose thread could not be started
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_SECTION_COUNT; ++i)
+    {
+        if ((out->requested & jobs[i].entry->bit) && !started[i])
+            jobs[i].rc = jobs[i].entry->gather(out);
+    }
+
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_SECTION_COUNT; ++i)
+    {
+        if (!started[i])
+            continue;
+#if defined(_WIN32)
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+
+    for (size_t i = 0; i < FOSSIL_SYS_HOSTINFO_SECTION_COUNT; ++i)
+    {
+        if ((out->requested & jobs[i].entry->bit) && jobs[i].rc == 0)
+            out->valid |= jobs[i].entry->bit;
+    }
+    return out->valid == out->requested ? 0 : -3;
+}
+
+/*
+ * Bounded output buffer. Writes past the end are dropped but still
+ * counted, so a too-small buffer reports the size it would have needed.
+ */
+typedef struct
+{
+    unsigned char *buf;
+    size_t size;
+    size_t len;
+} fossil_sys_hostinfo_writer_t;
+
+static void fossil_sys_hostinfo_put(fossil_sys_hostinfo_writer_t *w, const void *data, size_t n)
+{
+    if (w->len < w->size)
+    {
+        size_t room = w->size - w->len;
+        memcpy(w->buf + w->len, data, n < room ? n : room);
+    }
+    w->len += n;
+}
+
+static void fossil_sys_hostinfo_put_byte(fossil_sys_hostinfo_writer_t *w, unsigned char c)
+{
+    if (w->len < w->size)
+        w->buf[w->len] = c;
+    w->len++;
+}
+
+static void fossil_sys_hostinfo_put_str(fossil_sys_hostinfo_writer_t *w, const char *s)
+{
+    fossil_sys_hostinfo_put(w, s, strlen(s));
+}
+
+/* Length of a fixed-size string member that may lack its terminator. */
+static size_t fossil_sys_hostinfo_field_strlen(const char *s, size_t size)
+{
+    const char *end = memchr(s, '\0', size);
+    return end ? (size_t)(end - s) : size;
+}
+
+static void fossil_sys_hostinfo_json_string(fossil_sys_hostinfo_writer_t *w, const char *s, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+    fossil_sys_hostinfo_put_byte(w, '"');
+    for (size_t i = 0; i < len; ++i)
+    {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\')
+        {
+            fossil_sys_hostinfo_put_byte(w, '\\');
+            fossil_sys_hostinfo_put_byte(w, c);
+        }
+        else if (c < 0x20)
+        {
+            unsigned char esc[6] = {'\\', 'u', '0', '0', (unsigned char)hex[c >> 4], (unsigned char)hex[c & 0xf]};
+            fossil_sys_hostinfo_put(w, esc, sizeof(esc));
+        }
+        else
+        {
+            fossil_sys_hostinfo_put_byte(w, c);
+        }
+    }
+    fossil_sys_hostinfo_put_byte(w, '"');
+}
+
+static void fossil_sys_hostinfo_json_value(fossil_sys_hostinfo_writer_t *w, const fossil_sys_hostinfo_all_t *info,
+                                           const fossil_sys_hostinfo_field_t *field)
+{
+    const char *src = (const char *)info + field->offset;
+    char num[32];
+    switch (field->kind)
+    {
+    case FOSSIL_SYS_HOSTINFO_FIELD_STR:
+        fossil_sys_hostinfo_json_string(w, src, fossil_sys_hostinfo_field_strlen(src, field->size));
+        return;
+    case FOSSIL_SYS_HOSTINFO_FIELD_U64:
+    {
+        uint64_t v;
+        memcpy(&v, src, sizeof(v));
+        snprintf(num, sizeof(num), "%llu", (unsigned long long)v);
+        break;
+    }
+    case FOSSIL_SYS_HOSTINFO_FIELD_U32:
+    {
+        uint32_t v;
+        memcpy(&v, src, sizeof(v));
+        snprintf(num, sizeof(num), "%lu", (unsigned long)v);
+        break;
+    }
+    case FOSSIL_SYS_HOSTINFO_FIELD_INT:
+    {
+        int v;
+        memcpy(&v, src, sizeof(v));
+        snprintf(num, sizeof(num), "%d", v);
+        break;
+    }
+    case FOSSIL_SYS_HOSTINFO_FIELD_FLOAT:
+    {
+        float v;
+        memcpy(&v, src, sizeof(v));
+        // JSON has no NaN/Infinity
+        snprintf(num, sizeof(num), "%.3f", v == v && v - v == 0.0f ? (double)v : 0.0);
+        break;
+    }
+    }
+    fossil_sys_hostinfo_put_str(w, num);
+}
+
+int fossil_sys_hostinfo_to_json(const fossil_sys_hostinfo_all_t *info, char *buf, size_t size, size_t *written)
+{
+    if (!info || (!buf && size))
+        return -1;
+
+    fossil_sys_hostinfo_writer_t w = {(unsigned char *)buf, size ? size - 1 : 0, 0};
+    char num[32];
+
+    fossil_sys_hostinfo_put_str(&w, "{\"collected_at\":");
+    snprintf(num, sizeof(num), "%llu", (unsigned long long)info->collected_at);
+    fossil_sys_hostinfo_put_str(&w, num);
+
+    size_t f = 0;
+    for (size_t s = 0; s < FOSSIL_SYS_HOSTINFO_SECTION_COUNT; ++s)
+    {
+        const fossil_sys_hostinfo_section_entry_t *section = &fossil_sys_hostinfo_sections[s];
+        int emit = (info->valid & section->bit) != 0;
+        if (emit)
+        {
+            fossil_sys_hostinfo_put_str(&w, ",\"");
+            fossil_sys_hostinfo_put_str(&w, section->name);
+            fossil_sys_hostinfo_put_str(&w, "\":{");
+        }
+        for (int first = 1; f < FOSSIL_SYS_HOSTINFO_FIELD_COUNT && fossil_sys_hostinfo_fields[f].section == section->bit;
+             ++f)
+        {
+            if (!emit)
+                continue;
+            if (!first)
+                fossil_sys_hostinfo_put_byte(&w, ',');
+            first = 0;
+            fossil_sys_hostinfo_put_byte(&w, '"');
+            fossil_sys_hostinfo_put_str(&w, fossil_sys_hostinfo_fields[f].name);
+            fossil_sys_hostinfo_put_str(&w, "\":");
+            fossil_sys_hostinfo_json_value(&w, info, &fossil_sys_hostinfo_fields[f]);
+        }
+        if (emit)
+            fossil_sys_hostinfo_put_byte(&w, '}');
+    }
+    fossil_sys_hostinfo_put_byte(&w, '}');
+
+    if (size)
+        buf[w.len < w.size ? w.len : w.size] = '\0';
+    if (written)
+        *written = w.len;
+    return w.len <= w.size ? 0 : -4;
+}
+
+static void fossil_sys_hostinfo_put_varint(fossil_sys_hostinfo_writer_t *w, uint64_t v)
+{
+    while (v >= 0x80)
+    {
+        fossil_sys_hostinfo_put_byte(w, (unsigned char)(v | 0x80));
+        v >>= 7;
+    }
+    fossil_sys_hostinfo_put_byte(w, (unsigned char)v);
+}
+
+int fossil_sys_hostinfo_to_binary(const fossil_sys_hostinfo_all_t *info, void *buf, size_t size, size_t *written)
+{
+    if (!info || (!buf && size))
+        return -1;
+
+    fossil_sys_hostinfo_writer_t w = {(unsigned char *)buf, size, 0};
+    fossil_sys_hostinfo_put(&w, FOSSIL_SYS_HOSTINFO_BINARY_MAGIC, 4);
+    fossil_sys_hostinfo_put_byte(&w, FOSSIL_SYS_HOSTINFO_BINARY_VERSION);
+    fossil_sys_hostinfo_put_varint(&w, info->valid & FOSSIL_SYS_HOSTINFO_SECTION_ALL);
+    fossil_sys_hostinfo_put_varint(&w, info->collected_at);
+
+    for (size_t f = 0; f < FOSSIL_SYS_HOSTINFO_FIELD_COUNT; ++f)
+    {
+        const fossil_sys_hostinfo_field_t *field = &fossil_sys_hostinfo_fields[f];
+        if (!(info->valid & field->section))
+            continue;
+
+        const char *src = (const char *)info + field->offset;
+        switch (field->kind)
+        {
+        case FOSSIL_SYS_HOSTINFO_FIELD_STR:
+        {
+            size_t len = fossil_sys_hostinfo_field_strlen(src, field->size);
+            fossil_sys_hostinfo_put_varint(&w, len);
+            fossil_sys_hostinfo_put(&w, src, len);
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_U64:
+        {
+            uint64_t v;
+            memcpy(&v, src, sizeof(v));
+            fossil_sys_hostinfo_put_varint(&w, v);
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_U32:
+        {
+            uint32_t v;
+            memcpy(&v, src, sizeof(v));
+            fossil_sys_hostinfo_put_varint(&w, v);
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_INT:
+        {
+            int v;
+            memcpy(&v, src, sizeof(v));
+            int64_t wide = v;
+            fossil_sys_hostinfo_put_varint(&w, ((uint64_t)wide << 1) ^ (uint64_t)(wide >> 63)); // zigzag
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_FLOAT:
+        {
+            uint32_t bits;
+            memcpy(&bits, src, sizeof(bits));
+            unsigned char le[4] = {(unsigned char)bits, (unsigned char)(bits >> 8), (unsigned char)(bits >> 16),
+                                   (unsigned char)(bits >> 24)};
+            fossil_sys_hostinfo_put(&w, le, sizeof(le));
+            break;
+        }
+        }
+    }
+
+    if (written)
+        *written = w.len;
+    return w.len <= w.size ? 0 : -4;
+}
+
+typedef struct
+{
+    const unsigned char *p;
+    size_t size;
+    size_t pos;
+    int error;
+} fossil_sys_hostinfo_reader_t;
+
+static uint64_t fossil_sys_hostinfo_get_varint(fossil_sys_hostinfo_reader_t *r)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7)
+    {
+        if (r->pos >= r->size)
+            break;
+        unsigned char c = r->p[r->pos++];
+        v |= (uint64_t)(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return v;
+    }
+    r->error = 1;
+    return 0;
+}
+
+int fossil_sys_hostinfo_from_binary(const void *buf, size_t size, fossil_sys_hostinfo_all_t *out)
+{
+    if (!buf || !out || size < 5 || memcmp(buf, FOSSIL_SYS_HOSTINFO_BINARY_MAGIC, 4) != 0)
+        return -1;
+
+    fossil_sys_hostinfo_reader_t r = {(const unsigned char *)buf, size, 4, 0};
+    if (r.p[r.pos++] != FOSSIL_SYS_HOSTINFO_BINARY_VERSION)
+        return -2;
+
+    memset(out, 0, sizeof(*out));
+    out->valid = (uint32_t)fossil_sys_hostinfo_get_varint(&r) & FOSSIL_SYS_HOSTINFO_SECTION_ALL;
+    out->requested = out->valid;
+    out->collected_at = fossil_sys_hostinfo_get_varint(&r);
+
+    for (size_t f = 0; f < FOSSIL_SYS_HOSTINFO_FIELD_COUNT && !r.error; ++f)
+    {
+        const fossil_sys_hostinfo_field_t *field = &fossil_sys_hostinfo_fields[f];
+        if (!(out->valid & field->section))
+            continue;
+
+        char *dst = (char *)out + field->offset;
+        switch (field->kind)
+        {
+        case FOSSIL_SYS_HOSTINFO_FIELD_STR:
+        {
+            uint64_t len = fossil_sys_hostinfo_get_varint(&r);
+            if (len >= field->size || len > r.size - r.pos)
+            {
+                r.error = 1;
+                break;
+            }
+            memcpy(dst, r.p + r.pos, (size_t)len);
+            dst[len] = '\0';
+            r.pos += (size_t)len;
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_U64:
+        {
+            uint64_t v = fossil_sys_hostinfo_get_varint(&r);
+            memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_U32:
+        {
+            uint32_t v = (uint32_t)fossil_sys_hostinfo_get_varint(&r);
+            memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_INT:
+        {
+            uint64_t z = fossil_sys_hostinfo_get_varint(&r);
+            int v = (int)(int64_t)((z >> 1) ^ (~(z & 1) + 1));
+            memcpy(dst, &v, sizeof(v));
+            break;
+        }
+        case FOSSIL_SYS_HOSTINFO_FIELD_FLOAT:
+        {
+            if (r.size - r.pos < 4)
+            {
+                r.error = 1;
+                break;
+            }
+            const unsigned char *le = r.p + r.pos;
+            uint32_t bits = (uint32_t)le[0] | ((uint32_t)le[1] << 8) | ((uint32_t)le[2] << 16) | ((uint32_t)le[3] << 24);
+            memcpy(dst, &bits, sizeof(bits));
+            r.pos += 4;
+            break;
+        }
+        }
+    }
+    return r.error || r.pos != r.size ? -1 : 0;
+}
+
+/* ============================================================================
+ * Effective CPU and memory limits
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+#define FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/sys/fs/cgroup"
+
+/*
+ * Finds this process's cgroup path in /proc/self/cgroup. With controller
+ * NULL the unified (v2) entry "0::/path" is returned, otherwise the v1
+ * hierarchy whose controller list contains it ("4:cpu,cpuacct:/path").
+ */
+static int fossil_sys_hostinfo_cgroup_path(const char *controller, char *out, size_t size)
+{
+    char buf[4096];
+    if (fossil_sys_hostinfo_read_text("/proc/self/cgroup", buf, sizeof(buf)) <= 0)
+        return -1;
+
+    for (const char *p = buf; *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        const char *c1 = strchr(p, ':');
+        const char *c2 = c1 ? strchr(c1 + 1, ':') : NULL;
+        const char *nl = strchr(p, '\n');
+        if (!c2 || (nl && c2 > nl))
+            continue;
+
+        int match = 0;
+        if (!controller)
+        {
+            match = c1 - p == 1 && p[0] == '0' && c2 == c1 + 1;
+        }
+        else
+        {
+            size_t want = strlen(controller);
+            for (const char *name = c1 + 1; name < c2;)
+            {
+                size_t len = strcspn(name, ",:");
+                if (len == want && strncmp(name, controller, len) == 0)
+                    match = 1;
+                name += len + 1;
+            }
+        }
+        if (!match)
+            continue;
+
+        size_t len = nl ? (size_t)(nl - c2 - 1) : strlen(c2 + 1);
+        if (len >= size)
+            return -1;
+        memcpy(out, c2 + 1, len);
+        out[len] = '\0';
+        return 0;
+    }
+    return -1;
+}
+
+typedef double (*fossil_sys_hostinfo_cgroup_limit_fn)(const char *dir);
+
+/* cgroup v2 "cpu.max": "max 100000" or "<quota> <period>"; returns CPUs. */
+static double fossil_sys_hostinfo_cgroup2_cpu(const char *dir)
+{
+    char path[PATH_MAX];
+    char text[64];
+    snprintf(path, sizeof(path), "%s/cpu.max", dir);
+    if (fossil_sys_hostinfo_read_text(path, text, sizeof(text)) <= 0 || strncmp(text, "max", 3) == 0)
+        return 0;
+    double quota = 0, period = 0;
+    if (sscanf(text, "%lf %lf", &quota, &period) != 2 || quota <= 0 || period <= 0)
+        return 0;
+    return quota / period;
+}
+
+static double fossil_sys_hostinfo_cgroup1_cpu(const char *dir)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/cpu.cfs_quota_us", dir);
+    long long quota = fossil_sys_hostinfo_read_ll(path, -1);
+    snprintf(path, sizeof(path), "%s/cpu.cfs_period_us", dir);
+    long long period = fossil_sys_hostinfo_read_ll(path, 0);
+    return quota > 0 && period > 0 ? (double)quota / (double)period : 0;
+}
+
+static double fossil_sys_hostinfo_cgroup2_memory(const char *dir)
+{
+    char path[PATH_MAX];
+    char text[64];
+    snprintf(path, sizeof(path), "%s/memory.max", dir);
+    if (fossil_sys_hostinfo_read_text(path, text, sizeof(text)) <= 0 || strncmp(text, "max", 3) == 0)
+        return 0;
+    return (double)strtoull(text, NULL, 10);
+}
+
+static double fossil_sys_hostinfo_cgroup1_memory(const char *dir)
+{
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/memory.limit_in_bytes", dir);
+    long long limit = fossil_sys_hostinfo_read_ll(path, 0);
+    // "unlimited" is reported as LONG_MAX rounded down to a page
+    return limit > 0 && limit < (1LL << 62) ? (double)limit : 0;
+}
+
+/*
+ * Tightest limit from the process's cgroup up to the hierarchy root.
+ * Without a private cgroup namespace the path names a directory that
+ * does not exist inside the container; walking up then reaches the
+ * container's own root, which carries its limits.
+ */
+static double fossil_sys_hostinfo_cgroup_min(const char *root, const char *cgroup, fossil_sys_hostinfo_cgroup_limit_fn fn)
+{
+    char dir[PATH_MAX];
+    size_t root_len = strlen(root);
+    snprintf(dir, sizeof(dir), "%s%s", root, strcmp(cgroup, "/") == 0 ? "" : cgroup);
+
+    double best = 0;
+    for (;;)
+    {
+        double limit = fn(dir);
+        if (limit > 0 && (best == 0 || limit < best))
+            best = limit;
+        if (strlen(dir) <= root_len)
+            break;
+        char *slash = strrchr(dir, '/');
+        if (!slash || (size_t)(slash - dir) < root_len)
+            dir[root_len] = '\0';
+        else
+            *slash = '\0';
+    }
+    return best;
+}
+
+static void fossil_sys_hostinfo_cgroup_limits(fossil_sys_hostinfo_resources_t *info)
+{
+    char cgroup[1024];
+
+    if (fossil_sys_hostinfo_cgroup_path(NULL, cgroup, sizeof(cgroup)) == 0 &&
+        access(FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/cgroup.controllers", F_OK) == 0)
+    {
+        info->cgroup_version = 2;
+        info->cpu_quota = fossil_sys_hostinfo_cgroup_min(FOSSIL_SYS_HOSTINFO_CGROUP_ROOT, cgroup,
+                                                         fossil_sys_hostinfo_cgroup2_cpu);
+        info->memory_limit = (uint64_t)fossil_sys_hostinfo_cgroup_min(FOSSIL_SYS_HOSTINFO_CGROUP_ROOT, cgroup,
+                                                                      fossil_sys_hostinfo_cgroup2_memory);
+        return;
+    }
+
+    if (fossil_sys_hostinfo_cgroup_path("cpu", cgroup, sizeof(cgroup)) == 0)
+    {
+        info->cgroup_version = 1;
+        const char *root = access(FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/cpu,cpuacct", F_OK) == 0
+                               ? FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/cpu,cpuacct"
+                               : FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/cpu";
+        info->cpu_quota = fossil_sys_hostinfo_cgroup_min(root, cgroup, fossil_sys_hostinfo_cgroup1_cpu);
+    }
+    if (fossil_sys_hostinfo_cgroup_path("memory", cgroup, sizeof(cgroup)) == 0)
+    {
+        info->cgroup_version = 1;
+        info->memory_limit = (uint64_t)fossil_sys_hostinfo_cgroup_min(FOSSIL_SYS_HOSTINFO_CGROUP_ROOT "/memory", cgroup,
+                                                                      fossil_sys_hostinfo_cgroup1_memory);
+    }
+}
+#elif defined(_WIN32)
+static int fossil_sys_hostinfo_popcount(ULONG_PTR mask)
+{
+    int bits = 0;
+    for (; mask; mask &= mask - 1)
+        bits++;
+    return bits;
+}
+
+/* Job objects are the Windows counterpart of cgroups (containers, CI sandboxes). */
+static void fossil_sys_hostinfo_job_limits(fossil_sys_hostinfo_resources_t *info)
+{
+    JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate;
+    memset(&rate, 0, sizeof(rate));
+    if (QueryInformationJobObject(NULL, JobObjectCpuRateControlInformation, &rate, sizeof(rate), NULL) &&
+        (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE) &&
+        (rate.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP) && rate.CpuRate > 0)
+    {
+        // CpuRate is in 1/100 of a percent of the whole machine
+        info->cpu_quota = (double)rate.CpuRate / 10000.0 * (double)info->online_cpus;
+    }
+
+    JOBOBJECT_EXTENDED_LIMIT_INFORMATION limits;
+    memset(&limits, 0, sizeof(limits));
+    if (QueryInformationJobObject(NULL, JobObjectExtendedLimitInformation, &limits, sizeof(limits), NULL))
+    {
+        DWORD flags = limits.BasicLimitInformation.LimitFlags;
+        if (flags & JOB_OBJECT_LIMIT_JOB_MEMORY)
+            info->memory_limit = (uint64_t)limits.JobMemoryLimit;
+        if ((flags & JOB_OBJECT_LIMIT_PROCESS_MEMORY) &&
+            (info->memory_limit == 0 || (uint64_t)limits.ProcessMemoryLimit < info->memory_limit))
+            info->memory_limit = (uint64_t)limits.ProcessMemoryLimit;
+    }
+}
+#endif
+
+/* CPU side plus the raw container memory limit; cheap enough for hot callers. */
+static void fossil_sys_hostinfo_resources_limits(fossil_sys_hostinfo_resources_t *info)
+{
+    memset(info, 0, sizeof(*info));
+
+#if defined(_WIN32)
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    info->online_cpus = (int)si.dwNumberOfProcessors;
+    DWORD_PTR process_mask = 0, system_mask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+        info->affinity_cpus = fossil_sys_hostinfo_popcount(process_mask);
+    fossil_sys_hostinfo_job_limits(info);
+#else
+#if defined(_SC_NPROCESSORS_ONLN)
+    info->online_cpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+        info->affinity_cpus = CPU_COUNT(&mask);
+    fossil_sys_hostinfo_cgroup_limits(info);
+#endif
+#endif
+    if (info->online_cpus < 1)
+        info->online_cpus = 1;
+    if (info->affinity_cpus < 1 || info->affinity_cpus > info->online_cpus)
+        info->affinity_cpus = info->online_cpus;
+
+    info->effective_cpus = info->affinity_cpus;
+    if (info->cpu_quota > 0)
+    {
+        // A 2.5 CPU quota still lets three threads make progress
+        int quota = (int)info->cpu_quota;
+        if ((double)quota < info->cpu_quota)
+            quota++;
+        if (quota < info->effective_cpus)
+            info->effective_cpus = quota;
+    }
+    if (info->effective_cpus < 1)
+        info->effective_cpus = 1;
+}
+
+int fossil_sys_hostinfo_get_resources(fossil_sys_hostinfo_resources_t *info)
+{
+    if (!info)
+        return -1;
+    fossil_sys_hostinfo_resources_limits(info);
+
+    fossil_sys_hostinfo_memory_t memory;
+    if (fossil_sys_hostinfo_get_memory(&memory) == 0)
+        info->memory_total = memory.total_memory;
+    info->effective_memory = info->memory_total;
+    if (info->memory_limit > 0 && (info->effective_memory == 0 || info->memory_limit < info->effective_memory))
+        info->effective_memory = info->memory_limit;
+
+    fossil_sys_hostinfo_virtualization_t virt;
+    if (fossil_sys_hostinfo_get_virtualization(&virt) == 0)
+        info->is_container = virt.is_container;
+    return 0;
+}
+
+int fossil_sys_hostinfo_effective_cpus(void)
+{
+    fossil_sys_hostinfo_resources_t info;
+    fossil_sys_hostinfo_resources_limits(&info);
+    return info.effective_cpus;
+}
+
+/* ============================================================================
+ * Clocks and cycle counter
+ * ============================================================================
+ */
+
+#define FOSSIL_SYS_HOSTINFO_TSC_CALIBRATE_NS 10000000u
+
+static fossil_sys_hostinfo_tsc_t fossil_sys_hostinfo_tsc;
+static int fossil_sys_hostinfo_tsc_is_clock; // timestamp_ns may use the counter
+static fossil_sys_hostinfo_once_t fossil_sys_hostinfo_tsc_once = FOSSIL_SYS_HOSTINFO_ONCE_INIT;
+
+uint64_t fossil_sys_hostinfo_clock_ns(fossil_sys_hostinfo_clock_t clock)
+{
+#if defined(_WIN32)
+    // QPC is the only high-resolution source; it serves all three clocks
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    (void)clock;
+    if (!frequency.QuadPart && !QueryPerformanceFrequency(&frequency))
+        return 0;
+    if (!QueryPerformanceCounter(&counter))
+        return 0;
+    uint64_t c = (uint64_t)counter.QuadPart, f = (uint64_t)frequency.QuadPart;
+    return (c / f) * 1000000000u + (c % f) * 1000000000u / f;
+#elif defined(__APPLE__)
+    switch (clock)
+    {
+    case FOSSIL_SYS_HOSTINFO_CLOCK_BOOTTIME:
+        return clock_gettime_nsec_np(CLOCK_MONOTONIC); // counts sleep on Darwin
+    case FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC_RAW:
+        return clock_gettime_nsec_np(CLOCK_MONOTONIC_RAW);
+    default:
+        return clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    }
+#else
+    clockid_t id = CLOCK_MONOTONIC;
+#if defined(CLOCK_MONOTONIC_RAW)
+    if (clock == FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC_RAW)
+        id = CLOCK_MONOTONIC_RAW;
+#endif
+#if defined(CLOCK_BOOTTIME)
+    if (clock == FOSSIL_SYS_HOSTINFO_CLOCK_BOOTTIME)
+        id = CLOCK_BOOTTIME;
+#endif
+    struct timespec ts;
+    if (clock_gettime(id, &ts) != 0)
+        return 0;
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+/* Largest shift (at most 32) whose multiplier still fits in 32 bits. */
+static void fossil_sys_hostinfo_tsc_scale(fossil_sys_hostinfo_tsc_t *tsc)
+{
+    if (!tsc->frequency_hz)
+        return;
+    for (uint32_t shift = 32;; --shift)
+    {
+        uint64_t mult = (((uint64_t)1000000000u << shift) + tsc->frequency_hz / 2) / tsc->frequency_hz;
+        if (mult <= UINT32_MAX || shift == 0)
+        {
+            tsc->mult = (uint32_t)mult;
+            tsc->shift = shift;
+            return;
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+/* Measures the counter against CLOCK_MONOTONIC, the clock timestamp_ns stands in for. */
+static uint64_t fossil_sys_hostinfo_tsc_calibrate(void)
+{
+    uint64_t t0 = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+    uint64_t c0 = fossil_sys_hostinfo_cycles();
+    uint64_t t1, c1;
+    do
+    {
+        t1 = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+        c1 = fossil_sys_hostinfo_cycles();
+    } while (t1 - t0 < FOSSIL_SYS_HOSTINFO_TSC_CALIBRATE_NS);
+    return (c1 - c0) * 1000000000u / (t1 - t0);
+}
+
+/*
+ * The CPUID invariant bit says nothing about cross-socket sync or a TSC
+ * the kernel found unstable. On Linux, only trust it when the kernel
+ * itself keeps time with it.
+ */
+static int fossil_sys_hostinfo_tsc_kernel_trusted(void)
+{
+#if defined(__linux__)
+    char source[32];
+    if (fossil_sys_hostinfo_read_text("/sys/devices/system/clocksource/clocksource0/current_clocksource",
+                                      source, sizeof(source)) <= 0)
+        return 0;
+    return strcmp(source, "tsc") == 0;
+#else
+    return 1;
+#endif
+}
+
+/* Hypervisor leaves sit outside the range __get_cpuid_max reports. */
+static unsigned int fossil_sys_hostinfo_tsc_hypervisor_khz(void)
+{
+    if (!fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_HYPERVISOR))
+        return 0;
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuid(r, 0x40000000);
+    if ((unsigned int)r[0] < 0x40000010u)
+        return 0;
+    __cpuid(r, 0x40000010);
+    return (unsigned int)r[0];
+#else
+    unsigned int eax, ebx, ecx, edx;
+    __cpuid(0x40000000, eax, ebx, ecx, edx);
+    if (eax < 0x40000010u)
+        return 0;
+    __cpuid(0x40000010, eax, ebx, ecx, edx);
+    return eax;
+#endif
+}
+#endif
+
+static void fossil_sys_hostinfo_tsc_init(void)
+{
+    fossil_sys_hostinfo_tsc_t *tsc = &fossil_sys_hostinfo_tsc;
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    unsigned int r[4];
+    tsc->invariant = fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_INVARIANT_TSC);
+
+    // Leaf 0x15: TSC = crystal * EBX / EAX, exact when the crystal rate is enumerated
+    if (fossil_sys_hostinfo_cpuid(0x15, 0, r) && r[0] && r[1] && r[2])
+    {
+        tsc->frequency_hz = (uint64_t)r[2] * r[1] / r[0];
+        tsc->source = FOSSIL_SYS_HOSTINFO_TSC_SOURCE_CPUID_15;
+    }
+    if (!tsc->frequency_hz)
+    {
+        unsigned int khz = fossil_sys_hostinfo_tsc_hypervisor_khz();
+        if (khz)
+        {
+            tsc->frequency_hz = (uint64_t)khz * 1000u;
+            tsc->source = FOSSIL_SYS_HOSTINFO_TSC_SOURCE_HYPERVISOR;
+        }
+    }
+    // Leaf 0x16 is only the nominal base frequency and drifts; measure instead
+    if (!tsc->frequency_hz)
+    {
+        tsc->frequency_hz = fossil_sys_hostinfo_tsc_calibrate();
+        tsc->source = FOSSIL_SYS_HOSTINFO_TSC_SOURCE_CALIBRATED;
+    }
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__aarch64__)
+    uint64_t frequency;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(frequency));
+    tsc->frequency_hz = frequency;
+    tsc->invariant = frequency != 0; // the generic timer has a fixed rate by definition
+    tsc->source = frequency ? FOSSIL_SYS_HOSTINFO_TSC_SOURCE_ARCH_TIMER : FOSSIL_SYS_HOSTINFO_TSC_SOURCE_NONE;
+#endif
+
+    fossil_sys_hostinfo_tsc_scale(tsc);
+    fossil_sys_hostinfo_tsc_is_clock = tsc->invariant && tsc->mult;
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    if (fossil_sys_hostinfo_tsc_is_clock)
+        fossil_sys_hostinfo_tsc_is_clock = fossil_sys_hostinfo_tsc_kernel_trusted();
+#endif
+}
+
+const fossil_sys_hostinfo_tsc_t *fossil_sys_hostinfo_get_tsc(void)
+{
+    fossil_sys_hostinfo_once(&fossil_sys_hostinfo_tsc_once, fossil_sys_hostinfo_tsc_init);
+    return &fossil_sys_hostinfo_tsc;
+}
+
+uint64_t fossil_sys_hostinfo_timestamp_ns(void)
+{
+    const fossil_sys_hostinfo_tsc_t *tsc = fossil_sys_hostinfo_get_tsc();
+    if (fossil_sys_hostinfo_tsc_is_clock)
+        return fossil_sys_hostinfo_cycles_to_ns(tsc, fossil_sys_hostinfo_cycles());
+    return fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+}
+
+/* ============================================================================
+ * Interrupt and softirq counters
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+/*
+ * Parses the "CPU0 CPU1 ..." header and the "NAME: n n ... description"
+ * rows shared by /proc/interrupts and /proc/softirqs. Rows such as ERR
+ * and MIS carry a single column; missing columns are left at zero.
+ */
+static int fossil_sys_hostinfo_irq_parse(const char *text, int **cpus, size_t *cpu_count,
+                                         fossil_sys_hostinfo_irq_t **rows, uint64_t **counts,
+                                         size_t *row_count)
+{
+    const char *p = text;
+    size_t ncols = 0, nrows = 0;
+    for (const char *q = p; *q && *q != '\n'; ++q)
+        if (q[0] == 'C' && q[1] == 'P' && q[2] == 'U')
+            ++ncols;
+    for (const char *q = fossil_sys_hostinfo_next_line(p); *q; q = fossil_sys_hostinfo_next_line(q))
+        ++nrows;
+    if (ncols == 0)
+        return -3;
+
+    *cpus = malloc(ncols * sizeof(**cpus));
+    *rows = calloc(nrows ? nrows : 1, sizeof(**rows));
+    *counts = calloc(nrows ? nrows * ncols : 1, sizeof(**counts));
+    if (!*cpus || !*rows || !*counts)
+        return -3;
+
+    size_t col = 0;
+    while (*p && *p != '\n' && col < ncols)
+    {
+        const char *cpu = strstr(p, "CPU");
+        if (!cpu)
+            break;
+        (*cpus)[col++] = (int)strtol(cpu + 3, (char **)&p, 10);
+    }
+    *cpu_count = col;
+
+    size_t row = 0;
+    for (p = fossil_sys_hostinfo_next_line(p); *p && row < nrows; p = fossil_sys_hostinfo_next_line(p))
+    {
+        while (*p == ' ')
+            ++p;
+        const char *colon = strchr(p, ':');
+        const char *eol = strchr(p, '\n');
+        if (!eol)
+            eol = p + strlen(p);
+        if (!colon || colon > eol)
+            continue;
+
+        fossil_sys_hostinfo_irq_t *irq = &(*rows)[row];
+        uint64_t *line = *counts + row * col;
+        size_t name_len = (size_t)(colon - p);
+        if (name_len >= sizeof(irq->name))
+            name_len = sizeof(irq->name) - 1;
+        memcpy(irq->name, p, name_len);
+
+        const char *q = colon + 1;
+        for (size_t i = 0; i < col; ++i)
+        {
+            while (*q == ' ')
+                ++q;
+            if (*q < '0' || *q > '9')
+                break;
+            char *end;
+            line[i] = strtoull(q, &end, 10);
+            irq->total += line[i];
+            q = end;
+        }
+        while (*q == ' ')
+            ++q;
+        size_t desc_len = (size_t)(eol - q);
+        if (desc_len >= sizeof(irq->description))
+            desc_len = sizeof(irq->description) - 1;
+        memcpy(irq->description, q, desc_len);
+        ++row;
+    }
+    *row_count = row;
+    return 0;
+}
+
+/* Column of after that holds cpu, trying the same position first. */
+static ptrdiff_t fossil_sys_hostinfo_irq_column(const int *cpus, size_t count, size_t hint, int cpu)
+{
+    if (hint < count && cpus[hint] == cpu)
+        return (ptrdiff_t)hint;
+    for (size_t i = 0; i < count; ++i)
+        if (cpus[i] == cpu)
+            return (ptrdiff_t)i;
+    return -1;
+}
+
+/* Row of rows named name, searching forward from hint and wrapping. */
+static ptrdiff_t fossil_sys_hostinfo_irq_row(const fossil_sys_hostinfo_irq_t *rows, size_t count,
+                                             size_t hint, const char *name)
+{
+    for (size_t n = 0; n < count; ++n)
+    {
+        size_t i = (hint + n) % count;
+        if (strcmp(rows[i].name, name) == 0)
+            return (ptrdiff_t)i;
+    }
+    return -1;
+}
+
+static int fossil_sys_hostinfo_irq_table_delta(const fossil_sys_hostinfo_irq_t *brows, const uint64_t *bcounts,
+                                               size_t brow_count, size_t bcols,
+                                               const fossil_sys_hostinfo_irq_t *arows, const uint64_t *acounts,
+                                               size_t arow_count, size_t acols, const ptrdiff_t *colmap,
+                                               fossil_sys_hostinfo_irq_t **rows, uint64_t **counts)
+{
+    *rows = calloc(arow_count ? arow_count : 1, sizeof(**rows));
+    *counts = calloc(arow_count ? arow_count * acols : 1, sizeof(**counts));
+    if (!*rows || !*counts)
+        return -3;
+
+    size_t hint = 0;
+    for (size_t r = 0; r < arow_count; ++r)
+    {
+        fossil_sys_hostinfo_irq_t *out = &(*rows)[r];
+        *out = arows[r];
+        out->total = 0;
+        ptrdiff_t br = fossil_sys_hostinfo_irq_row(brows, brow_count, hint, arows[r].name);
+        if (br >= 0)
+            hint = (size_t)br + 1;
+        for (size_t c = 0; c < acols; ++c)
+        {
+            uint64_t now = acounts[r * acols + c];
+            uint64_t then = br >= 0 && colmap[c] >= 0 ? bcounts[(size_t)br * bcols + (size_t)colmap[c]] : 0;
+            uint64_t d = now >= then ? now - then : now;
+            (*counts)[r * acols + c] = d;
+            out->total += d;
+        }
+    }
+    return 0;
+}
+
+typedef struct
+{
+    uint64_t load;
+    int cpu;
+} fossil_sys_hostinfo_cpu_load_t;
+
+static int fossil_sys_hostinfo_cpu_load_cmp(const void *a, const void *b)
+{
+    const fossil_sys_hostinfo_cpu_load_t *x = a, *y = b;
+    if (x->load != y->load)
+        return x->load < y->load ? -1 : 1;
+    return (x->cpu > y->cpu) - (x->cpu < y->cpu);
+}
+#endif
+
+void fossil_sys_hostinfo_free_interrupts(fossil_sys_hostinfo_interrupts_t *stats)
+{
+    if (!stats)
+        return;
+    free(stats->cpus);
+    free(stats->irqs);
+    free(stats->irq_counts);
+    free(stats->softirqs);
+    free(stats->softirq_counts);
+    memset(stats, 0, sizeof(*stats));
+}
+
+int fossil_sys_hostinfo_get_interrupts(fossil_sys_hostinfo_interrupts_t *stats)
+{
+    if (!stats)
+        return -1;
+    memset(stats, 0, sizeof(*stats));
+#if defined(__linux__)
+    stats->timestamp_ns = fossil_sys_hostinfo_now_ns();
+
+    char *text = fossil_sys_hostinfo_read_all("/proc/interrupts");
+    if (!text)
+        return -3;
+    int rc = fossil_sys_hostinfo_irq_parse(text, &stats->cpus, &stats->cpu_count, &stats->irqs,
+                                           &stats->irq_counts, &stats->irq_count);
+    free(text);
+    if (rc != 0)
+    {
+        fossil_sys_hostinfo_free_interrupts(stats);
+        return rc;
+    }
+
+    // Softirq columns are remapped onto the interrupt columns by CPU number
+    text = fossil_sys_hostinfo_read_all("/proc/softirqs");
+    if (text)
+    {
+        int *cpus = NULL;
+        fossil_sys_hostinfo_irq_t *rows = NULL;
+        uint64_t *counts = NULL;
+        size_t cols = 0, count = 0;
+        rc = fossil_sys_hostinfo_irq_parse(text, &cpus, &cols, &rows, &counts, &count);
+        free(text);
+        if (rc == 0)
+        {
+            stats->softirq_counts = calloc(count ? count * stats->cpu_count : 1, sizeof(uint64_t));
+            if (stats->softirq_counts)
+            {
+                for (size_t c = 0; c < cols; ++c)
+                {
+                    ptrdiff_t to = fossil_sys_hostinfo_irq_column(stats->cpus, stats->cpu_count, c, cpus[c]);
+                    if (to < 0)
+                        continue;
+                    for (size_t r = 0; r < count; ++r)
+                        stats->softirq_counts[r * stats->cpu_count + (size_t)to] = counts[r * cols + c];
+                }
+                stats->softirqs = rows;
+                stats->softirq_count = count;
+                rows = NULL;
+            }
+        }
+        free(cpus);
+        free(rows);
+        free(counts);
+    }
+    return 0;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_interrupts_delta(const fossil_sys_hostinfo_interrupts_t *before,
+                                         const fossil_sys_hostinfo_interrupts_t *after,
+                                         fossil_sys_hostinfo_interrupts_t *delta)
+{
+    if (!before || !after || !delta || delta == before || delta == after)
+        return -1;
+    memset(delta, 0, sizeof(*delta));
+#if defined(__linux__)
+    size_t cols = after->cpu_count;
+    ptrdiff_t *colmap = malloc((cols ? cols : 1) * sizeof(*colmap));
+    delta->cpus = malloc((cols ? cols : 1) * sizeof(*delta->cpus));
+    if (!colmap || !delta->cpus)
+    {
+        free(colmap);
+        fossil_sys_hostinfo_free_interrupts(delta);
+        return -3;
+    }
+    for (size_t c = 0; c < cols; ++c)
+    {
+        delta->cpus[c] = after->cpus[c];
+        colmap[c] = fossil_sys_hostinfo_irq_column(before->cpus, before->cpu_count, c, after->cpus[c]);
+    }
+    delta->cpu_count = cols;
+    delta->timestamp_ns = after->timestamp_ns;
+
+    int rc = fossil_sys_hostinfo_irq_table_delta(before->irqs, before->irq_counts, before->irq_count,
+                                                 before->cpu_count, after->irqs, after->irq_counts,
+                                                 after->irq_count, cols, colmap, &delta->irqs,
+                                                 &delta->irq_counts);
+    delta->irq_count = after->irq_count;
+    if (rc == 0 && after->softirqs)
+    {
+        rc = fossil_sys_hostinfo_irq_table_delta(before->softirqs, before->softirq_counts, before->softirq_count,
+                                                 before->cpu_count, after->softirqs, after->softirq_counts,
+                                                 after->softirq_count, cols, colmap, &delta->softirqs,
+                                                 &delta->softirq_counts);
+        delta->softirq_count = after->softirq_count;
+    }
+    free(colmap);
+    if (rc != 0)
+        fossil_sys_hostinfo_free_interrupts(delta);
+    return rc;
+#else
+    return -2;
+#endif
+}
+
+int fossil_sys_hostinfo_quiet_cpus(const fossil_sys_hostinfo_interrupts_t *stats,
+                                   int *cpus, size_t capacity, size_t *count)
+{
+    if (!stats || !cpus || !count)
+        return -1;
+    *count = 0;
+#if defined(__linux__)
+    size_t cols = stats->cpu_count;
+    if (cols == 0)
+        return 0;
+    fossil_sys_hostinfo_cpu_load_t *loads = calloc(cols, sizeof(*loads));
+    if (!loads)
+        return -3;
+    for (size_t c = 0; c < cols; ++c)
+    {
+        loads[c].cpu = stats->cpus[c];
+        for (size_t r = 0; r < stats->irq_count; ++r)
+            loads[c].load += stats->irq_counts[r * cols + c];
+        for (size_t r = 0; stats->softirq_counts && r < stats->softirq_count; ++r)
+            loads[c].load += stats->softirq_counts[r * cols + c];
+    }
+    qsort(loads, cols, sizeof(*loads), fossil_sys_hostinfo_cpu_load_cmp);
+    for (size_t c = 0; c < cols && c < capacity; ++c)
+        cpus[(*count)++] = loads[c].cpu;
+    free(loads);
+    return 0;
+#else
+    (void)capacity;
+    return -2;
+#endif
+}
+
+/* ============================================================================
+ * File descriptor inventory
+ * ============================================================================
+ */
+
+#if defined(__linux__)
+typedef enum
+{
+    FOSSIL_SYS_HOSTINFO_SOCKET_TCP,
+    FOSSIL_SYS_HOSTINFO_SOCKET_UDP,
+    FOSSIL_SYS_HOSTINFO_SOCKET_UNIX
+} fossil_sys_hostinfo_socket_table_t;
+
+static int fossil_sys_hostinfo_inode_cmp(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static const char *fossil_sys_hostinfo_skip_fields(const char *p, int fields)
+{
+    while (fields-- > 0)
+    {
+        while (*p == ' ')
+            ++p;
+        while (*p && *p != ' ' && *p != '\n')
+            ++p;
+    }
+    while (*p == ' ')
+        ++p;
+    return p;
+}
+
+/*
+ * Counts the rows of one /proc/net table whose inode belongs to the
+ * process. Each inode is claimed once; matched[] records the claim so
+ * unclaimed inodes can be reported as other_sockets.
+ */
+static void fossil_sys_hostinfo_socket_table(const char *path, fossil_sys_hostinfo_socket_table_t table,
+                                             const uint64_t *inodes, size_t count, unsigned char *matched,
+                                             fossil_sys_hostinfo_fd_inventory_t *info)
+{
+    char *text = fossil_sys_hostinfo_read_all(path);
+    if (!text)
+        return;
+    int inode_field = table == FOSSIL_SYS_HOSTINFO_SOCKET_UNIX ? 6 : 9;
+    for (const char *p = fossil_sys_hostinfo_next_line(text); *p; p = fossil_sys_hostinfo_next_line(p))
+    {
+        unsigned long state = strtoul(fossil_sys_hostinfo_skip_fields(p, 3), NULL, 16);
+        uint64_t inode = strtoull(fossil_sys_hostinfo_skip_fields(p, inode_field), NULL, 10);
+        if (inode == 0)
+            continue;
+        const uint64_t *hit = bsearch(&inode, inodes, count, sizeof(*inodes), fossil_sys_hostinfo_inode_cmp);
+        if (!hit || matched[hit - inodes])
+            continue;
+        matched[hit - inodes] = 1;
+
+        if (table == FOSSIL_SYS_HOSTINFO_SOCKET_UNIX)
+            info->unix_sockets++;
+        else if (table == FOSSIL_SYS_HOSTINFO_SOCKET_UDP)
+            info->udp++;
+        else if (state == 0x01)
+            info->tcp_established++;
+        else if (state == 0x0A)
+            info->tcp_listen++;
+        else if (state == 0x02 || state == 0x03)
+            info->tcp_syn++;
+        else if (state == 0x04 || state == 0x05 || state == 0x09 || state == 0x0B)
+            info->tcp_closing++;
+        else if (state == 0x08)
+            info->tcp_close_wait++;
+        else
+            info->tcp_other++;
+    }
+    free(text);
+}
+
+static uint64_t fossil_sys_hostinfo_nofile_limit(const char *proc)
+{
+    char path[64], buf[4096];
+    snprintf(path, sizeof(path), "%s/limits", proc);
+    if (fossil_sys_hostinfo_read_text(path, buf, sizeof(buf)) <= 0)
+        return 0;
+    const char *line = strstr(buf, "Max open files");
+    if (!line)
+        return 0;
+    line += strlen("Max open files");
+    while (*line == ' ')
+        ++line;
+    return (uint64_t)strtoull(line, NULL, 10); // "unlimited" parses as 0
+}
+#endif
+
+int fossil_sys_hostinfo_get_fd_inventory(int pid, fossil_sys_hostinfo_fd_inventory_t *info)
+{
+    if (!info || pid < 0)
+        return -1;
+    memset(info, 0, sizeof(*info));
+#if defined(__linux__)
+    char proc[32], path[64];
+    if (pid == 0)
+        snprintf(proc, sizeof(proc), "/proc/self");
+    else
+        snprintf(proc, sizeof(proc), "/proc/%d", pid);
+    snprintf(path, sizeof(path), "%s/fd", proc);
+
+    int dirfd_ = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd_ < 0)
+        return -3;
+    DIR *dir = fdopendir(dirfd_);
+    if (!dir)
+    {
+        close(dirfd_);
+        return -3;
+    }
+
+    // The listing's own descriptor shows up when inspecting ourselves
+    int self = pid == 0 || pid == (int)getpid();
+    size_t capacity = 0, count = 0;
+    uint64_t *inodes = NULL;
+    struct dirent *entry;
+    char target[PATH_MAX];
+    int rc = 0;
+    while (rc == 0 && (entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+            continue;
+        if (self && atoi(entry->d_name) == dirfd_)
+            continue;
+        ssize_t n = readlinkat(dirfd_, entry->d_name, target, sizeof(target) - 1);
+        if (n < 0)
+            continue; // closed while listing
+        target[n] = '\0';
+        info->total++;
+
+        if (target[0] == '/')
+        {
+            if (strncmp(target, "/dev/", 5) == 0 && strncmp(target, "/dev/shm/", 9) != 0)
+                info->devices++;
+            else
+                info->files++;
+        }
+        else if (strncmp(target, "socket:[", 8) == 0)
+        {
+            info->sockets++;
+            if (count == capacity)
+            {
+                size_t grown = capacity ? capacity * 2 : 256;
+                uint64_t *next = realloc(inodes, grown * sizeof(*inodes));
+                if (!next)
+                {
+                    rc = -3; // a partial inode list would undercount socket states
+                    break;
+                }
+                inodes = next;
+                capacity = grown;
+            }
+            inodes[count++] = strtoull(target + 8, NULL, 10);
+        }
+        else if (strncmp(target, "pipe:[", 6) == 0)
+            info->pipes++;
+        else if (strncmp(target, "anon_inode:", 11) == 0)
+            info->anon_inodes++;
+        else
+            info->other++;
+    }
+    closedir(dir);
+    info->limit = fossil_sys_hostinfo_nofile_limit(proc);
+
+    if (rc == 0 && count > 0)
+    {
+        qsort(inodes, count, sizeof(*inodes), fossil_sys_hostinfo_inode_cmp);
+        size_t unique = 1;
+        for (size_t i = 1; i < count; ++i)
+            if (inodes[i] != inodes[unique - 1])
+                inodes[unique++] = inodes[i];
+        count = unique;
+
+        unsigned char *matched = calloc(count, 1);
+        if (!matched)
+            rc = -3;
+        else
+        {
+            static const struct
+            {
+                const char *name;
+                fossil_sys_hostinfo_socket_table_t table;
+            } tables[] = {
+                {"tcp", FOSSIL_SYS_HOSTINFO_SOCKET_TCP},  {"tcp6", FOSSIL_SYS_HOSTINFO_SOCKET_TCP},
+                {"udp", FOSSIL_SYS_HOSTINFO_SOCKET_UDP},  {"udp6", FOSSIL_SYS_HOSTINFO_SOCKET_UDP},
+                {"unix", FOSSIL_SYS_HOSTINFO_SOCKET_UNIX},
+            };
+            for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t)
+            {
+                snprintf(path, sizeof(path), "%s/net/%s", proc, tables[t].name);
+                fossil_sys_hostinfo_socket_table(path, tables[t].table, inodes, count, matched, info);
+            }
+            for (size_t i = 0; i < count; ++i)
+                info->other_sockets += !matched[i];
+            free(matched);
+        }
+    }
+    free(inodes);
+    if (rc != 0)
+        memset(info, 0, sizeof(*info));
+    return rc;
+#else
+    (void)pid;
+    return -2;
+#endif
+}
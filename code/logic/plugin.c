@@ -0,0 +1,679 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2014
+ *
+ * Copyright (C) 2014-2025 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+// Must be defined before any header for inotify_init1 flags
+#define _GNU_SOURCE
+#endif
+
+#include "fossil/sys/plugin.h"
+#include "fossil/sys/hostinfo.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#define FOSSIL_SYS_PLUGIN_INOTIFY 1
+#endif
+#endif
+
+/* ============================================================================
+ * Synchronization
+ *
+ * Readers use the two-counter epoch scheme of the env snapshot: register in
+ * the current epoch, load the published table, leave. A retired version is
+ * unloaded once the epoch has advanced twice past its retirement with no
+ * readers left in the previous epoch. Writers serialize on a lock.
+ * ============================================================================
+ */
+
+#if defined(_WIN32) || defined(_WIN64)
+typedef volatile LONG fossil_sys_plugin_atomic_t;
+#define fossil_sys_plugin_atomic_inc(p) InterlockedIncrement(p)
+#define fossil_sys_plugin_atomic_dec(p) InterlockedDecrement(p)
+#define fossil_sys_plugin_atomic_dec_release(p) InterlockedDecrement(p)
+#define fossil_sys_plugin_atomic_load(p) InterlockedCompareExchange((p), 0, 0)
+#define fossil_sys_plugin_atomic_store(p, v) InterlockedExchange((p), (v))
+#define fossil_sys_plugin_load_ptr(p) InterlockedCompareExchangePointer((PVOID volatile *)(p), NULL, NULL)
+#define fossil_sys_plugin_store_ptr(p, v) InterlockedExchangePointer((PVOID volatile *)(p), (v))
+typedef SRWLOCK fossil_sys_plugin_lock_t;
+#define fossil_sys_plugin_lock_init(l) InitializeSRWLock(l)
+#define fossil_sys_plugin_lock_destroy(l) ((void)(l))
+#define fossil_sys_plugin_lock(l) AcquireSRWLockExclusive(l)
+#define fossil_sys_plugin_unlock(l) ReleaseSRWLockExclusive(l)
+#else
+typedef long fossil_sys_plugin_atomic_t;
+#define fossil_sys_plugin_atomic_inc(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_plugin_atomic_dec(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define fossil_sys_plugin_atomic_dec_release(p) __atomic_sub_fetch((p), 1, __ATOMIC_RELEASE)
+#define fossil_sys_plugin_atomic_load(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define fossil_sys_plugin_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+#define fossil_sys_plugin_load_ptr(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define fossil_sys_plugin_store_ptr(p, v) __atomic_store_n((p), (v), __ATOMIC_SEQ_CST)
+typedef pthread_mutex_t fossil_sys_plugin_lock_t;
+#define fossil_sys_plugin_lock_init(l) pthread_mutex_init((l), NULL)
+#define fossil_sys_plugin_lock_destroy(l) pthread_mutex_destroy(l)
+#define fossil_sys_plugin_lock(l) pthread_mutex_lock(l)
+#define fossil_sys_plugin_unlock(l) pthread_mutex_unlock(l)
+#endif
+
+/* ============================================================================
+ * Storage
+ * ============================================================================
+ */
+
+/* One loaded version; the public table is the first member. */
+typedef struct fossil_sys_plugin_version
+{
+    fossil_sys_plugin_table_t table;
+    struct fossil_sys_plugin_version *retired_next;
+    unsigned long retired_epoch;
+    uint64_t retired_ns;
+    fossil_sys_dynamic_lib_t lib;
+    char *copy_path; /* private copy the version was loaded from */
+    void *slots[];
+} fossil_sys_plugin_version_t;
+
+#define FOSSIL_SYS_PLUGIN_CACHE_LINE 64
+
+/* Readers of the two epoch parities bump different cache lines */
+typedef struct
+{
+    fossil_sys_plugin_atomic_t count;
+    char pad[FOSSIL_SYS_PLUGIN_CACHE_LINE - sizeof(fossil_sys_plugin_atomic_t)];
+} fossil_sys_plugin_counter_t;
+
+struct fossil_sys_plugin
+{
+    fossil_sys_plugin_version_t *current; /* published version */
+    fossil_sys_plugin_atomic_t epoch;
+    char pad0[FOSSIL_SYS_PLUGIN_CACHE_LINE];
+    fossil_sys_plugin_counter_t active[2]; /* readers per epoch parity */
+
+    /* Writer side, guarded by lock */
+    fossil_sys_plugin_lock_t lock;
+    char *path;
+    char *copy_dir; /* where version copies go, with trailing separator */
+    char **symbols;
+    size_t count;
+    uint64_t version;
+    uint64_t grace_ns;
+    fossil_sys_plugin_version_t *retired;
+    unsigned long copies; /* copy counter */
+
+    /* Change detection */
+    int watch_fd;
+    const char *watch_name; /* basename within path */
+    int64_t stat_mtime;
+    int64_t stat_size;
+};
+
+static char *fossil_sys_plugin_strdup(const char *s)
+{
+    size_t len = strlen(s) + 1;
+    char *copy = malloc(len);
+    if (copy)
+        memcpy(copy, s, len);
+    return copy;
+}
+
+static const char *fossil_sys_plugin_basename(const char *path)
+{
+    const char *base = path;
+    for (const char *p = path; *p; ++p)
+    {
+        if (*p == '/' || *p == '\\')
+            base = p + 1;
+    }
+    return base;
+}
+
+/* ============================================================================
+ * Version copies
+ * ============================================================================
+ */
+
+static unsigned long fossil_sys_plugin_pid(void)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    return (unsigned long)GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
+/*
+ * Directory for version copies: copy_dir if given, else the plugin's own
+ * directory, which must allow executable mappings anyway (unlike /tmp,
+ * often mounted noexec). Returned with a trailing separator.
+ */
+static char *fossil_sys_plugin_copy_dir(const char *path, const char *copy_dir)
+{
+    const char *dir = copy_dir;
+    size_t len = dir ? strlen(dir) : (size_t)(fossil_sys_plugin_basename(path) - path);
+    if (!dir)
+        dir = path;
+    if (len == 0)
+    {
+        /* A bare file name would make the loader search its path, not the cwd */
+        dir = "./";
+        len = 2;
+    }
+    char *out = malloc(len + 2);
+    if (!out)
+        return NULL;
+    memcpy(out, dir, len);
+    if (out[len - 1] != '/' && out[len - 1] != '\\')
+        out[len++] = '/';
+    out[len] = '\0';
+    return out;
+}
+
+/* Whether a process with this id still exists (assumed so when unsure) */
+static int fossil_sys_plugin_pid_alive(unsigned long pid)
+{
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+    if (!process)
+        return GetLastError() != ERROR_INVALID_PARAMETER;
+    DWORD state = WaitForSingleObject(process, 0);
+    CloseHandle(process);
+    return state != WAIT_OBJECT_0;
+#else
+    return kill((pid_t)pid, 0) == 0 || errno != ESRCH;
+#endif
+}
+
+/* Matches "fossil-plugin-<pid>-<n>-<base>" and returns the pid, 0 otherwise */
+static unsigned long fossil_sys_plugin_copy_owner(const char *name, const char *base)
+{
+    static const char prefix[] = "fossil-plugin-";
+    if (strncmp(name, prefix, sizeof(prefix) - 1) != 0)
+        return 0;
+    char *end;
+    unsigned long pid = strtoul(name + sizeof(prefix) - 1, &end, 10);
+    if (*end != '-')
+        return 0;
+    strtoul(end + 1, &end, 10);
+    if (*end != '-' || strcmp(end + 1, base) != 0)
+        return 0;
+    return pid;
+}
+
+/*
+ * Removes copies of this plugin left behind by processes that exited
+ * without closing it (crashes, kills). Copies of live processes are kept.
+ */
+static void fossil_sys_plugin_sweep(fossil_sys_plugin_t *plugin)
+{
+    const char *base = fossil_sys_plugin_basename(plugin->path);
+    unsigned long self = fossil_sys_plugin_pid();
+    char stale[1024];
+#if defined(_WIN32) || defined(_WIN64)
+    char pattern[1024];
+    snprintf(pattern, sizeof(pattern), "%sfossil-plugin-*", plugin->copy_dir);
+    WIN32_FIND_DATAA entry;
+    HANDLE find = FindFirstFileA(pattern, &entry);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        unsigned long pid = fossil_sys_plugin_copy_owner(entry.cFileName, base);
+        if (pid && pid != self && !fossil_sys_plugin_pid_alive(pid))
+        {
+            snprintf(stale, sizeof(stale), "%s%s", plugin->copy_dir, entry.cFileName);
+            DeleteFileA(stale);
+        }
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+#else
+    DIR *dir = opendir(plugin->copy_dir);
+    if (!dir)
+        return;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        unsigned long pid = fossil_sys_plugin_copy_owner(entry->d_name, base);
+        if (pid && pid != self && !fossil_sys_plugin_pid_alive(pid))
+        {
+            snprintf(stale, sizeof(stale), "%s%s", plugin->copy_dir, entry->d_name);
+            remove(stale);
+        }
+    }
+    closedir(dir);
+#endif
+}
+
+/*
+ * Copies the plugin file to a fresh, uniquely named file in the copy
+ * directory so the loader maps it as a new object. Caller holds the lock.
+ */
+static char *fossil_sys_plugin_copy(fossil_sys_plugin_t *plugin)
+{
+    const char *dir = plugin->copy_dir;
+    char path[1024];
+    for (int attempt = 0; attempt < 16; ++attempt)
+    {
+        snprintf(path, sizeof(path), "%sfossil-plugin-%lu-%lu-%s", dir, fossil_sys_plugin_pid(),
+                 ++plugin->copies, fossil_sys_plugin_basename(plugin->path));
+#if defined(_WIN32) || defined(_WIN64)
+        if (CopyFileA(plugin->path, path, TRUE))
+            return fossil_sys_plugin_strdup(path);
+        if (GetLastError() != ERROR_FILE_EXISTS)
+            return NULL;
+#else
+        int out = open(path, O_WRONLY | O_CREAT | O_EXCL, 0700);
+        if (out < 0)
+        {
+            if (errno == EEXIST)
+                continue;
+            return NULL;
+        }
+        int in = open(plugin->path, O_RDONLY);
+        int ok = in >= 0;
+        char buffer[65536];
+        while (ok)
+        {
+            ssize_t n = read(in, buffer, sizeof(buffer));
+            if (n <= 0)
+            {
+                ok = n == 0;
+                break;
+            }
+            for (ssize_t done = 0; ok && done < n;)
+            {
+                ssize_t w = write(out, buffer + done, (size_t)(n - done));
+                ok = w > 0;
+                done += w;
+            }
+        }
+        if (in >= 0)
+            close(in);
+        if (close(out) != 0)
+            ok = 0;
+        if (ok)
+            return fossil_sys_plugin_strdup(path);
+        remove(path);
+        return NULL;
+#endif
+    }
+    return NULL;
+}
+
+/* ============================================================================
+ * Versions
+ * ============================================================================
+ */
+
+static void fossil_sys_plugin_version_free(fossil_sys_plugin_version_t *version)
+{
+    if (fossil_sys_dynamic_is_loaded(&version->lib))
+        fossil_sys_dynamic_unload(&version->lib);
+    if (version->copy_path)
+    {
+        remove(version->copy_path);
+        free(version->copy_path);
+    }
+    free(version);
+}
+
+/* Loads a new version from a fresh copy. Caller holds the lock. */
+static fossil_sys_plugin_version_t *fossil_sys_plugin_version_load(fossil_sys_plugin_t *plugin)
+{
+    fossil_sys_plugin_version_t *version =
+        calloc(1, sizeof(*version) + plugin->count * sizeof(version->slots[0]));
+    if (!version)
+        return NULL;
+    version->table.count = plugin->count;
+    version->table.fns = version->slots;
+
+    version->copy_path = fossil_sys_plugin_copy(plugin);
+    if (!version->copy_path || !fossil_sys_dynamic_load(version->copy_path, &version->lib))
+    {
+        fossil_sys_plugin_version_free(version);
+        return NULL;
+    }
+
+    int ok = 1;
+    for (size_t i = 0; i < plugin->count && ok; ++i)
+    {
+        fossil_sys_dynamic_binding_t binding = {plugin->symbols[i], &version->slots[i]};
+        ok = fossil_sys_dynamic_bind(&version->lib, &binding, 1);
+    }
+    if (!ok)
+    {
+        fossil_sys_plugin_version_free(version);
+        return NULL;
+    }
+    return version;
+}
+
+/*
+ * Unloads retired versions no reader can still hold and advances the epoch.
+ * Never waits: a version held by a slow reader is freed by a later call.
+ * Caller holds the lock.
+ */
+static size_t fossil_sys_plugin_reclaim(fossil_sys_plugin_t *plugin)
+{
+    uint64_t now = plugin->grace_ns ? fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC) : 0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        unsigned long e = (unsigned long)fossil_sys_plugin_atomic_load(&plugin->epoch);
+        if (fossil_sys_plugin_atomic_load(&plugin->active[(e + 1) & 1].count) != 0)
+            break; /* readers from epoch e - 1 are still inside */
+
+        fossil_sys_plugin_version_t **link = &plugin->retired;
+        while (*link)
+        {
+            fossil_sys_plugin_version_t *version = *link;
+            if ((long)(e - 1 - version->retired_epoch) >= 0 && now - version->retired_ns >= plugin->grace_ns)
+            {
+                *link = version->retired_next;
+                fossil_sys_plugin_version_free(version);
+            }
+            else
+                link = &version->retired_next;
+        }
+        fossil_sys_plugin_atomic_store(&plugin->epoch, (long)(e + 1));
+    }
+
+    size_t retired = 0;
+    for (fossil_sys_plugin_version_t *version = plugin->retired; version; version = version->retired_next)
+        retired++;
+    return retired;
+}
+
+/* Publishes next in place of the current version. Caller holds the lock. */
+static void fossil_sys_plugin_publish(fossil_sys_plugin_t *plugin, fossil_sys_plugin_version_t *next)
+{
+    fossil_sys_plugin_version_t *old = plugin->current;
+    next->table.version = ++plugin->version;
+    fossil_sys_plugin_store_ptr(&plugin->current, next);
+    if (old)
+    {
+        old->retired_epoch = (unsigned long)fossil_sys_plugin_atomic_load(&plugin->epoch);
+        old->retired_ns = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+        old->retired_next = plugin->retired;
+        plugin->retired = old;
+    }
+    fossil_sys_plugin_reclaim(plugin);
+}
+
+/* ============================================================================
+ * Change detection
+ * ============================================================================
+ */
+
+/* Records the file's mtime and size; returns 1 if they changed. */
+static int fossil_sys_plugin_stat_changed(fossil_sys_plugin_t *plugin)
+{
+    struct stat st;
+    if (stat(plugin->path, &st) != 0)
+        return 0; /* mid-replace; try again later */
+    int changed = (int64_t)st.st_mtime != plugin->stat_mtime || (int64_t)st.st_size != plugin->stat_size;
+    plugin->stat_mtime = (int64_t)st.st_mtime;
+    plugin->stat_size = (int64_t)st.st_size;
+    return changed;
+}
+
+static void fossil_sys_plugin_watch_start(fossil_sys_plugin_t *plugin)
+{
+    plugin->watch_fd = -1;
+    plugin->watch_name = fossil_sys_plugin_basename(plugin->path);
+    fossil_sys_plugin_stat_changed(plugin);
+#if defined(FOSSIL_SYS_PLUGIN_INOTIFY)
+    char dir[1024];
+    size_t dir_len = (size_t)(plugin->watch_name - plugin->path);
+    if (dir_len >= sizeof(dir))
+        return;
+    if (dir_len == 0)
+        snprintf(dir, sizeof(dir), ".");
+    else
+        snprintf(dir, sizeof(dir), "%.*s", (int)dir_len, plugin->path);
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0)
+        return;
+    /* Watch the directory: deployments usually replace the file by rename */
+    if (inotify_add_watch(fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        close(fd);
+        return;
+    }
+    plugin->watch_fd = fd;
+#endif
+}
+
+/* Drains pending notifications; returns 1 if the plugin file changed. */
+static int fossil_sys_plugin_watch_changed(fossil_sys_plugin_t *plugin)
+{
+#if defined(FOSSIL_SYS_PLUGIN_INOTIFY)
+    if (plugin->watch_fd >= 0)
+    {
+        int changed = 0;
+        int overflow = 0;
+        char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        for (;;)
+        {
+            ssize_t n = read(plugin->watch_fd, buffer, sizeof(buffer));
+            if (n <= 0)
+                break;
+            for (char *p = buffer; p < buffer + n;)
+            {
+                const struct inotify_event *event = (const struct inotify_event *)p;
+                if (event->mask & IN_Q_OVERFLOW)
+                    overflow = 1;
+                else if (event->len && strcmp(event->name, plugin->watch_name) == 0)
+                    changed = 1;
+                p += sizeof(*event) + event->len;
+            }
+        }
+        /* Events were dropped, so only comparing mtime and size can tell */
+        if (overflow)
+            changed |= fossil_sys_plugin_stat_changed(plugin);
+        else if (changed)
+            fossil_sys_plugin_stat_changed(plugin);
+        return changed;
+    }
+#endif
+    return fossil_sys_plugin_stat_changed(plugin);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+fossil_sys_plugin_t *fossil_sys_plugin_open(const char *path, const char *const *symbols, size_t count)
+{
+    return fossil_sys_plugin_open_ex(path, symbols, count, NULL);
+}
+
+fossil_sys_plugin_t *fossil_sys_plugin_open_ex(const char *path, const char *const *symbols, size_t count,
+                                               const char *copy_dir)
+{
+    if (!path || !*path || (!symbols && count))
+        return NULL;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!symbols[i])
+            return NULL;
+    }
+
+    fossil_sys_plugin_t *plugin = calloc(1, sizeof(*plugin));
+    if (!plugin)
+        return NULL;
+    plugin->path = fossil_sys_plugin_strdup(path);
+    plugin->copy_dir = fossil_sys_plugin_copy_dir(path, copy_dir && *copy_dir ? copy_dir : NULL);
+    plugin->symbols = calloc(count ? count : 1, sizeof(*plugin->symbols));
+    int ok = plugin->path && plugin->copy_dir && plugin->symbols;
+    for (size_t i = 0; ok && i < count; ++i)
+    {
+        ok = (plugin->symbols[i] = fossil_sys_plugin_strdup(symbols[i])) != NULL;
+        plugin->count = i + 1;
+    }
+    fossil_sys_plugin_lock_init(&plugin->lock);
+    plugin->watch_fd = -1;
+
+    fossil_sys_plugin_version_t *first = NULL;
+    if (ok)
+    {
+        fossil_sys_plugin_sweep(plugin);
+        fossil_sys_plugin_watch_start(plugin);
+        first = fossil_sys_plugin_version_load(plugin);
+    }
+    if (!first)
+    {
+        fossil_sys_plugin_close(plugin);
+        return NULL;
+    }
+    fossil_sys_plugin_publish(plugin, first);
+    return plugin;
+}
+
+void fossil_sys_plugin_close(fossil_sys_plugin_t *plugin)
+{
+    if (!plugin)
+        return;
+    while (plugin->retired)
+    {
+        fossil_sys_plugin_version_t *version = plugin->retired;
+        plugin->retired = version->retired_next;
+        fossil_sys_plugin_version_free(version);
+    }
+    if (plugin->current)
+        fossil_sys_plugin_version_free(plugin->current);
+#if !defined(_WIN32) && !defined(_WIN64)
+    if (plugin->watch_fd >= 0)
+        close(plugin->watch_fd);
+#endif
+    for (size_t i = 0; i < plugin->count; ++i)
+        free(plugin->symbols[i]);
+    free(plugin->symbols);
+    free(plugin->copy_dir);
+    free(plugin->path);
+    fossil_sys_plugin_lock_destroy(&plugin->lock);
+    free(plugin);
+}
+
+const fossil_sys_plugin_table_t *fossil_sys_plugin_enter(fossil_sys_plugin_t *plugin, unsigned long *token)
+{
+    for (;;)
+    {
+        unsigned long e = (unsigned long)fossil_sys_plugin_atomic_load(&plugin->epoch);
+        fossil_sys_plugin_atomic_inc(&plugin->active[e & 1].count);
+        if ((unsigned long)fossil_sys_plugin_atomic_load(&plugin->epoch) == e)
+        {
+            *token = e;
+            const fossil_sys_plugin_version_t *version = fossil_sys_plugin_load_ptr(&plugin->current);
+            return &version->table;
+        }
+        fossil_sys_plugin_atomic_dec(&plugin->active[e & 1].count);
+    }
+}
+
+void fossil_sys_plugin_leave(fossil_sys_plugin_t *plugin, unsigned long token)
+{
+    fossil_sys_plugin_atomic_dec_release(&plugin->active[token & 1].count);
+}
+
+int fossil_sys_plugin_reload(fossil_sys_plugin_t *plugin)
+{
+    if (!plugin)
+        return -1;
+    fossil_sys_plugin_lock(&plugin->lock);
+    fossil_sys_plugin_version_t *next = fossil_sys_plugin_version_load(plugin);
+    if (next)
+        fossil_sys_plugin_publish(plugin, next);
+    else
+        fossil_sys_plugin_reclaim(plugin);
+    fossil_sys_plugin_unlock(&plugin->lock);
+    return next ? 1 : -3;
+}
+
+int fossil_sys_plugin_poll(fossil_sys_plugin_t *plugin)
+{
+    if (!plugin)
+        return -1;
+    fossil_sys_plugin_lock(&plugin->lock);
+    int rc = 0;
+    if (fossil_sys_plugin_watch_changed(plugin))
+    {
+        fossil_sys_plugin_version_t *next = fossil_sys_plugin_version_load(plugin);
+        if (next)
+        {
+            fossil_sys_plugin_publish(plugin, next);
+            rc = 1;
+        }
+        else
+            rc = -3;
+    }
+    fossil_sys_plugin_reclaim(plugin);
+    fossil_sys_plugin_unlock(&plugin->lock);
+    return rc;
+}
+
+size_t fossil_sys_plugin_collect(fossil_sys_plugin_t *plugin)
+{
+    if (!plugin)
+        return 0;
+    fossil_sys_plugin_lock(&plugin->lock);
+    size_t retired = fossil_sys_plugin_reclaim(plugin);
+    fossil_sys_plugin_unlock(&plugin->lock);
+    return retired;
+}
+
+void fossil_sys_plugin_set_grace(fossil_sys_plugin_t *plugin, uint64_t grace_ns)
+{
+    if (!plugin)
+        return;
+    fossil_sys_plugin_lock(&plugin->lock);
+    plugin->grace_ns = grace_ns;
+    fossil_sys_plugin_unlock(&plugin->lock);
+}
+
+uint64_t fossil_sys_plugin_version(fossil_sys_plugin_t *plugin)
+{
+    if (!plugin)
+        return 0;
+    const fossil_sys_plugin_version_t *version = fossil_sys_plugin_load_ptr(&plugin->current);
+    return version ? version->table.version : 0;
+}
+
+int fossil_sys_plugin_watch_fd(const fossil_sys_plugin_t *plugin)
+{
+    return plugin ? plugin->watch_fd : -1;
+}
@@ -0,0 +1,71 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_SYS_TEST_FIXTURE_LIBM_H
+#define FOSSIL_SYS_TEST_FIXTURE_LIBM_H
+
+#include "fossil/sys/framework.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Shared fixture: a private copy of libm
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Dynamic loading and plugin tests need a real shared
+// object that is not already mapped into the runner, so
+// they copy the system math library to a path of their own.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+#if defined(__linux__)
+static inline int fossil_test_fixture_find_libm(const fossil_sys_dynamic_module_t *module, void *user_data)
+{
+    if (!strstr(module->path, "libm.so"))
+        return 0;
+    snprintf((char *)user_data, 512, "%s", module->path);
+    return 1;
+}
+
+// Copies the system math library to path. Returns 1 on success, 0 otherwise.
+static inline int fossil_test_fixture_install_libm(const char *path)
+{
+    char source[512] = "";
+    fossil_sys_dynamic_lib_t libm;
+    memset(&libm, 0, sizeof(libm));
+    if (!fossil_sys_dynamic_load("libm.so.6", &libm))
+        return 0;
+    fossil_sys_dynamic_enumerate(fossil_test_fixture_find_libm, source);
+    fossil_sys_dynamic_unload(&libm);
+    if (!source[0])
+        return 0;
+
+    FILE *in = fopen(source, "rb");
+    FILE *out = fopen(path, "wb");
+    int ok = in && out;
+    char buffer[4096];
+    size_t n;
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        ok = fwrite(buffer, 1, n, out) == n;
+    if (in)
+    {
+        ok = ok && !ferror(in);
+        fclose(in);
+    }
+    if (out && fclose(out) != 0)
+        ok = 0;
+    if (!ok)
+        remove(path);
+    return ok;
+}
+#endif
+
+#endif /* FOSSIL_SYS_TEST_FIXTURE_LIBM_H */
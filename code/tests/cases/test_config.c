@@ -0,0 +1,310 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+
+#include "fossil/sys/framework.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Define the test suite and add test cases
+FOSSIL_SUITE(c_config_suite);
+
+// Setup function for the test suite
+FOSSIL_SETUP(c_config_suite)
+{
+    // Setup code here
+}
+
+// Teardown function for the test suite
+FOSSIL_TEARDOWN(c_config_suite)
+{
+    // Teardown code here
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+static void write_config_file(const char *path, const char *text)
+{
+    FILE *file = fopen(path, "w");
+    if (file)
+    {
+        fputs(text, file);
+        fclose(file);
+    }
+}
+
+// ** Test typed parsing of default values **
+FOSSIL_TEST(c_test_config_defaults)
+{
+    fossil_sys_config_set_default("test.config.workers", "0x10");
+    fossil_sys_config_set_default("test.config.verbose", "Yes");
+    fossil_sys_config_set_default("test.config.timeout", "1m30s");
+    fossil_sys_config_set_default("test.config.poll", "250");
+    fossil_sys_config_set_default("test.config.cache", "64MiB");
+    fossil_sys_config_set_default("test.config.ratio", "0.5");
+
+    fossil_sys_config_handle_t *workers = fossil_sys_config_handle("test.config.workers");
+    ASSUME_NOT_CNULL(workers);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_source(workers), (int)FOSSIL_SYS_CONFIG_SOURCE_DEFAULT);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(workers, -1), 16);
+    ASSUME_ITS_TRUE(fossil_sys_config_bool(fossil_sys_config_handle("test.config.verbose"), 0));
+    ASSUME_ITS_EQUAL_U64(fossil_sys_config_duration_ns(fossil_sys_config_handle("test.config.timeout"), 0), 90000000000ULL);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_config_duration_ns(fossil_sys_config_handle("test.config.poll"), 0), 250000000ULL);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_config_size(fossil_sys_config_handle("test.config.cache"), 0), 64ULL << 20);
+    ASSUME_ITS_TRUE(fossil_sys_config_double(fossil_sys_config_handle("test.config.ratio"), 0.0) == 0.5);
+
+    // A trailing amount without a unit is rejected, not dropped
+    fossil_sys_config_set_default("test.config.partial", "1m30");
+    ASSUME_ITS_EQUAL_U64(fossil_sys_config_duration_ns(fossil_sys_config_handle("test.config.partial"), 7), 7);
+
+    // Values that do not parse fall back
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(fossil_sys_config_handle("test.config.cache"), -1), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_bool(workers, 7), 7);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_config_get("test.config.missing", "none"), "none");
+
+    fossil_sys_config_shutdown();
+}
+
+// ** Test file layer, env override and reload **
+FOSSIL_TEST(c_test_config_layers)
+{
+    const char *path = "fossil_sys_config_test.ini";
+    write_config_file(path, "# comment\nlevel = debug\n[test.config]\nport = 8080\nname = \"svc\"\n");
+    fossil_sys_config_set_default("test.config.port", "80");
+
+    fossil_sys_config_handle_t *port = fossil_sys_config_handle("test.config.port");
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(port, 0), 80);
+
+    fossil_sys_event_init();
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_load_file(path), 0);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(port, 0), 8080);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_source(port), (int)FOSSIL_SYS_CONFIG_SOURCE_FILE);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_config_get("test.config.name", ""), "svc");
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_config_get("level", ""), "debug");
+
+    fossil_sys_event_t event;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 1);
+    ASSUME_ITS_EQUAL_CSTR(event.id, FOSSIL_SYS_CONFIG_EVENT_RELOAD);
+    ASSUME_ITS_EQUAL_SIZE(event.size, sizeof(fossil_sys_config_reload_event_t));
+    fossil_sys_config_reload_event_t *reload = (fossil_sys_config_reload_event_t *)event.payload;
+    ASSUME_ITS_EQUAL_U64(reload->generation, fossil_sys_config_generation());
+
+    // A reload that changes nothing posts nothing
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_reload(), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_event_poll(&event), 0);
+
+    // The environment overrides the file, the handle stays the same
+    fossil_sys_env_set("TEST_CONFIG_PORT", "9090");
+    write_config_file(path, "[test.config]\nport = 8181\n");
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_reload(), 0);
+    ASSUME_ITS_TRUE(fossil_sys_config_handle("test.config.port") == port);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(port, 0), 9090);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_source(port), (int)FOSSIL_SYS_CONFIG_SOURCE_ENV);
+
+    fossil_sys_env_set("TEST_CONFIG_PORT", NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_reload(), 0);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(port, 0), 8181);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_config_get("test.config.name", "gone"), "gone");
+
+    remove(path);
+    fossil_sys_event_shutdown();
+    fossil_sys_config_shutdown();
+}
+
+// ** Test that a reload reports an event it could not post **
+FOSSIL_TEST(c_test_config_reload_queue_full)
+{
+    const char *path = "fossil_sys_config_full.ini";
+    write_config_file(path, "test.config.full = 1\n");
+    fossil_sys_event_init();
+    int loaded = fossil_sys_config_load_file(path);
+    while (fossil_sys_event_post("test.config.filler", NULL, 0) == 0)
+        ;
+
+    int unchanged = fossil_sys_config_reload();
+    write_config_file(path, "test.config.full = 2\n");
+    int full = fossil_sys_config_reload();
+    int64_t value = fossil_sys_config_int(fossil_sys_config_handle("test.config.full"), 0);
+
+    remove(path);
+    fossil_sys_event_shutdown();
+    fossil_sys_config_shutdown();
+
+    ASSUME_ITS_EQUAL_I32(loaded, 0);
+    ASSUME_ITS_EQUAL_I32(unchanged, 0); // nothing to post
+    ASSUME_ITS_EQUAL_I32(full, -3);
+    ASSUME_ITS_EQUAL_I32((int)value, 2); // the new value still applies
+}
+
+// ** Test that long lines are kept whole **
+FOSSIL_TEST(c_test_config_long_line)
+{
+    const char *path = "fossil_sys_config_long.ini";
+    enum { VALUE_LEN = 3000 };
+    char *text = malloc(VALUE_LEN + 64);
+    ASSUME_NOT_CNULL(text);
+    int n = snprintf(text, 64, "test.config.long = ");
+    memset(text + n, 'x', VALUE_LEN);
+    snprintf(text + n + VALUE_LEN, 64, "9\ntest.config.after = 1\n");
+    write_config_file(path, text);
+    free(text);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_load_file(path), 0);
+    const char *value = fossil_sys_config_get("test.config.long", "");
+    ASSUME_ITS_EQUAL_SIZE(strlen(value), VALUE_LEN + 1);
+    ASSUME_ITS_TRUE(value[VALUE_LEN] == '9');
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_int(fossil_sys_config_handle("test.config.after"), 0), 1);
+
+    remove(path);
+    fossil_sys_config_shutdown();
+}
+
+// ** Test fossil_sys_config_string_copy **
+FOSSIL_TEST(c_test_config_string_copy)
+{
+    fossil_sys_config_set_default("test.config.copy", "0123456789");
+    fossil_sys_config_handle_t *copy = fossil_sys_config_handle("test.config.copy");
+    char buf[8];
+    int full = fossil_sys_config_string_copy(copy, NULL, 0);
+    int truncated = fossil_sys_config_string_copy(copy, buf, sizeof(buf));
+    fossil_sys_config_set_default("test.config.copy", NULL);
+    int unset = fossil_sys_config_string_copy(copy, buf, sizeof(buf));
+    int invalid = fossil_sys_config_string_copy(copy, NULL, sizeof(buf));
+    fossil_sys_config_shutdown();
+
+    ASSUME_ITS_EQUAL_I32(full, 10);
+    ASSUME_ITS_EQUAL_I32(truncated, 10);
+    ASSUME_ITS_EQUAL_CSTR(buf, "0123456"); // truncated, still terminated
+    ASSUME_ITS_EQUAL_I32(unset, -1);
+    ASSUME_ITS_EQUAL_I32(invalid, -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_string_copy(NULL, NULL, 0), -1);
+}
+
+#if defined(__linux__)
+typedef struct
+{
+    fossil_sys_config_handle_t *text;
+    fossil_sys_config_handle_t *number;
+    int stop;
+    int ready;
+    unsigned long reads;
+    unsigned long errors;
+} test_config_shared_t;
+
+// Reads values the writer keeps replacing; every value must be whole
+static void *test_config_reader(void *arg)
+{
+    test_config_shared_t *shared = (test_config_shared_t *)arg;
+    unsigned long reads = 0;
+    unsigned long errors = 0;
+    char buf[64];
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE))
+    {
+        int n = fossil_sys_config_string_copy(shared->text, buf, sizeof(buf));
+        if (n < 0 || strncmp(buf, "value-", 6) != 0 || (size_t)n != strlen(buf))
+            errors++;
+        if (fossil_sys_config_int(shared->number, -1) < 0)
+            errors++;
+        if (reads++ == 0)
+            __atomic_add_fetch(&shared->ready, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_add_fetch(&shared->reads, reads, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&shared->errors, errors, __ATOMIC_RELAXED);
+    return NULL;
+}
+#endif
+
+// ** Test reads while replaced values are reclaimed **
+FOSSIL_TEST(c_test_config_threads)
+{
+#if defined(__linux__)
+    enum { READERS = 4, WRITES = 2000 };
+    fossil_sys_config_set_default("test.config.mt.text", "value-0");
+    fossil_sys_config_set_default("test.config.mt.number", "0");
+
+    test_config_shared_t shared = {fossil_sys_config_handle("test.config.mt.text"),
+                                   fossil_sys_config_handle("test.config.mt.number"), 0, 0, 0, 0};
+    pthread_t readers[READERS];
+    int started = 0;
+    while (started < READERS && pthread_create(&readers[started], NULL, test_config_reader, &shared) == 0)
+        started++;
+    // Write only once every reader is reading, and let them run in between
+    while (__atomic_load_n(&shared.ready, __ATOMIC_ACQUIRE) < started)
+        sched_yield();
+
+    char text[32];
+    for (int i = 1; i <= WRITES; ++i)
+    {
+        snprintf(text, sizeof(text), "value-%d", i);
+        fossil_sys_config_set_default("test.config.mt.text", text);
+        snprintf(text, sizeof(text), "%d", i);
+        fossil_sys_config_set_default("test.config.mt.number", text);
+        if (i % 64 == 0)
+            sched_yield();
+    }
+    __atomic_store_n(&shared.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; ++i)
+        pthread_join(readers[i], NULL);
+
+    int64_t last = fossil_sys_config_int(shared.number, -1);
+    fossil_sys_config_shutdown();
+
+    ASSUME_ITS_EQUAL_I32(started, READERS);
+    ASSUME_ITS_EQUAL_I32((int)last, WRITES);
+    ASSUME_ITS_TRUE(shared.reads > 0);
+    ASSUME_ITS_EQUAL_U64(shared.errors, 0);
+#endif
+}
+
+// ** Test invalid arguments **
+FOSSIL_TEST(c_test_config_invalid)
+{
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_set_default(NULL, "x"), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_load_file(NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_config_load_file("fossil_sys_config_missing.ini"), -3);
+    ASSUME_ITS_TRUE(fossil_sys_config_handle(NULL) == NULL);
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_config_source(NULL), (int)FOSSIL_SYS_CONFIG_SOURCE_NONE);
+    fossil_sys_config_shutdown();
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_config_tests)
+{
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_defaults);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_layers);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_reload_queue_full);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_long_line);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_string_copy);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_threads);
+    FOSSIL_ADD_TEST(c_config_suite, c_test_config_invalid);
+
+    FOSSIL_ADD_SUITE(c_config_suite);
+}
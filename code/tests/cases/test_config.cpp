@@ -0,0 +1,72 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+
+#include "fossil/sys/framework.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Define the test suite and add test cases
+FOSSIL_SUITE(cpp_config_suite);
+
+// Setup function for the test suite
+FOSSIL_SETUP(cpp_config_suite)
+{
+    // Setup code here
+}
+
+// Teardown function for the test suite
+FOSSIL_TEARDOWN(cpp_config_suite)
+{
+    // Teardown code here
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// ** Test fossil::sys::Config typed getters **
+FOSSIL_TEST(cpp_test_config_wrapper)
+{
+    fossil::sys::Config::set_default("test.config.cpp.retries", "3");
+    fossil::sys::Config::set_default("test.config.cpp.enabled", "off");
+    fossil::sys::Config::set_default("test.config.cpp.interval", "1.5s");
+    fossil::sys::Config::set_default("test.config.cpp.buffer", "4K");
+
+    ASSUME_ITS_EQUAL_I32((int)fossil::sys::Config::get_int("test.config.cpp.retries", 0), 3);
+    ASSUME_ITS_FALSE(fossil::sys::Config::get_bool("test.config.cpp.enabled", true));
+    ASSUME_ITS_EQUAL_U64(fossil::sys::Config::get_duration_ns("test.config.cpp.interval", 0), 1500000000ULL);
+    ASSUME_ITS_EQUAL_U64(fossil::sys::Config::get_size("test.config.cpp.buffer", 0), 4096ULL);
+    ASSUME_ITS_EQUAL_CSTR(fossil::sys::Config::get("test.config.cpp.missing", "fallback").c_str(), "fallback");
+
+    fossil_sys_config_shutdown();
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_config_tests)
+{
+    FOSSIL_ADD_TEST(cpp_config_suite, cpp_test_config_wrapper);
+
+    FOSSIL_ADD_SUITE(cpp_config_suite);
+}
@@ -14,6 +14,7 @@
 #include <fossil/maip/framework.h>
 
 #include "fossil/sys/framework.h"
+#include "fixture_libm.h"
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -133,6 +134,188 @@ FOSSIL_TEST(c_test_dynamic_error)
     ASSUME_NOT_CNULL(error);
 }
 
+// ** Test symbol cache and bulk binding against the math library **
+FOSSIL_TEST(c_test_dynamic_bind)
+{
+#if defined(__linux__)
+    fossil_sys_dynamic_lib_t lib = {0};
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_load("libm.so.6", &lib));
+
+    void *first = fossil_sys_dynamic_symbol(&lib, "cos");
+    ASSUME_NOT_CNULL(first);
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_symbol(&lib, "cos") == first);
+
+    // Bind into void * slots, then convert to the function pointer types
+    void *sym_cos = NULL, *sym_sqrt = NULL;
+    fossil_sys_dynamic_binding_t table[] = {
+        {"cos", &sym_cos},
+        {"sqrt", &sym_sqrt},
+    };
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_bind(&lib, table, 2));
+    double (*fn_cos)(double) = NULL;
+    double (*fn_sqrt)(double) = NULL;
+    memcpy(&fn_cos, &sym_cos, sizeof(fn_cos));
+    memcpy(&fn_sqrt, &sym_sqrt, sizeof(fn_sqrt));
+    ASSUME_ITS_TRUE(fn_sqrt(16.0) == 4.0);
+    ASSUME_ITS_TRUE(fn_cos(0.0) == 1.0);
+
+    void *missing = &lib;
+    fossil_sys_dynamic_binding_t partial[] = {
+        {"sqrt", &sym_sqrt},
+        {"fossil_no_such_symbol", &missing},
+    };
+    ASSUME_ITS_FALSE(fossil_sys_dynamic_bind(&lib, partial, 2));
+    ASSUME_NOT_CNULL(sym_sqrt);
+    ASSUME_ITS_CNULL(missing);
+    ASSUME_NOT_CNULL(strstr(fossil_sys_dynamic_error(), "fossil_no_such_symbol"));
+
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_unload(&lib));
+    ASSUME_ITS_CNULL(lib.cache);
+#endif
+}
+
+#if defined(__linux__)
+typedef struct
+{
+    unsigned libm_refs;
+    int modules;
+} test_dynamic_modules_t;
+
+static int test_dynamic_module_cb(const fossil_sys_dynamic_module_t *module, void *user_data)
+{
+    test_dynamic_modules_t *seen = (test_dynamic_modules_t *)user_data;
+    seen->modules++;
+    if (strstr(module->path, "libm.so"))
+        seen->libm_refs = module->refs;
+    return 0;
+}
+#endif
+
+// ** Test the loaded-library registry **
+FOSSIL_TEST(c_test_dynamic_registry)
+{
+#if defined(__linux__)
+    size_t before = fossil_sys_dynamic_registry_count();
+    fossil_sys_dynamic_lib_t a = {0};
+    fossil_sys_dynamic_lib_t b = {0};
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_load("libm.so.6", &a));
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_load("libm.so.6", &b));
+
+    // Paths are owned by the registry and shared between loads
+    ASSUME_ITS_EQUAL_CSTR(a.path, "libm.so.6");
+    ASSUME_ITS_TRUE(a.path == b.path);
+    ASSUME_ITS_TRUE(a.handle == b.handle);
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_dynamic_registry_count(), before + 1);
+
+    test_dynamic_modules_t seen = {0, 0};
+    int visited = fossil_sys_dynamic_enumerate(test_dynamic_module_cb, &seen);
+    ASSUME_ITS_TRUE(visited > 0);
+    ASSUME_ITS_EQUAL_I32(visited, seen.modules);
+    ASSUME_ITS_EQUAL_I32((int)seen.libm_refs, 2);
+
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_unload(&a));
+    ASSUME_ITS_CNULL(a.path);
+    ASSUME_NOT_CNULL(fossil_sys_dynamic_symbol(&b, "sqrt"));
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_unload(&b));
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_dynamic_registry_count(), before);
+#endif
+    ASSUME_ITS_EQUAL_I32(fossil_sys_dynamic_enumerate(NULL, NULL), -1);
+}
+
+// ** Test load flags and link-map namespaces **
+FOSSIL_TEST(c_test_dynamic_load_ex)
+{
+#if defined(__linux__) && defined(__GLIBC__)
+    fossil_sys_dynamic_lib_t lazy = {0};
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_load_ex("libm.so.6", FOSSIL_SYS_DYNAMIC_LAZY | FOSSIL_SYS_DYNAMIC_GLOBAL,
+                                               FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT, &lazy));
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_dynamic_namespace(&lazy), 0);
+    double (*fn_sqrt)(double) = (double (*)(double))fossil_sys_dynamic_symbol(&lazy, "sqrt");
+    ASSUME_ITS_TRUE(fn_sqrt && fn_sqrt(4.0) == 2.0);
+
+    // A private namespace gets its own copy of the library
+    fossil_sys_dynamic_lib_t isolated = {0};
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_load_ex("libm.so.6", FOSSIL_SYS_DYNAMIC_NOW, FOSSIL_SYS_DYNAMIC_NAMESPACE_NEW,
+                                               &isolated));
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_namespace(&isolated) > 0);
+    ASSUME_ITS_TRUE(isolated.handle != lazy.handle);
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_symbol(&isolated, "sqrt") != (void *)fn_sqrt);
+
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_unload(&isolated));
+    ASSUME_ITS_TRUE(fossil_sys_dynamic_unload(&lazy));
+#endif
+    ASSUME_ITS_EQUAL_I32((int)fossil_sys_dynamic_namespace(NULL), -1);
+}
+
+#if defined(__linux__)
+static int test_dynamic_promote_cb(const fossil_sys_dynamic_module_t *module, void *user_data)
+{
+    if (strstr(module->path, "fossil_sys_dynamic_promote"))
+        ++*(int *)user_data;
+    return 0;
+}
+#endif
+
+// ** Test that promoting a lazy load does not pin the library **
+FOSSIL_TEST(c_test_dynamic_promote_unmaps)
+{
+#if defined(__linux__) && defined(__GLIBC__)
+    const char *path = "./fossil_sys_dynamic_promote.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+
+    fossil_sys_dynamic_lib_t lazy = {0};
+    fossil_sys_dynamic_lib_t eager = {0};
+    bool ok = fossil_sys_dynamic_load_ex(path, FOSSIL_SYS_DYNAMIC_LAZY, FOSSIL_SYS_DYNAMIC_NAMESPACE_DEFAULT, &lazy);
+    // The eager load misses the lazy record, reopens and promotes it
+    ok = ok && fossil_sys_dynamic_load(path, &eager);
+    ASSUME_ITS_TRUE(ok);
+    ASSUME_ITS_TRUE(lazy.handle == eager.handle);
+    int mapped = 0;
+    fossil_sys_dynamic_enumerate(test_dynamic_promote_cb, &mapped);
+    ASSUME_ITS_EQUAL_I32(mapped, 1);
+
+    fossil_sys_dynamic_unload(&eager);
+    fossil_sys_dynamic_unload(&lazy);
+    remove(path);
+    // Every loader reference was returned, so the object is unmapped
+    mapped = 0;
+    fossil_sys_dynamic_enumerate(test_dynamic_promote_cb, &mapped);
+    ASSUME_ITS_EQUAL_I32(mapped, 0);
+#endif
+}
+
+// ** Test loading several libraries through worker threads **
+FOSSIL_TEST(c_test_dynamic_preload)
+{
+#if defined(__linux__)
+    enum { PRELOAD_LIBS = 4 };
+    // Distinct files so every load maps a new object
+    char names[PRELOAD_LIBS][64];
+    const char *paths[PRELOAD_LIBS];
+    int installed = 0;
+    for (int i = 0; i < PRELOAD_LIBS; ++i)
+    {
+        snprintf(names[i], sizeof(names[i]), "./fossil_sys_dynamic_preload_%d.so", i);
+        paths[i] = names[i];
+        installed += fossil_test_fixture_install_libm(names[i]);
+    }
+
+    fossil_sys_dynamic_lib_t libs[PRELOAD_LIBS] = {{0}};
+    size_t loaded = installed == PRELOAD_LIBS ? fossil_sys_dynamic_preload(paths, PRELOAD_LIBS, FOSSIL_SYS_DYNAMIC_LAZY, 2, libs) : 0;
+    int resolved = 0;
+    for (int i = 0; i < PRELOAD_LIBS; ++i)
+    {
+        resolved += fossil_sys_dynamic_symbol(&libs[i], "sqrt") != NULL;
+        fossil_sys_dynamic_unload(&libs[i]);
+        remove(paths[i]);
+    }
+    ASSUME_ITS_EQUAL_I32(installed, PRELOAD_LIBS);
+    ASSUME_ITS_EQUAL_SIZE(loaded, PRELOAD_LIBS);
+    ASSUME_ITS_EQUAL_I32(resolved, PRELOAD_LIBS);
+#endif
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_dynamic_preload(NULL, 1, 0, 0, NULL), 0);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -147,6 +330,11 @@ FOSSIL_TEST_GROUP(c_dynamic_tests)
     FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_is_loaded);
     FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_is_loaded_null);
     FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_error);
+    FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_bind);
+    FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_registry);
+    FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_load_ex);
+    FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_promote_unmaps);
+    FOSSIL_ADD_TEST(c_dynamic_suite, c_test_dynamic_preload);
 
     FOSSIL_ADD_SUITE(c_dynamic_suite);
 }
@@ -125,6 +125,56 @@ FOSSIL_TEST(cpp_test_dynamic_error)
     ASSUME_NOT_CNULL(err);
 }
 
+FOSSIL_TEST(cpp_test_dynamic_bind)
+{
+#if defined(__linux__)
+    fossil::sys::Dynamic lib("libm.so.6");
+    ASSUME_ITS_TRUE(lib.is_loaded());
+
+    auto fn_sqrt = lib.bind<double(double)>("sqrt");
+    ASSUME_ITS_TRUE(fn_sqrt != nullptr);
+    ASSUME_ITS_TRUE(fn_sqrt(9.0) == 3.0);
+
+    double (*fn_missing)(double) = nullptr;
+    ASSUME_ITS_FALSE(lib.bind("fossil_no_such_symbol", fn_missing));
+    ASSUME_ITS_TRUE(fn_missing == nullptr);
+#endif
+}
+
+FOSSIL_TEST(cpp_test_dynamic_registry)
+{
+#if defined(__linux__)
+    fossil::sys::Dynamic first("libm.so.6");
+    fossil::sys::Dynamic second("libm.so.6");
+    ASSUME_ITS_TRUE(first.raw()->handle == second.raw()->handle);
+
+    unsigned refs = 0;
+    fossil::sys::Dynamic::enumerate([&](const fossil_sys_dynamic_module_t &module) {
+        if (strstr(module.path, "libm.so"))
+        {
+            refs = module.refs;
+            return false;
+        }
+        return true;
+    });
+    ASSUME_ITS_EQUAL_I32((int)refs, 2);
+#endif
+}
+
+FOSSIL_TEST(cpp_test_dynamic_load_flags)
+{
+#if defined(__linux__)
+    fossil::sys::Dynamic lib;
+    ASSUME_ITS_TRUE(lib.load("libm.so.6", FOSSIL_SYS_DYNAMIC_LAZY));
+    ASSUME_ITS_TRUE(lib.bind<double(double)>("sqrt")(81.0) == 9.0);
+
+    auto libs = fossil::sys::Dynamic::preload({"libm.so.6", "fossil_missing_library.so"}, FOSSIL_SYS_DYNAMIC_LAZY);
+    ASSUME_ITS_EQUAL_SIZE(libs.size(), 2);
+    ASSUME_ITS_TRUE(libs[0].is_loaded());
+    ASSUME_ITS_FALSE(libs[1].is_loaded());
+#endif
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -141,6 +191,9 @@ FOSSIL_TEST_GROUP(cpp_dynamic_tests)
     FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_move_ctor);
     FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_move_assign);
     FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_error);
+    FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_bind);
+    FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_registry);
+    FOSSIL_ADD_TEST(cpp_dynamic_suite, cpp_test_dynamic_load_flags);
 
     FOSSIL_ADD_SUITE(cpp_dynamic_suite);
 }
@@ -15,6 +15,11 @@
 
 #include "fossil/sys/framework.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -170,6 +175,324 @@ FOSSIL_TEST(c_test_env_foreach)
     ASSUME_ITS_TRUE(count > 0);
 }
 
+// ** Test container-aware canonical keys **
+FOSSIL_TEST(c_test_env_effective_resources)
+{
+    int cpus = fossil_sys_env_get_int("fossil.sys.cpu_effective", 0);
+    ASSUME_ITS_TRUE(cpus >= 1);
+    ASSUME_ITS_TRUE(cpus == fossil_sys_hostinfo_effective_cpus());
+
+    const char *memory = fossil_sys_env_get("fossil.sys.memory_effective");
+    ASSUME_NOT_CNULL(memory);
+    ASSUME_ITS_TRUE(strtoull(memory, NULL, 10) > 0);
+}
+
+// ** Test canonical key mapping round trip and near-miss keys **
+FOSSIL_TEST(c_test_env_canonical_mapping)
+{
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_set("fossil.app.version", "1.2.3"), 0);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("FOSSIL_APP_VERSION"), "1.2.3");
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("fossil.app.version"), "1.2.3");
+    fossil_sys_env_set("fossil.app.version", NULL);
+    ASSUME_ITS_TRUE(fossil_sys_env_get("fossil.app.version") == NULL);
+
+    // Same length and domain as canonical keys, but not canonical
+    ASSUME_ITS_TRUE(fossil_sys_env_get("fossil.sys.nope") == NULL);
+    ASSUME_ITS_TRUE(fossil_sys_env_get("fossil.sys.page_sizX") == NULL);
+}
+
+// ** Test the environment snapshot **
+FOSSIL_TEST(c_test_env_snapshot)
+{
+    const char *path = fossil_sys_env_get("PATH");
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_snapshot_enable(), 0);
+    ASSUME_ITS_TRUE(fossil_sys_env_snapshot_enabled());
+    if (path)
+        ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("PATH"), path);
+
+    char key[32];
+    for (int i = 0; i < 200; ++i)
+    {
+        snprintf(key, sizeof(key), "FOSSIL_SNAPSHOT_%d", i);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_env_set(key, key), 0);
+    }
+    for (int i = 0; i < 200; i += 2)
+    {
+        snprintf(key, sizeof(key), "FOSSIL_SNAPSHOT_%d", i);
+        fossil_sys_env_set(key, NULL);
+    }
+    for (int i = 0; i < 200; ++i)
+    {
+        snprintf(key, sizeof(key), "FOSSIL_SNAPSHOT_%d", i);
+        if (i % 2)
+            ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get(key), key);
+        else
+            ASSUME_ITS_TRUE(fossil_sys_env_get(key) == NULL);
+    }
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("fossil.sys.name"), fossil_sys_env_get("fossil.sys.name"));
+
+    // Without mirroring the process environment is left untouched
+    fossil_sys_env_snapshot_disable();
+    ASSUME_ITS_FALSE(fossil_sys_env_snapshot_enabled());
+    ASSUME_ITS_TRUE(fossil_sys_env_get("FOSSIL_SNAPSHOT_1") == NULL);
+}
+
+// ** Test snapshot versions and mirroring into the process environment **
+FOSSIL_TEST(c_test_env_snapshot_mirror)
+{
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_snapshot_version(), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_snapshot_enable(), 0);
+    uint64_t version = fossil_sys_env_snapshot_version();
+    ASSUME_ITS_TRUE(version > 0);
+
+    char first[8];
+    fossil_sys_env_set("FOSSIL_SNAPSHOT_MIRROR", "one");
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_get_copy("FOSSIL_SNAPSHOT_MIRROR", first, sizeof(first)), 3);
+    fossil_sys_env_set("FOSSIL_SNAPSHOT_MIRROR", "two");
+    ASSUME_ITS_EQUAL_CSTR(first, "one"); // copies outlive later sets
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("FOSSIL_SNAPSHOT_MIRROR"), "two");
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_snapshot_version(), version + 2);
+
+    fossil_sys_env_snapshot_mirror(1);
+    fossil_sys_env_set("FOSSIL_SNAPSHOT_MIRROR", "three");
+    fossil_sys_env_snapshot_mirror(0);
+    fossil_sys_env_snapshot_disable();
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_get("FOSSIL_SNAPSHOT_MIRROR"), "three");
+    fossil_sys_env_set("FOSSIL_SNAPSHOT_MIRROR", NULL);
+}
+
+// ** Test fossil_sys_env_get_copy **
+FOSSIL_TEST(c_test_env_get_copy)
+{
+    char buf[8];
+    fossil_sys_env_set("FOSSIL_COPY_TEST", "abcdefghij");
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_get_copy("FOSSIL_COPY_TEST", buf, sizeof(buf)), 10);
+    ASSUME_ITS_EQUAL_CSTR(buf, "abcdefg"); // truncated, still terminated
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_get_copy("FOSSIL_COPY_TEST", NULL, 0), 10);
+    fossil_sys_env_set("FOSSIL_COPY_TEST", NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_get_copy("FOSSIL_COPY_TEST", buf, sizeof(buf)), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_get_copy(NULL, buf, sizeof(buf)), -1);
+    ASSUME_ITS_TRUE(fossil_sys_env_get_copy("fossil.sys.name", buf, sizeof(buf)) > 0);
+}
+
+#if defined(__linux__)
+typedef struct
+{
+    int stop;
+    int ready;
+    unsigned long reads;
+    unsigned long errors;
+} test_env_shared_t;
+
+// Reads keys the writer keeps changing; every value must be whole
+static void *test_env_reader(void *arg)
+{
+    test_env_shared_t *shared = (test_env_shared_t *)arg;
+    unsigned long reads = 0;
+    unsigned long errors = 0;
+    char buf[64];
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE))
+    {
+        int n = fossil_sys_env_get_copy("FOSSIL_MT_TEXT", buf, sizeof(buf));
+        if (n < 0 || strncmp(buf, "value-", 6) != 0 || (size_t)n != strlen(buf))
+            errors++;
+        if (fossil_sys_env_get_int("FOSSIL_MT_NUMBER", -1) < 0)
+            errors++;
+        fossil_sys_env_exists("FOSSIL_MT_FLICKER");
+        if (reads++ == 0)
+            __atomic_add_fetch(&shared->ready, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_add_fetch(&shared->reads, reads, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&shared->errors, errors, __ATOMIC_RELAXED);
+    return NULL;
+}
+#endif
+
+// ** Test concurrent get and set on the snapshot **
+FOSSIL_TEST(c_test_env_snapshot_threads)
+{
+#if defined(__linux__)
+    enum { READERS = 4, WRITES = 2000 };
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_snapshot_enable(), 0);
+    fossil_sys_env_set("FOSSIL_MT_TEXT", "value-0");
+    fossil_sys_env_set("FOSSIL_MT_NUMBER", "0");
+
+    test_env_shared_t shared = {0, 0, 0, 0};
+    pthread_t readers[READERS];
+    int started = 0;
+    while (started < READERS && pthread_create(&readers[started], NULL, test_env_reader, &shared) == 0)
+        started++;
+    // Write only once every reader is reading, and let them run in between
+    while (__atomic_load_n(&shared.ready, __ATOMIC_ACQUIRE) < started)
+        sched_yield();
+
+    uint64_t version = fossil_sys_env_snapshot_version();
+    char text[32];
+    for (int i = 1; i <= WRITES; ++i)
+    {
+        snprintf(text, sizeof(text), "value-%d", i);
+        fossil_sys_env_set("FOSSIL_MT_TEXT", text);
+        snprintf(text, sizeof(text), "%d", i);
+        fossil_sys_env_set("FOSSIL_MT_NUMBER", text);
+        fossil_sys_env_set("FOSSIL_MT_FLICKER", i % 2 ? "on" : NULL);
+        if (i % 64 == 0)
+            sched_yield();
+    }
+    __atomic_store_n(&shared.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; ++i)
+        pthread_join(readers[i], NULL);
+
+    uint64_t published = fossil_sys_env_snapshot_version() - version;
+    int last = fossil_sys_env_get_int("FOSSIL_MT_NUMBER", -1);
+    fossil_sys_env_snapshot_disable();
+
+    ASSUME_ITS_EQUAL_I32(started, READERS);
+    ASSUME_ITS_EQUAL_U64(published, WRITES * 3);
+    ASSUME_ITS_EQUAL_I32(last, WRITES);
+    ASSUME_ITS_TRUE(shared.reads > 0);
+    ASSUME_ITS_EQUAL_U64(shared.errors, 0);
+#endif
+}
+
+// ** Test fossil_sys_env_get_u64 **
+FOSSIL_TEST(c_test_env_get_u64)
+{
+    uint64_t page_size = fossil_sys_env_get_u64("fossil.sys.page_size", 0);
+    ASSUME_ITS_TRUE(page_size >= 4096 && (page_size & (page_size - 1)) == 0);
+    ASSUME_ITS_EQUAL_I32(atoi(fossil_sys_env_get("fossil.sys.page_size")), (int)page_size);
+    ASSUME_ITS_TRUE(fossil_sys_env_get_u64("fossil.sys.cpu_count", 0) >= 1);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("fossil.sys.cpu_effective", 0),
+                         (uint64_t)fossil_sys_hostinfo_effective_cpus());
+
+    fossil_sys_env_set("FOSSIL_TEST_U64", "18446744073709551615");
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("FOSSIL_TEST_U64", 0), UINT64_MAX);
+    fossil_sys_env_set("FOSSIL_TEST_U64", "18446744073709551616"); // one past the maximum
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("FOSSIL_TEST_U64", 7), 7);
+    fossil_sys_env_set("FOSSIL_TEST_U64", "-1");
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("FOSSIL_TEST_U64", 7), 7);
+    fossil_sys_env_set("FOSSIL_TEST_U64", "12ab");
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("FOSSIL_TEST_U64", 7), 7);
+    fossil_sys_env_set("FOSSIL_TEST_U64", NULL);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_env_get_u64("FOSSIL_TEST_U64", 9), 9);
+}
+
+FOSSIL_TEST(c_test_env_block)
+{
+    fossil_sys_env_set("FOSSIL_TEST_BLOCK", "inherited");
+    fossil_sys_env_block_t *block = fossil_sys_env_block_create(1);
+    ASSUME_NOT_CNULL(block);
+    fossil_sys_env_set("FOSSIL_TEST_BLOCK", NULL);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_block_get(block, "FOSSIL_TEST_BLOCK"), "inherited");
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_block_set(block, "FOSSIL_TEST_BLOCK", "override"), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_block_set(block, "FOSSIL_TEST_ADDED", "1"), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_block_set(block, "BAD=KEY", "1"), -1);
+    size_t count = fossil_sys_env_block_count(block);
+    char *const *envp = fossil_sys_env_block_envp(block);
+    ASSUME_NOT_CNULL(envp);
+
+    int override = 0, added = 0;
+    size_t seen = 0;
+    for (; envp[seen]; ++seen)
+    {
+        override += strcmp(envp[seen], "FOSSIL_TEST_BLOCK=override") == 0;
+        added += strcmp(envp[seen], "FOSSIL_TEST_ADDED=1") == 0;
+    }
+    ASSUME_ITS_EQUAL_SIZE(seen, count);
+    ASSUME_ITS_EQUAL_I32(override, 1);
+    ASSUME_ITS_EQUAL_I32(added, 1);
+
+    // Unmodified blocks and clones reuse the same image
+    fossil_sys_env_block_t *clone = fossil_sys_env_block_clone(block);
+    ASSUME_ITS_TRUE(fossil_sys_env_block_envp(block) == envp);
+    ASSUME_ITS_TRUE(fossil_sys_env_block_envp(clone) == envp);
+
+    // Modifying the clone leaves the original untouched
+    fossil_sys_env_block_unset(clone, "FOSSIL_TEST_ADDED");
+    ASSUME_ITS_TRUE(fossil_sys_env_block_envp(clone) != envp);
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_env_block_count(clone), count - 1);
+    ASSUME_ITS_TRUE(fossil_sys_env_block_get(clone, "FOSSIL_TEST_ADDED") == NULL);
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_env_block_get(block, "FOSSIL_TEST_ADDED"), "1");
+    fossil_sys_env_block_free(clone);
+
+    fossil_sys_env_block_t *empty = fossil_sys_env_block_create(0);
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_env_block_count(empty), 0);
+    ASSUME_ITS_TRUE(fossil_sys_env_block_envp(empty)[0] == NULL);
+    fossil_sys_env_block_free(empty);
+    fossil_sys_env_block_free(block);
+}
+
+FOSSIL_TEST(c_test_env_block_long_key)
+{
+    // The image ends right after "A=1"; longer keys must not read past it
+    fossil_sys_env_block_t *block = fossil_sys_env_block_create(0);
+    int set_rc = fossil_sys_env_block_set(block, "A", "1");
+    char *const *envp = fossil_sys_env_block_envp(block);
+    const char *long_key = fossil_sys_env_block_get(block, "FOSSIL_TEST_KEY_LONGER_THAN_ANY_ENTRY");
+    const char *prefix = fossil_sys_env_block_get(block, "A=");
+    const char *exact = fossil_sys_env_block_get(block, "A");
+    int exact_ok = exact && strcmp(exact, "1") == 0;
+    fossil_sys_env_block_free(block);
+
+    ASSUME_ITS_EQUAL_I32(set_rc, 0);
+    ASSUME_NOT_CNULL(envp);
+    ASSUME_ITS_CNULL(long_key);
+    ASSUME_ITS_CNULL(prefix);
+    ASSUME_ITS_TRUE(exact_ok);
+}
+
+typedef struct
+{
+    int count;
+    int stop_after;
+    int lengths_ok;
+} test_env_view_t;
+
+static int test_env_view_cb(const char *key, size_t key_len, const char *value, size_t value_len, void *user_data)
+{
+    test_env_view_t *view = (test_env_view_t *)user_data;
+    if (key[key_len] != '=' && key[key_len] != '\0')
+        view->lengths_ok = 0;
+    if (value[value_len] != '\0')
+        view->lengths_ok = 0;
+    view->count++;
+    return view->stop_after && view->count >= view->stop_after ? 42 : 0;
+}
+
+FOSSIL_TEST(c_test_env_foreach_view)
+{
+    test_env_view_t all = {0, 0, 1};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_foreach_view(test_env_view_cb, &all), 0);
+    ASSUME_ITS_TRUE(all.count > 0);
+    ASSUME_ITS_TRUE(all.lengths_ok);
+
+    test_env_view_t one = {0, 1, 1};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_foreach_view(test_env_view_cb, &one), 42);
+    ASSUME_ITS_EQUAL_I32(one.count, 1);
+
+    fossil_sys_env_set("FOSSIL_VIEW_TEST_A", "1");
+    fossil_sys_env_set("FOSSIL_VIEW_TEST_B", "22");
+    test_env_view_t some = {0, 0, 1};
+    fossil_sys_env_foreach_prefix("FOSSIL_VIEW_TEST_", test_env_view_cb, &some);
+    ASSUME_ITS_EQUAL_I32(some.count, 2);
+
+    // Dotted prefixes also match the mapped variable names
+    some.count = 0;
+    fossil_sys_env_foreach_prefix("fossil.view.test.", test_env_view_cb, &some);
+    ASSUME_ITS_EQUAL_I32(some.count, 2);
+
+    test_env_view_t first = {0, 1, 1};
+    ASSUME_ITS_EQUAL_I32(fossil_sys_env_foreach_prefix("FOSSIL_VIEW_TEST_", test_env_view_cb, &first), 42);
+    ASSUME_ITS_EQUAL_I32(first.count, 1);
+
+    test_env_view_t none = {0, 0, 1};
+    fossil_sys_env_foreach_prefix("FOSSIL_VIEW_TEST_MISSING", test_env_view_cb, &none);
+    ASSUME_ITS_EQUAL_I32(none.count, 0);
+
+    fossil_sys_env_set("FOSSIL_VIEW_TEST_A", NULL);
+    fossil_sys_env_set("FOSSIL_VIEW_TEST_B", NULL);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -182,6 +505,16 @@ FOSSIL_TEST_GROUP(c_env_tests)
     FOSSIL_ADD_TEST(c_env_suite, c_test_env_get_bool);
     FOSSIL_ADD_TEST(c_env_suite, c_test_env_canonical_keys);
     FOSSIL_ADD_TEST(c_env_suite, c_test_env_foreach);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_effective_resources);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_canonical_mapping);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_snapshot);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_snapshot_mirror);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_get_copy);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_snapshot_threads);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_get_u64);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_block);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_block_long_key);
+    FOSSIL_ADD_TEST(c_env_suite, c_test_env_foreach_view);
 
     FOSSIL_ADD_SUITE(c_env_suite);
 }
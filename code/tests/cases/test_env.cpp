@@ -113,6 +113,53 @@ FOSSIL_TEST(cpp_test_env_cpp_wrapper_foreach)
     ASSUME_ITS_TRUE(count > 0);
 }
 
+FOSSIL_TEST(cpp_test_env_cpp_wrapper_snapshot)
+{
+    using fossil::sys::Env;
+    ASSUME_ITS_TRUE(Env::snapshot_enable(true));
+    ASSUME_ITS_TRUE(Env::set("FOSSIL_CPP_SNAPSHOT", "on"));
+    ASSUME_ITS_EQUAL_CSTR(Env::get("FOSSIL_CPP_SNAPSHOT").c_str(), "on");
+    Env::snapshot_disable();
+    fossil_sys_env_snapshot_mirror(0);
+    ASSUME_ITS_EQUAL_CSTR(Env::get("FOSSIL_CPP_SNAPSHOT").c_str(), "on");
+    fossil_sys_env_set("FOSSIL_CPP_SNAPSHOT", NULL);
+}
+
+FOSSIL_TEST(cpp_test_env_cpp_wrapper_get_u64)
+{
+    using fossil::sys::Env;
+    ASSUME_ITS_TRUE(Env::get_u64("fossil.sys.cpu_count", 0) >= 1);
+    ASSUME_ITS_EQUAL_U64(Env::get_u64("FOSSIL_CPP_MISSING_U64", 42), 42);
+}
+
+FOSSIL_TEST(cpp_test_env_cpp_wrapper_block)
+{
+    fossil::sys::EnvBlock block(false);
+    ASSUME_ITS_TRUE(block.set("FOSSIL_CPP_BLOCK", "a"));
+    ASSUME_ITS_EQUAL_SIZE(block.size(), 1);
+    ASSUME_ITS_EQUAL_CSTR(block.envp()[0], "FOSSIL_CPP_BLOCK=a");
+
+    fossil::sys::EnvBlock copy(block);
+    ASSUME_ITS_TRUE(copy.envp() == block.envp());
+    copy.set("FOSSIL_CPP_BLOCK", "b");
+    ASSUME_ITS_EQUAL_CSTR(copy.get("FOSSIL_CPP_BLOCK").c_str(), "b");
+    ASSUME_ITS_EQUAL_CSTR(block.get("FOSSIL_CPP_BLOCK").c_str(), "a");
+}
+
+FOSSIL_TEST(cpp_test_env_cpp_wrapper_foreach_prefix)
+{
+    using fossil::sys::Env;
+    Env::set("FOSSIL_CPP_VIEW_X", "value");
+    std::string seen;
+    bool stopped = Env::foreach_prefix("FOSSIL_CPP_VIEW_", [&](std::string_view key, std::string_view value) {
+        seen = std::string(key) + "=" + std::string(value);
+        return false;
+    });
+    ASSUME_ITS_TRUE(stopped);
+    ASSUME_ITS_EQUAL_CSTR(seen.c_str(), "FOSSIL_CPP_VIEW_X=value");
+    Env::set("FOSSIL_CPP_VIEW_X", "");
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -122,6 +169,10 @@ FOSSIL_TEST_GROUP(cpp_env_tests)
     FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_get_int);
     FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_get_bool);
     FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_foreach);
+    FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_snapshot);
+    FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_get_u64);
+    FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_block);
+    FOSSIL_ADD_TEST(cpp_env_suite, cpp_test_env_cpp_wrapper_foreach_prefix);
 
     FOSSIL_ADD_SUITE(cpp_env_suite);
 }
@@ -25,6 +25,14 @@
 #include <fossil/maip/framework.h>
 
 #include "fossil/sys/framework.h"
+#include <time.h>
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#endif
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Utilities
@@ -225,6 +233,515 @@ FOSSIL_TEST(c_test_hostinfo_get_display)
     ASSUME_ITS_TRUE(info.primary_refresh_rate >= 0);
 }
 
+FOSSIL_TEST(c_test_hostinfo_get_topology)
+{
+    const fossil_sys_hostinfo_topology_t *topo = fossil_sys_hostinfo_get_topology();
+    ASSUME_NOT_CNULL(topo);
+    ASSUME_ITS_TRUE(topo->cpu_count > 0);
+    ASSUME_ITS_TRUE(topo->package_count > 0);
+    ASSUME_ITS_TRUE(topo->core_count > 0 && topo->core_count <= topo->cpu_count);
+
+    // Topology is built once and cached
+    ASSUME_ITS_EQUAL_PTR(topo, fossil_sys_hostinfo_get_topology());
+
+    int cpu = topo->cpus[0].cpu;
+    fossil_sys_hostinfo_cpuset_t smt;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_topology_smt_siblings(cpu, &smt), 0);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpuset_has(&smt, cpu));
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpuset_count(&smt) >= 1);
+
+    for (int i = 0; i < topo->cpus[0].cache_count; ++i)
+    {
+        const fossil_sys_hostinfo_cache_t *cache = &topo->caches[topo->cpus[0].cache_index[i]];
+        fossil_sys_hostinfo_cpuset_t shared;
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_topology_cache_siblings(cpu, cache->level, &shared), 0);
+        ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpuset_has(&shared, cpu));
+    }
+
+    fossil_sys_hostinfo_cpuset_t none;
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_topology_cache_siblings(-1, 3, &none) != 0);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_topology_smt_siblings(cpu, NULL) != 0);
+}
+
+FOSSIL_TEST(c_test_hostinfo_snapshot)
+{
+    const fossil_sys_hostinfo_static_t *snap =
+        fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM | FOSSIL_SYS_HOSTINFO_SECTION_CPU);
+    ASSUME_NOT_CNULL(snap);
+    ASSUME_ITS_TRUE(strlen(snap->system.os_name) > 0);
+    ASSUME_ITS_EQUAL_PTR(snap, fossil_sys_hostinfo_snapshot_static(FOSSIL_SYS_HOSTINFO_STATIC_SECTIONS));
+
+    uint32_t ttl = fossil_sys_hostinfo_snapshot_get_ttl();
+    fossil_sys_hostinfo_snapshot_set_ttl(60000);
+
+    fossil_sys_hostinfo_volatile_t a, b;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_volatile(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &a), 0);
+    ASSUME_ITS_TRUE(a.memory.total_memory > 0);
+
+    // Within the TTL the cached section is served without a refresh
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_volatile(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &b), 0);
+    ASSUME_ITS_TRUE(a.generation == b.generation);
+
+    fossil_sys_hostinfo_snapshot_invalidate();
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_volatile(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &b), 0);
+    ASSUME_ITS_TRUE(b.generation > a.generation);
+
+    // A single section copies out of the same cache
+    fossil_sys_hostinfo_memory_t memory;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &memory,
+                                                              sizeof(memory)), 0);
+    ASSUME_ITS_EQUAL_U64(memory.total_memory, b.memory.total_memory);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, &memory,
+                                                              sizeof(memory) - 1), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_section(FOSSIL_SYS_HOSTINFO_SECTION_CPU, &memory,
+                                                              sizeof(memory)), -1);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_snapshot_volatile(FOSSIL_SYS_HOSTINFO_SECTION_MEMORY, NULL), -1);
+    fossil_sys_hostinfo_snapshot_set_ttl(ttl);
+}
+
+static int c_dispatch_generic(void) { return 1; }
+static int c_dispatch_never(void) { return 2; }
+
+FOSSIL_TEST(c_test_hostinfo_features)
+{
+    const fossil_sys_hostinfo_features_t *features = fossil_sys_hostinfo_get_features();
+    ASSUME_NOT_CNULL(features);
+    ASSUME_ITS_EQUAL_PTR(features, fossil_sys_hostinfo_get_features());
+    ASSUME_ITS_FALSE(fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_NONE));
+    ASSUME_ITS_FALSE(fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_COUNT));
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_hostinfo_feature_name(FOSSIL_SYS_HOSTINFO_FEATURE_AVX2), "avx2");
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_hostinfo_feature_name(FOSSIL_SYS_HOSTINFO_FEATURE_COUNT), "unknown");
+
+#if defined(__x86_64__) || defined(_M_X64)
+    // SSE2 is part of the x86-64 baseline
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_SSE2));
+#endif
+    // AVX2 is only reported together with the OS-enabled AVX state
+    if (fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_AVX2))
+        ASSUME_ITS_TRUE(fossil_sys_hostinfo_has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_AVX));
+}
+
+FOSSIL_TEST(c_test_hostinfo_dispatch_select)
+{
+    // Requires a feature from both architecture families, so never usable
+    const fossil_sys_hostinfo_dispatch_entry_t table[] = {
+        {(fossil_sys_hostinfo_fn_t)c_dispatch_never,
+         {FOSSIL_SYS_HOSTINFO_FEATURE_AVX2, FOSSIL_SYS_HOSTINFO_FEATURE_NEON}},
+        {(fossil_sys_hostinfo_fn_t)c_dispatch_generic, {FOSSIL_SYS_HOSTINFO_FEATURE_NONE}},
+    };
+    fossil_sys_hostinfo_fn_t fn = fossil_sys_hostinfo_dispatch_select(table, 2);
+    ASSUME_ITS_TRUE(fn == (fossil_sys_hostinfo_fn_t)c_dispatch_generic);
+    ASSUME_ITS_EQUAL_I32(((int (*)(void))fn)(), 1);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_dispatch_select(table, 1) == NULL);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_dispatch_select(NULL, 2) == NULL);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_gpus)
+{
+    static fossil_sys_hostinfo_gpu_list_t list;
+    int result = fossil_sys_hostinfo_get_gpus(&list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    ASSUME_ITS_TRUE(list.count <= FOSSIL_SYS_HOSTINFO_GPU_MAX);
+
+    int primaries = 0;
+    for (size_t i = 0; i < list.count; ++i)
+    {
+        ASSUME_ITS_TRUE(strlen(list.list[i].name) > 0);
+        ASSUME_ITS_TRUE(strlen(list.list[i].vendor) > 0);
+        primaries += list.list[i].is_primary;
+    }
+    if (result == 0 && list.count > 0)
+        ASSUME_ITS_TRUE(primaries >= 1);
+
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_hostinfo_gpu_vendor_name(0x10de), "NVIDIA");
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_hostinfo_gpu_vendor_name(0x8086), "Intel");
+    ASSUME_ITS_EQUAL_CSTR(fossil_sys_hostinfo_gpu_vendor_name(0xffff), "Unknown");
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_get_gpus(NULL) == -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_sampler)
+{
+    static fossil_sys_hostinfo_sample_t history[4];
+    fossil_sys_hostinfo_sample_t sample;
+
+    int result = fossil_sys_hostinfo_sampler_sample_now();
+    if (result == -2)
+        return; // no sampler on this platform
+    ASSUME_ITS_EQUAL_I32(result, 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_sample_now(), 0);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_latest(&sample), 0);
+    ASSUME_ITS_TRUE(sample.sequence >= 2);
+    ASSUME_ITS_TRUE(sample.cpu_count > 0);
+    ASSUME_ITS_TRUE(sample.memory_total > 0);
+    ASSUME_ITS_TRUE(sample.cpu_busy >= 0.0f && sample.cpu_busy <= 100.0f);
+
+    size_t count = fossil_sys_hostinfo_sampler_history(history, 4);
+    ASSUME_ITS_TRUE(count >= 2);
+    ASSUME_ITS_TRUE(history[0].sequence == history[1].sequence + 1);
+
+    // Background thread keeps publishing at the configured interval
+    uint64_t before = sample.sequence;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_start(10), 0);
+    clock_t deadline = clock() + 2 * CLOCKS_PER_SEC;
+    while (sample.sequence < before + 3 && clock() < deadline)
+        fossil_sys_hostinfo_sampler_latest(&sample);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_stop(), 0);
+    ASSUME_ITS_TRUE(sample.sequence >= before + 3);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_latest(NULL), -1);
+
+    // Stop releases the sources but keeps history; the next sample reopens them
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_latest(&sample), 0);
+    before = sample.sequence;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_sample_now(), 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_latest(&sample), 0);
+    ASSUME_ITS_EQUAL_U64(sample.sequence, before + 1);
+    ASSUME_ITS_TRUE(sample.memory_total > 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_sampler_stop(), 0);
+}
+
+FOSSIL_TEST(c_test_hostinfo_psi)
+{
+    fossil_sys_hostinfo_psi_t psi;
+    int result = fossil_sys_hostinfo_get_psi(FOSSIL_SYS_HOSTINFO_PSI_MEMORY, &psi);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    if (result == 0)
+    {
+        ASSUME_ITS_TRUE(psi.some.avg10 >= 0.0f && psi.some.avg10 <= 100.0f);
+        ASSUME_ITS_TRUE(psi.some.avg300 >= 0.0f && psi.some.avg300 <= 100.0f);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_psi(FOSSIL_SYS_HOSTINFO_PSI_COUNT, &psi), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_psi(FOSSIL_SYS_HOSTINFO_PSI_CPU, NULL), -1);
+
+    // Stall larger than window is rejected before touching the kernel
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_psi_trigger_add(FOSSIL_SYS_HOSTINFO_PSI_MEMORY,
+                                                             FOSSIL_SYS_HOSTINFO_PSI_SOME, 3000000, 2000000), -1);
+
+    // Registration may be refused without privileges; when it works the trigger round-trips
+    int id = fossil_sys_hostinfo_psi_trigger_add(FOSSIL_SYS_HOSTINFO_PSI_MEMORY, FOSSIL_SYS_HOSTINFO_PSI_SOME,
+                                                 150000, 2000000);
+    if (id >= 0)
+    {
+        ASSUME_ITS_TRUE(fossil_sys_hostinfo_psi_dispatch(0) >= 0);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_psi_trigger_remove(id), 0);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_psi_trigger_remove(id), -1);
+    }
+    if (fossil_sys_hostinfo_psi_watch_start() == 0)
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_psi_watch_stop(), 0);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_mounts)
+{
+    static fossil_sys_hostinfo_mount_list_t list;
+    int result = fossil_sys_hostinfo_get_mounts(&list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    if (result == 0)
+    {
+        ASSUME_ITS_TRUE(list.count > 0);
+        for (size_t i = 0; i < list.count; ++i)
+        {
+            ASSUME_ITS_TRUE(strlen(list.list[i].mount_point) > 0);
+            ASSUME_ITS_TRUE(strlen(list.list[i].filesystem_type) > 0);
+            ASSUME_ITS_TRUE(list.list[i].used_space <= list.list[i].total_space);
+            if (list.list[i].is_network)
+                ASSUME_ITS_EQUAL_U64(list.list[i].total_space, 0);
+        }
+
+        fossil_sys_hostinfo_mount_t mount = list.list[0];
+        if (!mount.is_network)
+        {
+            ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_mount_space(&mount), 0);
+            ASSUME_ITS_EQUAL_U64(mount.total_space, list.list[0].total_space);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_mounts(NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_mount_space(NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_block_devices)
+{
+    static fossil_sys_hostinfo_block_device_list_t list;
+    int result = fossil_sys_hostinfo_get_block_devices(&list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    for (size_t i = 0; i < list.count; ++i)
+    {
+        ASSUME_ITS_TRUE(strlen(list.list[i].name) > 0);
+        ASSUME_ITS_TRUE(list.list[i].logical_block_size >= 512);
+        ASSUME_ITS_TRUE(list.list[i].rotational == 0 || list.list[i].rotational == 1);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_block_devices(NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_interfaces)
+{
+    static fossil_sys_hostinfo_interface_list_t list;
+    int result = fossil_sys_hostinfo_get_interfaces(&list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    for (size_t i = 0; i < list.count; ++i)
+    {
+        const fossil_sys_hostinfo_interface_t *iface = &list.list[i];
+        ASSUME_ITS_TRUE(strlen(iface->name) > 0);
+        ASSUME_ITS_TRUE(iface->address_count <= FOSSIL_SYS_HOSTINFO_IFACE_ADDR_MAX);
+        for (int a = 0; a < iface->address_count; ++a)
+        {
+            ASSUME_ITS_TRUE(iface->addresses[a].family == 4 || iface->addresses[a].family == 6);
+            ASSUME_ITS_TRUE(iface->addresses[a].prefix_len <= (iface->addresses[a].family == 4 ? 32 : 128));
+        }
+    }
+    if (result == 0)
+    {
+        uint64_t rx_before = list.count ? list.list[0].rx_bytes : 0;
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_refresh_interface_counters(&list), 0);
+        if (list.count)
+            ASSUME_ITS_TRUE(list.list[0].rx_bytes >= rx_before);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_interfaces(NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_refresh_interface_counters(NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_meminfo)
+{
+    static fossil_sys_hostinfo_meminfo_t info;
+    int result = fossil_sys_hostinfo_get_meminfo(&info);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    if (result == 0)
+    {
+        ASSUME_ITS_TRUE(info.total > 0);
+        ASSUME_ITS_TRUE(info.free <= info.total);
+        ASSUME_ITS_TRUE(info.available <= info.total);
+        ASSUME_ITS_TRUE(info.hugepage_size_count <= FOSSIL_SYS_HOSTINFO_HUGEPAGE_SIZES_MAX);
+        for (size_t i = 0; i < info.hugepage_size_count; ++i)
+        {
+            ASSUME_ITS_TRUE(info.hugepages[i].page_size > 0);
+            ASSUME_ITS_TRUE(info.hugepages[i].free <= info.hugepages[i].total + info.hugepages[i].surplus);
+        }
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_meminfo(NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_cpufreq_read)
+{
+    static fossil_sys_hostinfo_cpufreq_state_t before;
+    static fossil_sys_hostinfo_cpufreq_state_t after;
+    int result = fossil_sys_hostinfo_cpufreq_read(&before);
+    ASSUME_ITS_TRUE(result == 0 || result == -2 || result == -3);
+    if (result == 0)
+    {
+        ASSUME_ITS_TRUE(before.cpu_count > 0);
+        for (size_t i = 0; i < before.cpu_count; ++i)
+        {
+            const fossil_sys_hostinfo_cpufreq_t *cpu = &before.cpus[i];
+            ASSUME_ITS_TRUE(cpu->cpu >= 0 && cpu->cpu < FOSSIL_SYS_HOSTINFO_CPU_MAX);
+            if (cpu->max_khz)
+                ASSUME_ITS_TRUE(cpu->min_khz <= cpu->max_khz);
+        }
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_cpufreq_read(&after), 0);
+        ASSUME_ITS_TRUE(after.timestamp_ns >= before.timestamp_ns);
+        ASSUME_ITS_EQUAL_I32(after.cpu_count, before.cpu_count);
+        (void)fossil_sys_hostinfo_cpufreq_throttle_delta(&before, &after);
+        ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_cpufreq_close(), 0);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_cpufreq_read(NULL), -1);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpufreq_throttle_delta(NULL, &after) == 0);
+}
+
+FOSSIL_TEST(c_test_hostinfo_collect_all_json)
+{
+    static fossil_sys_hostinfo_all_t info;
+    static char json[16384];
+    uint32_t mask = FOSSIL_SYS_HOSTINFO_SECTION_ALL & ~(FOSSIL_SYS_HOSTINFO_SECTION_DISPLAY | FOSSIL_SYS_HOSTINFO_SECTION_GPU);
+    int result = fossil_sys_hostinfo_collect_all(mask, &info);
+    ASSUME_ITS_TRUE(result == 0 || result == -3);
+    ASSUME_ITS_TRUE(info.requested == mask);
+    ASSUME_ITS_TRUE((info.valid & ~mask) == 0);
+    ASSUME_ITS_TRUE(info.valid & FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS);
+
+    size_t needed = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_to_json(&info, NULL, 0, &needed), -4);
+    ASSUME_ITS_TRUE(needed > 2 && needed < sizeof(json));
+    size_t written = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_to_json(&info, json, sizeof(json), &written), 0);
+    ASSUME_ITS_TRUE(written == needed && strlen(json) == written);
+    ASSUME_ITS_TRUE(json[0] == '{' && json[written - 1] == '}');
+    ASSUME_ITS_TRUE(strstr(json, "\"endianness\":{\"is_little_endian\":") != NULL);
+    ASSUME_ITS_TRUE(strstr(json, "\"display\"") == NULL);
+
+    char small[8];
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_to_json(&info, small, sizeof(small), NULL), -4);
+    ASSUME_ITS_TRUE(strlen(small) == sizeof(small) - 1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_collect_all(mask, NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_binary_roundtrip)
+{
+    static fossil_sys_hostinfo_all_t info;
+    static fossil_sys_hostinfo_all_t decoded;
+    static unsigned char bin[16384];
+    uint32_t mask = FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM | FOSSIL_SYS_HOSTINFO_SECTION_MEMORY |
+                    FOSSIL_SYS_HOSTINFO_SECTION_CPU | FOSSIL_SYS_HOSTINFO_SECTION_TIME;
+    fossil_sys_hostinfo_collect_all(mask, &info);
+    info.time.utc_offset_seconds = -18000; // exercise zigzag for negatives
+
+    size_t written = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_to_binary(&info, bin, sizeof(bin), &written), 0);
+    ASSUME_ITS_TRUE(written > 5 && memcmp(bin, FOSSIL_SYS_HOSTINFO_BINARY_MAGIC, 4) == 0);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_from_binary(bin, written, &decoded), 0);
+    ASSUME_ITS_TRUE(decoded.valid == info.valid);
+    ASSUME_ITS_TRUE(decoded.collected_at == info.collected_at);
+    ASSUME_ITS_TRUE(strcmp(decoded.system.hostname, info.system.hostname) == 0);
+    ASSUME_ITS_TRUE(decoded.memory.total_memory == info.memory.total_memory);
+    ASSUME_ITS_TRUE(decoded.cpu.frequency_ghz == info.cpu.frequency_ghz);
+    ASSUME_ITS_EQUAL_I32(decoded.time.utc_offset_seconds, -18000);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_from_binary(bin, written - 1, &decoded), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_to_binary(&info, bin, 4, NULL), -4);
+    bin[4] = FOSSIL_SYS_HOSTINFO_BINARY_VERSION + 1;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_from_binary(bin, written, &decoded), -2);
+}
+
+FOSSIL_TEST(c_test_hostinfo_get_resources)
+{
+    fossil_sys_hostinfo_resources_t info;
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_resources(&info), 0);
+    ASSUME_ITS_TRUE(info.online_cpus >= 1);
+    ASSUME_ITS_TRUE(info.affinity_cpus >= 1 && info.affinity_cpus <= info.online_cpus);
+    ASSUME_ITS_TRUE(info.effective_cpus >= 1 && info.effective_cpus <= info.affinity_cpus);
+    if (info.cpu_quota > 0)
+        ASSUME_ITS_TRUE((double)info.effective_cpus < info.cpu_quota + 1.0);
+    ASSUME_ITS_TRUE(info.effective_memory <= info.memory_total || info.memory_total == 0);
+    if (info.memory_limit > 0)
+        ASSUME_ITS_TRUE(info.effective_memory <= info.memory_limit);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_effective_cpus(), info.effective_cpus);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_resources(NULL), -1);
+}
+
+FOSSIL_TEST(c_test_hostinfo_clocks)
+{
+    uint64_t mono = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC);
+    uint64_t boot = fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_BOOTTIME);
+    ASSUME_ITS_TRUE(mono > 0);
+    ASSUME_ITS_TRUE(boot >= mono);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC) >= mono);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_MONOTONIC_RAW) > 0);
+
+    uint64_t prev = fossil_sys_hostinfo_timestamp_ns();
+    for (int i = 0; i < 1000; ++i)
+    {
+        uint64_t now = fossil_sys_hostinfo_timestamp_ns();
+        ASSUME_ITS_TRUE(now >= prev);
+        prev = now;
+    }
+}
+
+FOSSIL_TEST(c_test_hostinfo_tsc_conversion)
+{
+    const fossil_sys_hostinfo_tsc_t *tsc = fossil_sys_hostinfo_get_tsc();
+    ASSUME_NOT_CNULL(tsc);
+    if (!tsc->frequency_hz)
+    {
+        ASSUME_ITS_EQUAL_U64(fossil_sys_hostinfo_cycles_to_ns(tsc, 1000), 0);
+        return;
+    }
+    uint64_t cycles = fossil_sys_hostinfo_ns_to_cycles(tsc, 1000000000u);
+    ASSUME_ITS_TRUE(cycles + 1 >= tsc->frequency_hz && cycles <= tsc->frequency_hz);
+    uint64_t ns = fossil_sys_hostinfo_cycles_to_ns(tsc, cycles);
+    ASSUME_ITS_TRUE(ns > 999999000u && ns < 1000001000u);
+}
+
+FOSSIL_TEST(c_test_hostinfo_interrupts)
+{
+    fossil_sys_hostinfo_interrupts_t before, after, delta;
+    memset(&before, 0, sizeof(before));
+    memset(&after, 0, sizeof(after));
+    memset(&delta, 0, sizeof(delta));
+    int cpus[FOSSIL_SYS_HOSTINFO_CPU_MAX];
+    size_t count = 0;
+
+    // Gather everything first so the readings are freed on every path
+    int result = fossil_sys_hostinfo_get_interrupts(&before);
+    size_t before_cpus = before.cpu_count, before_irqs = before.irq_count;
+    int after_rc = -1, delta_rc = -1, quiet_rc = -1;
+    int shape_ok = 0, totals_ok = 1;
+    if (result == 0)
+        after_rc = fossil_sys_hostinfo_get_interrupts(&after);
+    if (after_rc == 0)
+        delta_rc = fossil_sys_hostinfo_interrupts_delta(&before, &after, &delta);
+    if (delta_rc == 0)
+    {
+        shape_ok = delta.irq_count == after.irq_count && delta.cpu_count == after.cpu_count;
+        for (size_t i = 0; shape_ok && i < delta.irq_count; ++i)
+            totals_ok &= delta.irqs[i].total <= after.irqs[i].total;
+        quiet_rc = fossil_sys_hostinfo_quiet_cpus(&delta, cpus, FOSSIL_SYS_HOSTINFO_CPU_MAX, &count);
+    }
+    size_t delta_cpus = delta.cpu_count;
+
+    fossil_sys_hostinfo_free_interrupts(&delta);
+    fossil_sys_hostinfo_free_interrupts(&after);
+    fossil_sys_hostinfo_free_interrupts(&before);
+
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_interrupts(NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_quiet_cpus(NULL, cpus, 1, &count), -1);
+    ASSUME_ITS_TRUE(before.irqs == NULL && before.cpu_count == 0);
+    if (result != 0)
+        return;
+    ASSUME_ITS_TRUE(before_cpus >= 1);
+    ASSUME_ITS_TRUE(before_irqs >= 1);
+    ASSUME_ITS_EQUAL_I32(after_rc, 0);
+    ASSUME_ITS_EQUAL_I32(delta_rc, 0);
+    ASSUME_ITS_TRUE(shape_ok);
+    ASSUME_ITS_TRUE(totals_ok);
+    ASSUME_ITS_EQUAL_I32(quiet_rc, 0);
+    ASSUME_ITS_EQUAL_SIZE(count, delta_cpus);
+}
+
+FOSSIL_TEST(c_test_hostinfo_fd_inventory)
+{
+    fossil_sys_hostinfo_fd_inventory_t info;
+    int result = fossil_sys_hostinfo_get_fd_inventory(0, &info);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_fd_inventory(0, NULL), -1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_hostinfo_get_fd_inventory(-1, &info), -1);
+    if (result != 0)
+        return;
+    ASSUME_ITS_EQUAL_U64(info.total, info.files + info.devices + info.sockets + info.pipes +
+                                         info.anon_inodes + info.other);
+    ASSUME_ITS_TRUE(info.tcp_established + info.tcp_listen + info.tcp_syn + info.tcp_closing +
+                        info.tcp_close_wait + info.tcp_other + info.udp + info.unix_sockets +
+                        info.other_sockets <= info.sockets);
+    ASSUME_ITS_TRUE(info.limit == 0 || info.total <= info.limit);
+
+#if defined(__linux__)
+    // A pipe, a socket pair and a UDP socket must show up in their classes
+    int pipe_fds[2], pair_fds[2];
+    ASSUME_ITS_EQUAL_I32(pipe(pipe_fds), 0);
+    ASSUME_ITS_EQUAL_I32(socketpair(AF_UNIX, SOCK_STREAM, 0, pair_fds), 0);
+    // Only bound UDP sockets are listed in /proc/net/udp
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int udp_bound = udp_fd >= 0 && bind(udp_fd, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+    fossil_sys_hostinfo_fd_inventory_t after;
+    result = fossil_sys_hostinfo_get_fd_inventory(0, &after);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(pair_fds[0]);
+    close(pair_fds[1]);
+    if (udp_fd >= 0)
+        close(udp_fd);
+
+    ASSUME_ITS_EQUAL_I32(result, 0);
+    ASSUME_ITS_EQUAL_U64(after.pipes, info.pipes + 2);
+    ASSUME_ITS_EQUAL_U64(after.sockets, info.sockets + 2 + (udp_fd >= 0));
+    ASSUME_ITS_EQUAL_U64(after.unix_sockets, info.unix_sockets + 2);
+    if (udp_bound)
+        ASSUME_ITS_EQUAL_U64(after.udp, info.udp + 1);
+#endif
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -245,6 +762,25 @@ FOSSIL_TEST_GROUP(c_hostinfo_tests)
     FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_time);
     FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_hardware);
     FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_display);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_topology);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_snapshot);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_features);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_dispatch_select);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_gpus);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_sampler);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_psi);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_mounts);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_block_devices);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_interfaces);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_meminfo);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_cpufreq_read);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_collect_all_json);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_binary_roundtrip);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_get_resources);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_clocks);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_tsc_conversion);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_interrupts);
+    FOSSIL_ADD_TEST(c_hostinfo_suite, c_test_hostinfo_fd_inventory);
 
     FOSSIL_ADD_SUITE(c_hostinfo_suite);
 }
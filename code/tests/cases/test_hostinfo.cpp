@@ -200,6 +200,162 @@ FOSSIL_TEST(cpp_test_hostinfo_get_display)
     ASSUME_ITS_TRUE(info.primary_refresh_rate >= 0);
 }
 
+FOSSIL_TEST(cpp_test_hostinfo_get_topology)
+{
+    const auto *topo = fossil::sys::Hostinfo::get_topology();
+    ASSUME_NOT_CNULL(topo);
+    ASSUME_ITS_TRUE(topo->cpu_count > 0);
+    ASSUME_ITS_TRUE(topo->package_count > 0);
+
+    int cpu = topo->cpus[0].cpu;
+    auto smt = fossil::sys::Hostinfo::smt_siblings(cpu);
+    ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpuset_has(&smt, cpu));
+
+    int node = fossil::sys::Hostinfo::numa_node(cpu);
+    ASSUME_ITS_TRUE(node >= -1);
+
+    if (topo->cpus[0].cache_count > 0)
+    {
+        int level = topo->caches[topo->cpus[0].cache_index[0]].level;
+        auto shared = fossil::sys::Hostinfo::cache_siblings(cpu, level);
+        ASSUME_ITS_TRUE(fossil_sys_hostinfo_cpuset_count(&shared) >= 1);
+    }
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_snapshot)
+{
+    const auto &cpu = fossil::sys::Hostinfo::get_cpu();
+    ASSUME_ITS_EQUAL_PTR(&cpu, &fossil::sys::Hostinfo::get_cpu());
+
+    fossil::sys::Hostinfo::set_snapshot_ttl(60000);
+    auto mem = fossil::sys::Hostinfo::get_memory();
+    ASSUME_ITS_TRUE(mem.total_memory > 0);
+    fossil::sys::Hostinfo::invalidate();
+    fossil::sys::Hostinfo::set_snapshot_ttl(FOSSIL_SYS_HOSTINFO_SNAPSHOT_TTL_MS);
+}
+
+static int cpp_dispatch_generic() { return 7; }
+
+FOSSIL_TEST(cpp_test_hostinfo_dispatch)
+{
+    using fn_t = int (*)();
+    const fossil_sys_hostinfo_dispatch_entry_t table[] = {
+        {reinterpret_cast<fossil_sys_hostinfo_fn_t>(cpp_dispatch_generic), {FOSSIL_SYS_HOSTINFO_FEATURE_NONE}},
+    };
+    static const fn_t impl = fossil::sys::Hostinfo::dispatch<fn_t>(table, 1);
+    ASSUME_ITS_EQUAL_I32(impl(), 7);
+    ASSUME_ITS_FALSE(fossil::sys::Hostinfo::has_feature(FOSSIL_SYS_HOSTINFO_FEATURE_NONE));
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_get_gpus)
+{
+    auto list = fossil::sys::Hostinfo::get_gpus();
+    ASSUME_ITS_TRUE(list.count <= FOSSIL_SYS_HOSTINFO_GPU_MAX);
+    for (size_t i = 0; i < list.count; ++i)
+        ASSUME_ITS_TRUE(strlen(list.list[i].name) > 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_sampler)
+{
+    if (fossil_sys_hostinfo_sampler_sample_now() != 0)
+        return;
+    fossil_sys_hostinfo_sample_t sample;
+    ASSUME_ITS_TRUE(fossil::sys::Hostinfo::latest_sample(sample));
+    ASSUME_ITS_TRUE(sample.cpu_count > 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_psi)
+{
+    auto psi = fossil::sys::Hostinfo::get_psi(FOSSIL_SYS_HOSTINFO_PSI_CPU);
+    ASSUME_ITS_TRUE(psi.some.avg10 >= 0.0f);
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Hostinfo::remove_psi_trigger(-1), -1);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_get_mounts)
+{
+    static fossil_sys_hostinfo_mount_list_t list;
+    int result = fossil::sys::Hostinfo::get_mounts(list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    for (size_t i = 0; i < list.count; ++i)
+        ASSUME_ITS_TRUE(strlen(list.list[i].mount_point) > 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_get_interfaces)
+{
+    static fossil_sys_hostinfo_interface_list_t list;
+    int result = fossil::sys::Hostinfo::get_interfaces(list);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    for (size_t i = 0; i < list.count; ++i)
+        ASSUME_ITS_TRUE(strlen(list.list[i].name) > 0);
+    if (result == 0)
+        ASSUME_ITS_EQUAL_I32(fossil::sys::Hostinfo::refresh_interface_counters(list), 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_get_meminfo)
+{
+    fossil_sys_hostinfo_meminfo_t info;
+    int result = fossil::sys::Hostinfo::get_meminfo(info);
+    ASSUME_ITS_TRUE(result == 0 || result == -2);
+    if (result == 0)
+        ASSUME_ITS_TRUE(info.available <= info.total);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_read_cpufreq)
+{
+    static fossil_sys_hostinfo_cpufreq_state_t state;
+    int result = fossil::sys::Hostinfo::read_cpufreq(state);
+    ASSUME_ITS_TRUE(result == 0 || result == -2 || result == -3);
+    if (result == 0)
+        ASSUME_ITS_TRUE(state.cpu_count > 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_collect_all_json)
+{
+    static fossil_sys_hostinfo_all_t info;
+    int result = fossil::sys::Hostinfo::collect_all(info, FOSSIL_SYS_HOSTINFO_SECTION_SYSTEM |
+                                                              FOSSIL_SYS_HOSTINFO_SECTION_ENDIANNESS);
+    ASSUME_ITS_TRUE(result == 0 || result == -3);
+    std::string json = fossil::sys::Hostinfo::to_json(info);
+    ASSUME_ITS_TRUE(!json.empty() && json.front() == '{' && json.back() == '}');
+    ASSUME_ITS_TRUE(json.find("\"endianness\"") != std::string::npos);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_get_resources)
+{
+    fossil_sys_hostinfo_resources_t info = fossil::sys::Hostinfo::get_resources();
+    ASSUME_ITS_TRUE(info.effective_cpus >= 1);
+    ASSUME_ITS_EQUAL_I32(fossil::sys::Hostinfo::effective_cpus(), info.effective_cpus);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_clocks)
+{
+    uint64_t mono = fossil::sys::Hostinfo::clock_ns();
+    ASSUME_ITS_TRUE(fossil::sys::Hostinfo::clock_ns(FOSSIL_SYS_HOSTINFO_CLOCK_BOOTTIME) >= mono);
+    uint64_t first = fossil::sys::Hostinfo::timestamp_ns();
+    ASSUME_ITS_TRUE(fossil::sys::Hostinfo::timestamp_ns() >= first);
+    const fossil_sys_hostinfo_tsc_t &tsc = fossil::sys::Hostinfo::get_tsc();
+    ASSUME_ITS_TRUE(tsc.frequency_hz == 0 || tsc.mult != 0);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_quiet_cpus)
+{
+    fossil_sys_hostinfo_interrupts_t stats;
+    if (fossil::sys::Hostinfo::get_interrupts(stats) != 0)
+        return;
+    std::vector<int> cpus = fossil::sys::Hostinfo::quiet_cpus(stats);
+    size_t cpu_count = stats.cpu_count;
+    fossil::sys::Hostinfo::free_interrupts(stats);
+    ASSUME_ITS_EQUAL_SIZE(cpus.size(), cpu_count);
+}
+
+FOSSIL_TEST(cpp_test_hostinfo_fd_inventory)
+{
+    fossil_sys_hostinfo_fd_inventory_t info;
+    if (fossil::sys::Hostinfo::get_fd_inventory(info) != 0)
+        return;
+    ASSUME_ITS_TRUE(info.total >= info.sockets + info.pipes);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -220,6 +376,21 @@ FOSSIL_TEST_GROUP(cpp_hostinfo_tests)
     FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_time);
     FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_hardware);
     FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_display);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_topology);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_snapshot);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_dispatch);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_gpus);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_sampler);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_psi);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_mounts);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_interfaces);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_meminfo);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_read_cpufreq);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_collect_all_json);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_get_resources);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_clocks);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_quiet_cpus);
+    FOSSIL_ADD_TEST(cpp_hostinfo_suite, cpp_test_hostinfo_fd_inventory);
 
     FOSSIL_ADD_SUITE(cpp_hostinfo_suite);
 }
@@ -0,0 +1,320 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+
+#include "fossil/sys/framework.h"
+#include "fixture_libm.h"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Define the test suite and add test cases
+FOSSIL_SUITE(c_plugin_suite);
+
+// Setup function for the test suite
+FOSSIL_SETUP(c_plugin_suite)
+{
+    // Setup code here
+}
+
+// Teardown function for the test suite
+FOSSIL_TEARDOWN(c_plugin_suite)
+{
+    // Teardown code here
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// ** Test loading, calling and hot-reloading a plugin **
+FOSSIL_TEST(c_test_plugin_reload)
+{
+#if defined(__linux__)
+    const char *path = "fossil_sys_plugin_test.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+
+    const char *symbols[] = {"sqrt", "cos"};
+    fossil_sys_plugin_t *plugin = fossil_sys_plugin_open(path, symbols, 2);
+    ASSUME_NOT_CNULL(plugin);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_plugin_version(plugin), 1);
+    ASSUME_ITS_EQUAL_I32(fossil_sys_plugin_poll(plugin), 0);
+
+    // A reader pinned before the reload keeps a working old version
+    unsigned long token;
+    const fossil_sys_plugin_table_t *old = fossil_sys_plugin_enter(plugin, &token);
+    ASSUME_ITS_EQUAL_SIZE(old->count, 2);
+
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+    ASSUME_ITS_EQUAL_I32(fossil_sys_plugin_poll(plugin), 1);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_plugin_version(plugin), 2);
+    ASSUME_ITS_EQUAL_U64(old->version, 1);
+    double (*old_sqrt)(double) = (double (*)(double))old->fns[0];
+    ASSUME_ITS_TRUE(old_sqrt(25.0) == 5.0);
+    ASSUME_ITS_TRUE(fossil_sys_plugin_collect(plugin) == 1);
+    fossil_sys_plugin_leave(plugin, token);
+
+    // Once the reader has left, the old version is unloaded
+    ASSUME_ITS_EQUAL_SIZE(fossil_sys_plugin_collect(plugin), 0);
+
+    const fossil_sys_plugin_table_t *current = fossil_sys_plugin_enter(plugin, &token);
+    ASSUME_ITS_EQUAL_U64(current->version, 2);
+    ASSUME_ITS_TRUE(current->fns[0] != old_sqrt);
+    double (*fn_cos)(double) = (double (*)(double))current->fns[1];
+    ASSUME_ITS_TRUE(fn_cos(0.0) == 1.0);
+    fossil_sys_plugin_leave(plugin, token);
+
+    ASSUME_ITS_EQUAL_I32(fossil_sys_plugin_reload(plugin), 1);
+    ASSUME_ITS_EQUAL_U64(fossil_sys_plugin_version(plugin), 3);
+
+    fossil_sys_plugin_close(plugin);
+    remove(path);
+#endif
+}
+
+#if defined(__linux__)
+typedef struct
+{
+    fossil_sys_plugin_t *plugin;
+    int stop;
+    int ready;
+    unsigned long calls;
+    unsigned long errors;
+} test_plugin_readers_t;
+
+// Calls through the published table until told to stop
+static void *test_plugin_reader(void *arg)
+{
+    test_plugin_readers_t *shared = (test_plugin_readers_t *)arg;
+    unsigned long calls = 0;
+    unsigned long errors = 0;
+    uint64_t last = 0;
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_ACQUIRE))
+    {
+        unsigned long token;
+        const fossil_sys_plugin_table_t *table = fossil_sys_plugin_enter(shared->plugin, &token);
+        double (*fn_sqrt)(double) = (double (*)(double))table->fns[0];
+        if (table->version < last || fn_sqrt(81.0) != 9.0)
+            errors++;
+        last = table->version;
+        fossil_sys_plugin_leave(shared->plugin, token);
+        if (calls++ == 0)
+            __atomic_add_fetch(&shared->ready, 1, __ATOMIC_RELEASE);
+    }
+    __atomic_add_fetch(&shared->calls, calls, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&shared->errors, errors, __ATOMIC_RELAXED);
+    return NULL;
+}
+#endif
+
+// ** Test calls from reader threads while the plugin is reloaded **
+FOSSIL_TEST(c_test_plugin_concurrent_reload)
+{
+#if defined(__linux__)
+    enum { READERS = 4, RELOADS = 50 };
+    const char *path = "fossil_sys_plugin_concurrent.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+
+    const char *symbols[] = {"sqrt"};
+    test_plugin_readers_t shared = {fossil_sys_plugin_open(path, symbols, 1), 0, 0, 0, 0};
+    ASSUME_NOT_CNULL(shared.plugin);
+
+    pthread_t readers[READERS];
+    int started = 0;
+    while (started < READERS && pthread_create(&readers[started], NULL, test_plugin_reader, &shared) == 0)
+        started++;
+    // Reload only once every reader is calling, and let them run in between
+    while (__atomic_load_n(&shared.ready, __ATOMIC_ACQUIRE) < started)
+        sched_yield();
+
+    int reloaded = 0;
+    for (int i = 0; i < RELOADS; ++i)
+    {
+        reloaded += fossil_sys_plugin_reload(shared.plugin) == 1;
+        fossil_sys_plugin_collect(shared.plugin);
+        sched_yield();
+    }
+    __atomic_store_n(&shared.stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; ++i)
+        pthread_join(readers[i], NULL);
+
+    // With every reader gone all retired versions can be unloaded
+    size_t retired = fossil_sys_plugin_collect(shared.plugin);
+    retired += fossil_sys_plugin_collect(shared.plugin);
+    uint64_t version = fossil_sys_plugin_version(shared.plugin);
+    fossil_sys_plugin_close(shared.plugin);
+    remove(path);
+
+    ASSUME_ITS_EQUAL_I32(started, READERS);
+    ASSUME_ITS_EQUAL_I32(reloaded, RELOADS);
+    ASSUME_ITS_EQUAL_U64(version, RELOADS + 1);
+    ASSUME_ITS_EQUAL_SIZE(retired, 0);
+    ASSUME_ITS_TRUE(shared.calls > 0);
+    ASSUME_ITS_EQUAL_U64(shared.errors, 0);
+#endif
+}
+
+// ** Test that a change is still seen when the watch queue overflows **
+FOSSIL_TEST(c_test_plugin_watch_overflow)
+{
+#if defined(__linux__)
+    const char *path = "fossil_sys_plugin_overflow.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+    const char *symbols[] = {"sqrt"};
+    fossil_sys_plugin_t *plugin = fossil_sys_plugin_open(path, symbols, 1);
+    ASSUME_NOT_CNULL(plugin);
+
+    long queued = 0;
+    FILE *limit = fopen("/proc/sys/fs/inotify/max_queued_events", "r");
+    if (limit)
+    {
+        if (fscanf(limit, "%ld", &queued) != 1)
+            queued = 0;
+        fclose(limit);
+    }
+
+    int rc = 0;
+    if (fossil_sys_plugin_watch_fd(plugin) >= 0 && queued > 0 && queued <= 65536)
+    {
+        // Fill the queue from two names so the kernel cannot merge the events
+        const char *noise[] = {"fossil_sys_plugin_noise_a", "fossil_sys_plugin_noise_b"};
+        for (long i = 0; i <= queued; ++i)
+        {
+            FILE *f = fopen(noise[i & 1], "w");
+            if (f)
+                fclose(f);
+        }
+        // This write's event is dropped; the plugin grows by one byte
+        FILE *f = fopen(path, "ab");
+        if (f)
+        {
+            fputc(0, f);
+            fclose(f);
+        }
+        rc = fossil_sys_plugin_poll(plugin);
+        remove(noise[0]);
+        remove(noise[1]);
+    }
+    else
+        rc = 1; // no inotify: changes are found by polling anyway
+
+    fossil_sys_plugin_close(plugin);
+    remove(path);
+    ASSUME_ITS_EQUAL_I32(rc, 1);
+#endif
+}
+
+#if defined(__linux__)
+static int test_plugin_exists(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f)
+        fclose(f);
+    return f != NULL;
+}
+#endif
+
+// ** Test the copy directory and removal of copies left by dead processes **
+FOSSIL_TEST(c_test_plugin_copy_dir)
+{
+#if defined(__linux__)
+    const char *path = "fossil_sys_plugin_copies.so";
+    const char *dir = "fossil_sys_plugin_copies";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+    mkdir(dir, 0700);
+
+    // One copy from a pid above pid_max (dead), one from a live process
+    long pid_max = 4194304;
+    FILE *limit = fopen("/proc/sys/kernel/pid_max", "r");
+    if (limit)
+    {
+        if (fscanf(limit, "%ld", &pid_max) != 1)
+            pid_max = 4194304;
+        fclose(limit);
+    }
+    char stale[256], live[256], copy[256];
+    snprintf(stale, sizeof(stale), "%s/fossil-plugin-%ld-7-%s", dir, pid_max + 1, path);
+    snprintf(live, sizeof(live), "%s/fossil-plugin-%ld-7-%s", dir, (long)getppid(), path);
+    snprintf(copy, sizeof(copy), "%s/fossil-plugin-%ld-1-%s", dir, (long)getpid(), path);
+    FILE *f = fopen(stale, "w");
+    if (f)
+        fclose(f);
+    f = fopen(live, "w");
+    if (f)
+        fclose(f);
+
+    const char *symbols[] = {"sqrt"};
+    fossil_sys_plugin_t *plugin = fossil_sys_plugin_open_ex(path, symbols, 1, dir);
+    int opened = plugin != NULL;
+    int copied = test_plugin_exists(copy);
+    int stale_left = test_plugin_exists(stale);
+    int live_left = test_plugin_exists(live);
+    fossil_sys_plugin_close(plugin);
+    int copy_left = test_plugin_exists(copy);
+
+    remove(stale);
+    remove(live);
+    remove(copy);
+    rmdir(dir);
+    remove(path);
+    ASSUME_ITS_TRUE(opened);
+    ASSUME_ITS_TRUE(copied);
+    ASSUME_ITS_FALSE(stale_left);
+    ASSUME_ITS_TRUE(live_left);
+    ASSUME_ITS_FALSE(copy_left);
+#endif
+}
+
+// ** Test that a version with missing symbols is rejected **
+FOSSIL_TEST(c_test_plugin_missing_symbol)
+{
+#if defined(__linux__)
+    const char *path = "fossil_sys_plugin_missing.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+    const char *symbols[] = {"sqrt", "fossil_no_such_symbol"};
+    ASSUME_ITS_CNULL(fossil_sys_plugin_open(path, symbols, 2));
+    remove(path);
+#endif
+    ASSUME_ITS_CNULL(fossil_sys_plugin_open(NULL, NULL, 0));
+    ASSUME_ITS_EQUAL_I32(fossil_sys_plugin_poll(NULL), -1);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_plugin_tests)
+{
+    FOSSIL_ADD_TEST(c_plugin_suite, c_test_plugin_reload);
+    FOSSIL_ADD_TEST(c_plugin_suite, c_test_plugin_concurrent_reload);
+    FOSSIL_ADD_TEST(c_plugin_suite, c_test_plugin_watch_overflow);
+    FOSSIL_ADD_TEST(c_plugin_suite, c_test_plugin_copy_dir);
+    FOSSIL_ADD_TEST(c_plugin_suite, c_test_plugin_missing_symbol);
+
+    FOSSIL_ADD_SUITE(c_plugin_suite);
+}
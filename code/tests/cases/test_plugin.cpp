@@ -0,0 +1,76 @@
+/*
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * performance, cross-platform applications and libraries. The code contained
+ * This file is part of the Fossil Logic project, which aims to develop high-
+ * herein is subject to the terms and conditions defined in the project license.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ *
+ * Copyright (C) 2024 Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+
+#include "fossil/sys/framework.h"
+#include "fixture_libm.h"
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+// Define the test suite and add test cases
+FOSSIL_SUITE(cpp_plugin_suite);
+
+// Setup function for the test suite
+FOSSIL_SETUP(cpp_plugin_suite)
+{
+    // Setup code here
+}
+
+// Teardown function for the test suite
+FOSSIL_TEARDOWN(cpp_plugin_suite)
+{
+    // Teardown code here
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// ** Test fossil::sys::Plugin guards **
+FOSSIL_TEST(cpp_test_plugin_wrapper)
+{
+#if defined(__linux__)
+    const char *path = "fossil_sys_plugin_cpp.so";
+    ASSUME_ITS_TRUE(fossil_test_fixture_install_libm(path));
+
+    fossil::sys::Plugin plugin(path, {"sqrt"});
+    ASSUME_ITS_TRUE(plugin.is_open());
+    {
+        auto guard = plugin.enter();
+        ASSUME_ITS_EQUAL_U64(guard.version(), 1);
+        ASSUME_ITS_TRUE(guard.fn<double(double)>(0)(49.0) == 7.0);
+    }
+    ASSUME_ITS_EQUAL_I32(plugin.reload(), 1);
+    ASSUME_ITS_EQUAL_U64(plugin.version(), 2);
+    remove(path);
+#endif
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_plugin_tests)
+{
+    FOSSIL_ADD_TEST(cpp_plugin_suite, cpp_test_plugin_wrapper);
+
+    FOSSIL_ADD_SUITE(cpp_plugin_suite);
+}